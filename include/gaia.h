@@ -12,9 +12,11 @@
 
 #include "gaia/mem/data_layout_policy.h"
 #include "gaia/mem/mem_alloc.h"
+#include "gaia/mem/mem_bulk.h"
 #include "gaia/mem/mem_sani.h"
 #include "gaia/mem/mem_utils.h"
 #include "gaia/mem/raw_data_holder.h"
+#include "gaia/mem/simd.h"
 #include "gaia/mem/smallblock_allocator.h"
 #include "gaia/mem/stack_allocator.h"
 
@@ -46,9 +48,11 @@
 #include "gaia/ser/ser_binary.h"
 #include "gaia/ser/ser_buffer_binary.h"
 #include "gaia/ser/ser_common.h"
+#include "gaia/ser/ser_compress.h"
 #include "gaia/ser/ser_ct.h"
 #include "gaia/ser/ser_json.h"
 #include "gaia/ser/ser_rt.h"
+#include "gaia/ser/ser_stream_binary.h"
 
 #include "gaia/mt/threadpool.h"
 
@@ -63,4 +67,7 @@
 #include "gaia/ecs/component_setter.h"
 #include "gaia/ecs/id.h"
 #include "gaia/ecs/query.h"
+#include "gaia/ecs/snapshot.h"
+#include "gaia/ecs/spatial_index.h"
+#include "gaia/ecs/value_index.h"
 #include "gaia/ecs/world.h"
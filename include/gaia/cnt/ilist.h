@@ -1363,6 +1363,52 @@ namespace gaia {
 				++m_freeItems;
 			}
 
+			//! Invalidates a handle without linking its slot into the free-list. The payload stays alive.
+			//! The caller becomes the owner of the slot. It either revives it via reuse_retired() or hands it
+			//! over to the free-list via free_retired().
+			//! \param handle Handle identifying the item to retire.
+			//! \note Only the slot's own handle metadata is written. Owners of different retired slots
+			//!       do not need to synchronize with each other or with alloc()/free().
+			//! \warning Retired slots are neither live nor free. item_count() keeps counting them.
+			void retire_keep_live(TItemHandle handle) {
+				auto* pPage = try_page(handle.id());
+				GAIA_ASSERT(pPage != nullptr);
+				const auto slot = slot_index(handle.id());
+				GAIA_ASSERT(pPage->aliveMask.test(slot));
+				GAIA_ASSERT(pPage->handles[slot] == handle);
+				pPage->handles[slot] = ilist_handle_traits<TItemHandle>::make(handle.id(), handle.gen() + 1, handle);
+			}
+
+			//! Reinitializes a slot previously retired by retire_keep_live() in place.
+			//! \param index Slot index of the retired item.
+			//! \param ctx Creation context forwarded to TListItem::create().
+			//! \return Handle of the reinitialized item.
+			GAIA_NODISCARD TItemHandle reuse_retired(size_type index, void* ctx) {
+				auto* pPage = try_page(index);
+				GAIA_ASSERT(pPage != nullptr);
+				const auto slot = slot_index(index);
+				GAIA_ASSERT(pPage->aliveMask.test(slot));
+				GAIA_ASSERT(pPage->nextFree[slot] == TItemHandle::IdMask);
+
+				auto& item = *pPage->ptr(slot);
+				item = TListItem::create(index, pPage->handles[slot].gen(), ctx);
+				pPage->handles[slot] = TListItem::handle(item);
+				return pPage->handles[slot];
+			}
+
+			//! Links a slot previously retired by retire_keep_live() into the free-list.
+			//! The payload stays alive until the slot is allocated again, same as with free_keep_live().
+			//! \param index Slot index of the retired item.
+			void free_retired(size_type index) {
+				auto* pPage = try_page(index);
+				GAIA_ASSERT(pPage != nullptr);
+				const auto slot = slot_index(index);
+				GAIA_ASSERT(pPage->aliveMask.test(slot));
+				pPage->nextFree[slot] = m_freeItems == 0 ? TItemHandle::IdMask : m_nextFreeIdx;
+				m_nextFreeIdx = index;
+				++m_freeItems;
+			}
+
 			//! Verifies that the implicit free-list links are well formed.
 			void validate() const {
 				if (m_freeItems == 0)
@@ -44,6 +44,12 @@
 	#define GAIA_FUNC_WRAPPER_SMALLBLOCK 1
 #endif
 
+//! If enabled, mt::Futex uses the futex system call on platforms that provide it (Linux).
+//! Otherwise, futexes are emulated via mutex-protected wait lists and per-thread events.
+#ifndef GAIA_USE_NATIVE_FUTEX
+	#define GAIA_USE_NATIVE_FUTEX 1
+#endif
+
 //! If enabled, systems as entities are enabled
 #ifndef GAIA_SYSTEMS_ENABLED
 	#define GAIA_SYSTEMS_ENABLED 1
@@ -2,6 +2,7 @@
 #include "gaia/config/config.h"
 
 #include <cstdint>
+#include <cstring>
 #include <type_traits>
 
 namespace gaia {
@@ -244,5 +245,106 @@ namespace gaia {
 	#error "Unknown hashing type defined"
 #endif
 
+		//! \cond INTERNAL
+		namespace detail {
+			namespace hash64 {
+				constexpr uint64_t P1 = 0x9E3779B185EBCA87ULL;
+				constexpr uint64_t P2 = 0xC2B2AE3D27D4EB4FULL;
+				constexpr uint64_t P3 = 0x165667B19E3779F9ULL;
+				constexpr uint64_t P4 = 0x85EBCA77C2B2AE63ULL;
+				constexpr uint64_t P5 = 0x27D4EB2F165667C5ULL;
+
+				GAIA_FORCEINLINE uint64_t rotl(uint64_t x, uint32_t r) {
+					return (x << r) | (x >> (64U - r));
+				}
+
+				GAIA_FORCEINLINE uint64_t load64(const uint8_t* p) {
+					uint64_t v;
+					memcpy(&v, p, sizeof(v));
+					return v;
+				}
+
+				GAIA_FORCEINLINE uint32_t load32(const uint8_t* p) {
+					uint32_t v;
+					memcpy(&v, p, sizeof(v));
+					return v;
+				}
+
+				GAIA_FORCEINLINE uint64_t round(uint64_t acc, uint64_t input) {
+					acc += input * P2;
+					acc = rotl(acc, 31);
+					return acc * P1;
+				}
+
+				GAIA_FORCEINLINE uint64_t merge(uint64_t acc, uint64_t val) {
+					acc ^= round(0, val);
+					return acc * P1 + P4;
+				}
+			} // namespace hash64
+		} // namespace detail
+		//! \endcond
+
+		//! Calculates a 64-bit hash of a block of memory.
+		//! Large blocks are processed in 32-byte stripes by four independent lanes so the CPU can overlap
+		//! the multiplications. Meant for hashing bulk data, e.g. whole component columns.
+		//! \warning The result depends on the byte order of the platform.
+		//! \param pData Pointer to the first byte to hash
+		//! \param size Number of bytes to hash
+		//! \param seed Seed of the hash. Can be used to chain hashes of multiple blocks.
+		//! \return The 64-bit hash.
+		inline uint64_t hash_data64(const void* pData, uint64_t size, uint64_t seed = 0) {
+			using namespace detail::hash64;
+
+			const auto* p = (const uint8_t*)pData;
+			const auto* pEnd = p + size;
+			uint64_t h = 0;
+
+			if (size >= 32) {
+				uint64_t v1 = seed + P1 + P2;
+				uint64_t v2 = seed + P2;
+				uint64_t v3 = seed;
+				uint64_t v4 = seed - P1;
+
+				const auto* pLimit = pEnd - 32;
+				do {
+					v1 = round(v1, load64(p));
+					v2 = round(v2, load64(p + 8));
+					v3 = round(v3, load64(p + 16));
+					v4 = round(v4, load64(p + 24));
+					p += 32;
+				} while (p <= pLimit);
+
+				h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+				h = merge(h, v1);
+				h = merge(h, v2);
+				h = merge(h, v3);
+				h = merge(h, v4);
+			} else
+				h = seed + P5;
+
+			h += size;
+
+			for (; p + 8 <= pEnd; p += 8) {
+				h ^= round(0, load64(p));
+				h = rotl(h, 27) * P1 + P4;
+			}
+			if (p + 4 <= pEnd) {
+				h ^= (uint64_t)load32(p) * P1;
+				h = rotl(h, 23) * P2 + P3;
+				p += 4;
+			}
+			for (; p < pEnd; ++p) {
+				h ^= (uint64_t)(*p) * P5;
+				h = rotl(h, 11) * P1;
+			}
+
+			h ^= h >> 33;
+			h *= P2;
+			h ^= h >> 29;
+			h *= P3;
+			h ^= h >> 32;
+			return h;
+		}
+
 	} // namespace core
 } // namespace gaia
@@ -133,6 +133,8 @@ namespace gaia {
 
 		CommandBufferST& cmd_buffer_st_get(World& world);
 		CommandBufferMT& cmd_buffer_mt_get(World& world);
+		CommandBufferMT& cmd_buffer_mt_get(World& world, uint32_t partition);
+		uint32_t world_det_partitions(const World& world);
 		void commit_cmd_buffer_st(World& world);
 		void commit_cmd_buffer_mt(World& world);
 	} // namespace ecs
@@ -193,6 +193,14 @@ namespace gaia {
 			return world.cmd_buffer_mt();
 		}
 
+		GAIA_NODISCARD inline CommandBufferMT& cmd_buffer_mt_get(World& world, uint32_t partition) {
+			return world.cmd_buffer_mt(partition);
+		}
+
+		GAIA_NODISCARD inline uint32_t world_det_partitions(const World& world) {
+			return world.det_partitions();
+		}
+
 		inline void commit_cmd_buffer_st(World& world) {
 			if (world.locked())
 				return;
@@ -203,6 +211,10 @@ namespace gaia {
 			if (world.locked())
 				return;
 			cmd_buffer_commit(world.cmd_buffer_mt());
+
+			// Partitions of deterministic parallel execution follow in partition order
+			const auto partitions = world.det_partitions();
+			GAIA_FOR(partitions) cmd_buffer_commit(world.cmd_buffer_mt(i));
 		}
 	} // namespace ecs
 } // namespace gaia
@@ -130,9 +130,25 @@ namespace gaia {
 				ChunkDataOffset compOffs[ChunkHeader::MAX_COMPONENTS];
 			};
 
+			//! Cached state digest of a chunk
+			struct ChunkStateHash {
+				//! Chunk the digest belongs to. Chunks swap places when one of them is released.
+				const Chunk* pChunk = nullptr;
+				//! Digest of the chunk
+				uint64_t hash = 0;
+				//! Key of the component filter the digest was calculated with
+				uint64_t filterKey = 0;
+				//! World version at which the digest was calculated. 0 if it was never calculated.
+				uint32_t version = 0;
+				//! Entity count and the first enabled row at the time the digest was calculated
+				uint32_t rows = 0;
+			};
+
 			struct StorageData {
 				//! Array of chunks allocated by this archetype
 				cnt::darray<Chunk*> chunks;
+				//! State digests of chunks. Indexed like chunks. Filled on demand.
+				cnt::darray<ChunkStateHash> stateHashes;
 				//! Index of the first chunk with enough space to add at least one entity
 				uint32_t firstFreeChunkIdx = 0;
 			};
@@ -394,14 +410,14 @@ namespace gaia {
 
 			//! Estimates whether another entity still fits in the chunk described by \a comps.
 			//! \param cc Component metadata cache.
-			//! \param offs Current byte offset inside the chunk payload.
+			//! \param offs Current byte offset inside the chunk payload. Updated to the offset after the last component.
 			//! \param ids Entitiies laid out in the chunk.
 			//! \param comps Components laid out in the chunk.
 			//! \param cap Candidate entity count used for the estimate.
 			//! \param maxDataOffset Maximum byte offset available for component payloads.
 			//! \return True if the chunk can still fit the candidate entity count. False otherwise.
 			static bool est_max_entities_per_chunk(
-					uint32_t offs, const ComponentCacheItem* const* pItems, uint32_t cnt, uint32_t cap, uint32_t maxDataOffset) {
+					uint32_t& offs, const ComponentCacheItem* const* pItems, uint32_t cnt, uint32_t cap, uint32_t maxDataOffset) {
 				GAIA_FOR(cnt) {
 					const auto comp = comp_from_item(pItems[i]);
 					if (!component_uses_table_storage(comp))
@@ -435,7 +451,7 @@ namespace gaia {
 					if (!component_uses_table_storage(comp)) {
 						ofs[compIdx] = {};
 					} else {
-						const auto alig = comp.alig();
+						const auto alig = pItems[i]->column_alig();
 						currOff = mem::align(currOff, alig);
 						ofs[compIdx] = (ChunkDataOffset)currOff;
 
@@ -557,7 +573,7 @@ namespace gaia {
 
 					// Helper to test if a given entity count fits in the chunk
 					auto try_fit = [&](uint32_t count) -> bool {
-						const uint32_t currOff = offs.firstByte_EntityData + (count * sizeof(Entity));
+						uint32_t currOff = offs.firstByte_EntityData + (count * sizeof(Entity));
 
 						if (!est_max_entities_per_chunk(currOff, newArch->m_shape.compItems, entsGeneric, count, dataLimit))
 							return false;
@@ -766,6 +782,14 @@ namespace gaia {
 				chunk.update_versions();
 			}
 
+			//! Removes all entities from the chunk without moving any rows and updates the chunk versions.
+			//! \param chunk Chunk to clear
+			void remove_all_entities(Chunk& chunk) {
+				chunk.remove_all_entities();
+				try_update_free_chunk_idx(chunk);
+				chunk.update_versions();
+			}
+
 			GAIA_NODISCARD const Properties& props() const {
 				return m_shape.properties;
 			}
@@ -774,6 +798,33 @@ namespace gaia {
 				return m_storage.chunks;
 			}
 
+			//! Returns the state digest of the chunk at \a chunkIdx.
+			//! The digest is only recalculated if the chunk changed since the last call.
+			//! \param chunkIdx Index of the chunk
+			//! \param excluded Components whose data is not hashed
+			//! \param filterKey Key identifying \a excluded. Digests cached with a different key are recalculated.
+			//! \return 64-bit digest of the chunk.
+			//! \see Chunk::hash_state
+			GAIA_NODISCARD uint64_t chunk_state_hash(uint32_t chunkIdx, std::span<const Entity> excluded, uint64_t filterKey) {
+				const auto chunkCnt = m_storage.chunks.size();
+				if (m_storage.stateHashes.size() < chunkCnt)
+					m_storage.stateHashes.resize(chunkCnt);
+
+				const auto* pChunk = m_storage.chunks[chunkIdx];
+				auto& cache = m_storage.stateHashes[chunkIdx];
+				const uint32_t rows = ((uint32_t)pChunk->size() << 16) | (uint32_t)pChunk->size_disabled();
+				if (cache.pChunk == pChunk && cache.version != 0 && cache.filterKey == filterKey && cache.rows == rows &&
+						!pChunk->changed(cache.version) && !pChunk->entity_order_changed(cache.version))
+					return cache.hash;
+
+				cache.pChunk = pChunk;
+				cache.hash = pChunk->hash_state(excluded);
+				cache.filterKey = filterKey;
+				cache.version = m_worldVersion;
+				cache.rows = rows;
+				return cache.hash;
+			}
+
 			GAIA_NODISCARD LookupHash lookup_hash() const {
 				return m_shape.hashLookup;
 			}
@@ -0,0 +1,329 @@
+#pragma once
+#include "gaia/config/config.h"
+
+#include <cstdint>
+
+#include "gaia/cnt/darray.h"
+#include "gaia/config/profiler.h"
+#include "gaia/core/utility.h"
+#include "gaia/ecs/component.h"
+#include "gaia/ecs/id.h"
+#include "gaia/mt/spinlock.h"
+
+namespace gaia {
+	namespace ecs {
+		//! Kinds of changes recorded by ChangeJournal
+		enum class JournalOp : uint8_t {
+			//! Entity was created
+			EntityAdd,
+			//! Entity was deleted
+			EntityDel,
+			//! Component was added to an entity
+			CompAdd,
+			//! Component was removed from an entity
+			CompDel,
+			//! Component of an entity was written to
+			Write,
+		};
+
+		//! Change recorded by ChangeJournal
+		struct JournalEvent {
+			//! Kind of the change
+			JournalOp op;
+			//! Frame in which the change happened
+			uint32_t frame;
+			//! Entity that changed
+			Entity entity;
+			//! Component that was added, removed or written to. EntityBad for entity events.
+			Entity comp;
+		};
+
+		//! Reader of a ChangeJournal. Each cursor reads the journal at its own pace.
+		struct JournalCursor {
+			uint32_t idx = BadIndex;
+
+			GAIA_NODISCARD bool valid() const {
+				return idx != BadIndex;
+			}
+		};
+
+		//! Opt-in log of structural changes and component writes meant for replication.
+		//! Changes are appended to the current frame as they happen. commit() seals the frame and makes it visible
+		//! to cursors. World::update commits automatically at the end of each frame.
+		//! Sealed frames are dropped once every cursor has read them. With no cursors registered nothing is kept.
+		//! Events are stored as a byte stream. Each event is an opcode byte followed by the entity and component
+		//! encoded as zig-zag varint deltas against the previous event of the frame, so runs of neighbouring entities
+		//! take only a few bytes per event.
+		class ChangeJournal final {
+			//! Sealed frame
+			struct FrameRec {
+				//! Frame number
+				uint32_t frame;
+				//! Offset of the first event in m_data
+				uint32_t offset;
+				//! Number of bytes
+				uint32_t bytes;
+				//! Number of events
+				uint32_t events;
+			};
+
+			//! Max number of bytes of an encoded event
+			static constexpr uint32_t MaxEventBytes = 1 + 10 + 10;
+			//! Cursor slot not in use
+			static constexpr uint64_t FreeCursor = uint64_t(-1);
+
+			//! Encoded events of sealed frames followed by events of the current frame
+			cnt::darray<uint8_t> m_data;
+			//! Sealed frames
+			cnt::darray<FrameRec> m_frames;
+			//! Sequence number of m_frames[0]
+			uint64_t m_firstSeq = 0;
+			//! Sequence number of the next frame to read for each cursor. FreeCursor for slots not in use.
+			cnt::darray<uint64_t> m_cursors;
+			//! Number of active cursors
+			uint32_t m_cursorCnt = 0;
+			//! Number of the current frame
+			uint32_t m_frame = 0;
+			//! Offset of the current frame in m_data
+			uint32_t m_frameOffset = 0;
+			//! Number of events in the current frame
+			uint32_t m_frameEvents = 0;
+			//! Entity of the previous event. Base for delta encoding.
+			uint64_t m_prevEntity = 0;
+			//! Component of the previous event. Base for delta encoding.
+			uint64_t m_prevComp = 0;
+			//! True if changes are recorded
+			bool m_enabled = false;
+			//! Serializes recording from worker threads
+			GAIA_PROF_MUTEX(mt::SpinLock, m_mtx);
+
+		public:
+			ChangeJournal() = default;
+			~ChangeJournal() = default;
+			ChangeJournal(const ChangeJournal&) = delete;
+			ChangeJournal& operator=(const ChangeJournal&) = delete;
+			ChangeJournal(ChangeJournal&&) = delete;
+			ChangeJournal& operator=(ChangeJournal&&) = delete;
+
+			//! Enables or disables recording. Nothing is recorded by default.
+			//! \param enabled True to record changes
+			void enable(bool enabled) {
+				m_enabled = enabled;
+			}
+
+			//! Checks if changes are recorded.
+			GAIA_NODISCARD bool enabled() const {
+				return m_enabled;
+			}
+
+			//! Returns the number of the current frame.
+			GAIA_NODISCARD uint32_t frame() const {
+				return m_frame;
+			}
+
+			//! Returns the number of bytes held by the journal.
+			GAIA_NODISCARD uint32_t bytes() const {
+				return (uint32_t)m_data.size();
+			}
+
+			//! Records a change of \a entity. Thread-safe.
+			//! \param op Kind of the change
+			//! \param entity Entity that changed
+			//! \param comp Component the change applies to. EntityBad for entity events.
+			void record(JournalOp op, Entity entity, Entity comp = EntityBad) {
+				auto& mtx = GAIA_PROF_EXTRACT_MUTEX(m_mtx);
+				core::lock_scope lock(mtx);
+				GAIA_PROF_LOCK_MARK(m_mtx);
+
+				reserve(MaxEventBytes);
+				append(op, entity, comp);
+			}
+
+			//! Records the same change of component \a comp for each entity in \a entities. Thread-safe.
+			//! \param op Kind of the change
+			//! \param comp Component the change applies to
+			//! \param entities Entities that changed
+			void record(JournalOp op, Entity comp, EntitySpan entities) {
+				auto& mtx = GAIA_PROF_EXTRACT_MUTEX(m_mtx);
+				core::lock_scope lock(mtx);
+				GAIA_PROF_LOCK_MARK(m_mtx);
+
+				reserve(MaxEventBytes * (uint32_t)entities.size());
+				for (auto entity: entities)
+					append(op, entity, comp);
+			}
+
+			//! Seals the current frame and starts a new one.
+			//! Frames with no events are not stored but still advance the frame number.
+			void commit() {
+				if (m_frameEvents > 0 && m_cursorCnt > 0) {
+					m_frames.push_back({m_frame, m_frameOffset, (uint32_t)m_data.size() - m_frameOffset, m_frameEvents});
+					m_frameOffset = (uint32_t)m_data.size();
+				} else {
+					m_data.resize(m_frameOffset);
+				}
+
+				++m_frame;
+				m_frameEvents = 0;
+				m_prevEntity = 0;
+				m_prevComp = 0;
+				truncate();
+			}
+
+			//! Registers a new cursor. The cursor sees frames committed after this call.
+			//! \return Cursor handle
+			GAIA_NODISCARD JournalCursor cursor() {
+				const auto seq = m_firstSeq + m_frames.size();
+				++m_cursorCnt;
+				GAIA_EACH(m_cursors) {
+					if (m_cursors[i] == FreeCursor) {
+						m_cursors[i] = seq;
+						return {i};
+					}
+				}
+				m_cursors.push_back(seq);
+				return {(uint32_t)m_cursors.size() - 1};
+			}
+
+			//! Unregisters \a cursor. Frames no other cursor needs are dropped.
+			//! \param cursor Cursor handle
+			void release(JournalCursor& cursor) {
+				GAIA_ASSERT(cursor.valid() && cursor.idx < m_cursors.size() && m_cursors[cursor.idx] != FreeCursor);
+				m_cursors[cursor.idx] = FreeCursor;
+				--m_cursorCnt;
+				cursor.idx = BadIndex;
+				truncate();
+			}
+
+			//! Calls \a func for each event in frames committed since the previous read of \a cursor.
+			//! Events of a frame come in the order they were recorded.
+			//! \param cursor Cursor handle
+			//! \param func Function called as func(const JournalEvent&)
+			//! \return Number of events read.
+			template <typename Func>
+			uint32_t read(JournalCursor cursor, Func func) {
+				GAIA_PROF_SCOPE(ChangeJournal::read);
+				GAIA_ASSERT(cursor.valid() && cursor.idx < m_cursors.size() && m_cursors[cursor.idx] != FreeCursor);
+
+				auto& seq = m_cursors[cursor.idx];
+				const auto endSeq = m_firstSeq + m_frames.size();
+				uint32_t cnt = 0;
+				for (; seq < endSeq; ++seq) {
+					const auto& f = m_frames[(uint32_t)(seq - m_firstSeq)];
+					const auto* p = m_data.data() + f.offset;
+					uint64_t prevEntity = 0;
+					uint64_t prevComp = 0;
+					GAIA_FOR(f.events) {
+						JournalEvent ev;
+						ev.op = (JournalOp)*p++;
+						ev.frame = f.frame;
+						prevEntity += unzigzag(read_varint(p));
+						ev.entity = Entity(prevEntity);
+						if (ev.op == JournalOp::EntityAdd || ev.op == JournalOp::EntityDel)
+							ev.comp = EntityBad;
+						else {
+							prevComp += unzigzag(read_varint(p));
+							ev.comp = Entity(prevComp);
+						}
+						func((const JournalEvent&)ev);
+					}
+					cnt += f.events;
+				}
+
+				truncate();
+				return cnt;
+			}
+
+			//! Drops all frames, including changes recorded in the current frame. Cursors remain registered.
+			void clear() {
+				m_firstSeq += m_frames.size();
+				m_frames.clear();
+				m_data.clear();
+				m_frameOffset = 0;
+				m_frameEvents = 0;
+				m_prevEntity = 0;
+				m_prevComp = 0;
+				for (auto& seq: m_cursors) {
+					if (seq != FreeCursor)
+						seq = m_firstSeq;
+				}
+			}
+
+		private:
+			//! Makes sure at least \a bytes more bytes fit into m_data without reallocating.
+			void reserve(uint32_t bytes) {
+				const auto required = (uint32_t)m_data.size() + bytes;
+				if (required > m_data.capacity())
+					m_data.reserve(core::get_max(required, core::get_max((uint32_t)m_data.capacity() * 2U, 256U)));
+			}
+
+			GAIA_NODISCARD static uint64_t zigzag(uint64_t value, uint64_t prev) {
+				const auto delta = (int64_t)(value - prev);
+				return ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+			}
+
+			GAIA_NODISCARD static uint64_t unzigzag(uint64_t value) {
+				return (value >> 1) ^ (~(value & 1) + 1);
+			}
+
+			static uint8_t* write_varint(uint8_t* p, uint64_t value) {
+				while (value >= 0x80) {
+					*p++ = (uint8_t)(value | 0x80);
+					value >>= 7;
+				}
+				*p++ = (uint8_t)value;
+				return p;
+			}
+
+			GAIA_NODISCARD static uint64_t read_varint(const uint8_t*& p) {
+				uint64_t value = 0;
+				uint32_t shift = 0;
+				while ((*p & 0x80) != 0) {
+					value |= (uint64_t)(*p++ & 0x7F) << shift;
+					shift += 7;
+				}
+				value |= (uint64_t)*p++ << shift;
+				return value;
+			}
+
+			//! Encodes an event. Expects enough capacity to be reserved.
+			void append(JournalOp op, Entity entity, Entity comp) {
+				const auto pos = (uint32_t)m_data.size();
+				m_data.resize(pos + MaxEventBytes);
+				auto* pBegin = m_data.data() + pos;
+				auto* p = pBegin;
+
+				*p++ = (uint8_t)op;
+				p = write_varint(p, zigzag(entity.value(), m_prevEntity));
+				m_prevEntity = entity.value();
+				if (op != JournalOp::EntityAdd && op != JournalOp::EntityDel) {
+					p = write_varint(p, zigzag(comp.value(), m_prevComp));
+					m_prevComp = comp.value();
+				}
+
+				m_data.resize(pos + (uint32_t)(p - pBegin));
+				++m_frameEvents;
+			}
+
+			//! Drops sealed frames every cursor has read.
+			void truncate() {
+				auto minSeq = m_firstSeq + m_frames.size();
+				for (auto seq: m_cursors)
+					minSeq = core::get_min(minSeq, seq);
+
+				const auto dropCnt = (uint32_t)(minSeq - m_firstSeq);
+				if (dropCnt == 0)
+					return;
+
+				const auto dropBytes = dropCnt < m_frames.size() ? m_frames[dropCnt].offset : m_frameOffset;
+				if (dropBytes > 0)
+					m_data.erase(m_data.begin(), m_data.begin() + dropBytes);
+				m_frames.erase(m_frames.begin(), m_frames.begin() + dropCnt);
+				for (auto& f: m_frames)
+					f.offset -= dropBytes;
+				m_frameOffset -= dropBytes;
+				m_firstSeq = minSeq;
+			}
+		};
+	} // namespace ecs
+} // namespace gaia
@@ -439,6 +439,8 @@ namespace gaia {
 						sizeof(ChunkHeader) + sizeof(ChunkRecords);
 				static_assert(dataAreaOffset % MemoryBlockAlignment == 0);
 				static_assert(dataAreaOffset < UINT16_MAX);
+				// Column offsets are relative to the data area so its alignment bounds the alignment of columns
+				static_assert(ChunkColumnAlignment <= MemoryBlockAlignment);
 				return dataAreaOffset;
 			}
 
@@ -482,9 +484,11 @@ namespace gaia {
 				GAIA_ASSERT(totalBytes <= MaxMemoryBlockSize);
 				const auto sizeType = mem_block_size_type(totalBytes);
 				const auto allocSize = mem_block_size(sizeType);
-				auto* pChunkMem = mem::AllocHelper::alloc<uint8_t>(allocSize);
+				// Mirror the chunk allocator's block layout so the data area ends up equally aligned
+				auto* pChunkMem = mem::AllocHelper::alloc_alig<uint8_t>(MemoryBlockAlignment, allocSize);
 				std::memset(pChunkMem, 0, allocSize);
-				auto* pChunk = new (pChunkMem) Chunk(wld, cc, chunkIndex, capacity, genEntities, worldVersion);
+				auto* pChunk = new (pChunkMem + MemoryBlockUsableOffset)
+						Chunk(wld, cc, chunkIndex, capacity, genEntities, worldVersion);
 #endif
 
 				pChunk->init((uint32_t)cntEntities, ids, pItems, offsets, compOffs);
@@ -507,7 +511,7 @@ namespace gaia {
 #if GAIA_ECS_CHUNK_ALLOCATOR
 				ChunkAllocator::get().free(pChunk);
 #else
-				mem::AllocHelper::free((uint8_t*)pChunk);
+				mem::AllocHelper::free_alig((uint8_t*)pChunk - MemoryBlockUsableOffset);
 #endif
 			}
 
@@ -889,8 +893,10 @@ namespace gaia {
 			//! \param pDstChunk Destination chunk
 			//! \param dstRow First destination row in destination chunk
 			//! \param dstCount Number of destination rows to copy into
+			//! \param stream If true, trivially copyable columns are written with non-temporal stores
 			static void copy_entity_data_n_same_chunk(
-					Chunk* pSrcChunk, uint32_t srcRow, Chunk* pDstChunk, uint32_t dstRow, uint32_t dstCount) {
+					Chunk* pSrcChunk, uint32_t srcRow, Chunk* pDstChunk, uint32_t dstRow, uint32_t dstCount,
+					bool stream = false) {
 				GAIA_PROF_SCOPE(Chunk::copy_entity_data_n_same_chunk);
 
 				GAIA_ASSERT(pSrcChunk != nullptr);
@@ -909,10 +915,9 @@ namespace gaia {
 						continue;
 
 					const auto* pSrc = (const void*)pSrcChunk->comp_ptr(i);
-					GAIA_FOR_(dstCount, rowOffset) {
-						auto* pDst = (void*)pDstChunk->comp_ptr_mut(i);
-						rec.pItem->copy(pDst, pSrc, dstRow + rowOffset, srcRow, pDstChunk->capacity(), pSrcChunk->capacity());
-					}
+					auto* pDst = (void*)pDstChunk->comp_ptr_mut(i);
+					rec.pItem->copy_fill(
+							pDst, pSrc, dstRow, srcRow, dstCount, pDstChunk->capacity(), pSrcChunk->capacity(), stream);
 				}
 			}
 
@@ -922,8 +927,10 @@ namespace gaia {
 			//! \param pDstChunk Destination chunk
 			//! \param dstRow First destination row in destination chunk
 			//! \param dstCount Number of destination rows to copy into
+			//! \param stream If true, trivially copyable columns are written with non-temporal stores
 			static void copy_foreign_entity_data_n(
-					Chunk* pSrcChunk, uint32_t srcRow, Chunk* pDstChunk, uint32_t dstRow, uint32_t dstCount) {
+					Chunk* pSrcChunk, uint32_t srcRow, Chunk* pDstChunk, uint32_t dstRow, uint32_t dstCount,
+					bool stream = false) {
 				GAIA_PROF_SCOPE(Chunk::copy_foreign_entity_data_n);
 
 				GAIA_ASSERT(pSrcChunk != nullptr);
@@ -946,9 +953,15 @@ namespace gaia {
 						if (component_uses_table_storage(rec.comp)) {
 							auto* pSrc = (void*)pSrcChunk->comp_ptr_mut(i);
 							auto* pDst = (void*)pDstChunk->comp_ptr_mut(j);
-							GAIA_FOR_(dstCount, rowOffset) {
-								rec.pItem->ctor_copy(
-										pDst, pSrc, dstRow + rowOffset, srcRow, pDstChunk->capacity(), pSrcChunk->capacity());
+							if (rec.pItem->trivialCopy) {
+								// Trivially copyable values need no constructor so the rows can be filled in bulk
+								rec.pItem->copy_fill(
+										pDst, pSrc, dstRow, srcRow, dstCount, pDstChunk->capacity(), pSrcChunk->capacity(), stream);
+							} else {
+								GAIA_FOR_(dstCount, rowOffset) {
+									rec.pItem->ctor_copy(
+											pDst, pSrc, dstRow + rowOffset, srcRow, pDstChunk->capacity(), pSrcChunk->capacity());
+								}
 							}
 						}
 
@@ -1223,6 +1236,42 @@ namespace gaia {
 				}
 			}
 
+			//! Removes all entities from the chunk at once.
+			//! Unlike remove_entity no rows are moved. Generic component data is destroyed with one call per component.
+			//! \warning Records of the removed entities are left untouched. It is up to the caller to invalidate them.
+			void remove_all_entities() {
+				if GAIA_UNLIKELY (m_header.count == 0)
+					return;
+
+				GAIA_PROF_SCOPE(Chunk::remove_all_entities);
+
+				if (m_header.hasAnyCustomGenDtor) {
+					auto recs = comp_rec_view();
+					GAIA_FOR(m_header.genEntities) {
+						const auto& rec = recs[i];
+						if (!component_uses_table_storage(rec.comp))
+							continue;
+
+						const auto* pItem = rec.pItem;
+						if (pItem == nullptr || pItem->func_dtor == nullptr)
+							continue;
+
+						auto* pSrc = (void*)comp_ptr_mut(i, 0);
+						pItem->func_dtor(pSrc, m_header.count);
+					}
+				}
+
+#if GAIA_ASSERT_ENABLED
+				// Invalidate the entities in chunk data
+				auto ev = entity_view_mut();
+				GAIA_FOR(m_header.count) ev[i] = EntityBad;
+#endif
+
+				m_header.count = 0;
+				m_header.countEnabled = 0;
+				m_header.rowFirstEnabledEntity = 0;
+			}
+
 			//! Tries to swap the entity at row \a rowA with the one at the row \a rowB.
 			//! When swapping, all data associated with the two entities is swapped as well.
 			//! If \a rowA equals \a rowB no swapping is performed.
@@ -1854,6 +1903,58 @@ namespace gaia {
 				return ::gaia::ecs::version_changed(m_header.entityOrderVersion, requiredVersion);
 			}
 
+			//! Checks if the column at index \a compIdx holds data that makes up the state of the world.
+			//! That is data of table-stored, trivially copyable components other than core components.
+			//! \param compIdx Component index
+			//! \return True if the column is part of the world state.
+			GAIA_NODISCARD bool is_state_column(uint32_t compIdx) const {
+				// Core components store runtime data such as pointers which differ between processes
+				const auto& rec = m_records.pRecords[compIdx];
+				return m_records.pCompEntities[compIdx].id() > GAIA_ID(LastCoreComponent).id() &&
+							 component_uses_table_storage(rec.comp) && rec.comp.size() != 0 && rec.pItem->trivialCopy;
+			}
+
+			//! Calculates a digest of the entities and component data stored in the chunk.
+			//! Hashes the entity column, the enabled state, ids of all components and data of trivially copyable
+			//! components. Data of core components, sparse components and components listed in \a excluded is skipped.
+			//! \param excluded Components whose data is not hashed
+			//! \return 64-bit digest of the chunk.
+			GAIA_NODISCARD uint64_t hash_state(std::span<const Entity> excluded) const {
+				const uint32_t rows = ((uint32_t)m_header.count << 16) | (uint32_t)m_header.rowFirstEnabledEntity;
+				const auto cnt = (uint32_t)m_header.count;
+				uint64_t hash = core::hash_data64(m_records.pEntities, sizeof(Entity) * cnt, rows);
+
+				auto recs = comp_rec_view();
+				GAIA_EACH(recs) {
+					const auto compEntity = m_records.pCompEntities[i];
+					bool isExcluded = false;
+					for (auto e: excluded) {
+						if (e == compEntity) {
+							isExcluded = true;
+							break;
+						}
+					}
+					if (isExcluded)
+						continue;
+
+					// Component ids also cover tags and relationships
+					const auto id = compEntity.value();
+					hash = core::hash_data64(&id, sizeof(id), hash);
+
+					if (!is_state_column(i))
+						continue;
+
+					// Unique components store a single value
+					const auto& rec = recs[i];
+					if (i < m_header.genEntities)
+						hash = rec.pItem->hash_data(rec.pData, cnt, m_header.capacity, hash);
+					else
+						hash = rec.pItem->hash_data(rec.pData, 1, 1, hash);
+				}
+
+				return hash;
+			}
+
 			//! Update the version of a component at the index \param compIdx
 			GAIA_FORCEINLINE void update_world_version(uint32_t compIdx) {
 				auto versions = comp_version_view_mut();
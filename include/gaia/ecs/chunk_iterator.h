@@ -13,7 +13,9 @@
 #include "gaia/ecs/component_cache_item.h"
 #include "gaia/ecs/component_cursor.h"
 #include "gaia/ecs/id.h"
+#include "gaia/ecs/ordered_reduce.h"
 #include "gaia/ecs/query_common.h"
+#include "gaia/ecs/simd_view.h"
 #include "gaia/mem/data_layout_policy.h"
 
 namespace gaia {
@@ -69,6 +71,18 @@ namespace gaia {
 			AcceptAll
 		};
 
+		//! Range of rows [from, to) within a chunk.
+		struct ChunkRange {
+			//! Archetype of the chunk
+			const Archetype* pArchetype = nullptr;
+			//! Chunk the rows belong to
+			Chunk* pChunk = nullptr;
+			//! First row
+			uint16_t from = 0;
+			//! One past the last row
+			uint16_t to = 0;
+		};
+
 		//! \cond INTERNAL
 		namespace detail {
 			class ChunkIterImpl;
@@ -1083,6 +1097,10 @@ namespace gaia {
 				GroupId m_groupId = 0;
 				//! User-owned pointer supplied by the caller driving this iteration.
 				void* m_pCtx = nullptr;
+				//! Index of the chunk batch within a parallel run. 0 for sequential iteration.
+				uint32_t m_batchIdx = 0;
+				//! Command buffer of the logical partition in deterministic mode. Null otherwise.
+				CommandBufferMT* m_pCmdBufferMT = nullptr;
 
 			public:
 				ChunkIterImpl() = default;
@@ -1316,10 +1334,42 @@ namespace gaia {
 				}
 
 				GAIA_NODISCARD CommandBufferMT& cmd_buffer_mt() const {
+					if (m_pCmdBufferMT != nullptr)
+						return *m_pCmdBufferMT;
+
 					auto* pWorld = const_cast<World*>(m_pWorld);
 					return cmd_buffer_mt_get(*pWorld);
 				}
 
+				//! Sets the command buffer returned by cmd_buffer_mt().
+				//! \param pCmdBuffer Command buffer of the logical partition. Null for the world's command buffer.
+				void set_cmd_buffer_mt(CommandBufferMT* pCmdBuffer) {
+					m_pCmdBufferMT = pCmdBuffer;
+				}
+
+				//! Sets the index of the chunk batch within a parallel run.
+				//! \param batchIdx Batch index
+				void set_batch_idx(uint32_t batchIdx) {
+					m_batchIdx = batchIdx;
+				}
+
+				//! Returns the index of the chunk batch within a parallel run.
+				//! Batches are enumerated the same way regardless of the number of threads.
+				//! \return Batch index. 0 for sequential iteration.
+				GAIA_NODISCARD uint32_t batch_idx() const {
+					return m_batchIdx;
+				}
+
+				//! Adds a partial result for the currently iterated chunk batch to \a reduce.
+				//! Partial results are combined in batch order by OrderedReduce::fold so the result does not depend
+				//! on the number of threads.
+				//! \param target Reduction the partial result is added to
+				//! \param value Partial result
+				template <typename T>
+				void reduce(OrderedReduce<T>& target, T value) const {
+					target.add(m_batchIdx, GAIA_MOV(value));
+				}
+
 				GAIA_NODISCARD IterTermDesc resolved_term_desc(uint32_t termIdx, IterTermDesc desc) const {
 					if (m_pTermIdMapping != nullptr) {
 						const auto mappedTermId = m_pTermIdMapping[termIdx];
@@ -1803,6 +1853,42 @@ namespace gaia {
 					return ChunkIterTypedOps::template sview_any_mut<T>(*this, termIdx);
 				}
 
+				//! Returns a read-only lane-blocked view of the chunk column of \a T for explicit SIMD processing.
+				//! Works for SoA components and arithmetic AoS components stored directly in the chunk.
+				//! \code
+				//! auto v = it.simd_view<VelocitySoA>().get<0>();
+				//! \endcode
+				//! \tparam T Component
+				//! \return Read-only SimdView
+				template <typename T>
+				GAIA_NODISCARD auto simd_view() const {
+					using U = typename actual_type_t<T>::Type;
+					const auto v = view<T>();
+					if constexpr (mem::is_soa_layout_v<U>)
+						return SimdView<U, false>(v.pData, v.dataSize, from(), to());
+					else
+						return SimdView<U, false>((const uint8_t*)(v.data() - from()), m_pChunk->capacity(), from(), to());
+				}
+
+				//! Returns a mutable lane-blocked view of the chunk column of \a T for explicit SIMD processing.
+				//! Updates world versioning the same way view_mut() does.
+				//! \code
+				//! auto px = it.simd_view_mut<PositionSoA>().set<0>();
+				//! \endcode
+				//! \tparam T Component
+				//! \return Mutable SimdView
+				template <typename T>
+				GAIA_NODISCARD auto simd_view_mut() {
+					using U = typename actual_type_t<T>::Type;
+					auto v = view_mut<T>();
+					if constexpr (mem::is_soa_layout_v<U>)
+						return SimdView<U, true>(v.pData, v.dataSize, from(), to());
+					else if (v.data() == nullptr)
+						return SimdView<U, true>();
+					else
+						return SimdView<U, true>((uint8_t*)(v.data() - from()), m_pChunk->capacity(), from(), to());
+				}
+
 				//! Marks the component \a T as modified. Best used with sview to manually trigger
 				//! an update at user's whim.
 				//! If \a TriggerHooks is true, also triggers the component's set hooks.
@@ -0,0 +1,97 @@
+#pragma once
+#include "gaia/config/config.h"
+
+#include <cstdint>
+
+#include "gaia/cnt/darray.h"
+#include "gaia/ecs/chunk_iterator.h"
+
+namespace gaia {
+	namespace ecs {
+		namespace detail {
+			//! Set of chunk rows collected by index lookups. Chunks are referred to by the slot index the owning index
+			//! assigned to them. Rows are kept as bitmaps so they come out ordered and merged into ranges no matter
+			//! the order they were added in.
+			class ChunkRowSet final {
+				struct Rows {
+					//! One bit per row
+					cnt::darray<uint64_t> bits;
+					//! One bit per word of bits with any bit set
+					cnt::darray<uint64_t> words;
+					//! True if any row is set
+					bool used = false;
+				};
+
+				//! Rows of each slot
+				cnt::darray<Rows> m_rows;
+				//! Slots with any row set
+				cnt::darray<uint32_t> m_used;
+
+			public:
+				//! Makes room for \a rowCnt rows in slot \a slotIdx.
+				void reserve(uint32_t slotIdx, uint32_t rowCnt) {
+					if (slotIdx >= m_rows.size())
+						m_rows.resize(slotIdx + 1);
+
+					auto& rows = m_rows[slotIdx];
+					const auto wordCnt = (rowCnt + 63) / 64;
+					if (rows.bits.size() < wordCnt) {
+						rows.bits.resize(wordCnt, 0);
+						rows.words.resize((wordCnt + 63) / 64, 0);
+					}
+				}
+
+				//! Adds \a row of slot \a slotIdx to the set.
+				void add(uint32_t slotIdx, uint16_t row) {
+					auto& rows = m_rows[slotIdx];
+					if (!rows.used) {
+						rows.used = true;
+						m_used.push_back(slotIdx);
+					}
+
+					const uint32_t w = row / 64;
+					rows.bits[w] |= 1ULL << (row % 64);
+					rows.words[w / 64] |= 1ULL << (w % 64);
+				}
+
+				//! Moves the set to \a out as ranges and clears it.
+				//! Ranges of the same chunk come one after another ordered by row.
+				//! \param[out] out Ranges. Appended to.
+				//! \param func Function returning ChunkRange with the archetype and chunk of a slot as func(slotIdx)
+				template <typename Func>
+				void flush(cnt::darray<ChunkRange>& out, Func func) {
+					for (auto slotIdx: m_used) {
+						auto& rows = m_rows[slotIdx];
+						rows.used = false;
+
+						auto range = func(slotIdx);
+						const auto firstRange = (uint32_t)out.size();
+						GAIA_EACH_(rows.words, ww) {
+							auto words = rows.words[ww];
+							rows.words[ww] = 0;
+							while (words != 0) {
+								const auto w = ww * 64 + GAIA_FFS64(words) - 1;
+								words &= words - 1;
+
+								auto bits = rows.bits[w];
+								rows.bits[w] = 0;
+								while (bits != 0) {
+									const auto row = (uint16_t)(w * 64 + GAIA_FFS64(bits) - 1);
+									bits &= bits - 1;
+									if (out.size() > firstRange && out.back().to == row) {
+										++out.back().to;
+										continue;
+									}
+									range.from = row;
+									range.to = (uint16_t)(row + 1);
+									out.push_back(range);
+								}
+							}
+						}
+					}
+					m_used.clear();
+				}
+			};
+		} // namespace detail
+	} // namespace ecs
+} // namespace gaia
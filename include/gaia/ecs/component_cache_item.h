@@ -12,6 +12,7 @@
 #include "gaia/ecs/component_desc.h"
 #include "gaia/ecs/id.h"
 #include "gaia/mem/mem_alloc.h"
+#include "gaia/mem/mem_bulk.h"
 #include "gaia/mem/mem_utils.h"
 #include "gaia/mem/smallblock_allocator.h"
 #include "gaia/ser/ser_common.h"
@@ -26,6 +27,11 @@ namespace gaia {
 		class ComponentCache;
 		struct ComponentRecord;
 
+		//! Minimum alignment of AoS component columns inside chunks in bytes.
+		//! Together with the cache-line aligned chunk data area it lets lane blocks of arithmetic columns use aligned
+		//! vector loads of any native width. SoA columns keep the alignment of their layout.
+		static constexpr uint32_t ChunkColumnAlignment = 64;
+
 		//! Intern table for immutable component-cache symbols.
 		class SymbolTable final {
 			using Key = core::StringLookupKey<256>;
@@ -166,6 +172,8 @@ namespace gaia {
 			FuncSave* func_save{};
 			//! Serialization callback for loading component values.
 			FuncLoad* func_load{};
+			//! True if values can be copied byte by byte. Enables the bulk paths of copy_fill.
+			bool trivialCopy = false;
 			//! Runtime reflection type kind.
 			RuntimeTypeKind typeKind = RuntimeTypeKind::Struct;
 			//! Optional named entity identifying the authored semantic.
@@ -378,6 +386,84 @@ namespace gaia {
 				memcpy((void*)pD, (const void*)pS, comp.size());
 			}
 
+			//! Copies one existing component value into \a cnt consecutive values starting at \a idxDst.
+			//! Trivially copyable components are replicated with bulk stores, one fill per column or SoA field.
+			//! Other components are copied value by value.
+			//! \param pDst Destination component storage base pointer.
+			//! \param pSrc Source component storage base pointer.
+			//! \param idxDst First destination value index.
+			//! \param idxSrc Source value index.
+			//! \param cnt Number of destination values.
+			//! \param sizeDst Destination storage capacity.
+			//! \param sizeSrc Source storage capacity.
+			//! \param stream If true, bulk stores bypass the cache. Meant for batches too big to be read back soon.
+			void copy_fill(
+					void* pDst, const void* pSrc, uint32_t idxDst, uint32_t idxSrc, uint32_t cnt, uint32_t sizeDst,
+					uint32_t sizeSrc, bool stream) const {
+				GAIA_ASSERT(pSrc != nullptr && pDst != nullptr);
+				GAIA_ASSERT(pSrc != pDst || idxSrc < idxDst || idxSrc >= idxDst + cnt);
+				if (!trivialCopy) {
+					GAIA_FOR(cnt) copy(pDst, pSrc, idxDst + i, idxSrc, sizeDst, sizeSrc);
+					return;
+				}
+
+				if (comp.soa() != 0) {
+					const auto capDst = soa_capacity(sizeDst);
+					const auto capSrc = soa_capacity(sizeSrc);
+					const std::span<const uint8_t> fieldSizes{soaSizes, comp.soa()};
+					GAIA_FOR(comp.soa()) {
+						auto* pD = mem::data_view_policy_soa_erased::set(pDst, comp.alig(), fieldSizes, i, idxDst, capDst);
+						const auto* pS = mem::data_view_policy_soa_erased::get(pSrc, comp.alig(), fieldSizes, i, idxSrc, capSrc);
+						mem::fill_pattern(pD, pS, soaSizes[i], cnt, stream);
+					}
+					return;
+				}
+				if (comp.size() == 0)
+					return;
+
+				auto* pD = (uint8_t*)pDst + ((uintptr_t)comp.size() * idxDst);
+				const auto* pS = (const uint8_t*)pSrc + ((uintptr_t)comp.size() * idxSrc);
+				mem::fill_pattern(pD, pS, comp.size(), cnt, stream);
+			}
+
+			//! Calls \a func for each contiguous block of bytes holding \a cnt consecutive values starting at the beginning
+			//! of the storage. AoS components are stored in a single block, SoA components in one block per field.
+			//! \param pData Component storage base pointer.
+			//! \param cnt Number of values.
+			//! \param capacity Storage capacity.
+			//! \param func Function called as func(const uint8_t* pBlock, uint32_t bytes).
+			template <typename Func>
+			void each_block(const void* pData, uint32_t cnt, uint32_t capacity, Func func) const {
+				if (comp.soa() != 0) {
+					const auto cap = soa_capacity(capacity);
+					const std::span<const uint8_t> fieldSizes{soaSizes, comp.soa()};
+					GAIA_FOR(comp.soa()) {
+						const auto* p = mem::data_view_policy_soa_erased::get(pData, comp.alig(), fieldSizes, i, 0, cap);
+						func((const uint8_t*)p, (uint32_t)soaSizes[i] * cnt);
+					}
+					return;
+				}
+
+				func((const uint8_t*)pData, comp.size() * cnt);
+			}
+
+			//! Hashes the bytes of \a cnt consecutive values starting at the beginning of the storage.
+			//! SoA components are hashed field array by field array.
+			//! \warning Only meaningful for trivially copyable components. Padding bytes are hashed as well.
+			//! \param pData Component storage base pointer.
+			//! \param cnt Number of values to hash.
+			//! \param capacity Storage capacity.
+			//! \param seed Seed of the hash.
+			//! \return 64-bit hash of the values.
+			GAIA_NODISCARD uint64_t hash_data(const void* pData, uint32_t cnt, uint32_t capacity, uint64_t seed) const {
+				GAIA_ASSERT(trivialCopy);
+
+				each_block(pData, cnt, capacity, [&seed](const uint8_t* p, uint32_t bytes) {
+					seed = core::hash_data64(p, bytes, seed);
+				});
+				return seed;
+			}
+
 			//! Moves one existing component value into another value.
 			//! \param pDst Destination component storage base pointer.
 			//! \param pSrc Source component storage base pointer.
@@ -667,13 +753,20 @@ namespace gaia {
 
 #endif
 
+			//! Returns the alignment of the first value of this component's chunk column in bytes.
+			GAIA_NODISCARD uint32_t column_alig() const noexcept {
+				if (comp.soa() != 0 || comp.size() == 0)
+					return comp.alig();
+				return core::get_max((uint32_t)comp.alig(), ChunkColumnAlignment);
+			}
+
 			//! Calculates the next aligned memory offset after storing \a cnt values of this component.
 			//! \param addr Starting byte offset.
 			//! \param cnt Number of component values to reserve.
 			//! \return Byte offset after the component storage block.
 			GAIA_NODISCARD uint32_t calc_new_mem_offset(uint32_t addr, size_t cnt) const noexcept {
 				if (comp.soa() == 0) {
-					addr = (uint32_t)mem::detail::get_aligned_byte_offset(addr, comp.alig(), comp.size(), cnt);
+					addr = (uint32_t)mem::detail::get_aligned_byte_offset(addr, column_alig(), comp.size(), cnt);
 				} else {
 					GAIA_FOR(comp.soa()) {
 						addr = (uint32_t)mem::detail::get_aligned_byte_offset(addr, comp.alig(), soaSizes[i], cnt);
@@ -929,6 +1022,7 @@ namespace gaia {
 				cci->func_cmp = desc.funcCmp;
 				cci->func_save = desc.funcSave;
 				cci->func_load = desc.funcLoad;
+				cci->trivialCopy = desc.trivialCopy || (desc.funcCopy == nullptr && desc.funcCopyCtor == nullptr);
 
 				const auto& runtimeType = desc.runtimeType;
 				cci->typeKind = runtimeType.typeKind;
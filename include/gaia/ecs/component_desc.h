@@ -316,6 +316,9 @@ namespace gaia {
 			FuncSave* funcSave = nullptr;
 			//! Optional typed serialization load callback. Semantic runtime JSON uses field metadata instead.
 			FuncLoad* funcLoad = nullptr;
+			//! True if payload values can be copied byte by byte, i.e. the type is trivially copyable.
+			//! Components without copy callbacks are always copied byte by byte.
+			bool trivialCopy = false;
 		};
 
 		namespace detail {
@@ -632,6 +635,7 @@ namespace gaia {
 					desc.funcCmp = func_cmp();
 					desc.funcSave = func_save();
 					desc.funcLoad = func_load();
+					desc.trivialCopy = std::is_trivially_copyable_v<U>;
 					return desc;
 				}
 			};
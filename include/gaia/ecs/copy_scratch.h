@@ -49,6 +49,22 @@ namespace gaia {
 				//! Archetype component or pair ids reported to add hooks and observers.
 				cnt::darray_ext<Entity, 16> addHookIds;
 			};
+
+			//! Destination rows reserved in one chunk for instances of one prefab plan node.
+			struct PrefabInstantiateBatch {
+				//! Index of the plan node the rows belong to.
+				uint32_t nodeIdx = 0;
+				//! Chunk holding the prefab the rows are copied from.
+				Chunk* pSrcChunk = nullptr;
+				//! Row of the prefab in \a pSrcChunk.
+				uint16_t srcRow = 0;
+				//! First reserved row in \a pDstChunk.
+				uint16_t startRow = 0;
+				//! Destination chunk.
+				Chunk* pDstChunk = nullptr;
+				//! Number of reserved rows.
+				uint32_t count = 0;
+			};
 		} // namespace detail
 	} // namespace ecs
 } // namespace gaia
@@ -0,0 +1,89 @@
+#pragma once
+#include "gaia/config/config.h"
+
+#include <cstdint>
+
+#include "gaia/cnt/darray.h"
+#include "gaia/config/profiler.h"
+#include "gaia/core/utility.h"
+#include "gaia/mt/spinlock.h"
+
+namespace gaia {
+	namespace ecs {
+		//! Collects partial results produced by query callbacks and combines them in a fixed order.
+		//! Each partial result is tagged with the index of the chunk batch it was produced for. Batches are
+		//! enumerated in the same order no matter how many threads process them, so folding partial results in batch
+		//! order gives bit-identical results for floating-point reductions with any number of threads.
+		//! Partial results are added via Iter::reduce. Adding is thread-safe.
+		//! \tparam T Type of partial results
+		template <typename T>
+		class OrderedReduce final {
+			struct Item {
+				//! Index of the chunk batch the value was produced for
+				uint32_t batchIdx;
+				//! Position at which the value was added. Keeps values of the same batch in the order they were added.
+				uint32_t seq;
+				//! Partial result
+				T value;
+			};
+
+			cnt::darray<Item> m_items;
+			GAIA_PROF_MUTEX(mt::SpinLock, m_mtx);
+
+		public:
+			OrderedReduce() = default;
+			~OrderedReduce() = default;
+			OrderedReduce(const OrderedReduce&) = delete;
+			OrderedReduce& operator=(const OrderedReduce&) = delete;
+			OrderedReduce(OrderedReduce&&) = delete;
+			OrderedReduce& operator=(OrderedReduce&&) = delete;
+
+			//! Adds the partial result \a value produced for chunk batch \a batchIdx.
+			//! \param batchIdx Index of the chunk batch
+			//! \param value Partial result
+			void add(uint32_t batchIdx, T value) {
+				auto& mtx = GAIA_PROF_EXTRACT_MUTEX(m_mtx);
+				core::lock_scope lock(mtx);
+				GAIA_PROF_LOCK_MARK(m_mtx);
+
+				m_items.push_back({batchIdx, (uint32_t)m_items.size(), GAIA_MOV(value)});
+			}
+
+			//! Returns the number of partial results collected so far.
+			GAIA_NODISCARD uint32_t size() const {
+				return (uint32_t)m_items.size();
+			}
+
+			//! Checks if no partial results have been collected.
+			GAIA_NODISCARD bool empty() const {
+				return m_items.empty();
+			}
+
+			//! Removes all partial results.
+			void clear() {
+				m_items.clear();
+			}
+
+			//! Combines all partial results in batch order.
+			//! \warning Must not be called while partial results are still being added.
+			//! \tparam Func Functor with the signature T(T, const T&)
+			//! \param init Initial value
+			//! \param func Combining function
+			//! \return \a init combined with all partial results
+			template <typename Func>
+			GAIA_NODISCARD T fold(T init, Func func) {
+				GAIA_PROF_SCOPE(OrderedReduce::fold);
+
+				core::sort(m_items, [](const Item& a, const Item& b) {
+					return a.batchIdx != b.batchIdx ? a.batchIdx < b.batchIdx : a.seq < b.seq;
+				});
+				// Keep the order stable for values added later
+				GAIA_EACH(m_items) m_items[i].seq = i;
+
+				for (const auto& item: m_items)
+					init = func(GAIA_MOV(init), item.value);
+				return init;
+			}
+		};
+	} // namespace ecs
+} // namespace gaia
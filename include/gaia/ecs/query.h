@@ -960,8 +960,8 @@ namespace gaia {
 
 					if (!uses_query_cache_storage()) {
 						queryInfo.ensure_matches_transient(
-								*m_entityToArchetypeMap, all_archetypes_view(), *m_entityToArchetypeMapVersions, m_varBindings,
-								m_varBindingsMask);
+								*m_entityToArchetypeMap, all_archetypes_view(), *m_entityToArchetypeMapVersions, last_archetype_id(),
+								m_varBindings, m_varBindingsMask);
 						return;
 					}
 
@@ -2215,9 +2215,13 @@ namespace gaia {
 				//! \param pWorld World owning the chunk batches.
 				//! \param func Callback invoked once per initialized chunk iterator.
 				//! \param batches Prepared chunk batches to iterate.
+				//! \param firstBatchIdx Index of the first batch within the parallel run. 0 for sequential iteration.
+				//! \param pCmdBufferMT Command buffer of the logical partition in deterministic mode. Null otherwise.
 				//! \see run_query_func(World*, Func, ChunkBatch&)
 				template <typename Func, typename TMode>
-				static void run_query_func(World* pWorld, Func func, std::span<ChunkBatch> batches) {
+				static void run_query_func(
+						World* pWorld, Func func, std::span<ChunkBatch> batches, uint32_t firstBatchIdx = 0,
+						CommandBufferMT* pCmdBufferMT = nullptr) {
 					GAIA_PROF_SCOPE(query::run_query_func);
 
 					const auto chunkCnt = batches.size();
@@ -2225,13 +2229,16 @@ namespace gaia {
 
 					Iter it;
 					it.init_query_state(pWorld, iter_mode_constraints<TMode>(), false);
+					it.set_cmd_buffer_mt(pCmdBufferMT);
 
 					const Archetype* pLastArchetype = nullptr;
 					const uint8_t* pLastIndices = nullptr;
 					InheritedTermDataView lastInheritedData{};
 					GroupId lastGroupId = GroupIdMax;
 
-					const auto apply_batch = [&](const ChunkBatch& batch) {
+					const auto apply_batch = [&](uint32_t batchIdx) {
+						const auto& batch = batches[batchIdx];
+						it.set_batch_idx(firstBatchIdx + batchIdx);
 						if (batch.pArchetype != pLastArchetype) {
 							it.set_archetype(batch.pArchetype);
 							pLastArchetype = batch.pArchetype;
@@ -2260,7 +2267,7 @@ namespace gaia {
 
 					// We only have one chunk to process.
 					if GAIA_UNLIKELY (chunkCnt == 1) {
-						apply_batch(batches[0]);
+						apply_batch(0);
 						return;
 					}
 
@@ -2273,15 +2280,55 @@ namespace gaia {
 					// Let us be conservative for now and go with T2. That means we will try to keep our data at
 					// least in L3 cache or higher.
 					gaia::prefetch(batches[1].pChunk, PrefetchHint::PREFETCH_HINT_T2);
-					apply_batch(batches[0]);
+					apply_batch(0);
 
 					uint32_t chunkIdx = 1;
 					for (; chunkIdx < chunkCnt - 1; ++chunkIdx) {
 						gaia::prefetch(batches[chunkIdx + 1].pChunk, PrefetchHint::PREFETCH_HINT_T2);
-						apply_batch(batches[chunkIdx]);
+						apply_batch(chunkIdx);
 					}
 
-					apply_batch(batches[chunkIdx]);
+					apply_batch(chunkIdx);
+				}
+
+				//! Returns the group size for parallel processing of \a batchCnt chunk batches.
+				//! In deterministic mode, batches are split into the world's logical partitions so the split does not
+				//! depend on the number of threads. Otherwise, the scheduler is free to decide.
+				//! \param world World the batches belong to
+				//! \param batchCnt Number of chunk batches
+				//! \return Number of batches per logical partition. 0 if the scheduler decides.
+				GAIA_NODISCARD static uint32_t par_group_size(const World& world, uint32_t batchCnt) {
+					const auto partitions = world_det_partitions(world);
+					if (partitions == 0)
+						return 0;
+
+					return (batchCnt + partitions - 1) / partitions;
+				}
+
+				//! Runs \a func for the range of chunk batches [idxStart, idxEnd).
+				//! With a non-zero \a groupSize the range is split at logical partition boundaries and each part
+				//! records its commands to the command buffer of its partition.
+				//! \tparam Func Functor with the signature void(uint32_t idxStart, uint32_t idxEnd, CommandBufferMT*)
+				//! \param pWorld World the batches belong to
+				//! \param groupSize Number of batches per logical partition. 0 if not deterministic.
+				//! \param idxStart First batch index
+				//! \param idxEnd Batch index one past the last batch
+				//! \param func Function processing the batches
+				template <typename Func>
+				static void run_par_batches(World* pWorld, uint32_t groupSize, uint32_t idxStart, uint32_t idxEnd, Func func) {
+					if (groupSize == 0) {
+						func(idxStart, idxEnd, nullptr);
+						return;
+					}
+
+					// Schedulers following SchedParDesc::groupSize hand over exactly one partition at a time.
+					// Be robust against those that do not.
+					while (idxStart < idxEnd) {
+						const auto partition = idxStart / groupSize;
+						const auto partitionEnd = core::get_min((partition + 1) * groupSize, idxEnd);
+						func(idxStart, partitionEnd, &cmd_buffer_mt_get(*pWorld, partition));
+						idxStart = partitionEnd;
+					}
 				}
 
 				//------------------------------------------------
@@ -2293,6 +2340,7 @@ namespace gaia {
 					World* pWorld = nullptr;
 					cnt::darray<ChunkBatch> batches;
 					Func func;
+					uint32_t groupSize = 0;
 
 					GAIA_USE_SMALLBLOCK(QueryJobCtx)
 				};
@@ -2385,16 +2433,22 @@ namespace gaia {
 					auto* pCtx = new QueryJobCtx<Func, TMode>{this, pWorld, {}, GAIA_MOV(func)};
 					pCtx->batches.resize(m_batches.size());
 					GAIA_EACH(m_batches) pCtx->batches[i] = m_batches[i];
+					pCtx->groupSize = par_group_size(*pWorld, (uint32_t)m_batches.size());
 					m_batches.clear();
 
 					SchedParDesc desc{};
 					desc.pCtx = pCtx;
 					desc.itemCount = (uint32_t)pCtx->batches.size();
-					desc.groupSize = 0;
+					desc.groupSize = pCtx->groupSize;
 					desc.execType = ExecType;
 					desc.invoke = [](void* pInvokeCtx, uint32_t idxStart, uint32_t idxEnd) {
 						auto& ctx = *reinterpret_cast<QueryJobCtx<Func, TMode>*>(pInvokeCtx);
-						run_query_func<Func, TMode>(ctx.pWorld, ctx.func, std::span(&ctx.batches[idxStart], idxEnd - idxStart));
+						run_par_batches(
+								ctx.pWorld, ctx.groupSize, idxStart, idxEnd,
+								[&ctx](uint32_t from, uint32_t to, CommandBufferMT* pCmdBuffer) {
+									run_query_func<Func, TMode>(
+											ctx.pWorld, ctx.func, std::span(&ctx.batches[from], to - from), from, pCmdBuffer);
+								});
 					};
 
 					return sched_add_par(world_sched(*pWorld), desc, pCtx, &cleanup_query_job<Func, TMode>);
@@ -2712,18 +2766,23 @@ namespace gaia {
 					struct ParallelQueryBatchCtx {
 						QueryImpl* pSelf;
 						Func* pFunc;
+						uint32_t groupSize;
 					};
-					ParallelQueryBatchCtx ctx{this, &func};
+					ParallelQueryBatchCtx ctx{
+							this, &func, par_group_size(*m_storage.world(), (uint32_t)m_batches.size())};
 					SchedParDesc desc{};
 					desc.pCtx = &ctx;
 					desc.itemCount = (uint32_t)m_batches.size();
-					desc.groupSize = 0;
+					desc.groupSize = ctx.groupSize;
 					desc.execType = ExecType;
 					desc.invoke = [](void* pCtx, uint32_t idxStart, uint32_t idxEnd) {
 						auto& ctx = *reinterpret_cast<ParallelQueryBatchCtx*>(pCtx);
-						run_query_func<Func, TMode>(
-								ctx.pSelf->m_storage.world(), *ctx.pFunc,
-								std::span(&ctx.pSelf->m_batches[idxStart], idxEnd - idxStart));
+						auto* pWorld = ctx.pSelf->m_storage.world();
+						run_par_batches(
+								pWorld, ctx.groupSize, idxStart, idxEnd, [&](uint32_t from, uint32_t to, CommandBufferMT* pCmdBuffer) {
+									run_query_func<Func, TMode>(
+											pWorld, *ctx.pFunc, std::span(&ctx.pSelf->m_batches[from], to - from), from, pCmdBuffer);
+								});
 					};
 
 					const auto& sched = world_sched(*m_storage.world());
@@ -2888,18 +2947,23 @@ namespace gaia {
 					struct ParallelQueryBatchCtx {
 						QueryImpl* pSelf;
 						Func* pFunc;
+						uint32_t groupSize;
 					};
-					ParallelQueryBatchCtx ctx{this, &func};
+					ParallelQueryBatchCtx ctx{
+							this, &func, par_group_size(*m_storage.world(), (uint32_t)m_batches.size())};
 					SchedParDesc desc{};
 					desc.pCtx = &ctx;
 					desc.itemCount = (uint32_t)m_batches.size();
-					desc.groupSize = 0;
+					desc.groupSize = ctx.groupSize;
 					desc.execType = ExecType;
 					desc.invoke = [](void* pCtx, uint32_t idxStart, uint32_t idxEnd) {
 						auto& ctx = *reinterpret_cast<ParallelQueryBatchCtx*>(pCtx);
-						run_query_func<Func, TMode>(
-								ctx.pSelf->m_storage.world(), *ctx.pFunc,
-								std::span(&ctx.pSelf->m_batches[idxStart], idxEnd - idxStart));
+						auto* pWorld = ctx.pSelf->m_storage.world();
+						run_par_batches(
+								pWorld, ctx.groupSize, idxStart, idxEnd, [&](uint32_t from, uint32_t to, CommandBufferMT* pCmdBuffer) {
+									run_query_func<Func, TMode>(
+											pWorld, *ctx.pFunc, std::span(&ctx.pSelf->m_batches[from], to - from), from, pCmdBuffer);
+								});
 					};
 
 					const auto& sched = world_sched(*m_storage.world());
@@ -3012,8 +3076,9 @@ namespace gaia {
 				}
 
 				template <typename Func>
-				static void
-				run_query_func_runtime(World* pWorld, Func func, std::span<ChunkBatch> batches, Constraints constraints) {
+				static void run_query_func_runtime(
+						World* pWorld, Func func, std::span<ChunkBatch> batches, Constraints constraints,
+						uint32_t firstBatchIdx = 0, CommandBufferMT* pCmdBufferMT = nullptr) {
 					GAIA_PROF_SCOPE(query::run_query_func);
 
 					const auto chunkCnt = batches.size();
@@ -3021,13 +3086,16 @@ namespace gaia {
 
 					Iter it;
 					it.init_query_state(pWorld, constraints, false);
+					it.set_cmd_buffer_mt(pCmdBufferMT);
 
 					const Archetype* pLastArchetype = nullptr;
 					const uint8_t* pLastIndices = nullptr;
 					InheritedTermDataView lastInheritedData{};
 					GroupId lastGroupId = GroupIdMax;
 
-					const auto apply_batch = [&](const ChunkBatch& batch) {
+					const auto apply_batch = [&](uint32_t batchIdx) {
+						const auto& batch = batches[batchIdx];
+						it.set_batch_idx(firstBatchIdx + batchIdx);
 						if (batch.pArchetype != pLastArchetype) {
 							it.set_archetype(batch.pArchetype);
 							pLastArchetype = batch.pArchetype;
@@ -3055,20 +3123,20 @@ namespace gaia {
 					};
 
 					if GAIA_UNLIKELY (chunkCnt == 1) {
-						apply_batch(batches[0]);
+						apply_batch(0);
 						return;
 					}
 
 					gaia::prefetch(batches[1].pChunk, PrefetchHint::PREFETCH_HINT_T2);
-					apply_batch(batches[0]);
+					apply_batch(0);
 
 					uint32_t chunkIdx = 1;
 					for (; chunkIdx < chunkCnt - 1; ++chunkIdx) {
 						gaia::prefetch(batches[chunkIdx + 1].pChunk, PrefetchHint::PREFETCH_HINT_T2);
-						apply_batch(batches[chunkIdx]);
+						apply_batch(chunkIdx);
 					}
 
-					apply_batch(batches[chunkIdx]);
+					apply_batch(chunkIdx);
 				}
 
 				template <bool HasFilters, typename Func>
@@ -3261,18 +3329,24 @@ namespace gaia {
 						QueryImpl* pSelf;
 						Func* pFunc;
 						Constraints constraints;
+						uint32_t groupSize;
 					};
-					ParallelQueryBatchCtx ctx{this, &func, constraints};
+					ParallelQueryBatchCtx ctx{
+							this, &func, constraints, par_group_size(*m_storage.world(), (uint32_t)m_batches.size())};
 					SchedParDesc desc{};
 					desc.pCtx = &ctx;
 					desc.itemCount = (uint32_t)m_batches.size();
-					desc.groupSize = 0;
+					desc.groupSize = ctx.groupSize;
 					desc.execType = ExecType;
 					desc.invoke = [](void* pCtx, uint32_t idxStart, uint32_t idxEnd) {
 						auto& ctx = *reinterpret_cast<ParallelQueryBatchCtx*>(pCtx);
-						run_query_func_runtime(
-								ctx.pSelf->m_storage.world(), *ctx.pFunc, std::span(&ctx.pSelf->m_batches[idxStart], idxEnd - idxStart),
-								ctx.constraints);
+						auto* pWorld = ctx.pSelf->m_storage.world();
+						run_par_batches(
+								pWorld, ctx.groupSize, idxStart, idxEnd, [&](uint32_t from, uint32_t to, CommandBufferMT* pCmdBuffer) {
+									run_query_func_runtime(
+											pWorld, *ctx.pFunc, std::span(&ctx.pSelf->m_batches[from], to - from), ctx.constraints, from,
+											pCmdBuffer);
+								});
 					};
 
 					const auto& sched = world_sched(*m_storage.world());
@@ -3402,18 +3476,24 @@ namespace gaia {
 						QueryImpl* pSelf;
 						Func* pFunc;
 						Constraints constraints;
+						uint32_t groupSize;
 					};
-					ParallelQueryBatchCtx ctx{this, &func, constraints};
+					ParallelQueryBatchCtx ctx{
+							this, &func, constraints, par_group_size(*m_storage.world(), (uint32_t)m_batches.size())};
 					SchedParDesc desc{};
 					desc.pCtx = &ctx;
 					desc.itemCount = (uint32_t)m_batches.size();
-					desc.groupSize = 0;
+					desc.groupSize = ctx.groupSize;
 					desc.execType = ExecType;
 					desc.invoke = [](void* pCtx, uint32_t idxStart, uint32_t idxEnd) {
 						auto& ctx = *reinterpret_cast<ParallelQueryBatchCtx*>(pCtx);
-						run_query_func_runtime(
-								ctx.pSelf->m_storage.world(), *ctx.pFunc, std::span(&ctx.pSelf->m_batches[idxStart], idxEnd - idxStart),
-								ctx.constraints);
+						auto* pWorld = ctx.pSelf->m_storage.world();
+						run_par_batches(
+								pWorld, ctx.groupSize, idxStart, idxEnd, [&](uint32_t from, uint32_t to, CommandBufferMT* pCmdBuffer) {
+									run_query_func_runtime(
+											pWorld, *ctx.pFunc, std::span(&ctx.pSelf->m_batches[from], to - from), ctx.constraints, from,
+											pCmdBuffer);
+								});
 					};
 
 					const auto& sched = world_sched(*m_storage.world());
@@ -4930,52 +5010,58 @@ namespace gaia {
 					GAIA_ASSERT(ec.pChunk != nullptr);
 					GAIA_ASSERT(ec.row < ec.pChunk->size());
 
-					if (ec.pArchetype != pLastArchetype) {
-						GAIA_FOR(ChunkHeader::MAX_COMPONENTS) {
-							pIndices[i] = 0xFF;
-							pTermIds[i] = EntityBad;
-						}
+					init_direct_archetype_iter(queryInfo, world, ec.pArchetype, it, pIndices, pTermIds, pLastArchetype);
+					it.set_chunk(ec.pChunk, ec.row, (uint16_t)(ec.row + 1));
+					it.set_group_id(0);
+				}
 
-						const auto terms = queryInfo.ctx().data.terms_view();
-						const auto queryIdCnt = (uint32_t)terms.size();
-						auto indicesView = queryInfo.try_indices_mapping_view(ec.pArchetype);
-						GAIA_FOR(queryIdCnt) {
-							const auto& term = terms[i];
-							const auto fieldIdx = term.fieldIndex;
-							const auto queryId = term.id;
-							pTermIds[fieldIdx] = queryId;
-							if (!indicesView.empty()) {
-								pIndices[fieldIdx] = indicesView[fieldIdx];
-								continue;
-							}
-							if (!query_term_maps_to_current_archetype(term))
-								continue;
+				static void init_direct_archetype_iter(
+						const QueryInfo& queryInfo, const World& world, const Archetype* pArchetype, Iter& it, uint8_t* pIndices,
+						Entity* pTermIds, const Archetype*& pLastArchetype) {
+					if (pArchetype == pLastArchetype)
+						return;
+
+					GAIA_FOR(ChunkHeader::MAX_COMPONENTS) {
+						pIndices[i] = 0xFF;
+						pTermIds[i] = EntityBad;
+					}
 
-							if (!queryId.pair() && world_component_uses_sparse_storage(world, queryId)) {
+					const auto terms = queryInfo.ctx().data.terms_view();
+					const auto queryIdCnt = (uint32_t)terms.size();
+					auto indicesView = queryInfo.try_indices_mapping_view(pArchetype);
+					GAIA_FOR(queryIdCnt) {
+						const auto& term = terms[i];
+						const auto fieldIdx = term.fieldIndex;
+						const auto queryId = term.id;
+						pTermIds[fieldIdx] = queryId;
+						if (!indicesView.empty()) {
+							pIndices[fieldIdx] = indicesView[fieldIdx];
+							continue;
+						}
+						if (!query_term_maps_to_current_archetype(term))
+							continue;
+
+						if (!queryId.pair() && world_component_uses_sparse_storage(world, queryId)) {
 #if GAIA_ASSERT_ENABLED
-								const auto compIdx = core::get_index_unsafe(ec.pArchetype->ids_view(), queryId);
-								GAIA_ASSERT(compIdx != BadIndex);
+							const auto compIdx = core::get_index_unsafe(pArchetype->ids_view(), queryId);
+							GAIA_ASSERT(compIdx != BadIndex);
 #endif
-								pIndices[fieldIdx] = 0xFF;
-								continue;
-							}
-
-							auto compIdx = world_component_index_comp_idx(world, *ec.pArchetype, queryId);
-							if (compIdx == BadIndex)
-								compIdx = core::get_index(ec.pArchetype->ids_view(), queryId);
-							pIndices[fieldIdx] = (uint8_t)compIdx;
+							pIndices[fieldIdx] = 0xFF;
+							continue;
 						}
 
-						it.set_archetype(ec.pArchetype);
-						it.set_comp_indices(pIndices);
-						const auto inheritedDataView = queryInfo.inherited_data_view(ec.pArchetype);
-						it.set_inherited_data(inheritedDataView);
-						it.set_term_ids(pTermIds);
-						pLastArchetype = ec.pArchetype;
+						auto compIdx = world_component_index_comp_idx(world, *pArchetype, queryId);
+						if (compIdx == BadIndex)
+							compIdx = core::get_index(pArchetype->ids_view(), queryId);
+						pIndices[fieldIdx] = (uint8_t)compIdx;
 					}
 
-					it.set_chunk(ec.pChunk, ec.row, (uint16_t)(ec.row + 1));
-					it.set_group_id(0);
+					it.set_archetype(pArchetype);
+					it.set_comp_indices(pIndices);
+					const auto inheritedDataView = queryInfo.inherited_data_view(pArchetype);
+					it.set_inherited_data(inheritedDataView);
+					it.set_term_ids(pTermIds);
+					pLastArchetype = pArchetype;
 				}
 
 				static void init_direct_entity_iter(
@@ -5009,6 +5095,45 @@ namespace gaia {
 					}
 				}
 
+				template <typename Func>
+				void each_chunk_ranges_iter(QueryInfo& queryInfo, std::span<const ChunkRange> ranges, Func func) {
+					auto& world = *queryInfo.world();
+					const auto archetypes = queryInfo.cache_archetype_view();
+					Iter it;
+					it.init_query_state(&world, Constraints::EnabledOnly, false);
+					const Archetype* pLastArchetype = nullptr;
+					const Archetype* pLastTested = nullptr;
+					bool lastMatched = false;
+					uint8_t indices[ChunkHeader::MAX_COMPONENTS];
+					Entity termIds[ChunkHeader::MAX_COMPONENTS];
+
+					for (const auto& range: ranges) {
+						if (range.from >= range.to)
+							continue;
+
+						if (range.pArchetype != pLastTested) {
+							pLastTested = range.pArchetype;
+							lastMatched = false;
+							for (const auto* pArchetype: archetypes) {
+								if (pArchetype == pLastTested) {
+									lastMatched = true;
+									break;
+								}
+							}
+						}
+						if (!lastMatched)
+							continue;
+
+						init_direct_archetype_iter(queryInfo, world, range.pArchetype, it, indices, termIds, pLastArchetype);
+						it.set_chunk(range.pChunk, range.from, range.to);
+						it.set_group_id(0);
+						it.ctx(m_ctx);
+						func(it);
+						finish_iter_writes(it);
+						it.clear_touched_writes();
+					}
+				}
+
 				struct DirectChunkArgEvalDesc {
 					Entity id = EntityBad;
 					bool isEntity = false;
@@ -6123,6 +6248,20 @@ namespace gaia {
 					}
 				}
 
+				//! Iterates query matches restricted to the given chunk row ranges, e.g. ranges returned by
+				//! SpatialIndex::ranges. Ranges in chunks the query does not match are skipped.
+				//! Rows are not filtered any further. Change filters and grouping do not apply.
+				//! Ranges are valid only until the next structural change of the world.
+				//! \tparam Func Iterator callback type invocable with `Iter&`.
+				//! \param ranges Chunk row ranges to iterate
+				//! \param func Callable invoked for each range.
+				template <typename Func, std::enable_if_t<detail::is_query_iter_callback_v<Func>, int> = 0>
+				void each(std::span<const ChunkRange> ranges, Func func) {
+					auto& queryInfo = fetch();
+					match_all(queryInfo);
+					each_chunk_ranges_iter(queryInfo, ranges, func);
+				}
+
 				//! Iterates query matches with a typed component callback using the selected execution mode.
 				//! \tparam Func Typed callback whose arguments identify the requested query components.
 				//! \param func Callable invoked for each matching entity.
@@ -463,6 +463,75 @@ namespace gaia {
 				trackedIt->second.syncedRevision = queryInfo.result_cache_rev();
 			}
 
+			//! Number of groups the VM passes of build_all() are split into at most.
+			//! Each group matches its queries one after another reusing a single scratch.
+			static constexpr uint32_t BuildGroupCnt = 32;
+
+			//! Matches all cached queries which were not matched against the current set of archetypes yet.
+			//! Queries satisfying QueryInfo::can_match_concurrently() are split into groups run by \a par. Each of them
+			//! only touches its own cache state there. The shared archetype->query index is updated on the calling
+			//! thread afterwards in the order the queries are stored so the outcome does not depend on how the groups
+			//! were scheduled. The remaining queries are matched one by one at the end. Queries depending on runtime
+			//! inputs are left for their first use.
+			//! \tparam ParFunc Functor with the signature void(uint32_t groupCnt, Func func) that runs func(groupIdx)
+			//!                 for each group in [0, groupCnt), possibly in parallel, and waits for all of them.
+			//! \param entityToArchetypeMap Lookup of archetypes by entity
+			//! \param entityToArchetypeMapVersions Version map for archetype lookup validation
+			//! \param allArchetypes List of all archetypes
+			//! \param archetypeLastId Last recorded archetype id
+			//! \param par Function running the groups
+			//! \warning The world must not change until the function returns.
+			template <typename ParFunc>
+			void build_all(
+					const EntityToArchetypeMap& entityToArchetypeMap,
+					const EntityToArchetypeVersionMap& entityToArchetypeMapVersions, std::span<const Archetype*> allArchetypes,
+					ArchetypeId archetypeLastId, ParFunc par) {
+				GAIA_PROF_SCOPE(QueryCache::build_all);
+
+				cnt::darray<QueryInfo*> pending;
+				cnt::darray<QueryInfo*> serial;
+				for (auto& info: m_queryArr) {
+					if (info.refs() == 0)
+						continue;
+
+					if (!info.can_match_concurrently()) {
+						if (info.ctx().data.cachePolicy != QueryCtx::CachePolicy::Dynamic)
+							serial.push_back(&info);
+						continue;
+					}
+
+					if (info.match_begin(archetypeLastId))
+						pending.push_back(&info);
+				}
+
+				if (!pending.empty()) {
+					const auto queryCnt = (uint32_t)pending.size();
+					const auto groupSize = (queryCnt + BuildGroupCnt - 1) / BuildGroupCnt;
+					const auto groupCnt = (queryCnt + groupSize - 1) / groupSize;
+
+					cnt::darray<QueryMatchScratch> scratch(groupCnt);
+					par(groupCnt, [&](uint32_t groupIdx) {
+						auto& matchScratch = scratch[groupIdx];
+						const auto idxFrom = groupIdx * groupSize;
+						const auto idxTo = core::get_min(idxFrom + groupSize, queryCnt);
+						for (uint32_t i = idxFrom; i < idxTo; ++i)
+							pending[i]->match_exec(entityToArchetypeMap, allArchetypes, entityToArchetypeMapVersions, matchScratch);
+					});
+
+					for (auto* pInfo: pending) {
+						pInfo->match_end();
+						sync_archetype_cache(*pInfo);
+					}
+				}
+
+				const cnt::sarray<Entity, MaxVarCnt> noVarBindings{};
+				for (auto* pInfo: serial) {
+					pInfo->ensure_matches(
+							entityToArchetypeMap, allArchetypes, entityToArchetypeMapVersions, archetypeLastId, noVarBindings, 0);
+					sync_archetype_cache(*pInfo);
+				}
+			}
+
 			void remove_archetype_from_queries(Archetype* pArchetype) {
 				const auto archetypeKey = ArchetypeIdLookupKey(pArchetype->id(), pArchetype->id_hash());
 				auto it = m_archetypeToQuery.find(archetypeKey);
@@ -48,6 +48,7 @@ namespace gaia {
 		GAIA_NODISCARD const Archetype* world_entity_archetype(const World& world, Entity entity);
 		void world_finish_write(World& world, Entity term, Entity entity);
 		GAIA_NODISCARD uint32_t world_component_index_bucket_size(const World& world, Entity term);
+		GAIA_NODISCARD uint32_t world_component_index_match_total(const World& world, Entity term);
 		GAIA_NODISCARD uint32_t world_component_index_comp_idx(const World& world, const Archetype& archetype, Entity term);
 		GAIA_NODISCARD uint32_t
 		world_component_index_match_count(const World& world, const Archetype& archetype, Entity term);
@@ -11,6 +11,9 @@ namespace gaia {
 		class Archetype;
 		struct Entity;
 
+		template <typename... Terms>
+		class QueryKernel;
+
 		//! Stable numeric identifier assigned to a cached query.
 		using QueryId = uint32_t;
 		//! Numeric key returned by query grouping callbacks.
@@ -195,6 +195,8 @@ namespace gaia {
 			struct QueryPlan {
 				QueryCtx ctx;
 				vm::VirtualMachine vm;
+				//! Last archetype id the variable search order was checked against live statistics
+				ArchetypeId statsArchetypeId = 0;
 			};
 
 			struct QueryState {
@@ -653,6 +655,22 @@ namespace gaia {
 
 			enum QueryCmdType : uint8_t { ALL, OR, NOT };
 
+			//! Re-orders the variable search program when the statistics it was ordered by went stale.
+			//! Statistics are only re-checked after a batch of new archetypes because the check walks the component
+			//! index buckets of every variable term.
+			//! \param archetypeLastId Last archetype id known to the world.
+			void replan_if_stale(ArchetypeId archetypeLastId) {
+				constexpr ArchetypeId StatsCheckStep = 8;
+				const auto lastId = m_plan.statsArchetypeId;
+				if (archetypeLastId < lastId + core::get_max(StatsCheckStep, lastId / 8))
+					return;
+
+				m_plan.statsArchetypeId = archetypeLastId;
+				auto& w = *world();
+				if (m_plan.vm.stats_drifted(w))
+					m_plan.vm.build_var_search_program(w);
+			}
+
 			//! Clears all cached match state and resets incremental lookup cursors.
 			//! \param trackMembershipChange True to bump the result membership revision when non-empty results are discarded.
 			void reset_matching_cache(bool trackMembershipChange) {
@@ -1194,6 +1212,43 @@ namespace gaia {
 				}
 			};
 
+			//! Prepares the VM context of a full match pass.
+			//! \param[out] ctx Context to initialize
+			//! \param entityToArchetypeMap Lookup of archetypes by entity
+			//! \param allArchetypes List of all archetypes
+			//! \param pEntityToArchetypeMapVersions Optional version map for archetype lookup validation
+			//! \param matchScratch Scratch providing the dedup stamps
+			//! \param matches Array receiving the matched archetypes
+			template <typename ArchetypeLookup>
+			void init_match_ctx(
+					vm::MatchingCtx& ctx, const ArchetypeLookup& entityToArchetypeMap, std::span<const Archetype*> allArchetypes,
+					const EntityToArchetypeVersionMap* pEntityToArchetypeMapVersions, QueryMatchScratch& matchScratch,
+					cnt::darr<const Archetype*>& matches) {
+				auto& ctxData = m_plan.ctx.data;
+
+				ctx.pWorld = world();
+				// ctx.targetEntities = {};
+				ctx.allArchetypes = allArchetypes;
+				if constexpr (std::is_same_v<ArchetypeLookup, EntityToArchetypeMap>) {
+					GAIA_ASSERT(pEntityToArchetypeMapVersions != nullptr);
+					ctx.archetypeLookup = vm::make_archetype_lookup_view(entityToArchetypeMap, *pEntityToArchetypeMapVersions);
+				} else {
+					(void)pEntityToArchetypeMapVersions;
+					ctx.archetypeLookup = vm::make_archetype_lookup_view(entityToArchetypeMap);
+				}
+
+				ctx.pMatchesArr = &matches;
+				ctx.pMatchesStampByArchetypeId = &matchScratch.matchStamps;
+				ctx.matchesVersion = matchScratch.next_match_version();
+				ctx.pLastMatchedArchetypeIdx_All = &ctxData.lastMatchedArchetypeIdx_All;
+				ctx.pLastMatchedArchetypeIdx_Or = &ctxData.lastMatchedArchetypeIdx_Or;
+				ctx.pLastMatchedArchetypeIdx_Not = &ctxData.lastMatchedArchetypeIdx_Not;
+				ctx.queryMask = ctxData.queryMask;
+				ctx.as_mask_0 = ctxData.as_mask_0;
+				ctx.as_mask_1 = ctxData.as_mask_1;
+				ctx.flags = ctxData.flags;
+			}
+
 			//! Tries to match the query against archetypes in \a entityToArchetypeMap.
 			//! This is necessary so we do not iterate all chunks over and over again when running queries.
 			//! \param entityToArchetypeMap Lookup of archetypes by entity
@@ -1262,32 +1317,16 @@ namespace gaia {
 				GAIA_PROF_SCOPE(queryinfo::match);
 
 				auto& w = *world();
+				replan_if_stale(archetypeLastId);
+
 				auto& matchScratch = pMatchScratch != nullptr ? *pMatchScratch : query_match_scratch_acquire(w);
 				CleanUpTmpArchetypeMatches autoCleanup(w, true);
 
 				// Prepare the context
 				vm::MatchingCtx ctx{};
-				ctx.pWorld = &w;
-				// ctx.targetEntities = {};
-				ctx.allArchetypes = allArchetypes;
-				if constexpr (std::is_same_v<ArchetypeLookup, EntityToArchetypeMap>) {
-					GAIA_ASSERT(pEntityToArchetypeMapVersions != nullptr);
-					ctx.archetypeLookup = vm::make_archetype_lookup_view(entityToArchetypeMap, *pEntityToArchetypeMapVersions);
-				} else {
-					(void)pEntityToArchetypeMapVersions;
-					ctx.archetypeLookup = vm::make_archetype_lookup_view(entityToArchetypeMap);
-				}
-
-				ctx.pMatchesArr = &matchScratch.matchesArr;
-				ctx.pMatchesStampByArchetypeId = &matchScratch.matchStamps;
-				ctx.matchesVersion = matchScratch.next_match_version();
-				ctx.pLastMatchedArchetypeIdx_All = &ctxData.lastMatchedArchetypeIdx_All;
-				ctx.pLastMatchedArchetypeIdx_Or = &ctxData.lastMatchedArchetypeIdx_Or;
-				ctx.pLastMatchedArchetypeIdx_Not = &ctxData.lastMatchedArchetypeIdx_Not;
-				ctx.queryMask = ctxData.queryMask;
-				ctx.as_mask_0 = ctxData.as_mask_0;
-				ctx.as_mask_1 = ctxData.as_mask_1;
-				ctx.flags = ctxData.flags;
+				init_match_ctx(
+						ctx, entityToArchetypeMap, allArchetypes, pEntityToArchetypeMapVersions, matchScratch,
+						matchScratch.matchesArr);
 				ctx.varBindings = runtimeVarBindings;
 				ctx.varBindingMask = runtimeVarBindingMask;
 
@@ -1321,6 +1360,107 @@ namespace gaia {
 				m_state.clear_dirty();
 			}
 
+			//! Returns true when the VM pass of the query reads nothing but the archetype lookup and archetype ids
+			//! so it can run on a worker thread next to the passes of other queries.
+			//! Queries evaluating Is relationships, sources, variables or per-entity filters read world caches
+			//! that are built lazily and have to be matched by match() on the main thread.
+			GAIA_NODISCARD bool can_match_concurrently() const {
+				const auto& ctxData = m_plan.ctx.data;
+				constexpr uint16_t UnsafeFlags = QueryCtx::QueryFlags::Complex | QueryCtx::QueryFlags::Recompile |
+																				 QueryCtx::QueryFlags::HasSourceTerms |
+																				 QueryCtx::QueryFlags::HasVariableTerms;
+				if ((ctxData.flags & UnsafeFlags) != 0 || has_dyn_terms())
+					return false;
+				if (ctxData.as_mask_0 != 0 || ctxData.as_mask_1 != 0)
+					return false;
+
+				const auto& deps = ctxData.deps;
+				return !deps.has_dep_flag(QueryCtx::DependencyHasTraversalTerms) &&
+							 !deps.has_dep_flag(QueryCtx::DependencyHasEntityFilterTerms) &&
+							 !deps.has_dep_flag(QueryCtx::DependencyHasInheritedDataTerms);
+			}
+
+			//! First step of a match() split into steps so VM passes of several queries can run in parallel.
+			//! Refreshes the cache state the same way match() does.
+			//! \param archetypeLastId Last recorded archetype id
+			//! \return True when the VM pass needs to run. False if the cached result is up to date.
+			//! \warning The query must satisfy can_match_concurrently().
+			GAIA_NODISCARD bool match_begin(ArchetypeId archetypeLastId) {
+				GAIA_ASSERT(can_match_concurrently());
+
+				if (!m_plan.vm.is_compiled())
+					return false;
+
+				if (m_state.seed_dirty()) {
+					reset_matching_cache(true);
+				} else if (m_state.result_dirty()) {
+					sync_result_cache_from_seed_cache();
+					if (m_state.lastArchetypeId == archetypeLastId) {
+						sort_entities();
+						sort_cache_groups();
+						m_state.clear_dirty();
+						return false;
+					}
+				}
+
+				GAIA_ASSERT(archetypeLastId >= m_state.lastArchetypeId);
+				if (!m_state.needs_refresh() && m_state.lastArchetypeId == archetypeLastId) {
+					sort_entities();
+					return false;
+				}
+
+				m_state.lastArchetypeId = archetypeLastId;
+				return true;
+			}
+
+			//! Second step of the split match(). Runs the VM pass and writes its matches to the cache.
+			//! Grouped queries leave the result cache for match_end() because group callbacks may read the world.
+			//! Passes of different queries can run at the same time as long as each uses its own \a matchScratch
+			//! and nothing modifies the world meanwhile.
+			//! \param entityToArchetypeMap Lookup of archetypes by entity
+			//! \param allArchetypes List of all archetypes
+			//! \param entityToArchetypeMapVersions Version map for archetype lookup validation
+			//! \param matchScratch Scratch providing the dedup stamps and match buffer
+			void match_exec(
+					const EntityToArchetypeMap& entityToArchetypeMap, std::span<const Archetype*> allArchetypes,
+					const EntityToArchetypeVersionMap& entityToArchetypeMapVersions, QueryMatchScratch& matchScratch) {
+				GAIA_PROF_SCOPE(queryinfo::match_exec);
+
+				matchScratch.matchesArr.clear();
+				vm::MatchingCtx ctx{};
+				init_match_ctx(
+						ctx, entityToArchetypeMap, allArchetypes, &entityToArchetypeMapVersions, matchScratch,
+						matchScratch.matchesArr);
+
+#if GAIA_ECS_TEST_HOOKS
+				++m_testMatchPassCount;
+#endif
+				m_plan.vm.exec(ctx);
+
+				const auto& matches = matchScratch.matchesArr;
+				const bool isGrouped = m_plan.ctx.data.groupBy != EntityBad;
+				m_state.seedArchetypeSet.reserve(m_state.seedArchetypeSet.size() + matches.size());
+				if (!isGrouped)
+					m_state.archetypeSet.reserve(m_state.archetypeSet.size() + matches.size());
+				for (const auto* pArchetype: matches) {
+					add_archetype_to_seed_cache(pArchetype);
+					if (!isGrouped)
+						add_archetype_to_cache(pArchetype, true, false);
+				}
+			}
+
+			//! Last step of the split match(). Finishes the cache refresh started by match_begin().
+			void match_end() {
+				if (m_plan.ctx.data.groupBy != EntityBad) {
+					for (const auto* pArchetype: m_state.seedArchetypeCache)
+						add_archetype_to_cache(pArchetype, true, false);
+				}
+
+				sort_entities();
+				sort_cache_groups();
+				m_state.clear_dirty();
+			}
+
 			//! Tries to match the query against the provided archetype.
 			//! This is necessary so we do not iterate all chunks over and over again when running queries.
 			//! \param archetype Archtype to match
@@ -1420,11 +1560,12 @@ namespace gaia {
 			//! \param entityToArchetypeMap World reverse index used to seed matching.
 			//! \param allArchetypes Current world archetypes.
 			//! \param entityToArchetypeMapVersions Revisions for reverse-index buckets.
+			//! \param archetypeLastId Last archetype id known to the world.
 			//! \param runtimeVarBindings Runtime values for query variable slots.
 			//! \param runtimeVarBindingMask Bitmask selecting bound slots in \a runtimeVarBindings.
 			void ensure_matches_transient(
 					const EntityToArchetypeMap& entityToArchetypeMap, std::span<const Archetype*> allArchetypes,
-					const EntityToArchetypeVersionMap& entityToArchetypeMapVersions,
+					const EntityToArchetypeVersionMap& entityToArchetypeMapVersions, ArchetypeId archetypeLastId,
 					const cnt::sarray<Entity, MaxVarCnt>& runtimeVarBindings, uint8_t runtimeVarBindingMask) {
 				auto& ctxData = m_plan.ctx.data;
 
@@ -1437,6 +1578,8 @@ namespace gaia {
 				m_state.clear_transient_result_cache();
 
 				auto& w = *world();
+				replan_if_stale(archetypeLastId);
+
 				auto& matchScratch = query_match_scratch_acquire(w);
 				CleanUpTmpArchetypeMatches autoCleanup(w, true);
 
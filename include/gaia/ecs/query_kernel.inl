@@ -0,0 +1,298 @@
+#include "gaia/config/config.h"
+
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "gaia/cnt/darray.h"
+#include "gaia/core/utility.h"
+#include "gaia/ecs/chunk.h"
+#include "gaia/ecs/chunk_iterator.h"
+#include "gaia/ecs/id.h"
+#include "gaia/ecs/query.h"
+#include "gaia/mem/data_layout_policy.h"
+
+namespace gaia {
+	namespace ecs {
+		//! Compile-time list of components every entity matched by a QueryKernel must have.
+		//! Components listed as mutable references (T&) are written by the kernel, everything else is read-only.
+		//! \tparam T Components in the order they are passed to kernel callbacks.
+		template <typename... T>
+		struct AllOf {};
+
+		//! Compile-time list of components entities matched by a QueryKernel must not have.
+		//! \tparam T Components or tags to exclude.
+		template <typename... T>
+		struct NoneOf {};
+
+		namespace detail {
+			//! \cond INTERNAL
+
+			template <typename T>
+			struct kernel_term {
+				using Type = core::raw_t<T>;
+				static constexpr bool IsWrite =
+						std::is_lvalue_reference_v<T> && !std::is_const_v<std::remove_reference_t<T>>;
+				static constexpr bool IsSoA = mem::is_soa_layout_v<Type>;
+				using Ptr = std::conditional_t<IsWrite, Type*, const Type*>;
+
+				static_assert(!std::is_same_v<Type, Entity>, "QueryKernel terms must be components");
+				static_assert(!is_pair<Type>::value, "QueryKernel does not support pairs");
+				static_assert(!std::is_empty_v<Type>, "QueryKernel AllOf terms need data. Use a regular query for tags");
+			};
+
+			template <typename...>
+			inline constexpr bool kernel_invalid_shape = false;
+
+			//! \endcond
+		} // namespace detail
+
+		//! Query whose shape is fixed at compile time.
+		//!
+		//! Matching is delegated to a regular cached Query. On top of it, the kernel keeps a flat table with
+		//! the column index of every AllOf term in every matched archetype. The table is rebuilt only when
+		//! the query result or the set of archetypes changes. Iteration then walks archetypes and chunks
+		//! directly and calls the callback from a loop instantiated for the exact term types. There are no
+		//! type-erased calls or per-chunk component lookups inside the loop, so simple bodies auto-vectorize.
+		//!
+		//! Only the enabled entities are visited. All AllOf terms need to be stored in chunks. Inherited prefab
+		//! data and sparse components are not supported and need a regular query.
+		//!
+		//! \code
+		//! auto k = w.query<ecs::AllOf<Position&, const Velocity>, ecs::NoneOf<Frozen>>();
+		//! k.each([&](Position& p, const Velocity& v) {
+		//!   p.x += v.x * dt;
+		//! });
+		//! \endcode
+		template <typename... Terms>
+		class QueryKernel {
+			static_assert(
+					detail::kernel_invalid_shape<Terms...>,
+					"QueryKernel expects AllOf<...> optionally followed by NoneOf<...>, e.g. "
+					"QueryKernel<AllOf<Position&, Velocity>, NoneOf<Frozen>>");
+		};
+
+		template <typename... TAll, typename... TNo>
+		class QueryKernel<AllOf<TAll...>, NoneOf<TNo...>> {
+			static constexpr uint32_t TermCnt = (uint32_t)sizeof...(TAll);
+			static constexpr bool HasWrites = (detail::kernel_term<TAll>::IsWrite || ...);
+			static constexpr bool HasSoA = (detail::kernel_term<TAll>::IsSoA || ...);
+
+			static_assert(TermCnt > 0, "QueryKernel needs at least one AllOf term");
+			static_assert(TermCnt <= MAX_ITEMS_IN_QUERY, "Too many QueryKernel terms");
+
+			//! Matched archetype together with the column index of each AllOf term.
+			struct Entry {
+				Archetype* pArchetype;
+				uint8_t compIdx[TermCnt];
+			};
+
+			World* m_pWorld;
+			//! Query used for matching archetypes
+			Query m_query;
+			//! Component entities of the AllOf terms
+			Entity m_comps[TermCnt];
+			//! Flat table of matched archetypes and their column indices
+			cnt::darray<Entry> m_entries;
+			//! Query result revision the table was built for
+			uint32_t m_resultRev = 0;
+			//! Archetype delete version the table was built for
+			uint32_t m_deleteVersion = 0;
+
+			template <typename T>
+			void add_all_term() {
+				using Term = detail::kernel_term<T>;
+				if constexpr (Term::IsWrite)
+					(void)m_query.template all<typename Term::Type&>();
+				else
+					(void)m_query.template all<typename Term::Type>();
+			}
+
+			//! Makes sure the archetype table matches the current query result.
+			void refresh() {
+				auto& queryInfo = m_query.fetch();
+				m_query.match_all(queryInfo);
+
+				const auto resultRev = queryInfo.result_cache_rev();
+				const auto deleteVersion = world_archetype_delete_version(*m_pWorld);
+				if (resultRev == m_resultRev && deleteVersion == m_deleteVersion)
+					return;
+
+				m_resultRev = resultRev;
+				m_deleteVersion = deleteVersion;
+				m_entries.clear();
+
+				const bool matchesPrefabs = queryInfo.matches_prefab_entities();
+				for (const auto* pArchetype: queryInfo.cache_archetype_view()) {
+					if (!matchesPrefabs && pArchetype->has(Prefab))
+						continue;
+
+					Entry entry{const_cast<Archetype*>(pArchetype), {}};
+					const auto ids = pArchetype->ids_view();
+					bool stored = true;
+					GAIA_FOR(TermCnt) {
+						const auto idx = core::get_index(ids, m_comps[i]);
+						if (idx == BadIndex) {
+							stored = false;
+							break;
+						}
+						entry.compIdx[i] = (uint8_t)idx;
+					}
+
+					GAIA_ASSERT2(stored, "QueryKernel matched an archetype which does not store all terms in its chunks");
+					if (stored)
+						m_entries.push_back(entry);
+				}
+			}
+
+			//! Visits every chunk with enabled entities. Takes care of versioning and world locking.
+			template <typename ChunkFunc>
+			void run(ChunkFunc&& chunkFunc) {
+				refresh();
+
+				if constexpr (HasWrites)
+					::gaia::ecs::update_version(m_pWorld->world_version());
+
+				lock(*m_pWorld);
+
+				for (const auto& entry: m_entries) {
+					if GAIA_UNLIKELY (entry.pArchetype->is_req_del())
+						continue;
+
+					for (auto* pChunk: entry.pArchetype->chunks()) {
+						const auto from = Iter::start_index(pChunk);
+						const auto to = Iter::end_index(pChunk);
+						if (from == to)
+							continue;
+
+						chunkFunc(pChunk, entry.compIdx, from, to);
+
+						if constexpr (HasWrites)
+							finish_writes(pChunk, entry.compIdx, from, to, std::index_sequence_for<TAll...>{});
+					}
+				}
+
+				unlock(*m_pWorld);
+				commit_cmd_buffer_st(*m_pWorld);
+				commit_cmd_buffer_mt(*m_pWorld);
+			}
+
+			template <size_t... I>
+			static void finish_writes(
+					Chunk* pChunk, const uint8_t* pCompIdx, uint16_t from, uint16_t to, std::index_sequence<I...>) {
+				((detail::kernel_term<TAll>::IsWrite ? pChunk->finish_write(pCompIdx[I], from, to) : void()), ...);
+			}
+
+			template <typename Func, size_t... I>
+			GAIA_FORCEINLINE static void
+			run_rows(Func& func, const ComponentRecord* pRecs, const uint8_t* pCompIdx, uint16_t from, uint16_t to,
+							 std::index_sequence<I...>) {
+				const std::tuple<typename detail::kernel_term<TAll>::Ptr...> ptrs{
+						((typename detail::kernel_term<TAll>::Ptr)pRecs[pCompIdx[I]].pData)...};
+				for (uint32_t i = from; i < to; ++i)
+					func(std::get<I>(ptrs)[i]...);
+			}
+
+			template <typename T>
+			GAIA_FORCEINLINE static auto chunk_view(Chunk* pChunk, const ComponentRecord& rec, uint16_t to) {
+				using Term = detail::kernel_term<T>;
+				const uint32_t size = Term::IsSoA ? pChunk->capacity() : to;
+				if constexpr (Term::IsWrite)
+					return pChunk->template sview_mut_raw<typename Term::Type>(rec.pData, size);
+				else
+					return pChunk->template view_raw<typename Term::Type>(rec.pData, size);
+			}
+
+			template <typename Func, size_t... I>
+			GAIA_FORCEINLINE static void run_chunk(
+					Func& func, Chunk* pChunk, const uint8_t* pCompIdx, uint16_t from, uint16_t to, std::index_sequence<I...>) {
+				const auto* pRecs = pChunk->comp_rec_view().data();
+				func((uint32_t)from, (uint32_t)to, chunk_view<TAll>(pChunk, pRecs[pCompIdx[I]], to)...);
+			}
+
+		public:
+			explicit QueryKernel(World& world): m_pWorld(&world), m_query(world.query()) {
+				(add_all_term<TAll>(), ...);
+				(m_query.template no<TNo>(), ...);
+
+				uint32_t i = 0;
+				((m_comps[i++] = world.template add<typename detail::kernel_term<TAll>::Type>().entity), ...);
+			}
+
+			//! Returns the underlying query used for matching.
+			GAIA_NODISCARD Query& query() {
+				return m_query;
+			}
+
+			//! Returns the number of archetypes in the cached kernel table.
+			//! The table is refreshed first so the number reflects the current state of the world.
+			GAIA_NODISCARD uint32_t archetype_cnt() {
+				refresh();
+				return (uint32_t)m_entries.size();
+			}
+
+			//! Returns the number of enabled entities matched by the kernel.
+			GAIA_NODISCARD uint32_t count() {
+				refresh();
+
+				uint32_t cnt = 0;
+				for (const auto& entry: m_entries) {
+					if (entry.pArchetype->is_req_del())
+						continue;
+					for (auto* pChunk: entry.pArchetype->chunks())
+						cnt += (uint32_t)(Iter::end_index(pChunk) - Iter::start_index(pChunk));
+				}
+				return cnt;
+			}
+
+			//! Calls \a func for every matched entity. The callback receives one reference per AllOf term
+			//! in declaration order, mutable for T& terms and const otherwise:
+			//! \code
+			//! k.each([](Position& p, const Velocity& v) { ... });
+			//! \endcode
+			//! SoA components do not have a per-entity reference. Use each_chunk for them.
+			template <typename Func>
+			void each(Func func) {
+				static_assert(!HasSoA, "QueryKernel::each can't be used with SoA components. Use each_chunk instead.");
+
+				run([&](Chunk* pChunk, const uint8_t* pCompIdx, uint16_t from, uint16_t to) {
+					run_rows(func, pChunk->comp_rec_view().data(), pCompIdx, from, to, std::index_sequence_for<TAll...>{});
+				});
+			}
+
+			//! Calls \a func for every chunk with matched entities:
+			//! \code
+			//! k.each_chunk([](uint32_t from, uint32_t to, auto p, auto v) {
+			//!   for (uint32_t i = from; i < to; ++i) ...
+			//! });
+			//! \endcode
+			//! \a from and \a to delimit the enabled rows of the chunk. The remaining arguments are component views,
+			//! one per AllOf term, indexed by chunk row. Views of SoA components expose per-field arrays via
+			//! get<N>() / set<N>() which makes them a good fit for vectorized loops.
+			template <typename Func>
+			void each_chunk(Func func) {
+				run([&](Chunk* pChunk, const uint8_t* pCompIdx, uint16_t from, uint16_t to) {
+					run_chunk(func, pChunk, pCompIdx, from, to, std::index_sequence_for<TAll...>{});
+				});
+			}
+		};
+
+		template <typename... TAll>
+		class QueryKernel<AllOf<TAll...>>: public QueryKernel<AllOf<TAll...>, NoneOf<>> {
+		public:
+			using QueryKernel<AllOf<TAll...>, NoneOf<>>::QueryKernel;
+		};
+
+		template <typename... TAll, typename... TNo>
+		class QueryKernel<NoneOf<TNo...>, AllOf<TAll...>>: public QueryKernel<AllOf<TAll...>, NoneOf<TNo...>> {
+		public:
+			using QueryKernel<AllOf<TAll...>, NoneOf<TNo...>>::QueryKernel;
+		};
+
+		template <typename... Terms>
+		inline QueryKernel<Terms...> World::query() {
+			return QueryKernel<Terms...>(*this);
+		}
+	} // namespace ecs
+} // namespace gaia
@@ -0,0 +1,189 @@
+#pragma once
+#include "gaia/config/config.h"
+
+#include <cstdint>
+#include <type_traits>
+
+#include "gaia/core/span.h"
+#include "gaia/core/utility.h"
+#include "gaia/mem/data_layout_policy.h"
+#include "gaia/mem/simd.h"
+
+namespace gaia {
+	namespace ecs {
+		//! Lane-blocked view of one chunk column of arithmetic values.
+		//!
+		//! The column is split into blocks of \a N consecutive rows. Blocks are aligned to the column start which
+		//! itself is aligned to sizeof(T) * N bytes so full blocks are loaded and stored with aligned vector
+		//! instructions. Only the first and the last block can be partial. They are accessed with masked loads
+		//! and stores which never touch rows outside of the iterated range.
+		//! \code
+		//! GAIA_FOR(px.block_cnt()) px.store(i, px.load(i) + vx.load(i) * dt);
+		//! \endcode
+		//! \tparam T Lane type
+		//! \tparam N Number of lanes in one block
+		//! \tparam Mut True if the column can be written to
+		template <typename T, uint32_t N, bool Mut>
+		class SimdColumn {
+		public:
+			using value_type = T;
+			using vec_type = mem::simd_vec<T, N>;
+			static constexpr uint32_t Lanes = N;
+
+		private:
+			using Ptr = std::conditional_t<Mut, T*, const T*>;
+
+			//! Value of row 0 of the chunk column
+			Ptr m_pData = nullptr;
+			//! First row of the first block
+			uint32_t m_first = 0;
+			//! First row of the iterated range
+			uint32_t m_from = 0;
+			//! One past the last row of the iterated range
+			uint32_t m_to = 0;
+
+		public:
+			SimdColumn() = default;
+			SimdColumn(Ptr pData, uint32_t from, uint32_t to):
+					m_pData(pData), m_first(from & ~(N - 1)), m_from(from), m_to(to) {
+				GAIA_ASSERT(from <= to);
+				GAIA_ASSERT(pData == nullptr || (uintptr_t)pData % (sizeof(T) * N) == 0);
+			}
+
+			//! Returns the number of blocks covering the iterated rows.
+			GAIA_NODISCARD uint32_t block_cnt() const noexcept {
+				return m_from == m_to ? 0 : (m_to - m_first + N - 1) / N;
+			}
+
+			//! Returns the chunk row of the first lane of block \a b.
+			GAIA_NODISCARD uint32_t block_row(uint32_t b) const noexcept {
+				return m_first + b * N;
+			}
+
+			//! Returns true if all lanes of block \a b lie inside the iterated rows.
+			GAIA_NODISCARD bool full(uint32_t b) const noexcept {
+				const auto row = block_row(b);
+				return row >= m_from && row + N <= m_to;
+			}
+
+			//! Loads block \a b. Lanes outside the iterated rows are zero.
+			GAIA_NODISCARD vec_type load(uint32_t b) const noexcept {
+				GAIA_ASSERT(b < block_cnt());
+				const auto row = block_row(b);
+				if GAIA_LIKELY (full(b))
+					return vec_type::load(m_pData + row);
+
+				const auto lo = m_from > row ? m_from - row : 0;
+				const auto hi = core::get_min(m_to - row, N);
+				return mem::simd_load_masked<vec_type>(m_pData + row, lo, hi);
+			}
+
+			//! Stores \a v to block \a b. Lanes outside the iterated rows are not written.
+			template <bool M = Mut, typename = std::enable_if_t<M>>
+			void store(uint32_t b, vec_type v) noexcept {
+				GAIA_ASSERT(b < block_cnt());
+				const auto row = block_row(b);
+				if GAIA_LIKELY (full(b)) {
+					v.store(m_pData + row);
+					return;
+				}
+
+				const auto lo = m_from > row ? m_from - row : 0;
+				const auto hi = core::get_min(m_to - row, N);
+				mem::simd_store_masked<vec_type>(m_pData + row, v, lo, hi);
+			}
+
+			//! Returns the address of row 0 of the chunk column.
+			GAIA_NODISCARD Ptr data() const noexcept {
+				return m_pData;
+			}
+		};
+
+		//! \cond INTERNAL
+		namespace detail {
+			template <typename U, typename = void>
+			struct simd_view_traits {
+				static_assert(std::is_arithmetic_v<U>, "simd_view needs an SoA component or an arithmetic AoS component");
+
+				static constexpr uint32_t FieldCnt = 1;
+				template <size_t Item>
+				using field_type = U;
+				template <size_t Item>
+				static constexpr uint32_t Lanes = mem::SimdNativeBytes / (uint32_t)sizeof(U);
+			};
+
+			template <typename U>
+			struct simd_view_traits<U, std::enable_if_t<mem::is_soa_layout_v<U>>> {
+				using policy = mem::data_view_policy_soa<U::gaia_Data_Layout, U>;
+				static constexpr uint32_t FieldCnt = (uint32_t)policy::TTupleItems;
+				template <size_t Item>
+				using field_type = typename policy::template value_type<Item>;
+				//! One block of a field spans exactly one alignment unit of the SoA layout
+				template <size_t Item>
+				static constexpr uint32_t Lanes = (uint32_t)(policy::Alignment / sizeof(field_type<Item>));
+			};
+		} // namespace detail
+		//! \endcond
+
+		//! Lane-blocked view of a component in the iterated chunk.
+		//! SoA components expose one SimdColumn per field, arithmetic AoS components a single one at index 0.
+		//! Lane counts follow the column layout: GAIA_LAYOUT(SoA) gives 16-byte blocks, SoA8 32-byte blocks and SoA16
+		//! 64-byte blocks. Arithmetic AoS columns use the widest native register of the target.
+		//! \tparam U Component type
+		//! \tparam Mut True if the view can be written to
+		template <typename U, bool Mut>
+		class SimdView {
+			using Traits = detail::simd_view_traits<U>;
+			using Ptr = std::conditional_t<Mut, uint8_t*, const uint8_t*>;
+
+			template <size_t Item>
+			using field_type = typename Traits::template field_type<Item>;
+			template <size_t Item>
+			static constexpr uint32_t Lanes = Traits::template Lanes<Item>;
+
+			//! Start of the component column, row 0
+			Ptr m_pData = nullptr;
+			//! Chunk capacity
+			uint32_t m_cap = 0;
+			//! First row of the iterated range
+			uint32_t m_from = 0;
+			//! One past the last row of the iterated range
+			uint32_t m_to = 0;
+
+			template <size_t Item>
+			GAIA_NODISCARD auto field_ptr() const {
+				static_assert(Item < Traits::FieldCnt, "Field index out of range");
+				using F = field_type<Item>;
+				static_assert(std::is_arithmetic_v<F>, "simd_view fields need to be arithmetic");
+				static_assert(Lanes<Item> > 0, "simd_view field is wider than a block");
+
+				if constexpr (mem::is_soa_layout_v<U>) {
+					using Policy = typename Traits::policy;
+					if (m_pData == nullptr)
+						return (const F*)nullptr;
+					return Policy::template get<Item>(std::span<const uint8_t>{m_pData, m_cap}).data();
+				} else
+					return (const F*)m_pData;
+			}
+
+		public:
+			SimdView() = default;
+			SimdView(Ptr pData, uint32_t cap, uint32_t from, uint32_t to):
+					m_pData(pData), m_cap(cap), m_from(from), m_to(to) {}
+
+			//! Returns a read-only lane view of the field \a Item.
+			template <size_t Item>
+			GAIA_NODISCARD auto get() const {
+				using Column = SimdColumn<field_type<Item>, Lanes<Item>, false>;
+				return Column(field_ptr<Item>(), m_from, m_to);
+			}
+
+			//! Returns a mutable lane view of the field \a Item.
+			template <size_t Item, bool M = Mut, typename = std::enable_if_t<M>>
+			GAIA_NODISCARD auto set() {
+				using Column = SimdColumn<field_type<Item>, Lanes<Item>, true>;
+				return Column(const_cast<field_type<Item>*>(field_ptr<Item>()), m_from, m_to);
+			}
+		};
+	} // namespace ecs
+} // namespace gaia
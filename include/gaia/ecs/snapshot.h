@@ -0,0 +1,343 @@
+#pragma once
+#include "gaia/config/config.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "gaia/cnt/darray.h"
+#include "gaia/cnt/map.h"
+#include "gaia/config/profiler.h"
+#include "gaia/core/hashing_policy.h"
+#include "gaia/ecs/world.h"
+#include "gaia/mem/mem_alloc.h"
+
+namespace gaia {
+	namespace ecs {
+		//! Ring of in-memory world snapshots meant for rollback netcode.
+		//! Snapshots store component data column by column. Columns nobody wrote to since the previous snapshot are
+		//! shared with it instead of being copied, so the cost of a snapshot is proportional to the amount of data
+		//! modified in between. Changes are detected the same way changed() query filters detect them.
+		//! Restoring copies stored columns back into the chunks they were taken from. Only columns that differ from
+		//! the current state are copied and nothing needs to be deserialized.
+		//! Restoring is possible as long as the structure of the world did not change since the snapshot was taken,
+		//! i.e. no entities were created, deleted, enabled, disabled or moved to another archetype. Otherwise,
+		//! restore() fails and the caller needs to fall back to World::save and World::load.
+		//! \warning Data of core, sparse and non-trivially copyable components is not part of snapshots.
+		//!          Restored columns are marked as changed but no OnSet observers or set hooks are triggered.
+		class SnapshotRing final {
+		public:
+			//! Default number of frames kept in the ring
+			static constexpr uint32_t MaxFramesDefault = 8;
+
+		private:
+			//! Reference-counted copy of a component column. Column data follows the header.
+			struct Page {
+				//! Number of column references to the page
+				uint32_t refs;
+				//! Number of bytes of column data
+				uint32_t bytes;
+
+				GAIA_NODISCARD uint8_t* data() {
+					return (uint8_t*)(this + 1);
+				}
+			};
+
+			struct Column {
+				//! Chunk the column belongs to
+				Chunk* pChunk;
+				//! Index of the component in the chunk
+				uint32_t compIdx;
+				//! Copy of the column data
+				Page* pPage;
+			};
+
+			struct Frame {
+				//! Frame number given by the user
+				uint32_t frame = 0;
+				//! World version at which the frame was captured
+				uint32_t version = 0;
+				//! Digest of the chunk layout at the time of capture
+				uint64_t layout = 0;
+				//! Columns of all chunks in the order of archetypes and their chunks
+				cnt::darray<Column> columns;
+			};
+
+			//! World the snapshots are taken from
+			World& m_world;
+			//! Frame storage. Used as a ring buffer.
+			cnt::darray<Frame> m_frames;
+			//! Index of the oldest frame in m_frames
+			uint32_t m_head = 0;
+			//! Number of frames stored
+			uint32_t m_cnt = 0;
+			//! Columns matching the world's data as of m_version. Equal to the last captured or restored frame.
+			cnt::darray<Column> m_current;
+			//! Chunk layout digest of m_current
+			uint64_t m_currentLayout = 0;
+			//! World version at which m_current was last in sync with the world. 0 if never.
+			uint32_t m_version = 0;
+			//! Number of bytes held by pages
+			uint64_t m_bytes = 0;
+
+		public:
+			//! Creates a snapshot ring for \a world.
+			//! \param world World the snapshots are taken from. Must outlive the ring.
+			//! \param maxFrames Maximum number of frames kept. The oldest frames are dropped first.
+			explicit SnapshotRing(World& world, uint32_t maxFrames = MaxFramesDefault): m_world(world) {
+				GAIA_ASSERT(maxFrames > 0);
+				m_frames.resize(core::get_max(maxFrames, 1U));
+			}
+
+			~SnapshotRing() {
+				clear();
+			}
+
+			SnapshotRing(const SnapshotRing&) = delete;
+			SnapshotRing& operator=(const SnapshotRing&) = delete;
+			SnapshotRing(SnapshotRing&&) = delete;
+			SnapshotRing& operator=(SnapshotRing&&) = delete;
+
+			//! Captures the current state of the world as \a frame.
+			//! Frames equal to or newer than \a frame are dropped first. When the ring is full the oldest frame
+			//! is dropped.
+			//! \param frame Frame number
+			void capture(uint32_t frame) {
+				GAIA_PROF_SCOPE(SnapshotRing::capture);
+				GAIA_ASSERT(!m_world.locked());
+
+				drop_newer(frame, true);
+				if (m_cnt == max_frames())
+					drop_oldest();
+
+				auto& f = m_frames[(m_head + m_cnt) % max_frames()];
+				++m_cnt;
+				f.frame = frame;
+				f.columns.clear();
+
+				const bool inSync = m_version != 0;
+				cnt::map<const Chunk*, uint32_t> lookup;
+				bool lookupReady = false;
+				uint32_t prevIdx = 0;
+				uint64_t layout = 0;
+
+				for (auto* pArchetype: m_world.archetypes()) {
+					for (auto* pChunk: pArchetype->chunks()) {
+						if (pChunk->empty())
+							continue;
+
+						layout = layout_hash(layout, *pChunk);
+						const bool orderChanged = !inSync || pChunk->entity_order_changed(m_version);
+
+						const auto cntComps = (uint32_t)pChunk->comp_rec_view().size();
+						GAIA_FOR_(cntComps, compIdx) {
+							if (!pChunk->is_state_column(compIdx))
+								continue;
+
+							Page* pPage = nullptr;
+							if (!orderChanged && !pChunk->changed(m_version, compIdx)) {
+								// Columns come in the same order as long as the structure stays the same.
+								// Search only when it does not.
+								if (prevIdx >= m_current.size() || m_current[prevIdx].pChunk != pChunk ||
+										m_current[prevIdx].compIdx != compIdx) {
+									if (!lookupReady) {
+										GAIA_EACH(m_current) lookup.try_emplace(m_current[i].pChunk, i);
+										lookupReady = true;
+									}
+									const auto it = lookup.find(pChunk);
+									prevIdx = it != lookup.end() ? it->second : (uint32_t)m_current.size();
+									while (prevIdx < m_current.size() && m_current[prevIdx].pChunk == pChunk &&
+												 m_current[prevIdx].compIdx != compIdx)
+										++prevIdx;
+								}
+								if (prevIdx < m_current.size() && m_current[prevIdx].pChunk == pChunk &&
+										m_current[prevIdx].compIdx == compIdx) {
+									pPage = m_current[prevIdx].pPage;
+									++pPage->refs;
+								}
+							}
+
+							if (pPage == nullptr)
+								pPage = copy_column(*pChunk, compIdx);
+
+							f.columns.push_back({pChunk, compIdx, pPage});
+							++prevIdx;
+						}
+					}
+				}
+
+				f.layout = layout;
+				set_current(f.columns, layout);
+				f.version = m_version;
+			}
+
+			//! Restores the state of the world captured as \a frame. Frames newer than \a frame are dropped because
+			//! they are expected to be simulated and captured again.
+			//! \param frame Frame number
+			//! \return True if the frame was restored. False if there is no such frame or the structure of the world
+			//!         changed since the frame was captured.
+			GAIA_NODISCARD bool restore(uint32_t frame) {
+				GAIA_PROF_SCOPE(SnapshotRing::restore);
+				GAIA_ASSERT(!m_world.locked());
+
+				auto* pFrame = find(frame);
+				if (pFrame == nullptr)
+					return false;
+				auto& f = *pFrame;
+
+				// Make sure the structure is the same as it was at the time of capture
+				uint64_t layout = 0;
+				for (auto* pArchetype: m_world.archetypes()) {
+					for (auto* pChunk: pArchetype->chunks()) {
+						if (pChunk->empty())
+							continue;
+						if (pChunk->entity_order_changed(f.version))
+							return false;
+						layout = layout_hash(layout, *pChunk);
+					}
+				}
+				if (layout != f.layout)
+					return false;
+
+				// Columns still matching their page do not need to be copied
+				const bool canCompare = m_version != 0 && m_currentLayout == f.layout && m_current.size() == f.columns.size();
+				GAIA_EACH(f.columns) {
+					const auto& col = f.columns[i];
+					if (canCompare && m_current[i].pPage == col.pPage && !col.pChunk->changed(m_version, col.compIdx))
+						continue;
+
+					restore_column(col);
+				}
+
+				drop_newer(frame, false);
+				set_current(f.columns, f.layout);
+				return true;
+			}
+
+			//! Checks if \a frame is stored in the ring.
+			//! \param frame Frame number
+			//! \return True if the frame can be restored.
+			GAIA_NODISCARD bool contains(uint32_t frame) const {
+				return const_cast<SnapshotRing*>(this)->find(frame) != nullptr;
+			}
+
+			//! Returns the number of frames stored in the ring.
+			GAIA_NODISCARD uint32_t size() const {
+				return m_cnt;
+			}
+
+			//! Returns the maximum number of frames stored in the ring.
+			GAIA_NODISCARD uint32_t max_frames() const {
+				return (uint32_t)m_frames.size();
+			}
+
+			//! Returns the number of bytes of component data held by the ring.
+			GAIA_NODISCARD uint64_t bytes() const {
+				return m_bytes;
+			}
+
+			//! Drops all frames.
+			void clear() {
+				while (m_cnt > 0)
+					drop_oldest();
+				release(m_current);
+				m_currentLayout = 0;
+				m_version = 0;
+				m_head = 0;
+			}
+
+		private:
+			GAIA_NODISCARD static uint64_t layout_hash(uint64_t hash, const Chunk& chunk) {
+				const uint64_t data[] = {(uint64_t)(uintptr_t)&chunk, chunk.size(), chunk.size_disabled()};
+				return core::hash_data64(data, sizeof(data), hash);
+			}
+
+			GAIA_NODISCARD Frame* find(uint32_t frame) {
+				GAIA_FOR(m_cnt) {
+					auto& f = m_frames[(m_head + i) % max_frames()];
+					if (f.frame == frame)
+						return &f;
+				}
+				return nullptr;
+			}
+
+			Page* copy_column(const Chunk& chunk, uint32_t compIdx) {
+				const auto& rec = chunk.comp_rec_view()[compIdx];
+				const auto cnt = compIdx < chunk.size_generic() ? (uint32_t)chunk.size() : 1U;
+				const auto cap = compIdx < chunk.size_generic() ? (uint32_t)chunk.capacity() : 1U;
+
+				uint32_t bytes = 0;
+				rec.pItem->each_block(rec.pData, cnt, cap, [&](const uint8_t*, uint32_t blockBytes) {
+					bytes += blockBytes;
+				});
+
+				auto* pPage = (Page*)mem::mem_alloc("SnapshotPage", sizeof(Page) + bytes);
+				pPage->refs = 1;
+				pPage->bytes = bytes;
+				m_bytes += bytes;
+
+				auto* pDst = pPage->data();
+				rec.pItem->each_block(rec.pData, cnt, cap, [&](const uint8_t* pSrc, uint32_t blockBytes) {
+					memcpy(pDst, pSrc, blockBytes);
+					pDst += blockBytes;
+				});
+				return pPage;
+			}
+
+			static void restore_column(const Column& col) {
+				auto& chunk = *col.pChunk;
+				const auto& rec = chunk.comp_rec_view()[col.compIdx];
+				const auto cnt = col.compIdx < chunk.size_generic() ? (uint32_t)chunk.size() : 1U;
+				const auto cap = col.compIdx < chunk.size_generic() ? (uint32_t)chunk.capacity() : 1U;
+
+				const auto* pSrc = col.pPage->data();
+				rec.pItem->each_block(rec.pData, cnt, cap, [&](const uint8_t* pDst, uint32_t blockBytes) {
+					memcpy(const_cast<uint8_t*>(pDst), pSrc, blockBytes);
+					pSrc += blockBytes;
+				});
+				chunk.update_world_version(col.compIdx);
+			}
+
+			void release(cnt::darray<Column>& columns) {
+				for (auto& col: columns) {
+					if (--col.pPage->refs != 0)
+						continue;
+					m_bytes -= col.pPage->bytes;
+					mem::mem_free("SnapshotPage", col.pPage);
+				}
+				columns.clear();
+			}
+
+			//! Makes \a columns the columns the world is in sync with.
+			void set_current(const cnt::darray<Column>& columns, uint64_t layout) {
+				for (const auto& col: columns)
+					++col.pPage->refs;
+				release(m_current);
+				m_current = columns;
+				m_currentLayout = layout;
+
+				// Writes from now on get a newer version than the one the columns are in sync with
+				auto& worldVersion = m_world.world_version();
+				m_version = worldVersion;
+				update_version(worldVersion);
+			}
+
+			void drop_oldest() {
+				GAIA_ASSERT(m_cnt > 0);
+				release(m_frames[m_head].columns);
+				m_head = (m_head + 1) % max_frames();
+				--m_cnt;
+			}
+
+			//! Drops frames newer than \a frame. Also drops \a frame itself if \a inclusive is true.
+			void drop_newer(uint32_t frame, bool inclusive) {
+				while (m_cnt > 0) {
+					auto& f = m_frames[(m_head + m_cnt - 1) % max_frames()];
+					if (f.frame < frame || (!inclusive && f.frame == frame))
+						break;
+					release(f.columns);
+					--m_cnt;
+				}
+			}
+		};
+	} // namespace ecs
+} // namespace gaia
@@ -0,0 +1,354 @@
+#pragma once
+#include "gaia/config/config.h"
+
+#include <cmath>
+#include <cstdint>
+
+#include "gaia/cnt/darray.h"
+#include "gaia/cnt/map.h"
+#include "gaia/config/profiler.h"
+#include "gaia/core/utility.h"
+#include "gaia/ecs/chunk_row_set.h"
+#include "gaia/ecs/world.h"
+
+namespace gaia {
+	namespace ecs {
+		//! Axis-aligned box used by spatial queries. Both corners are inclusive.
+		struct SpatialBox {
+			float min[3];
+			float max[3];
+		};
+
+		//! Provides coordinates of component \a T to SpatialIndex.
+		//! The default implementation reads members x, y and z. Specialize it for other types.
+		template <typename T>
+		struct SpatialTraits {
+			static void coords(const T& value, float (&out)[3]) {
+				out[0] = (float)value.x;
+				out[1] = (float)value.y;
+				out[2] = (float)value.z;
+			}
+		};
+
+		//! Uniform grid over the positions of entities with component \a T.
+		//! Answers area-of-interest queries without scanning the world. The grid is brought up-to-date lazily before
+		//! each query. Only chunks whose \a T column was written to or whose entities changed since the previous update
+		//! are visited, and only entities that moved to a different cell are re-bucketed. Changes are detected via the
+		//! same chunk versions changed() query filters use. Disabled entities are not indexed.
+		//! Instances are owned by the world. See World::spatial_index.
+		//! \tparam T Component holding positions. Coordinates are read via SpatialTraits<T>.
+		template <typename T>
+		class SpatialIndex final {
+			//! Entity stored in a cell
+			struct Ref {
+				//! Position of the entity as of the last update
+				float pos[3];
+				//! Index of the chunk slot
+				uint32_t slot;
+				//! Row of the entity in the chunk
+				uint16_t row;
+			};
+
+			struct Cell {
+				//! Cell coordinates
+				int32_t coords[3];
+				//! Entities in the cell
+				cnt::darray<Ref> refs;
+			};
+
+			//! Indexing data of a chunk
+			struct ChunkSlot {
+				//! Archetype of the chunk
+				const Archetype* pArchetype = nullptr;
+				//! Chunk. Nullptr for unused slots.
+				Chunk* pChunk = nullptr;
+				//! Value of m_updates when the chunk was last seen
+				uint32_t seen = 0;
+				//! Cell of each row. BadIndex for rows not indexed.
+				cnt::darray<uint32_t> cells;
+				//! Index of the reference of each row in its cell
+				cnt::darray<uint32_t> refs;
+			};
+
+			//! Max distance from the origin in cells along each axis
+			static constexpr int32_t MaxCellCoord = (1 << 20) - 1;
+
+			World& m_world;
+			//! Query matching everything with the component
+			Query m_query;
+			//! Component entity
+			Entity m_comp;
+			//! Size of a cell along each axis
+			float m_cellSize;
+			//! Inverse of m_cellSize
+			float m_cellSizeInv;
+			//! Packed cell coordinates -> index of the cell in m_cells
+			cnt::map<uint64_t, uint32_t> m_cellMap;
+			//! Cells
+			cnt::darray<Cell> m_cells;
+			//! Chunk slots
+			cnt::darray<ChunkSlot> m_slots;
+			//! Unused chunk slots
+			cnt::darray<uint32_t> m_freeSlots;
+			//! Chunk -> index of its slot
+			cnt::map<const Chunk*, uint32_t> m_chunkToSlot;
+			//! Rows found by the running region query
+			detail::ChunkRowSet m_hits;
+			//! Scratch buffer of ranges
+			cnt::darray<ChunkRange> m_ranges;
+			//! Number of updates done so far
+			uint32_t m_updates = 0;
+			//! World version of the last update
+			uint32_t m_version = 0;
+			//! Number of indexed entities
+			uint32_t m_live = 0;
+
+		public:
+			//! Creates a spatial index over component \a T.
+			//! \param world World the entities live in
+			//! \param cellSize Size of a cell along each axis. Ideally about the size of a typical query region.
+			SpatialIndex(World& world, float cellSize):
+					m_world(world), m_query(world.query().template all<T>()), m_comp(world.template add<T>().entity),
+					m_cellSize(cellSize), m_cellSizeInv(1.0f / cellSize) {
+				GAIA_ASSERT(cellSize > 0.0f);
+			}
+
+			SpatialIndex(const SpatialIndex&) = delete;
+			SpatialIndex& operator=(const SpatialIndex&) = delete;
+			SpatialIndex(SpatialIndex&&) = delete;
+			SpatialIndex& operator=(SpatialIndex&&) = delete;
+
+			//! Returns the size of a cell.
+			GAIA_NODISCARD float cell_size() const {
+				return m_cellSize;
+			}
+
+			//! Returns the number of indexed entities as of the last update.
+			GAIA_NODISCARD uint32_t size() const {
+				return m_live;
+			}
+
+			//! Brings the index up-to-date with the world. Called automatically by queries.
+			void update() {
+				GAIA_PROF_SCOPE(SpatialIndex::update);
+
+				++m_updates;
+				m_query.each([&](Iter& it) {
+					auto* pChunk = const_cast<Chunk*>(it.chunk());
+					auto slotIdx = BadIndex;
+					bool isNew = false;
+					const auto itSlot = m_chunkToSlot.find(pChunk);
+					if (itSlot != m_chunkToSlot.end())
+						slotIdx = itSlot->second;
+					else {
+						slotIdx = add_slot(it.archetype(), pChunk);
+						isNew = true;
+					}
+
+					auto& slot = m_slots[slotIdx];
+					slot.seen = m_updates;
+					// Chunks are recycled so the same address might now hold a chunk with more rows
+					const auto cap = (uint32_t)pChunk->capacity();
+					if (slot.cells.size() < cap) {
+						slot.cells.resize(cap, BadIndex);
+						slot.refs.resize(cap, BadIndex);
+						m_hits.reserve(slotIdx, cap);
+					}
+
+					// Structural changes invalidate all rows. Rows whose data did not change keep their cells.
+					const bool orderChanged = isNew || pChunk->entity_order_changed(m_version);
+					if (!orderChanged && !pChunk->changed(m_version, pChunk->comp_idx(m_comp)))
+						return;
+					if (orderChanged)
+						del_refs(slot);
+
+					auto view = it.template view<T>();
+					const auto from = it.row_begin();
+					GAIA_EACH(it) {
+						const T value = view[i];
+						Ref ref;
+						SpatialTraits<T>::coords(value, ref.pos);
+						ref.slot = slotIdx;
+						ref.row = (uint16_t)(from + i);
+
+						const auto cellIdx = get_or_add_cell(ref.pos);
+						const auto prevCellIdx = slot.cells[ref.row];
+						if (prevCellIdx == cellIdx) {
+							m_cells[cellIdx].refs[slot.refs[ref.row]] = ref;
+							continue;
+						}
+
+						if (prevCellIdx != BadIndex)
+							del_ref(slot, ref.row);
+						add_ref(slot, cellIdx, ref);
+					}
+				});
+
+				// Chunks no longer around or without any enabled entities
+				GAIA_EACH(m_slots) {
+					auto& slot = m_slots[i];
+					if (slot.pChunk == nullptr || slot.seen == m_updates)
+						continue;
+
+					del_refs(slot);
+					m_chunkToSlot.erase(slot.pChunk);
+					slot.pChunk = nullptr;
+					m_freeSlots.push_back(i);
+				}
+
+				// Writes from now on get a newer version than the one the index is in sync with
+				auto& worldVersion = m_world.world_version();
+				m_version = worldVersion;
+				update_version(worldVersion);
+			}
+
+			//! Finds entities inside \a box and returns them as ranges of chunk rows.
+			//! Ranges of the same chunk come one after another ordered by row. Neighbouring rows are merged into
+			//! a single range.
+			//! Ranges are valid only until the next structural change of the world.
+			//! \param box Region to search
+			//! \param[out] out Ranges of rows of entities inside the region
+			void ranges(const SpatialBox& box, cnt::darray<ChunkRange>& out) {
+				GAIA_PROF_SCOPE(SpatialIndex::ranges);
+
+				update();
+				out.clear();
+
+				int32_t lo[3];
+				int32_t hi[3];
+				uint64_t cellCnt = 1;
+				GAIA_FOR(3) {
+					lo[i] = cell_coord(box.min[i]);
+					hi[i] = cell_coord(box.max[i]);
+					cellCnt *= (uint64_t)(hi[i] - lo[i] + 1);
+				}
+
+				// Large regions are cheaper to answer by going over the cells that exist
+				if (cellCnt > m_cells.size()) {
+					for (const auto& cell: m_cells) {
+						if (cell_overlaps(cell.coords, lo, hi))
+							collect(cell, box, cell_inside(cell.coords, lo, hi));
+					}
+				} else {
+					for (int32_t z = lo[2]; z <= hi[2]; ++z) {
+						for (int32_t y = lo[1]; y <= hi[1]; ++y) {
+							for (int32_t x = lo[0]; x <= hi[0]; ++x) {
+								const int32_t coords[3] = {x, y, z};
+								const auto it = m_cellMap.find(cell_key(coords));
+								if (it == m_cellMap.end())
+									continue;
+								collect(m_cells[it->second], box, cell_inside(coords, lo, hi));
+							}
+						}
+					}
+				}
+
+				m_hits.flush(out, [&](uint32_t slotIdx) {
+					const auto& slot = m_slots[slotIdx];
+					return ChunkRange{slot.pArchetype, slot.pChunk, 0, 0};
+				});
+			}
+
+			//! Runs \a query over entities inside \a box.
+			//! \param query Query to run. Entities not matching it are skipped.
+			//! \param box Region to search
+			//! \param func Function called as func(Iter&) for each range of entities
+			template <typename Func>
+			void each(Query& query, const SpatialBox& box, Func func) {
+				ranges(box, m_ranges);
+				query.each(std::span<const ChunkRange>{m_ranges.data(), m_ranges.size()}, func);
+			}
+
+		private:
+			GAIA_NODISCARD int32_t cell_coord(float value) const {
+				const auto c = (int32_t)std::floor(value * m_cellSizeInv);
+				return core::get_min(core::get_max(c, -MaxCellCoord), MaxCellCoord);
+			}
+
+			GAIA_NODISCARD static uint64_t cell_key(const int32_t (&coords)[3]) {
+				return ((uint64_t)(uint32_t)(coords[0] + MaxCellCoord) << 42) |
+							 ((uint64_t)(uint32_t)(coords[1] + MaxCellCoord) << 21) | (uint64_t)(uint32_t)(coords[2] + MaxCellCoord);
+			}
+
+			GAIA_NODISCARD static bool cell_overlaps(const int32_t (&coords)[3], const int32_t (&lo)[3], const int32_t (&hi)[3]) {
+				return coords[0] >= lo[0] && coords[0] <= hi[0] && coords[1] >= lo[1] && coords[1] <= hi[1] &&
+							 coords[2] >= lo[2] && coords[2] <= hi[2];
+			}
+
+			//! Checks if the cell lies inside the region so entities in it do not need to be tested one by one.
+			GAIA_NODISCARD static bool cell_inside(const int32_t (&coords)[3], const int32_t (&lo)[3], const int32_t (&hi)[3]) {
+				return coords[0] > lo[0] && coords[0] < hi[0] && coords[1] > lo[1] && coords[1] < hi[1] && coords[2] > lo[2] &&
+							 coords[2] < hi[2];
+			}
+
+			//! Marks rows of entities of \a cell inside \a box as hits.
+			void collect(const Cell& cell, const SpatialBox& box, bool inside) {
+				for (const auto& ref: cell.refs) {
+					if (!inside && (ref.pos[0] < box.min[0] || ref.pos[0] > box.max[0] || ref.pos[1] < box.min[1] ||
+													ref.pos[1] > box.max[1] || ref.pos[2] < box.min[2] || ref.pos[2] > box.max[2]))
+						continue;
+
+					m_hits.add(ref.slot, ref.row);
+				}
+			}
+
+			GAIA_NODISCARD uint32_t get_or_add_cell(const float (&pos)[3]) {
+				const int32_t coords[3] = {cell_coord(pos[0]), cell_coord(pos[1]), cell_coord(pos[2])};
+				const auto key = cell_key(coords);
+				const auto it = m_cellMap.find(key);
+				if (it != m_cellMap.end())
+					return it->second;
+
+				const auto cellIdx = (uint32_t)m_cells.size();
+				m_cellMap.emplace(key, cellIdx);
+				auto& cell = m_cells.emplace_back();
+				GAIA_FOR(3) cell.coords[i] = coords[i];
+				return cellIdx;
+			}
+
+			GAIA_NODISCARD uint32_t add_slot(const Archetype* pArchetype, Chunk* pChunk) {
+				uint32_t slotIdx;
+				if (!m_freeSlots.empty()) {
+					slotIdx = m_freeSlots.back();
+					m_freeSlots.pop_back();
+				} else {
+					slotIdx = (uint32_t)m_slots.size();
+					m_slots.emplace_back();
+				}
+
+				m_slots[slotIdx].pArchetype = pArchetype;
+				m_slots[slotIdx].pChunk = pChunk;
+				m_chunkToSlot.emplace(pChunk, slotIdx);
+				return slotIdx;
+			}
+
+			void add_ref(ChunkSlot& slot, uint32_t cellIdx, const Ref& ref) {
+				auto& refs = m_cells[cellIdx].refs;
+				slot.cells[ref.row] = cellIdx;
+				slot.refs[ref.row] = (uint32_t)refs.size();
+				refs.push_back(ref);
+				++m_live;
+			}
+
+			//! Removes the entity on \a row from its cell. The last entity of the cell takes its place.
+			void del_ref(ChunkSlot& slot, uint16_t row) {
+				auto& refs = m_cells[slot.cells[row]].refs;
+				const auto refIdx = slot.refs[row];
+				const auto& last = refs.back();
+				m_slots[last.slot].refs[last.row] = refIdx;
+				refs[refIdx] = last;
+				refs.pop_back();
+				slot.cells[row] = BadIndex;
+				--m_live;
+			}
+
+			//! Removes all entities of \a slot from their cells.
+			void del_refs(ChunkSlot& slot) {
+				GAIA_EACH(slot.cells) {
+					if (slot.cells[i] != BadIndex)
+						del_ref(slot, (uint16_t)i);
+				}
+			}
+		};
+	} // namespace ecs
+} // namespace gaia
@@ -0,0 +1,154 @@
+#pragma once
+#include "gaia/config/config.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "gaia/mt/threadpool.h"
+
+namespace gaia {
+	namespace ecs {
+		//! Runtime statistics of a query or a system.
+		//! Collected only while statistics are enabled on the world.
+		//! \see World::stats_enabled(bool)
+		struct QueryStats {
+			//! Number of executions
+			uint64_t runs = 0;
+			//! Wall time spent executing, in nanoseconds
+			uint64_t timeNs = 0;
+			//! Number of chunks handed over to the callback
+			uint64_t chunks = 0;
+			//! Number of rows handed over to the callback
+			uint64_t rows = 0;
+			//! Number of rows in chunks skipped by changed filters
+			uint64_t rowsSkipped = 0;
+			//! Number of times the cached result was rebuilt
+			uint64_t cacheRebuilds = 0;
+			//! Number of archetype matching passes run by the query VM
+			uint64_t vmMatches = 0;
+		};
+
+		//! Structural operation counters of a world.
+		//! Collected only while statistics are enabled on the world.
+		//! \see World::stats_enabled(bool)
+		struct WorldStats {
+			//! Number of created entities
+			uint64_t entitiesAdded = 0;
+			//! Number of deleted entities
+			uint64_t entitiesDeleted = 0;
+			//! Number of entities moved to a different archetype
+			uint64_t archetypeMoves = 0;
+			//! Number of allocated chunks
+			uint64_t chunksAllocated = 0;
+			//! Number of released chunks
+			uint64_t chunksFreed = 0;
+			//! Number of committed command buffer operations
+			uint64_t cmdBufferOps = 0;
+		};
+
+		namespace detail {
+			enum class QueryStat : uint32_t { Runs, TimeNs, Chunks, Rows, RowsSkipped, Count };
+			enum class WorldStat : uint32_t { EntitiesAdded, EntitiesDeleted, ArchetypeMoves, ChunksAllocated, ChunksFreed, CmdBufferOps, Count };
+
+			GAIA_MSVC_WARNING_PUSH()
+			GAIA_MSVC_WARNING_DISABLE(4324)
+
+			//! Counters spread over per-thread slots.
+			//! Each worker thread of the job system bumps a slot of its own so counting does not make cache lines
+			//! bounce between threads. Any other thread uses a shared slot. Totals are summed up on demand.
+			//! \tparam N Number of counters
+			template <uint32_t N>
+			class StatsSlots {
+				static constexpr uint32_t SlotCnt = mt::ThreadPool::MaxWorkers + 1;
+
+				struct GAIA_ALIGNAS(64) Slot {
+					std::atomic<uint64_t> values[N];
+				};
+
+				Slot m_slots[SlotCnt];
+
+				GAIA_NODISCARD static uint32_t slot_idx() {
+					const auto* pCtx = mt::detail::tl_workerCtx;
+					return pCtx != nullptr ? pCtx->workerIdx : SlotCnt - 1;
+				}
+
+			public:
+				StatsSlots() {
+					reset();
+				}
+
+				StatsSlots(const StatsSlots&) = delete;
+				StatsSlots& operator=(const StatsSlots&) = delete;
+
+				//! Adds \a value to the counter \a idx of the calling thread.
+				void add(uint32_t idx, uint64_t value) {
+					GAIA_ASSERT(idx < N);
+					m_slots[slot_idx()].values[idx].fetch_add(value, std::memory_order_relaxed);
+				}
+
+				//! Returns the counter \a idx summed over all threads.
+				GAIA_NODISCARD uint64_t sum(uint32_t idx) const {
+					GAIA_ASSERT(idx < N);
+					uint64_t total = 0;
+					for (const auto& slot: m_slots)
+						total += slot.values[idx].load(std::memory_order_relaxed);
+					return total;
+				}
+
+				//! Sets all counters to zero.
+				void reset() {
+					for (auto& slot: m_slots) {
+						for (auto& value: slot.values)
+							value.store(0, std::memory_order_relaxed);
+					}
+				}
+			};
+
+			GAIA_MSVC_WARNING_POP()
+
+			using QueryStatsSlots = StatsSlots<(uint32_t)QueryStat::Count>;
+			using WorldStatsSlots = StatsSlots<(uint32_t)WorldStat::Count>;
+
+			//! Statistics slots of the query executed by the current thread, nullptr when nothing is collected.
+			inline thread_local QueryStatsSlots* tl_pQueryStats = nullptr;
+
+			//! Adds \a value to the counter \a stat of the query executed by the current thread.
+			inline void query_stats_add(QueryStat stat, uint64_t value) {
+				auto* pStats = tl_pQueryStats;
+				if GAIA_UNLIKELY (pStats != nullptr)
+					pStats->add((uint32_t)stat, value);
+			}
+
+			//! Makes \a pStats the statistics target of the current thread for the lifetime of the scope and
+			//! records one execution and the time spent in the scope into it.
+			//! A scope with nullptr suspends collection, e.g. while the thread helps with jobs of a parallel query
+			//! whose work has already been accounted for.
+			class QueryStatsScope {
+				QueryStatsSlots* m_pPrev;
+				QueryStatsSlots* m_pStats;
+				std::chrono::steady_clock::time_point m_start{};
+
+			public:
+				explicit QueryStatsScope(QueryStatsSlots* pStats): m_pPrev(tl_pQueryStats), m_pStats(pStats) {
+					tl_pQueryStats = pStats;
+					if GAIA_UNLIKELY (pStats != nullptr)
+						m_start = std::chrono::steady_clock::now();
+				}
+
+				~QueryStatsScope() {
+					if GAIA_UNLIKELY (m_pStats != nullptr) {
+						const auto end = std::chrono::steady_clock::now();
+						const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - m_start).count();
+						m_pStats->add((uint32_t)QueryStat::Runs, 1);
+						m_pStats->add((uint32_t)QueryStat::TimeNs, (uint64_t)ns);
+					}
+					tl_pQueryStats = m_pPrev;
+				}
+
+				QueryStatsScope(const QueryStatsScope&) = delete;
+				QueryStatsScope& operator=(const QueryStatsScope&) = delete;
+			};
+		} // namespace detail
+	} // namespace ecs
+} // namespace gaia
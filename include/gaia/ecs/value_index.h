@@ -0,0 +1,761 @@
+#pragma once
+#include "gaia/config/config.h"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "gaia/cnt/darray.h"
+#include "gaia/cnt/map.h"
+#include "gaia/config/profiler.h"
+#include "gaia/core/utility.h"
+#include "gaia/ecs/chunk_row_set.h"
+#include "gaia/ecs/world.h"
+#include "gaia/ser/ser_common.h"
+
+namespace gaia {
+	namespace ecs {
+		//! Value a ValueCond compares field values with
+		struct ValueArg {
+			//! Integer value. Unsigned values are stored as their bit pattern.
+			int64_t i = 0;
+			//! Floating-point value
+			double f = 0.0;
+			//! True if the value was given as a floating-point number
+			bool isFloat = false;
+
+			template <typename V>
+			GAIA_NODISCARD static ValueArg make(V value) {
+				static_assert(std::is_arithmetic_v<V> || std::is_enum_v<V>);
+				ValueArg arg;
+				if constexpr (std::is_floating_point_v<V>) {
+					arg.f = (double)value;
+					arg.i = (int64_t)value;
+					arg.isFloat = true;
+				} else {
+					arg.i = (int64_t)value;
+					arg.f = (double)value;
+				}
+				return arg;
+			}
+		};
+
+		//! Condition on the value of a field indexed by ValueIndex
+		struct ValueCond {
+			enum class Op : uint8_t { Eq, Lt, Le, Gt, Ge, Between };
+
+			//! Comparison
+			Op op;
+			//! Value to compare with. The lower bound for Between.
+			ValueArg a;
+			//! Upper bound for Between
+			ValueArg b;
+		};
+
+		//! Matches values equal to \a value.
+		template <typename V>
+		GAIA_NODISCARD inline ValueCond eq(V value) {
+			return {ValueCond::Op::Eq, ValueArg::make(value), {}};
+		}
+		//! Matches values smaller than \a value.
+		template <typename V>
+		GAIA_NODISCARD inline ValueCond lt(V value) {
+			return {ValueCond::Op::Lt, ValueArg::make(value), {}};
+		}
+		//! Matches values smaller than or equal to \a value.
+		template <typename V>
+		GAIA_NODISCARD inline ValueCond le(V value) {
+			return {ValueCond::Op::Le, ValueArg::make(value), {}};
+		}
+		//! Matches values greater than \a value.
+		template <typename V>
+		GAIA_NODISCARD inline ValueCond gt(V value) {
+			return {ValueCond::Op::Gt, ValueArg::make(value), {}};
+		}
+		//! Matches values greater than or equal to \a value.
+		template <typename V>
+		GAIA_NODISCARD inline ValueCond ge(V value) {
+			return {ValueCond::Op::Ge, ValueArg::make(value), {}};
+		}
+		//! Matches values in the range [\a lo, \a hi].
+		template <typename V>
+		GAIA_NODISCARD inline ValueCond between(V lo, V hi) {
+			return {ValueCond::Op::Between, ValueArg::make(lo), ValueArg::make(hi)};
+		}
+
+		//! Secondary index over a scalar field of a component. Finds entities whose field value satisfies
+		//! a ValueCond without scanning the world.
+		//! The index is brought up-to-date lazily before each lookup. Only chunks whose component column was written to
+		//! or whose entities changed since the previous update are visited, and only entities whose value changed are
+		//! re-indexed. This covers set, modify, mutable query views and anything else going through OnSet.
+		//! A sorted index applies small batches of changes in place. Larger ones are sorted and merged with it
+		//! in one pass. The index is rebuilt from scratch when most of it changed.
+		//! Disabled entities are not indexed. Only components with the AoS layout are supported.
+		//! Instances are owned by the world. See World::value_index.
+		class ValueIndex final {
+			//! Location of an entity in a hash bucket
+			struct Loc {
+				//! Index of the chunk slot
+				uint32_t slot;
+				//! Row of the entity in the chunk
+				uint16_t row;
+			};
+
+			struct Bucket {
+				//! Encoded value
+				uint64_t key;
+				//! Entities with the value
+				cnt::darray<Loc> locs;
+			};
+
+			//! Entity in the sorted index. Ordered by key and then by loc.
+			struct Entry {
+				//! Encoded value
+				uint64_t key;
+				//! Chunk slot index << 16 | row
+				uint64_t loc;
+
+				GAIA_NODISCARD bool operator<(const Entry& other) const {
+					return key < other.key || (key == other.key && loc < other.loc);
+				}
+				GAIA_NODISCARD bool operator==(const Entry& other) const {
+					return key == other.key && loc == other.loc;
+				}
+			};
+
+			struct Block {
+				cnt::darray<Entry> entries;
+			};
+
+			//! Indexing data of a chunk
+			struct ChunkSlot {
+				//! Archetype of the chunk
+				const Archetype* pArchetype = nullptr;
+				//! Chunk. Nullptr for unused slots.
+				Chunk* pChunk = nullptr;
+				//! Value of m_updates when the chunk was last seen
+				uint32_t seen = 0;
+				//! Encoded value of each row
+				cnt::darray<uint64_t> keys;
+				//! Index of each row in its hash bucket. Zero for rows in the sorted index. BadIndex for rows not indexed.
+				cnt::darray<uint32_t> refs;
+			};
+
+			//! Max number of entries in a block of the sorted index
+			static constexpr uint32_t MaxBlockSize = 512;
+			//! Sorted index is rebuilt when more than 1/RebuildRatio of its entries change at once.
+			//! An in-place change costs about as much as moving a few hundred entries during a rebuild.
+			static constexpr uint32_t RebuildRatio = 128;
+			static constexpr uint64_t SignBit = 1ULL << 63;
+
+			World& m_world;
+			//! Query matching everything with the component
+			Query m_query;
+			//! Component
+			Entity m_comp;
+			//! Size of the component
+			uint32_t m_compSize;
+			//! Offset of the field in the component
+			uint32_t m_offset;
+			//! Type of the field
+			ser::serialization_type_id m_type;
+			//! Kind of the index
+			ValueIndexKind m_kind;
+			//! Encoded value -> index of its bucket in m_buckets
+			cnt::map<uint64_t, uint32_t> m_bucketMap;
+			//! Hash buckets
+			cnt::darray<Bucket> m_buckets;
+			//! Blocks of the sorted index
+			cnt::darray<Block> m_blocks;
+			//! Entries removed from the sorted index during the running update
+			cnt::darray<Entry> m_dels;
+			//! Entries added to the sorted index during the running update
+			cnt::darray<Entry> m_adds;
+			//! Chunk slots
+			cnt::darray<ChunkSlot> m_slots;
+			//! Unused chunk slots
+			cnt::darray<uint32_t> m_freeSlots;
+			//! Chunk -> index of its slot
+			cnt::map<const Chunk*, uint32_t> m_chunkToSlot;
+			//! Rows found by the running lookup
+			detail::ChunkRowSet m_hits;
+			//! Scratch buffer of ranges
+			cnt::darray<ChunkRange> m_ranges;
+			//! Number of updates done so far
+			uint32_t m_updates = 0;
+			//! World version of the last update
+			uint32_t m_version = 0;
+			//! Number of indexed entities
+			uint32_t m_live = 0;
+
+		public:
+			//! Creates an index over a field of component \a comp.
+			//! \param world World the entities live in
+			//! \param comp Component
+			//! \param offset Offset of the field in the component
+			//! \param type Type of the field. Integers, bool, characters, float and double are supported.
+			//! \param kind Kind of the index
+			ValueIndex(World& world, Entity comp, uint32_t offset, ser::serialization_type_id type, ValueIndexKind kind):
+					m_world(world), m_query(world.query().all(comp)), m_comp(comp),
+					m_compSize(world.comp_cache().get(comp).comp.size()), m_offset(offset), m_type(type), m_kind(kind) {
+				GAIA_ASSERT(world.comp_cache().get(comp).comp.soa() == 0 && "SoA components are not supported");
+				GAIA_ASSERT(
+						component_uses_table_storage(world.comp_cache().get(comp).comp) && "Sparse components are not supported");
+				GAIA_ASSERT(type_size(type) != 0 && "Unsupported field type");
+				GAIA_ASSERT(offset + type_size(type) <= m_compSize);
+			}
+
+			ValueIndex(const ValueIndex&) = delete;
+			ValueIndex& operator=(const ValueIndex&) = delete;
+			ValueIndex(ValueIndex&&) = delete;
+			ValueIndex& operator=(ValueIndex&&) = delete;
+
+			//! Returns the indexed component.
+			GAIA_NODISCARD Entity comp() const {
+				return m_comp;
+			}
+
+			//! Returns the offset of the indexed field in the component.
+			GAIA_NODISCARD uint32_t offset() const {
+				return m_offset;
+			}
+
+			//! Returns the kind of the index.
+			GAIA_NODISCARD ValueIndexKind kind() const {
+				return m_kind;
+			}
+
+			//! Returns the number of indexed entities as of the last update.
+			GAIA_NODISCARD uint32_t size() const {
+				return m_live;
+			}
+
+			//! Returns the size of a field of type \a type in bytes. Zero for types the index does not support.
+			GAIA_NODISCARD static uint32_t type_size(ser::serialization_type_id type) {
+				switch (type) {
+					case ser::serialization_type_id::s8:
+					case ser::serialization_type_id::u8:
+					case ser::serialization_type_id::b:
+					case ser::serialization_type_id::c8:
+						return 1;
+					case ser::serialization_type_id::s16:
+					case ser::serialization_type_id::u16:
+					case ser::serialization_type_id::c16:
+						return 2;
+					case ser::serialization_type_id::s32:
+					case ser::serialization_type_id::u32:
+					case ser::serialization_type_id::c32:
+					case ser::serialization_type_id::f32:
+						return 4;
+					case ser::serialization_type_id::s64:
+					case ser::serialization_type_id::u64:
+					case ser::serialization_type_id::f64:
+						return 8;
+					default:
+						return 0;
+				}
+			}
+
+			//! Brings the index up-to-date with the world. Called automatically by lookups.
+			void update() {
+				GAIA_PROF_SCOPE(ValueIndex::update);
+
+				++m_updates;
+				m_query.each([&](Iter& it) {
+					auto* pChunk = const_cast<Chunk*>(it.chunk());
+					auto slotIdx = BadIndex;
+					bool isNew = false;
+					const auto itSlot = m_chunkToSlot.find(pChunk);
+					if (itSlot != m_chunkToSlot.end())
+						slotIdx = itSlot->second;
+					else {
+						slotIdx = add_slot(it.archetype(), pChunk);
+						isNew = true;
+					}
+
+					auto& slot = m_slots[slotIdx];
+					slot.seen = m_updates;
+					// Chunks are recycled so the same address might now hold a chunk with more rows
+					const auto cap = (uint32_t)pChunk->capacity();
+					if (slot.keys.size() < cap) {
+						slot.keys.resize(cap, 0);
+						slot.refs.resize(cap, BadIndex);
+						m_hits.reserve(slotIdx, cap);
+					}
+
+					// Structural changes invalidate all rows. Rows whose data did not change keep their entries.
+					const auto compIdx = pChunk->comp_idx(m_comp);
+					const bool orderChanged = isNew || pChunk->entity_order_changed(m_version);
+					if (!orderChanged && !pChunk->changed(m_version, compIdx))
+						return;
+					if (orderChanged)
+						del_rows(slotIdx);
+
+					const auto* pData = pChunk->comp_ptr(compIdx) + m_offset;
+					const auto rowEnd = it.row_end();
+					for (auto row = it.row_begin(); row < rowEnd; ++row) {
+						const auto key = key_of(pData + (size_t)row * m_compSize);
+						if (slot.refs[row] != BadIndex) {
+							if (slot.keys[row] == key)
+								continue;
+							del_row(slotIdx, (uint16_t)row);
+						}
+						add_row(slotIdx, (uint16_t)row, key);
+					}
+				});
+
+				// Chunks no longer around or without any enabled entities
+				GAIA_EACH(m_slots) {
+					auto& slot = m_slots[i];
+					if (slot.pChunk == nullptr || slot.seen == m_updates)
+						continue;
+
+					del_rows(i);
+					m_chunkToSlot.erase(slot.pChunk);
+					slot.pChunk = nullptr;
+					m_freeSlots.push_back(i);
+				}
+
+				if (m_kind == ValueIndexKind::Sorted)
+					apply_sorted_changes();
+
+				// Writes from now on get a newer version than the one the index is in sync with
+				auto& worldVersion = m_world.world_version();
+				m_version = worldVersion;
+				update_version(worldVersion);
+			}
+
+			//! Finds entities whose field value satisfies \a cond and returns them as ranges of chunk rows.
+			//! Ranges of the same chunk come one after another ordered by row. Neighbouring rows are merged into
+			//! a single range. Ranges are valid only until the next structural change of the world.
+			//! \param cond Condition
+			//! \param[out] out Ranges of rows of matching entities
+			void ranges(const ValueCond& cond, cnt::darray<ChunkRange>& out) {
+				GAIA_PROF_SCOPE(ValueIndex::ranges);
+
+				update();
+				out.clear();
+
+				uint64_t lo = 0;
+				uint64_t hi = 0;
+				if (!key_range(cond, lo, hi))
+					return;
+
+				if (m_kind == ValueIndexKind::Hash) {
+					if (lo == hi) {
+						const auto it = m_bucketMap.find(lo);
+						if (it != m_bucketMap.end())
+							collect(m_buckets[it->second]);
+					} else {
+						for (const auto& bucket: m_buckets) {
+							if (bucket.key >= lo && bucket.key <= hi)
+								collect(bucket);
+						}
+					}
+				} else {
+					auto blockIdx = find_block({lo, 0});
+					for (; blockIdx < m_blocks.size(); ++blockIdx) {
+						const auto& entries = m_blocks[blockIdx].entries;
+						auto entryIdx = lower_bound(entries, {lo, 0});
+						for (; entryIdx < entries.size(); ++entryIdx) {
+							const auto& e = entries[entryIdx];
+							if (e.key > hi)
+								break;
+							m_hits.add((uint32_t)(e.loc >> 16), (uint16_t)(e.loc & 0xFFFF));
+						}
+						if (entryIdx < entries.size())
+							break;
+					}
+				}
+
+				m_hits.flush(out, [&](uint32_t slotIdx) {
+					const auto& slot = m_slots[slotIdx];
+					return ChunkRange{slot.pArchetype, slot.pChunk, 0, 0};
+				});
+			}
+
+			//! Runs \a query over entities whose field value satisfies \a cond.
+			//! \param query Query to run. Entities not matching it are skipped.
+			//! \param cond Condition
+			//! \param func Function called as func(Iter&) for each range of entities
+			template <typename Func>
+			void each(Query& query, const ValueCond& cond, Func func) {
+				ranges(cond, m_ranges);
+				query.each(std::span<const ChunkRange>{m_ranges.data(), m_ranges.size()}, func);
+			}
+
+			//! Returns the number of entities whose field value satisfies \a cond.
+			GAIA_NODISCARD uint32_t count(const ValueCond& cond) {
+				ranges(cond, m_ranges);
+				uint32_t cnt = 0;
+				for (const auto& r: m_ranges)
+					cnt += (uint32_t)(r.to - r.from);
+				return cnt;
+			}
+
+		private:
+			//! Encodes a double so encoded values compare the same way the doubles do.
+			GAIA_NODISCARD static uint64_t key_of_double(double value) {
+				// -0 and +0 are equal
+				if (value == 0.0)
+					value = 0.0;
+				uint64_t bits;
+				memcpy(&bits, &value, sizeof(bits));
+				return (bits & SignBit) != 0 ? ~bits : bits | SignBit;
+			}
+
+			template <typename V>
+			GAIA_NODISCARD static V load(const uint8_t* pData) {
+				V value;
+				memcpy(&value, pData, sizeof(V));
+				return value;
+			}
+
+			//! Encodes the field value at \a pData so encoded values compare the same way the values do.
+			GAIA_NODISCARD uint64_t key_of(const uint8_t* pData) const {
+				switch (m_type) {
+					case ser::serialization_type_id::s8:
+						return (uint64_t)(int64_t)load<int8_t>(pData) ^ SignBit;
+					case ser::serialization_type_id::s16:
+						return (uint64_t)(int64_t)load<int16_t>(pData) ^ SignBit;
+					case ser::serialization_type_id::s32:
+						return (uint64_t)(int64_t)load<int32_t>(pData) ^ SignBit;
+					case ser::serialization_type_id::s64:
+						return (uint64_t)load<int64_t>(pData) ^ SignBit;
+					case ser::serialization_type_id::u8:
+					case ser::serialization_type_id::b:
+					case ser::serialization_type_id::c8:
+						return load<uint8_t>(pData);
+					case ser::serialization_type_id::u16:
+					case ser::serialization_type_id::c16:
+						return load<uint16_t>(pData);
+					case ser::serialization_type_id::u32:
+					case ser::serialization_type_id::c32:
+						return load<uint32_t>(pData);
+					case ser::serialization_type_id::u64:
+						return load<uint64_t>(pData);
+					case ser::serialization_type_id::f32:
+						return key_of_double((double)load<float>(pData));
+					case ser::serialization_type_id::f64:
+						return key_of_double(load<double>(pData));
+					default:
+						GAIA_ASSERT(false);
+						return 0;
+				}
+			}
+
+			//! Encodes \a arg the way values of the field are encoded.
+			GAIA_NODISCARD uint64_t key_of(const ValueArg& arg) const {
+				switch (m_type) {
+					case ser::serialization_type_id::s8:
+					case ser::serialization_type_id::s16:
+					case ser::serialization_type_id::s32:
+					case ser::serialization_type_id::s64:
+						return (uint64_t)(arg.isFloat ? (int64_t)arg.f : arg.i) ^ SignBit;
+					case ser::serialization_type_id::f32:
+						// Values are compared at the precision they are stored with
+						return key_of_double((double)(float)(arg.isFloat ? arg.f : (double)arg.i));
+					case ser::serialization_type_id::f64:
+						return key_of_double(arg.isFloat ? arg.f : (double)arg.i);
+					default:
+						return (uint64_t)(arg.isFloat ? (int64_t)arg.f : arg.i);
+				}
+			}
+
+			//! Turns \a cond into the inclusive range of encoded values [lo, hi].
+			//! \return False if no value can satisfy the condition.
+			GAIA_NODISCARD bool key_range(const ValueCond& cond, uint64_t& lo, uint64_t& hi) const {
+				const auto a = key_of(cond.a);
+				lo = 0;
+				hi = ~0ULL;
+				switch (cond.op) {
+					case ValueCond::Op::Eq:
+						lo = hi = a;
+						break;
+					case ValueCond::Op::Lt:
+						if (a == 0)
+							return false;
+						hi = a - 1;
+						break;
+					case ValueCond::Op::Le:
+						hi = a;
+						break;
+					case ValueCond::Op::Gt:
+						if (a == ~0ULL)
+							return false;
+						lo = a + 1;
+						break;
+					case ValueCond::Op::Ge:
+						lo = a;
+						break;
+					case ValueCond::Op::Between:
+						lo = a;
+						hi = key_of(cond.b);
+						break;
+				}
+				return lo <= hi;
+			}
+
+			void collect(const Bucket& bucket) {
+				for (const auto& loc: bucket.locs)
+					m_hits.add(loc.slot, loc.row);
+			}
+
+			GAIA_NODISCARD uint32_t add_slot(const Archetype* pArchetype, Chunk* pChunk) {
+				uint32_t slotIdx;
+				if (!m_freeSlots.empty()) {
+					slotIdx = m_freeSlots.back();
+					m_freeSlots.pop_back();
+				} else {
+					slotIdx = (uint32_t)m_slots.size();
+					m_slots.emplace_back();
+				}
+
+				m_slots[slotIdx].pArchetype = pArchetype;
+				m_slots[slotIdx].pChunk = pChunk;
+				m_chunkToSlot.emplace(pChunk, slotIdx);
+				return slotIdx;
+			}
+
+			void add_row(uint32_t slotIdx, uint16_t row, uint64_t key) {
+				auto& slot = m_slots[slotIdx];
+				slot.keys[row] = key;
+				++m_live;
+
+				if (m_kind == ValueIndexKind::Sorted) {
+					slot.refs[row] = 0;
+					m_adds.push_back({key, ((uint64_t)slotIdx << 16) | row});
+					return;
+				}
+
+				auto it = m_bucketMap.find(key);
+				if (it == m_bucketMap.end()) {
+					it = m_bucketMap.emplace(key, (uint32_t)m_buckets.size()).first;
+					m_buckets.push_back({key, {}});
+				}
+				auto& locs = m_buckets[it->second].locs;
+				slot.refs[row] = (uint32_t)locs.size();
+				locs.push_back({slotIdx, row});
+			}
+
+			//! Removes the entity on \a row from the index. In a hash bucket the last entity takes its place.
+			void del_row(uint32_t slotIdx, uint16_t row) {
+				auto& slot = m_slots[slotIdx];
+				const auto key = slot.keys[row];
+				const auto refIdx = slot.refs[row];
+				slot.refs[row] = BadIndex;
+				--m_live;
+
+				if (m_kind == ValueIndexKind::Sorted) {
+					m_dels.push_back({key, ((uint64_t)slotIdx << 16) | row});
+					return;
+				}
+
+				const auto itBucket = m_bucketMap.find(key);
+				const auto bucketIdx = itBucket->second;
+				auto& locs = m_buckets[bucketIdx].locs;
+				const auto last = locs.back();
+				if (last.slot != slotIdx || last.row != row)
+					m_slots[last.slot].refs[last.row] = refIdx;
+				locs[refIdx] = last;
+				locs.pop_back();
+				if (!locs.empty())
+					return;
+
+				// Drop empty buckets so values that keep changing do not pile up. The last bucket takes the place.
+				m_bucketMap.erase(itBucket);
+				const auto lastBucketIdx = (uint32_t)m_buckets.size() - 1;
+				if (bucketIdx != lastBucketIdx) {
+					m_buckets[bucketIdx] = GAIA_MOV(m_buckets[lastBucketIdx]);
+					m_bucketMap[m_buckets[bucketIdx].key] = bucketIdx;
+				}
+				m_buckets.pop_back();
+			}
+
+			//! Removes all entities of slot \a slotIdx from the index.
+			void del_rows(uint32_t slotIdx) {
+				auto& slot = m_slots[slotIdx];
+				GAIA_EACH(slot.refs) {
+					if (slot.refs[i] != BadIndex)
+						del_row(slotIdx, (uint16_t)i);
+				}
+			}
+
+			//! Returns the index of the first entry in \a entries not smaller than \a e.
+			GAIA_NODISCARD static uint32_t lower_bound(const cnt::darray<Entry>& entries, const Entry& e) {
+				uint32_t lo = 0;
+				uint32_t hi = (uint32_t)entries.size();
+				while (lo < hi) {
+					const auto mid = (lo + hi) / 2;
+					if (entries[mid] < e)
+						lo = mid + 1;
+					else
+						hi = mid;
+				}
+				return lo;
+			}
+
+			//! Returns the index of the block \a e belongs to.
+			GAIA_NODISCARD uint32_t find_block(const Entry& e) const {
+				// Last block whose first entry is not greater than e
+				uint32_t lo = 0;
+				uint32_t hi = (uint32_t)m_blocks.size();
+				while (lo < hi) {
+					const auto mid = (lo + hi) / 2;
+					if (e < m_blocks[mid].entries[0])
+						hi = mid;
+					else
+						lo = mid + 1;
+				}
+				return lo > 0 ? lo - 1 : 0;
+			}
+
+			void sorted_insert(const Entry& e) {
+				if (m_blocks.empty())
+					m_blocks.emplace_back();
+
+				const auto blockIdx = find_block(e);
+				auto& entries = m_blocks[blockIdx].entries;
+				const auto entryIdx = lower_bound(entries, e);
+				entries.push_back(e);
+				for (auto i = (uint32_t)entries.size() - 1; i > entryIdx; --i)
+					entries[i] = entries[i - 1];
+				entries[entryIdx] = e;
+				if (entries.size() <= MaxBlockSize)
+					return;
+
+				// Split full blocks in halves
+				Block block;
+				const auto half = (uint32_t)entries.size() / 2;
+				block.entries.reserve(MaxBlockSize);
+				for (uint32_t i = half; i < entries.size(); ++i)
+					block.entries.push_back(entries[i]);
+				entries.resize(half);
+				m_blocks.push_back(GAIA_MOV(block));
+				for (auto i = (uint32_t)m_blocks.size() - 1; i > blockIdx + 1; --i)
+					core::swap(m_blocks[i], m_blocks[i - 1]);
+			}
+
+			void sorted_erase(const Entry& e) {
+				const auto blockIdx = find_block(e);
+				auto& entries = m_blocks[blockIdx].entries;
+				const auto entryIdx = lower_bound(entries, e);
+				GAIA_ASSERT(entryIdx < entries.size() && entries[entryIdx] == e);
+				entries.erase(entries.begin() + entryIdx);
+				if (entries.empty())
+					m_blocks.erase(m_blocks.begin() + blockIdx);
+			}
+
+			//! Applies changes collected by the running update to the sorted index.
+			void apply_sorted_changes() {
+				if (m_dels.empty() && m_adds.empty())
+					return;
+
+				const auto changes = (uint32_t)(m_dels.size() + m_adds.size());
+				if (changes <= m_live / RebuildRatio) {
+					for (const auto& e: m_dels)
+						sorted_erase(e);
+					for (const auto& e: m_adds)
+						sorted_insert(e);
+				} else if (changes < m_live)
+					merge_sorted();
+				else
+					rebuild_sorted();
+
+				m_dels.clear();
+				m_adds.clear();
+			}
+
+			//! Adds \a e to the end of \a blocks. Blocks are filled only halfway to leave room for inserts.
+			static void push_sorted(cnt::darray<Block>& blocks, const Entry& e) {
+				constexpr uint32_t BlockFill = MaxBlockSize / 2;
+				if (blocks.empty() || blocks.back().entries.size() == BlockFill) {
+					auto& block = blocks.emplace_back();
+					block.entries.reserve(MaxBlockSize);
+				}
+				blocks.back().entries.push_back(e);
+			}
+
+			//! Builds the sorted index from scratch.
+			void rebuild_sorted() {
+				GAIA_PROF_SCOPE(ValueIndex::rebuild_sorted);
+
+				cnt::darray<Entry> all;
+				all.reserve(m_live);
+				GAIA_EACH_(m_slots, slotIdx) {
+					const auto& slot = m_slots[slotIdx];
+					if (slot.pChunk == nullptr)
+						continue;
+					GAIA_EACH_(slot.refs, row) {
+						if (slot.refs[row] != BadIndex)
+							all.push_back({slot.keys[row], ((uint64_t)slotIdx << 16) | row});
+					}
+				}
+				core::sort(all, core::is_smaller<Entry>());
+
+				m_blocks.clear();
+				for (const auto& e: all)
+					push_sorted(m_blocks, e);
+			}
+
+			//! Rebuilds the sorted index by merging sorted changes with its current entries.
+			void merge_sorted() {
+				GAIA_PROF_SCOPE(ValueIndex::merge_sorted);
+
+				core::sort(m_dels, core::is_smaller<Entry>());
+				core::sort(m_adds, core::is_smaller<Entry>());
+
+				cnt::darray<Block> blocks;
+				blocks.reserve(m_live / (MaxBlockSize / 2) + 1);
+
+				uint32_t delIdx = 0;
+				uint32_t addIdx = 0;
+				for (const auto& block: m_blocks) {
+					for (const auto& e: block.entries) {
+						// Both are sorted and every deleted entry is present so a single pass is enough
+						if (delIdx < m_dels.size() && m_dels[delIdx] == e) {
+							++delIdx;
+							continue;
+						}
+						while (addIdx < m_adds.size() && m_adds[addIdx] < e)
+							push_sorted(blocks, m_adds[addIdx++]);
+						push_sorted(blocks, e);
+					}
+				}
+				GAIA_ASSERT(delIdx == m_dels.size());
+				while (addIdx < m_adds.size())
+					push_sorted(blocks, m_adds[addIdx++]);
+
+				m_blocks = GAIA_MOV(blocks);
+			}
+		};
+
+		inline ValueIndex& World::value_index_inter(
+				Entity comp, uint32_t offset, ser::serialization_type_id type, ValueIndexKind kind) {
+			for (auto* pIndex: m_valueIndices) {
+				if (pIndex->comp() == comp && pIndex->offset() == offset && pIndex->kind() == kind)
+					return *pIndex;
+			}
+
+			auto* pIndex = new ValueIndex(*this, comp, offset, type, kind);
+			m_valueIndices.push_back(pIndex);
+			return *pIndex;
+		}
+
+		inline ValueIndex& World::value_index(Entity comp, util::str_view field, ValueIndexKind kind) {
+			const auto* pField = comp_cache().get(comp).field(field);
+			GAIA_ASSERT(pField != nullptr && "Field not found in the runtime schema of the component");
+			GAIA_ASSERT(pField->count == 0 && "Only scalar fields can be indexed");
+
+			ser::serialization_type_id type{};
+			const bool isPrimitive = runtime_primitive_serialization_type(pField->type, type);
+			GAIA_ASSERT(isPrimitive && "Only primitive fields can be indexed");
+			(void)isPrimitive;
+			return value_index_inter(comp, pField->offset, type, kind);
+		}
+
+		inline void value_index_destroy(ValueIndex& index) {
+			delete &index;
+		}
+	} // namespace ecs
+} // namespace gaia
@@ -278,6 +278,8 @@ namespace gaia {
 						EOpcode sourceOpcode = EOpcode::Src_Never;
 						QueryTerm term{};
 						uint8_t varMask = 0;
+						//! Bindings the term was estimated to yield when the search program was last ordered
+						uint32_t card = 0;
 					};
 
 					struct VarProgram {
@@ -1502,6 +1504,70 @@ namespace gaia {
 								 !is_variable((EntityId)queryId.gen()) && queryId.gen() != All.id();
 				}
 
+				//! Bindings assumed for variable terms the world keeps no statistics for.
+				inline constexpr uint32_t VarTermCardUnknown = 16;
+
+				//! Returns true when the search can enter \a termOp by enumerating candidates for its variable source.
+				GAIA_NODISCARD inline bool var_term_binds_src(const QueryCompileCtx::VarTermOp& termOp) {
+					return is_var_entity(termOp.term.src) &&
+								 termOp.varMask == (uint8_t)(uint8_t(1) << var_index(termOp.term.src));
+				}
+
+				//! Estimates how many bindings entering \a termOp yields using live world statistics.
+				//! Terms binding their variable source enumerate every entity with the term id. Other terms enumerate
+				//! the matching ids of a single archetype, so the average match count per archetype is used.
+				//! \param w World providing the statistics.
+				//! \param termOp Variable term to estimate.
+				//! \return Estimated number of bindings. Zero when nothing in the world can match the term.
+				GAIA_NODISCARD inline uint32_t var_term_card(const World& w, const QueryCompileCtx::VarTermOp& termOp) {
+					const auto queryId = termOp.term.id;
+					if (var_term_binds_src(termOp))
+						return has_concrete_match_id(queryId) ? world_count_direct_term_entities(w, queryId) : VarTermCardUnknown;
+
+					if (!queryId.pair())
+						return is_var_entity(queryId) ? VarTermCardUnknown : 1u;
+
+					const auto queryRel = pair_rel(w, queryId);
+					const auto queryTgt = pair_tgt(w, queryId);
+					if (queryRel == EntityBad || queryTgt == EntityBad)
+						return VarTermCardUnknown;
+
+					const bool relIsConcrete = !is_var_entity(queryRel) && queryRel.id() != All.id();
+					const bool tgtIsConcrete = !is_var_entity(queryTgt) && queryTgt.id() != All.id();
+					if (relIsConcrete && tgtIsConcrete)
+						return 1u;
+					// Non-fragmenting relations are exclusive, each source has exactly one target
+					if (relIsConcrete && world_relation_uses_non_fragmenting_storage(w, queryRel))
+						return 1u;
+
+					const auto key = Pair(relIsConcrete ? queryRel : All, tgtIsConcrete ? queryTgt : All);
+					const auto archetypeCnt = world_component_index_bucket_size(w, key);
+					if (archetypeCnt == 0)
+						return 0;
+
+					return (world_component_index_match_total(w, key) + archetypeCnt - 1) / archetypeCnt;
+				}
+
+				//! Search cost of a variable term ordered by its cardinality estimate.
+				//! Every doubling of the estimate costs as much as one variable token in the term id. Terms binding their
+				//! variable source are charged by the number of candidate sources instead of the flat source penalty.
+				GAIA_NODISCARD inline uint8_t planned_search_term_cost(const QueryCompileCtx::VarTermOp& termOp) {
+					uint32_t cost = var_term_binds_src(termOp) ? (uint32_t)bound_term_cost(termOp) + 8u
+																										 : (uint32_t)search_term_cost(termOp);
+					for (auto card = termOp.card; card != 0; card >>= 1)
+						cost += 2u;
+
+					return cost < 0xFFu ? (uint8_t)cost : (uint8_t)0xFFu;
+				}
+
+				//! Returns true when \a card moved far enough from \a cardPrev that the search order might change.
+				GAIA_NODISCARD inline bool var_term_card_drifted(uint32_t cardPrev, uint32_t card) {
+					constexpr uint32_t DriftSlack = 8;
+					const auto lo = core::get_min(cardPrev, card);
+					const auto hi = core::get_max(cardPrev, card);
+					return hi > lo * 2u + DriftSlack;
+				}
+
 				GAIA_NODISCARD inline bool
 				match_id_bound(const World& w, const Archetype& archetype, Entity queryId, const VarBindings& vars) {
 					auto archetypeIds = archetype.ids_view();
@@ -2558,6 +2624,8 @@ namespace gaia {
 						add_cstr(out, opcode_name(terms[i].sourceOpcode));
 						out.append(" id=");
 						add_term_expr(out, world, terms[i].term);
+						out.append(" card=");
+						add_uint(out, terms[i].card);
 						out.append('\n');
 					}
 				}
@@ -3106,7 +3174,8 @@ namespace gaia {
 									if (select_next_pending_search_all_term(
 													programOps, search, state.pendingAllMask, state.vars, nextAllLocalIdx, nextAllPc)) {
 										const auto bindPc = (uint32_t)search.allBegin + nextAllLocalIdx;
-										if (nextAllPc != bindPc) {
+										// Source bindings can't be probed per archetype. Enter them when the plan orders them first.
+										if (nextAllPc != bindPc || programOps[bindPc].opcode == EOpcode::Var_Term_All_Src_Bind) {
 											state.termOpIdx = (uint8_t)nextAllLocalIdx;
 											state.pc = (uint16_t)nextAllPc;
 											break;
@@ -3803,6 +3872,42 @@ namespace gaia {
 					detail::sort_src_terms_by_cost(m_compCtx.terms_or_src);
 					detail::sort_src_terms_by_cost(m_compCtx.terms_not_src);
 
+					create_opcodes(queryCtx);
+					build_var_search_program(world);
+				}
+
+				//! Returns true when live world statistics drifted far enough from those the variable search program
+				//! was ordered by that re-planning it may pick a different order.
+				//! \param world World providing the statistics.
+				GAIA_NODISCARD bool stats_drifted(const World& world) const {
+					auto drifted = [&](const cnt::sarray_ext<detail::QueryCompileCtx::VarTermOp, MAX_ITEMS_IN_QUERY>& terms) {
+						for (const auto& termOp: terms) {
+							if (detail::var_term_card_drifted(termOp.card, detail::var_term_card(world, termOp)))
+								return true;
+						}
+						return false;
+					};
+
+					return drifted(m_compCtx.terms_all_var) || drifted(m_compCtx.terms_or_var) ||
+								 drifted(m_compCtx.terms_any_var);
+				}
+
+				//! Orders the variable search program by live world statistics and appends it after the main opcodes.
+				//! Replaces any search program built before.
+				//! \param world World providing the cardinality estimates.
+				void build_var_search_program(const World& world) {
+					GAIA_PROF_SCOPE(vm::build_var_search_program);
+
+					m_compCtx.ops.resize(m_compCtx.mainOpsCount);
+					m_compCtx.var_programs.clear();
+
+					for (auto& termOp: m_compCtx.terms_all_var)
+						termOp.card = detail::var_term_card(world, termOp);
+					for (auto& termOp: m_compCtx.terms_or_var)
+						termOp.card = detail::var_term_card(world, termOp);
+					for (auto& termOp: m_compCtx.terms_any_var)
+						termOp.card = detail::var_term_card(world, termOp);
+
 					constexpr uint32_t VarSearchProgramOpCapacity = MAX_ITEMS_IN_QUERY * 3u + 8u;
 					cnt::sarray_ext<detail::CompiledOp, VarSearchProgramOpCapacity> varSearchProgramOps;
 					detail::QueryCompileCtx::VarSearchMeta varSearchMeta{};
@@ -3821,7 +3926,7 @@ namespace gaia {
 
 						const auto allVarCnt = (uint32_t)m_compCtx.terms_all_var.size();
 						GAIA_FOR(allVarCnt) {
-							const auto cost = detail::search_term_cost(m_compCtx.terms_all_var[i]);
+							const auto cost = detail::planned_search_term_cost(m_compCtx.terms_all_var[i]);
 							const auto srcVarBit =
 									detail::is_var_entity(m_compCtx.terms_all_var[i].term.src)
 											? (uint8_t)(uint8_t(1) << detail::var_index(m_compCtx.terms_all_var[i].term.src))
@@ -3851,14 +3956,15 @@ namespace gaia {
 											? detail::EOpcode::Var_Term_All_Src_Bind
 											: detail::EOpcode::Var_Term_All_Bind;
 							searchAllBindOps.push_back({opcode, 0, 0, (uint8_t)i, cost});
-							searchAllCheckOps.push_back({detail::EOpcode::Var_Term_All_Check, 0, 0, (uint8_t)i, cost});
 						}
 						detail::sort_program_ops_by_cost(searchAllBindOps);
-						detail::sort_program_ops_by_cost(searchAllCheckOps);
+						// The search addresses bind and check ops by the same local index so they need to share the order
+						for (const auto& op: searchAllBindOps)
+							searchAllCheckOps.push_back({detail::EOpcode::Var_Term_All_Check, 0, 0, op.arg, op.cost});
 
 						const auto orVarCnt = (uint32_t)m_compCtx.terms_or_var.size();
 						GAIA_FOR(orVarCnt) {
-							const auto cost = detail::search_term_cost(m_compCtx.terms_or_var[i]);
+							const auto cost = detail::planned_search_term_cost(m_compCtx.terms_or_var[i]);
 							searchOrBindOps.push_back({detail::EOpcode::Var_Term_Or_Bind, 0, 0, (uint8_t)i, cost});
 							searchOrCheckOps.push_back({detail::EOpcode::Var_Term_Or_Check, 0, 0, (uint8_t)i, cost});
 							finalOrCheckOps.push_back({detail::EOpcode::Var_Final_Or_Check, 0, 0, (uint8_t)i, cost});
@@ -3870,7 +3976,7 @@ namespace gaia {
 
 						const auto anyVarCnt = (uint32_t)m_compCtx.terms_any_var.size();
 						GAIA_FOR(anyVarCnt) {
-							const auto cost = detail::search_term_cost(m_compCtx.terms_any_var[i]);
+							const auto cost = detail::planned_search_term_cost(m_compCtx.terms_any_var[i]);
 							searchAnyBindOps.push_back({detail::EOpcode::Var_Term_Any_Bind, 0, 0, (uint8_t)i, cost});
 							searchAnyCheckOps.push_back({detail::EOpcode::Var_Term_Any_Check, 0, 0, (uint8_t)i, cost});
 						}
@@ -4005,8 +4111,6 @@ namespace gaia {
 						varSearchMeta.initialAnyMask = init_mask(0, varSearchMeta.anyCount);
 					};
 
-					create_opcodes(queryCtx);
-
 					init_var_search_program();
 
 					auto emit_flat_program = [&](std::span<const detail::CompiledOp> ops) {
@@ -4023,7 +4127,6 @@ namespace gaia {
 						return program;
 					};
 
-					m_compCtx.var_programs.clear();
 					if (m_compCtx.has_variable_terms()) {
 						const auto program = emit_flat_program(
 								std::span<const detail::CompiledOp>{varSearchProgramOps.data(), varSearchProgramOps.size()});
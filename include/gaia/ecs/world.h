@@ -24,6 +24,7 @@
 #include "gaia/ecs/archetype.h"
 #include "gaia/ecs/archetype_common.h"
 #include "gaia/ecs/archetype_graph.h"
+#include "gaia/ecs/change_journal.h"
 #include "gaia/ecs/chunk.h"
 #include "gaia/ecs/chunk_allocator.h"
 #include "gaia/ecs/chunk_header.h"
@@ -69,6 +70,20 @@ namespace gaia {
 		class ObserverRegistry;
 #endif
 		class World;
+		class SnapshotRing;
+		template <typename T>
+		class SpatialIndex;
+		class ValueIndex;
+
+		//! Kinds of ValueIndex
+		enum class ValueIndexKind : uint8_t {
+			//! Hash table. Fast equality lookups. Other conditions visit every distinct value.
+			Hash,
+			//! Sorted blocks of values. Equality and range lookups.
+			Sorted
+		};
+
+		void value_index_destroy(ValueIndex& index);
 
 		void world_notify_on_set_entity(World& world, Entity term, Entity entity);
 		template <typename T>
@@ -94,11 +109,13 @@ namespace gaia {
 #endif
 			friend struct ComponentGetter;
 			friend struct ComponentSetter;
+			friend class SnapshotRing;
 			friend void lock(World&);
 			friend void unlock(World&);
 			friend QueryMatchScratch& query_match_scratch_acquire(World&);
 			friend void query_match_scratch_release(World&, bool);
 			friend uint32_t world_component_index_bucket_size(const World&, Entity);
+			friend uint32_t world_component_index_match_total(const World&, Entity);
 			friend uint32_t world_component_index_comp_idx(const World&, const Archetype&, Entity);
 			friend uint32_t world_component_index_match_count(const World&, const Archetype&, Entity);
 			template <typename T>
@@ -129,6 +146,7 @@ namespace gaia {
 			using CopyIterGroupState = detail::CopyIterGroupState;
 			using PrefabChildEdge = detail::PrefabChildEdge;
 			using PrefabInstantiatePlanNode = detail::PrefabInstantiatePlanNode;
+			using PrefabInstantiateBatch = detail::PrefabInstantiateBatch;
 
 			template <
 					typename TApi, typename TValue, bool DeriveFromValue = std::is_class_v<TValue> && !std::is_final_v<TValue>>
@@ -634,6 +652,22 @@ namespace gaia {
 			//! Observers
 			ObserverRegistry m_observers;
 #endif
+			//! Log of changes for replication
+			ChangeJournal m_journal;
+
+			//! Spatial index owned by the world
+			struct SpatialIndexRec {
+				//! Component the index is built over
+				Entity comp;
+				//! Type-erased SpatialIndex
+				void* pIndex;
+				//! Destroys the index
+				void (*funcDel)(void*);
+			};
+			//! Spatial indices
+			cnt::darray<SpatialIndexRec> m_spatialIndices;
+			//! Value indices
+			cnt::darray<ValueIndex*> m_valueIndices;
 
 #if GAIA_SYSTEMS_ENABLED
 			//! System runtime payload kept outside ECS component storage.
@@ -644,6 +678,9 @@ namespace gaia {
 			CommandBufferST* m_pCmdBufferST;
 			//! Command buffer for commands executed from a locked world. Thread-safe
 			CommandBufferMT* m_pCmdBufferMT;
+			//! Command buffers of logical partitions of deterministic parallel execution.
+			//! Committed in partition order right after m_pCmdBufferMT. Empty when the mode is disabled.
+			cnt::darray<CommandBufferMT*> m_detCmdBuffers;
 			//! Runtime callbacks have been shut down and must not execute anymore.
 			bool m_teardownActive = false;
 			//! Query used to iterate systems
@@ -669,6 +706,17 @@ namespace gaia {
 			uint32_t m_defragLastArchetypeIdx = 0;
 			//! Maximum number of entities to defragment per world tick
 			uint32_t m_defragEntitiesPerTick = 100;
+			//! Minimum number of entities spawned by one copy_n or instantiate_n call for which component data
+			//! is written with non-temporal stores
+			uint32_t m_streamCopyThreshold = 16384;
+			//! Minimum number of entities spawned by one instantiate_n call for which component data is copied
+			//! on worker threads
+			uint32_t m_parInstantiateThreshold = 16384;
+			//! Instantiation plans of prefabs spawned via instantiate_n, keyed by the root prefab.
+			//! Dropped whenever a prefab, its hierarchy or an OnInstantiate policy changes.
+			cnt::map<EntityLookupKey, cnt::darray<PrefabInstantiatePlanNode>> m_prefabPlans;
+			//! Increments whenever m_prefabPlans is dropped
+			uint32_t m_prefabPlansVersion = 0;
 
 			//! With every structural change world version changes
 			uint32_t m_worldVersion = 0;
@@ -689,10 +737,19 @@ namespace gaia {
 			}
 
 			~World() {
+				// Indices hold queries so they need to go before the rest of the world
+				for (auto& rec: m_spatialIndices)
+					rec.funcDel(rec.pIndex);
+				m_spatialIndices.clear();
+				for (auto* pIndex: m_valueIndices)
+					value_index_destroy(*pIndex);
+				m_valueIndices.clear();
 				teardown();
 				done();
 				cmd_buffer_destroy(*m_pCmdBufferST);
 				cmd_buffer_destroy(*m_pCmdBufferMT);
+				for (auto* pCmdBuffer: m_detCmdBuffers)
+					cmd_buffer_destroy(*pCmdBuffer);
 			}
 
 			World(World&&) = delete;
@@ -712,6 +769,13 @@ namespace gaia {
 						m_nextArchetypeId, m_worldVersion, m_entityToArchetypeMap, m_entityToArchetypeMapVersions, m_archetypes);
 			}
 
+			//! Provides a query kernel whose shape is fixed at compile time.
+			//! \tparam Terms AllOf<...> optionally followed by NoneOf<...>
+			//! \return Query kernel bound to the world
+			//! \see QueryKernel
+			template <typename... Terms>
+			QueryKernel<Terms...> query();
+
 			//! Provides an uncached query set up to work with the parent world.
 			//! Uncached queries keep only a local immutable plan and rebuild transient matches on demand.
 			//! \return Valid query object
@@ -721,6 +785,40 @@ namespace gaia {
 				return q;
 			}
 
+			//! Matches all cached queries against the current set of archetypes ahead of their first use.
+			//! VM passes of queries comparing nothing but archetype ids are run in parallel on the world's scheduler.
+			//! Useful after registering many queries at once, e.g. when gameplay code is reloaded, so their first
+			//! iteration does not stall on archetype matching. Queries are registered by Query::fetch() or their first
+			//! use. Queries depending on runtime variable bindings or source entities are matched on first use as usual.
+			void build_queries() {
+				GAIA_PROF_SCOPE(World::build_queries);
+
+				lock();
+				m_queryCache.build_all(
+						m_entityToArchetypeMap, m_entityToArchetypeMapVersions,
+						std::span<const Archetype*>((const Archetype**)m_archetypes.data(), m_archetypes.size()),
+						m_nextArchetypeId - 1, [this](uint32_t groupCnt, auto func) {
+							using Func = decltype(func);
+
+							SchedParDesc desc{};
+							desc.pCtx = &func;
+							desc.itemCount = groupCnt;
+							desc.groupSize = 1;
+							desc.execType = QueryExecType::Parallel;
+							desc.invoke = [](void* pCtx, uint32_t idxStart, uint32_t idxEnd) {
+								auto& func = *reinterpret_cast<Func*>(pCtx);
+								for (uint32_t i = idxStart; i < idxEnd; ++i)
+									func(i);
+							};
+
+							const auto& sched = this->sched();
+							const auto token = sched_par(sched, desc);
+							sched_wait(sched, token);
+							sched_del(sched, token);
+						});
+				unlock();
+			}
+
 #if GAIA_ECS_TEST_HOOKS
 			//! Verifies cached-query reverse-index consistency.
 			GAIA_NODISCARD bool verify_query_cache() const {
@@ -1301,6 +1399,7 @@ namespace gaia {
 			//! \param mode Sparse storage mode for the component.
 			void finish_sparse_component_add_inter(Entity entity, Entity object, SparseStorageMode mode) {
 				GAIA_ASSERT(mode != SparseStorageMode::None);
+				invalidate_prefab_plans(entity);
 
 #if GAIA_OBSERVERS_ENABLED
 				auto ctx =
@@ -1335,6 +1434,7 @@ namespace gaia {
 				if (it == m_sparseComponentsByComp.end())
 					return;
 
+				invalidate_prefab_plans();
 				it->second.func_clear_store(it->second.pStore);
 				it->second.func_del_store(it->second.pStore);
 				m_sparseComponentsByComp.erase(it);
@@ -1366,8 +1466,10 @@ namespace gaia {
 			void
 			nonfragmenting_relation_set(NonFragmentingRelationStore& store, Entity source, Entity relation, Entity target) {
 				GAIA_ASSERT(relation_uses_non_fragmenting_storage(relation));
-				if (store.set(source, target))
+				if (store.set(source, target)) {
 					invalidate_relation_caches(relation);
+					invalidate_prefab_plans(source, relation);
+				}
 			}
 
 			//! Sets an exclusive non-fragmenting relation target, creating its store when necessary.
@@ -1397,6 +1499,7 @@ namespace gaia {
 					m_nonFragmentingRelationsByRel.erase(itStore);
 
 				invalidate_relation_caches(relation);
+				invalidate_prefab_plans(source, relation);
 
 				return true;
 			}
@@ -4087,24 +4190,32 @@ namespace gaia {
 
 				auto& parentStore = nonfragmenting_relation_store_mut(Parent);
 				prepare_parent_batch(parentEntity, parentStore);
+				invalidate_prefab_plans(archetype);
 
-				auto entities = chunk.entity_view();
-#if GAIA_OBSERVERS_ENABLED
-				if (!m_observers.has_on_add_observers()) {
+				// Links are written first and relation caches invalidated once for the whole batch
+				auto set_links = [&]() {
+					auto entities = chunk.entity_view();
+					bool changed = false;
 					GAIA_FOR2_(originalChunkSize, originalChunkSize + toCreate, rowIdx) {
-						nonfragmenting_relation_set(parentStore, entities[rowIdx], Parent, parentEntity);
+						changed |= parentStore.set(entities[rowIdx], parentEntity);
 					}
+					if (changed)
+						invalidate_relation_caches(Parent);
+				};
+
+#if GAIA_OBSERVERS_ENABLED
+				if (!m_observers.has_on_add_observers()) {
+					set_links();
 					return;
 				}
 
+				auto entities = chunk.entity_view();
 				const Entity parentPair = Pair(Parent, parentEntity);
 				auto addDiffCtx = m_observers.prepare_diff(
 						*this, ObserverEvent::OnAdd, EntitySpan{&parentPair, 1},
 						EntitySpan{entities.data() + originalChunkSize, toCreate});
 #endif
-				GAIA_FOR2_(originalChunkSize, originalChunkSize + toCreate, rowIdx) {
-					nonfragmenting_relation_set(parentStore, entities[rowIdx], Parent, parentEntity);
-				}
+				set_links();
 
 #if GAIA_OBSERVERS_ENABLED
 				m_observers.on_add(
@@ -4305,6 +4416,7 @@ namespace gaia {
 				// so instead of fetching the container again we simply cache the row
 				// of our source entity.
 				const auto srcRow = ec.row;
+				const bool stream = count >= m_streamCopyThreshold;
 
 				EntityContainerCtx ctx{true, false, EntityKind::EK_Gen};
 
@@ -4326,21 +4438,20 @@ namespace gaia {
 						GAIA_ASSERT(entityExpected == entityNew);
 #endif
 
-						if (hasEntityDesc) {
-							Chunk::copy_foreign_entity_data(pSrcChunk, srcRow, pDstChunk, ecNew.row);
-						}
-
 						copy_all_sparse_entity_data(entity, entityNew);
 					}
 
 					pDstArchetype->try_update_free_chunk_idx();
 
-					if (!hasEntityDesc) {
-						pDstChunk->call_gen_ctors(originalChunkSize, toCreate);
-
-						{
-							GAIA_PROF_SCOPE(World::copy_n_entity_data);
-							Chunk::copy_entity_data_n_same_chunk(pSrcChunk, srcRow, pDstChunk, originalChunkSize, toCreate);
+					{
+						GAIA_PROF_SCOPE(World::copy_n_entity_data);
+						if (hasEntityDesc) {
+							// The source is named and lives in a different archetype
+							Chunk::copy_foreign_entity_data_n(pSrcChunk, srcRow, pDstChunk, originalChunkSize, toCreate, stream);
+						} else {
+							pDstChunk->call_gen_ctors(originalChunkSize, toCreate);
+							Chunk::copy_entity_data_n_same_chunk(
+									pSrcChunk, srcRow, pDstChunk, originalChunkSize, toCreate, stream);
 						}
 					}
 
@@ -4914,32 +5025,86 @@ namespace gaia {
 						EntitySpan{addHookIds});
 			}
 
-			template <typename Func>
-			void instantiate_prefab_n_inter(
-					const PrefabInstantiatePlanNode& node, Entity parentInstance, uint32_t count, Func& func) {
-				GAIA_ASSERT(node.prefab != EntityBad);
-				GAIA_ASSERT(node.pDstArchetype != nullptr);
+			//! Drops all cached prefab instantiation plans.
+			void invalidate_prefab_plans() {
+				if (m_prefabPlans.empty())
+					return;
 
-				if (count == 0U)
+				m_prefabPlans = {};
+				++m_prefabPlansVersion;
+			}
+
+			//! Drops cached prefab instantiation plans when \a archetype stores prefabs.
+			//! \param archetype Archetype of the entity being changed.
+			void invalidate_prefab_plans(const Archetype& archetype) {
+				if (!m_prefabPlans.empty() && archetype.has(Prefab))
+					invalidate_prefab_plans();
+			}
+
+			//! Drops cached prefab instantiation plans when \a entity is a prefab.
+			//! \param entity Entity being changed.
+			void invalidate_prefab_plans(Entity entity) {
+				if (m_prefabPlans.empty() || entity.pair() || !valid(entity))
+					return;
+
+				const auto* pArchetype = fetch(entity).pArchetype;
+				if (pArchetype != nullptr)
+					invalidate_prefab_plans(*pArchetype);
+			}
+
+			//! Drops cached prefab instantiation plans affected by a change of a non-fragmenting relation.
+			//! \param source Source entity of the changed relation.
+			//! \param relation Changed relation.
+			void invalidate_prefab_plans(Entity source, Entity relation) {
+				if (relation == OnInstantiate)
+					invalidate_prefab_plans();
+				else if (relation == Parent)
+					invalidate_prefab_plans(source);
+			}
+
+			//! Returns the instantiation plan of \a prefabEntity, building it when it is not cached.
+			//! The plan is moved out of the cache while in use and handed back by put_prefab_plan.
+			//! \param prefabEntity Root prefab.
+			//! \return Plan nodes in depth-first order.
+			GAIA_NODISCARD cnt::darray<PrefabInstantiatePlanNode> take_prefab_plan(Entity prefabEntity) {
+				const auto key = EntityLookupKey(prefabEntity);
+				const auto it = m_prefabPlans.find(key);
+				if (it != m_prefabPlans.end() && !it->second.empty())
+					return GAIA_MOV(it->second);
+
+				cnt::darray<PrefabInstantiatePlanNode> plan;
+				build_prefab_instantiate_plan(prefabEntity, BadIndex, EntityBad, plan);
+				// Keep a slot in the cache so edits made while the plan is in use are noticed by put_prefab_plan
+				(void)m_prefabPlans[key];
+				return plan;
+			}
+
+			//! Stores \a plan taken by take_prefab_plan back to the cache unless it went stale in the meantime.
+			//! \param prefabEntity Root prefab.
+			//! \param plan Plan to store.
+			//! \param version Value of m_prefabPlansVersion when the plan was taken.
+			void put_prefab_plan(Entity prefabEntity, cnt::darray<PrefabInstantiatePlanNode>&& plan, uint32_t version) {
+				if (version != m_prefabPlansVersion || !valid(prefabEntity))
 					return;
-#if GAIA_OBSERVERS_ENABLED
-				auto addDiffCtx = m_observers.prepare_diff_add_new(*this, EntitySpan{node.addedIds});
-#endif
 
+				m_prefabPlans[EntityLookupKey(prefabEntity)] = GAIA_MOV(plan);
+			}
+
+			//! Reserves destination rows for \a count instances of one prefab plan node.
+			//! Entity records are allocated and bound to their rows. Table component data is left for
+			//! fill_prefab_rows.
+			//! \tparam T Batch container type.
+			//! \param node Plan node to instantiate.
+			//! \param nodeIdx Index of \a node in its plan.
+			//! \param count Number of instances.
+			//! \param outBatches Receives one batch per destination chunk.
+			template <typename T>
+			void reserve_prefab_rows(const PrefabInstantiatePlanNode& node, uint32_t nodeIdx, uint32_t count, T& outBatches) {
 				auto& ecSrc = m_recs.entities[node.prefab.id()];
 				GAIA_ASSERT(ecSrc.pChunk != nullptr);
 
-				if (parentInstance != EntityBad)
-					prepare_parent_batch(parentInstance);
-
-				const auto srcRow = ecSrc.row;
-				auto* pSrcChunk = ecSrc.pChunk;
 				auto* pDstArchetype = node.pDstArchetype;
-				const auto prefabKey = EntityLookupKey(node.prefab);
 				EntityContainerCtx ctx{true, false, node.prefab.kind()};
-				auto& asRelations = m_entityToAsRelations[prefabKey];
-				m_entityToAsTargets.reserve(m_entityToAsTargets.size() + count);
-				asRelations.reserve(asRelations.size() + count);
 
 				uint32_t left = count;
 				do {
@@ -4958,8 +5123,87 @@ namespace gaia {
 					}
 
 					pDstArchetype->try_update_free_chunk_idx();
-					Chunk::copy_foreign_entity_data_n(pSrcChunk, srcRow, pDstChunk, originalChunkSize, toCreate);
-					pDstChunk->update_versions();
+
+					PrefabInstantiateBatch batch{};
+					batch.nodeIdx = nodeIdx;
+					batch.pSrcChunk = ecSrc.pChunk;
+					batch.srcRow = ecSrc.row;
+					batch.startRow = (uint16_t)originalChunkSize;
+					batch.pDstChunk = pDstChunk;
+					batch.count = toCreate;
+					outBatches.push_back(batch);
+
+					left -= toCreate;
+				} while (left > 0);
+			}
+
+			//! Copies prefab component data into rows reserved by reserve_prefab_rows.
+			//! Every batch writes to its own rows only so big spawns are spread over the world's scheduler.
+			//! \param batches Reserved rows.
+			//! \param instanceCnt Number of instances spawned per plan node.
+			//! \param rowCnt Total number of reserved rows.
+			void fill_prefab_rows(std::span<const PrefabInstantiateBatch> batches, uint32_t instanceCnt, uint32_t rowCnt) {
+				const bool stream = instanceCnt >= m_streamCopyThreshold;
+				auto fill = [&](uint32_t idxStart, uint32_t idxEnd) {
+					for (uint32_t i = idxStart; i < idxEnd; ++i) {
+						const auto& batch = batches[i];
+						Chunk::copy_foreign_entity_data_n(
+								batch.pSrcChunk, batch.srcRow, batch.pDstChunk, batch.startRow, batch.count, stream);
+					}
+				};
+
+				if (batches.size() > 1 && rowCnt >= m_parInstantiateThreshold) {
+					using Func = decltype(fill);
+
+					SchedParDesc desc{};
+					desc.pCtx = &fill;
+					desc.itemCount = (uint32_t)batches.size();
+					desc.groupSize = 1;
+					desc.execType = QueryExecType::Parallel;
+					desc.invoke = [](void* pCtx, uint32_t idxStart, uint32_t idxEnd) {
+						(*reinterpret_cast<Func*>(pCtx))(idxStart, idxEnd);
+					};
+
+					const auto& sched = this->sched();
+					const auto token = sched_par(sched, desc);
+					sched_wait(sched, token);
+					sched_del(sched, token);
+				} else
+					fill(0, (uint32_t)batches.size());
+
+				for (const auto& batch: batches)
+					batch.pDstChunk->update_versions();
+			}
+
+			//! Finishes instances of one prefab plan node once their data is in place. Updates Is bookkeeping,
+			//! runs add hooks and OnAdd observers, parents the instances and invokes \a func for each batch.
+			//! \tparam Func Callback type. It can be either void(ecs::Entity) or void(ecs::CopyIter&).
+			//! \param node Plan node the batches belong to.
+			//! \param parentInstance Parent entity of the instances, or EntityBad.
+			//! \param batches Batches filled by fill_prefab_rows.
+			//! \param func Functor executed for each batch.
+			template <typename Func>
+			void finish_prefab_rows(
+					const PrefabInstantiatePlanNode& node, Entity parentInstance, std::span<const PrefabInstantiateBatch> batches,
+					Func& func
+#if GAIA_OBSERVERS_ENABLED
+					,
+					ObserverRegistry::DiffDispatchCtx& addDiffCtx
+#endif
+			) {
+				auto* pDstArchetype = node.pDstArchetype;
+				const auto prefabKey = EntityLookupKey(node.prefab);
+				auto& asRelations = m_entityToAsRelations[prefabKey];
+				uint32_t count = 0;
+				for (const auto& batch: batches)
+					count += batch.count;
+				m_entityToAsTargets.reserve(m_entityToAsTargets.size() + count);
+				asRelations.reserve(asRelations.size() + count);
+
+				for (const auto& batch: batches) {
+					auto* pDstChunk = batch.pDstChunk;
+					const uint32_t originalChunkSize = batch.startRow;
+					const uint32_t toCreate = batch.count;
 
 					invalidate_relation_caches(Is);
 
@@ -5008,14 +5252,167 @@ namespace gaia {
 						parent_batch(parentInstance, *pDstArchetype, *pDstChunk, originalChunkSize, toCreate);
 
 					invoke_copy_batch_callback(func, pDstArchetype, pDstChunk, originalChunkSize, toCreate);
+				}
+			}
 
-					left -= toCreate;
-				} while (left > 0);
+			template <typename Func>
+			void instantiate_prefab_n_inter(
+					const PrefabInstantiatePlanNode& node, Entity parentInstance, uint32_t count, Func& func) {
+				GAIA_ASSERT(node.prefab != EntityBad);
+				GAIA_ASSERT(node.pDstArchetype != nullptr);
+
+				if (count == 0U)
+					return;
 #if GAIA_OBSERVERS_ENABLED
+				auto addDiffCtx = m_observers.prepare_diff_add_new(*this, EntitySpan{node.addedIds});
+#endif
+
+				if (parentInstance != EntityBad)
+					prepare_parent_batch(parentInstance);
+
+				cnt::darray_ext<PrefabInstantiateBatch, 16> batches;
+				reserve_prefab_rows(node, 0, count, batches);
+				const std::span<const PrefabInstantiateBatch> batchSpan{batches.data(), batches.size()};
+				fill_prefab_rows(batchSpan, count, count);
+#if GAIA_OBSERVERS_ENABLED
+				finish_prefab_rows(node, parentInstance, batchSpan, func, addDiffCtx);
 				m_observers.finish_diff(*this, GAIA_MOV(addDiffCtx));
+#else
+				finish_prefab_rows(node, parentInstance, batchSpan, func);
 #endif
 			}
 
+			//! Attaches spawned child instances to their parent instances.
+			//! Parent links are written as one batch unless OnAdd observers need to see them one by one.
+			//! \param relation Hierarchy relation copied from the prefab child edge.
+			//! \param children Spawned child instances.
+			//! \param parents Parent instance of each child in \a children.
+			void link_prefab_child_instances(Entity relation, EntitySpan children, EntitySpan parents) {
+				GAIA_ASSERT(children.size() == parents.size());
+
+				bool batched = relation == Parent;
+#if GAIA_OBSERVERS_ENABLED
+				batched = batched && !m_observers.has_on_add_observers();
+#endif
+				if (!batched) {
+					GAIA_EACH(children) attach_prefab_child_instance(children[i], relation, parents[i]);
+					return;
+				}
+
+				auto& parentStore = nonfragmenting_relation_store_mut(Parent);
+				bool changed = false;
+				GAIA_EACH(children) {
+					prepare_parent_batch(parents[i], parentStore);
+					changed |= parentStore.set(children[i], parents[i]);
+				}
+				if (changed)
+					invalidate_relation_caches(Parent);
+			}
+
+			//! Instantiates \a count copies of a multi-node prefab \a plan one node at a time.
+			//! Each node is linked to its parent instances right after it is spawned.
+			//! \param plan Prefab instantiation plan.
+			//! \param parentInstance Parent entity attached to each spawned root instance, or EntityBad.
+			//! \param count Number of copies to make.
+			//! \param[out] spawned Spawned instances grouped by plan node.
+			void instantiate_prefab_plan_by_node(
+					std::span<const PrefabInstantiatePlanNode> plan, Entity parentInstance, uint32_t count,
+					cnt::darray<Entity>& spawned) {
+				const auto planSize = (uint32_t)plan.size();
+				spawned.resize(planSize * count);
+
+				GAIA_FOR_(planSize, nodeIdx) {
+					const auto nodeOffset = nodeIdx * count;
+					uint32_t instanceIdx = 0;
+					auto collect = [&](Entity instance) {
+						spawned[nodeOffset + instanceIdx++] = instance;
+					};
+					instantiate_prefab_n_inter(plan[nodeIdx], nodeIdx == 0 ? parentInstance : EntityBad, count, collect);
+					if (nodeIdx == 0)
+						continue;
+
+					const auto parentOffset = plan[nodeIdx].parentIdx * count;
+					link_prefab_child_instances(
+							plan[nodeIdx].parentRelation, EntitySpan{spawned.data() + nodeOffset, count},
+							EntitySpan{spawned.data() + parentOffset, count});
+				}
+			}
+
+			//! Checks if any node of a prefab \a plan is linked to its parent via a fragmenting relation.
+			//! Such links move every instance to an archetype of its own right after it is linked, so rows
+			//! are better spawned and linked one node at a time while they are still in cache.
+			static bool prefab_plan_links_fragment(std::span<const PrefabInstantiatePlanNode> plan) {
+				GAIA_FOR2_(1, (uint32_t)plan.size(), nodeIdx) {
+					if (plan[nodeIdx].parentRelation != Parent)
+						return true;
+				}
+				return false;
+			}
+
+			//! Instantiates \a count copies of a multi-node prefab \a plan.
+			//! Rows of all nodes are reserved and filled first, hierarchy links are added afterwards.
+			//! \param plan Prefab instantiation plan.
+			//! \param parentInstance Parent entity attached to each spawned root instance, or EntityBad.
+			//! \param count Number of copies to make.
+			//! \param[out] spawned Spawned instances grouped by plan node.
+			void instantiate_prefab_plan_batched(
+					std::span<const PrefabInstantiatePlanNode> plan, Entity parentInstance, uint32_t count,
+					cnt::darray<Entity>& spawned) {
+				const auto planSize = (uint32_t)plan.size();
+				const auto rowCnt = planSize * count;
+
+#if GAIA_OBSERVERS_ENABLED
+				cnt::darray<ObserverRegistry::DiffDispatchCtx> addDiffCtxs;
+				addDiffCtxs.resize(planSize);
+#endif
+				if (parentInstance != EntityBad)
+					prepare_parent_batch(parentInstance);
+
+				// Reserve rows of all nodes first so their data can be copied in one go
+				cnt::darray<PrefabInstantiateBatch> batches;
+				GAIA_FOR_(planSize, nodeIdx) {
+#if GAIA_OBSERVERS_ENABLED
+					addDiffCtxs[nodeIdx] = m_observers.prepare_diff_add_new(*this, EntitySpan{plan[nodeIdx].addedIds});
+#endif
+					reserve_prefab_rows(plan[nodeIdx], nodeIdx, count, batches);
+				}
+				fill_prefab_rows(std::span<const PrefabInstantiateBatch>{batches.data(), batches.size()}, count, rowCnt);
+
+				// Batches are ordered by node so instances end up grouped by node as well
+				spawned.reserve(rowCnt);
+				for (const auto& batch: batches) {
+					auto entities = batch.pDstChunk->entity_view();
+					GAIA_FOR_(batch.count, rowOffset) spawned.push_back(entities[batch.startRow + rowOffset]);
+				}
+
+				m_entityToAsTargets.reserve(m_entityToAsTargets.size() + rowCnt);
+				auto skipRoot = [](Entity) {};
+				uint32_t batchIdx = 0;
+				GAIA_FOR_(planSize, nodeIdx) {
+					const auto firstBatchIdx = batchIdx;
+					while (batchIdx < batches.size() && batches[batchIdx].nodeIdx == nodeIdx)
+						++batchIdx;
+
+					const std::span<const PrefabInstantiateBatch> nodeBatches{
+							batches.data() + firstBatchIdx, batchIdx - firstBatchIdx};
+					const auto nodeParentInstance = nodeIdx == 0 ? parentInstance : EntityBad;
+#if GAIA_OBSERVERS_ENABLED
+					finish_prefab_rows(plan[nodeIdx], nodeParentInstance, nodeBatches, skipRoot, addDiffCtxs[nodeIdx]);
+					m_observers.finish_diff(*this, GAIA_MOV(addDiffCtxs[nodeIdx]));
+#else
+					finish_prefab_rows(plan[nodeIdx], nodeParentInstance, nodeBatches, skipRoot);
+#endif
+				}
+
+				GAIA_FOR2_(1, planSize, planIdx) {
+					const auto nodeOffset = planIdx * count;
+					const auto parentOffset = plan[planIdx].parentIdx * count;
+					link_prefab_child_instances(
+							plan[planIdx].parentRelation, EntitySpan{spawned.data() + nodeOffset, count},
+							EntitySpan{spawned.data() + parentOffset, count});
+				}
+			}
+
 			//! Builds a depth-first prefab instantiation plan from \a prefabEntity.
 			//! \tparam T Prefab instantiation plan container type.
 			//! \param prefabEntity Prefab represented by the next plan node.
@@ -5251,38 +5648,23 @@ namespace gaia {
 					return;
 				}
 
-				cnt::darray_ext<PrefabInstantiatePlanNode, 16> plan;
-				build_prefab_instantiate_plan(prefabEntity, BadIndex, EntityBad, plan);
+				auto plan = take_prefab_plan(prefabEntity);
+				const auto planVersion = m_prefabPlansVersion;
 				if (plan.size() == 1) {
 					instantiate_prefab_n_inter(plan[0], parentInstance, count, func);
+					put_prefab_plan(prefabEntity, GAIA_MOV(plan), planVersion);
 					return;
 				}
 
-				const auto planSize = (uint32_t)plan.size();
-				GAIA_ASSERT(planSize <= uint32_t(-1) / count);
+				GAIA_ASSERT(plan.size() <= uint32_t(-1) / count);
+				const std::span<const PrefabInstantiatePlanNode> planSpan{plan.data(), plan.size()};
 				cnt::darray<Entity> spawned;
-				spawned.resize(planSize * count);
-
-				uint32_t rootIdx = 0;
-				auto collectRoot = [&](Entity instance) {
-					spawned[rootIdx++] = instance;
-				};
-				instantiate_prefab_n_inter(plan[0], parentInstance, count, collectRoot);
-
-				GAIA_FOR2_(1, planSize, planIdx) {
-					uint32_t nodeIdx = 0;
-					const auto nodeOffset = planIdx * count;
-					auto collectNode = [&](Entity instance) {
-						spawned[nodeOffset + nodeIdx++] = instance;
-					};
-					instantiate_prefab_n_inter(plan[planIdx], EntityBad, count, collectNode);
+				if (prefab_plan_links_fragment(planSpan))
+					instantiate_prefab_plan_by_node(planSpan, parentInstance, count, spawned);
+				else
+					instantiate_prefab_plan_batched(planSpan, parentInstance, count, spawned);
 
-					const auto parentOffset = plan[planIdx].parentIdx * count;
-					GAIA_FOR_(count, instanceIdx) {
-						attach_prefab_child_instance(
-								spawned[nodeOffset + instanceIdx], plan[planIdx].parentRelation, spawned[parentOffset + instanceIdx]);
-					}
-				}
+				put_prefab_plan(prefabEntity, GAIA_MOV(plan), planVersion);
 
 				if constexpr (std::is_invocable_v<Func, CopyIter&>) {
 					CopyIterGroupState group;
@@ -5400,6 +5782,77 @@ namespace gaia {
 				del_inter(entity);
 			}
 
+			//! Removes \a entities along with all data associated with them.
+			//! The outcome is the same as calling del() for each of them. However, entities nothing else in the world
+			//! refers to are deleted in bulk. They are grouped by chunk, chunks losing all their entities are cleared
+			//! without moving any rows and OnDel observers are notified once for the whole batch.
+			//! Entities which need extra cleanup (components, relationship targets, entities with OnDelete rules,
+			//! named entities, ...) are deleted one by one afterwards.
+			//! \param entities Entities to delete. Invalid entities and duplicates are ignored.
+			//! \note Entities listed in the order of their storage, e.g. as returned by a query, are deleted fastest.
+			void del_n(EntitySpan entities) {
+				GAIA_PROF_SCOPE(World::del_n);
+				GAIA_ASSERT(
+						!locked() && "Entities can't be deleted while the world is locked "
+												 "(structural changes are forbidden during this time!)");
+
+				cnt::darray<Entity> bulk;
+				cnt::darray<Entity> single;
+				bulk.reserve((uint32_t)entities.size());
+
+				const Archetype* pLastArchetype = nullptr;
+				bool lastArchetypeOk = false;
+				for (auto entity: entities) {
+					if (entity.pair() || !valid(entity)) {
+						single.push_back(entity);
+						continue;
+					}
+
+					auto& ec = fetch(entity);
+					if (ec.pArchetype != pLastArchetype) {
+						pLastArchetype = ec.pArchetype;
+						lastArchetypeOk = can_del_in_bulk(*ec.pArchetype);
+					}
+					if (!lastArchetypeOk || !can_del_in_bulk(ec, entity)) {
+						single.push_back(entity);
+						continue;
+					}
+
+#if GAIA_USE_SAFE_ENTITY
+					// Decrement the ref count at this point.
+					if ((ec.flags & EntityContainerFlags::RefDecreased) == 0) {
+						--ec.refCnt;
+						ec.flags |= EntityContainerFlags::RefDecreased;
+					}
+
+					// Don't delete so long something still references us
+					if (ec.refCnt != 0)
+						continue;
+#endif
+
+					// Marking the entity also makes any duplicate of it fail the validity check above
+					ec.req_del();
+					bulk.push_back(entity);
+				}
+
+				del_entities_bulk(EntitySpan{bulk.data(), bulk.size()});
+
+				for (auto entity: single) {
+					if (valid(entity))
+						del(entity);
+				}
+			}
+
+			//! Removes all entities matched by \a query along with all data associated with them.
+			//! \param query Query selecting the entities to delete
+			//! \param constraints Selects whether enabled, disabled or all matched entities are deleted
+			//! \see del_n
+			void del(Query& query, Constraints constraints = Constraints::EnabledOnly) {
+				cnt::darray<Entity> entities;
+				query.arr(entities, constraints);
+				del_n(EntitySpan{entities.data(), entities.size()});
+			}
+
 			//! Removes an \a object from \a entity if possible.
 			//! \param entity Entity to delete from
 			//! \param object Entity to delete
@@ -5408,6 +5861,7 @@ namespace gaia {
 				if (!object.pair()) {
 					const auto itSparseStore = m_sparseComponentsByComp.find(EntityLookupKey(object));
 					if (itSparseStore != m_sparseComponentsByComp.end()) {
+						invalidate_prefab_plans(entity);
 						if (!component_is_non_fragmenting(object)) {
 							{
 								EntityBuilder eb(*this, entity);
@@ -7856,6 +8310,14 @@ namespace gaia {
 				return *m_pCmdBufferMT;
 			}
 
+			//! Returns the command buffer of a logical partition of deterministic parallel execution.
+			//! \param partition Partition index. Must be smaller than det_partitions().
+			//! \return Multi-thread-safe command buffer reference.
+			CommandBufferMT& cmd_buffer_mt(uint32_t partition) const {
+				GAIA_ASSERT(partition < m_detCmdBuffers.size());
+				return *m_detCmdBuffers[partition];
+			}
+
 			//----------------------------------------------------------------------
 
 #if GAIA_SYSTEMS_ENABLED
@@ -8148,6 +8610,7 @@ namespace gaia {
 			//! \see frame_cleanup()
 			//! \see update()
 			void frame_end() {
+				m_journal.commit();
 				util::log_flush();
 
 				// Signal the end of the frame
@@ -8239,6 +8702,157 @@ namespace gaia {
 				m_defragEntitiesPerTick = value;
 			}
 
+			//! Sets the minimum number of entities spawned at once by copy_n or instantiate_n for which trivially
+			//! copyable component data is written with non-temporal stores. Such stores bypass the cache so a big
+			//! spawn does not evict data the current frame still works with. The new data is not cached afterwards
+			//! though, so keep the threshold high enough for batches which are read back right away.
+			//! \param value Number of entities. 0 streams every batch, uint32_t(-1) disables streaming.
+			void stream_copy_threshold(uint32_t value) {
+				m_streamCopyThreshold = value;
+			}
+
+			//! Returns the minimum number of entities spawned at once for which non-temporal stores are used.
+			GAIA_NODISCARD uint32_t stream_copy_threshold() const {
+				return m_streamCopyThreshold;
+			}
+
+			//! Sets the minimum number of entities spawned at once by instantiate_n for which component data of
+			//! the instances is copied in parallel on the world's scheduler. Rows are always reserved and hooks and
+			//! observers always run on the calling thread.
+			//! \param value Number of entities. 0 copies every batch in parallel, uint32_t(-1) disables it.
+			void par_instantiate_threshold(uint32_t value) {
+				m_parInstantiateThreshold = value;
+			}
+
+			//! Returns the minimum number of entities spawned at once for which component data is copied in parallel.
+			GAIA_NODISCARD uint32_t par_instantiate_threshold() const {
+				return m_parInstantiateThreshold;
+			}
+
+			//! Default number of logical partitions used by deterministic parallel execution
+			static constexpr uint32_t DetPartitionsDefault = 64;
+
+			//! Makes parallel execution independent of the number of threads and of which thread runs what.
+			//! Meant for lockstep simulations where every peer has to end up with the same world.
+			//! - Chunk batches of a parallel query are split into \a partitions logical partitions. The split only
+			//!   depends on the number of batches.
+			//! - Every partition records commands issued via Iter::cmd_buffer_mt() to a command buffer of its own.
+			//!   These are committed in partition order so entities are created, changed and deleted in the same order
+			//!   and observers fire in the same order, too.
+			//! - Systems run one after another in their deterministic order. Their queries still run in parallel.
+			//! Floating-point reductions over parallel queries can be made deterministic via OrderedReduce.
+			//! \param enabled True to enable the deterministic mode
+			//! \param partitions Number of logical partitions. More partitions balance better on more threads.
+			//! \warning Custom schedulers need to follow SchedParDesc::groupSize for the split to stay deterministic.
+			void deterministic(bool enabled, uint32_t partitions = DetPartitionsDefault) {
+				GAIA_ASSERT(!locked());
+				GAIA_ASSERT(!enabled || partitions > 0);
+
+				const auto cnt = enabled ? core::get_max(partitions, 1U) : 0U;
+				// Make sure nothing recorded so far gets lost
+				for (auto* pCmdBuffer: m_detCmdBuffers) {
+					cmd_buffer_commit(*pCmdBuffer);
+					if (m_detCmdBuffers.size() > cnt)
+						cmd_buffer_destroy(*pCmdBuffer);
+				}
+				if (m_detCmdBuffers.size() > cnt)
+					m_detCmdBuffers.clear();
+
+				while (m_detCmdBuffers.size() < cnt)
+					m_detCmdBuffers.push_back(cmd_buffer_mt_create(*this));
+			}
+
+			//! Checks if parallel execution is deterministic.
+			//! \return True if the deterministic mode is enabled.
+			GAIA_NODISCARD bool deterministic() const {
+				return !m_detCmdBuffers.empty();
+			}
+
+			//! Returns the number of logical partitions of deterministic parallel execution.
+			//! \return Number of partitions. Zero when the deterministic mode is disabled.
+			GAIA_NODISCARD uint32_t det_partitions() const {
+				return (uint32_t)m_detCmdBuffers.size();
+			}
+
+			//--------------------------------------------------------------------------------
+
+			//! Returns the change journal of the world. Once enabled via ChangeJournal::enable, the journal records
+			//! entity creation and deletion, components added to and removed from entities, and component writes that
+			//! trigger OnSet (set, modify, mutable query views). Changes of core components are not recorded.
+			//! The current frame of the journal is committed by frame_end().
+			//! \return Change journal.
+			GAIA_NODISCARD ChangeJournal& journal() {
+				return m_journal;
+			}
+
+			//! Returns the change journal of the world.
+			//! \return Change journal.
+			GAIA_NODISCARD const ChangeJournal& journal() const {
+				return m_journal;
+			}
+
+			//! Checks if changes of \a comp are recorded by the change journal.
+			//! \param comp Component or pair
+			//! \return True if the journal is enabled and \a comp is not a core component.
+			GAIA_NODISCARD bool journal_comp(Entity comp) const {
+				return m_journal.enabled() && (comp.pair() || comp.id() > GAIA_ID(LastCoreComponent).id());
+			}
+
+			//--------------------------------------------------------------------------------
+
+			//! Returns the spatial index over component \a T. The index is created on first use and lives as long as
+			//! the world does. Later calls return the same index and ignore \a cellSize.
+			//! \tparam T Component holding positions
+			//! \param cellSize Size of a grid cell along each axis
+			//! \return Spatial index.
+			template <typename T>
+			SpatialIndex<T>& spatial_index(float cellSize) {
+				const auto comp = add<T>().entity;
+				for (auto& rec: m_spatialIndices) {
+					if (rec.comp == comp)
+						return *static_cast<SpatialIndex<T>*>(rec.pIndex);
+				}
+
+				auto* pIndex = new SpatialIndex<T>(*this, cellSize);
+				auto funcDel = [](void* p) {
+					delete static_cast<SpatialIndex<T>*>(p);
+				};
+				m_spatialIndices.push_back({comp, pIndex, funcDel});
+				return *pIndex;
+			}
+
+			//! Returns the value index over field \a field of component \a comp. The field is looked up in the runtime
+			//! schema of the component. The index is created on first use and lives as long as the world does.
+			//! \param comp Component
+			//! \param field Name of a scalar field of a primitive type
+			//! \param kind Kind of the index
+			//! \return Value index.
+			ValueIndex& value_index(Entity comp, util::str_view field, ValueIndexKind kind = ValueIndexKind::Hash);
+
+			//! Returns the value index over member \a member of component \a T. Components without a runtime schema
+			//! can be indexed this way. The index is created on first use and lives as long as the world does.
+			//! \tparam T Component
+			//! \tparam V Type of the member. Integers, bool, characters, float and double are supported.
+			//! \param member Member pointer, e.g. &Team::id
+			//! \param kind Kind of the index
+			//! \return Value index.
+			template <typename T, typename V>
+			ValueIndex& value_index(V T::*member, ValueIndexKind kind = ValueIndexKind::Hash) {
+				static_assert(std::is_arithmetic_v<V> || std::is_enum_v<V>, "Only scalar members can be indexed");
+				const auto comp = add<T>().entity;
+
+				// Note, offsetof is implementation-defined for non-standard-layout types.
+				// Therefore, we instantiate the component and calculate the relative address ourselves.
+				T object{};
+				const auto offset = (uint32_t)((uintptr_t)&(object.*member) - (uintptr_t)&object);
+				return value_index_inter(comp, offset, ser::type_id<V>(), kind);
+			}
+
+		private:
+			ValueIndex& value_index_inter(Entity comp, uint32_t offset, ser::serialization_type_id type, ValueIndexKind kind);
+
+		public:
+
 			//--------------------------------------------------------------------------------
 
 			//! Performs diagnostics on archetypes. Prints basic info about them and the chunks they contain.
@@ -8323,6 +8937,7 @@ namespace gaia {
 					m_depthOrderCache = {};
 					m_sourcesAllCache = {};
 					m_targetsAllCache = {};
+					m_prefabPlans = {};
 					m_relationCachesPopulated = false;
 					m_hasOnDeleteTargetPolicy = false;
 					m_hasCantCombinePolicy = false;
@@ -8694,6 +9309,46 @@ namespace gaia {
 			}
 
 		public:
+			//! Calculates a 64-bit digest of the simulation state. Meant for desync detection in lockstep and
+			//! rollback setups where comparing full snapshots every frame would be too expensive.
+			//! Entities, their components and data of trivially copyable components stored in chunks are hashed.
+			//! Tags contribute only by their presence. Data of core components, sparse components, components
+			//! with custom copy semantics and components listed in \a excluded is skipped.
+			//! Digests of chunks are cached, so chunks nobody wrote to since the last call cost nothing.
+			//! Changes are detected the same way as by changed() query filters, i.e. only writes the world knows
+			//! about (mutable views, set, structural changes) invalidate the cache.
+			//! Chunk digests are combined independently of the order in which chunks and archetypes were allocated.
+			//! \param excluded Components whose data should not be hashed, e.g. render or caching data.
+			//!        Keep the list and its order the same between calls so cached digests can be reused.
+			//! \return 64-bit digest of the world state.
+			GAIA_NODISCARD uint64_t hash_state(std::span<const Entity> excluded = {}) {
+				GAIA_PROF_SCOPE(World::hash_state);
+				GAIA_ASSERT(!locked());
+
+				const auto filterKey = core::hash_data64(excluded.data(), excluded.size() * sizeof(Entity));
+
+				// Addition is commutative so neither archetype nor chunk order matter
+				uint64_t hash = 0;
+				uint32_t cnt = 0;
+				for (auto* pArchetype: m_archetypes) {
+					const auto& chunks = pArchetype->chunks();
+					GAIA_EACH(chunks) {
+						if (chunks[i]->empty())
+							continue;
+
+						const auto chunkHash = pArchetype->chunk_state_hash(i, excluded, filterKey);
+						hash += core::hash_data64(&chunkHash, sizeof(chunkHash));
+						++cnt;
+					}
+				}
+
+				// Writes from now on get a newer version than the one cached chunk digests were calculated at
+				update_version(m_worldVersion);
+
+				const uint64_t data[] = {hash, cnt};
+				return core::hash_data64(data, sizeof(data));
+			}
+
 			//! Saves contents of the world to a buffer. The buffer is reset, not appended.
 			//! NOTE: In order for custom version of save to be used for a given component, it needs to have either
 			//!       of the following functions defined:
@@ -8804,6 +9459,8 @@ namespace gaia {
 					return false;
 				}
 
+				invalidate_prefab_plans();
+
 				// Store the index of the last core component. As they change, we will have to modify entity ids accordingly.
 				uint32_t lastCoreComponentId = 0;
 				s.load(lastCoreComponentId);
@@ -9011,6 +9668,9 @@ namespace gaia {
 					GAIA_ASSERT(ec.pEntity != nullptr);
 				}
 #endif
+				// Scratch storage for strings read from streaming backends
+				cnt::darray<char> strScratch;
+
 				// Entity names
 				{
 					m_nameToEntity = {};
@@ -9056,9 +9716,9 @@ namespace gaia {
 						uint32_t len = 0;
 						s.load(len);
 
-						// Get a pointer to where the string begins and seek to the end of the string
-						const char* entityStr = (const char*)(s.data() + s.tell());
-						s.seek(s.tell() + len);
+						// Get a pointer to where the string begins and seek to the end of the string.
+						// Streaming backends do not expose their data so the string is copied out instead.
+						const char* entityStr = load_str_inter(s, len, strScratch);
 
 						// Make sure EntityDesc does not point anywhere right now.
 						{
@@ -9104,8 +9764,7 @@ namespace gaia {
 						s.load(len);
 
 						// Get a pointer to where the string begins and seek to the end of the string
-						const char* aliasStr = (const char*)(s.data() + s.tell());
-						s.seek(s.tell() + len);
+						const char* aliasStr = load_str_inter(s, len, strScratch);
 
 						pDesc->alias = nullptr;
 						pDesc->alias_len = 0;
@@ -9125,6 +9784,25 @@ namespace gaia {
 			}
 
 		private:
+			//! Reads a string of \a len bytes from the serializer.
+			//! In-memory backends hand out a pointer into their buffer. Streaming backends that do not expose
+			//! their data have the string copied into \a scratch instead.
+			//! \param s Serializer to read from
+			//! \param len Length of the string in bytes
+			//! \param scratch Storage used when the backend does not expose its data
+			//! \return Pointer to the string. Valid until the next read or until \a scratch changes.
+			static const char* load_str_inter(ser::serializer& s, uint32_t len, cnt::darray<char>& scratch) {
+				if (const char* pData = s.data(); pData != nullptr) {
+					const char* str = pData + s.tell();
+					s.seek(s.tell() + len);
+					return str;
+				}
+
+				scratch.resize(len);
+				s.load_raw(scratch.data(), len, ser::serialization_type_id::c8);
+				return scratch.data();
+			}
+
 			//! Sorts archetypes in the archetype list with their ids in ascending order
 			void sort_archetypes() {
 				struct sort_cond {
@@ -9835,6 +10513,9 @@ namespace gaia {
 			void unreg_archetype(Archetype* pArchetype) {
 				GAIA_ASSERT(pArchetype != nullptr);
 
+				// Cached prefab plans keep raw destination archetype pointers
+				invalidate_prefab_plans();
+
 				// Make sure hashes were set already
 				GAIA_ASSERT(
 						(m_archetypesById.empty() || pArchetype == m_pRootArchetype) || (pArchetype->lookup_hash().hash != 0));
@@ -10179,8 +10860,12 @@ namespace gaia {
 					// If the call was made inside invalidate_entity we would access a memory location
 					// which has already been destructed which is not nice.
 					del_name(ec, entity);
+					invalidate_prefab_plans(*ec.pArchetype);
 					remove_entity(*ec.pArchetype, *ec.pChunk, ec.row);
 					remove_src_entity_version(entity);
+
+					if GAIA_UNLIKELY (m_journal.enabled())
+						m_journal.record(JournalOp::EntityDel, entity);
 				}
 
 				// Invalidate on-demand.
@@ -10224,6 +10909,148 @@ namespace gaia {
 				validate_entities();
 			}
 
+			//! Checks whether entities of \a archetype can be deleted by del_entities_bulk.
+			//! Names, observers, systems and prefabs are unregistered one entity at a time so their archetypes
+			//! are excluded.
+			//! \param archetype Archetype to check.
+			//! \return True if entities of the archetype can be deleted in bulk. False otherwise.
+			GAIA_NODISCARD static bool can_del_in_bulk(const Archetype& archetype) {
+				if (archetype.is_req_del())
+					return false;
+
+				const auto ids = archetype.ids_view();
+				if (core::has(ids, GAIA_ID(EntityDesc)) || core::has(ids, Prefab))
+					return false;
+#if GAIA_OBSERVERS_ENABLED
+				if (core::has(ids, Observer))
+					return false;
+#endif
+#if GAIA_SYSTEMS_ENABLED
+				if (core::has(ids, System))
+					return false;
+#endif
+
+				return true;
+			}
+
+			//! Checks whether \a entity can be deleted by del_entities_bulk.
+			//! That is the case when nothing else in the world refers to the entity, so deleting it does not need
+			//! any of the cleanup handle_del_entity performs.
+			//! \param ec Entity container associated with \a entity.
+			//! \param entity Entity to check.
+			//! \return True if the entity can be deleted in bulk. False otherwise.
+			GAIA_NODISCARD bool can_del_in_bulk(const EntityContainer& ec, Entity entity) const {
+				constexpr EntityContainerFlagsType RefFlags =
+						EntityContainerFlags::OnDelete_Delete | EntityContainerFlags::OnDelete_Error |
+						EntityContainerFlags::OnDeleteTarget_Delete | EntityContainerFlags::OnDeleteTarget_Error |
+						EntityContainerFlags::IsSingleton | EntityContainerFlags::IsObserved;
+				if ((ec.flags & RefFlags) != 0)
+					return false;
+
+				const auto key = EntityLookupKey(entity);
+				if (m_entityToArchetypeMap.contains(key))
+					return false;
+				if (m_pairLookup.relations(entity) != nullptr || m_pairLookup.targets(entity) != nullptr)
+					return false;
+				if (!m_sparseComponentsByComp.empty() && m_sparseComponentsByComp.contains(key))
+					return false;
+				for (const auto& it: m_nonFragmentingRelationsByRel) {
+					if (it.first == key || it.second.sources(entity) != nullptr)
+						return false;
+				}
+
+				return true;
+			}
+
+			//! Deletes \a entities which passed can_del_in_bulk.
+			//! Entities are expected to be marked as delete-requested already and grouped by chunk, the way
+			//! query results are. Each run of entities sharing a chunk is removed at once. When the run covers
+			//! the whole chunk, the chunk is cleared without moving any rows. Otherwise, rows are removed from
+			//! the back so no entity of the run is moved before it is removed itself.
+			//! \param entities Entities to delete
+			void del_entities_bulk(EntitySpan entities) {
+				GAIA_PROF_SCOPE(World::del_entities_bulk);
+
+				if (entities.empty())
+					return;
+
+#if GAIA_OBSERVERS_ENABLED
+				// OnDel observers compare matches before and after the change, so the entities need to be seen
+				// as alive until their storage is gone, the same as when they are deleted one by one.
+				const bool hasOnDelObservers = m_observers.has_on_del_observers();
+				auto delDiffCtx = ObserverRegistry::DiffDispatchCtx{};
+				if (hasOnDelObservers) {
+					for (auto entity: entities) {
+						EntityBuilder::set_flag(fetch(entity).flags, EntityContainerFlags::DeleteRequested, false);
+						del_nonfragmenting_relation_source_observed(entity);
+					}
+					delDiffCtx = m_observers.prepare_diff(*this, ObserverEvent::OnDel, entities, entities);
+				}
+#endif
+
+				cnt::darray<uint16_t> rows;
+				const auto cnt = (uint32_t)entities.size();
+				for (uint32_t i = 0; i < cnt;) {
+					const auto& ec = fetch(entities[i]);
+					auto* pArchetype = ec.pArchetype;
+					auto* pChunk = ec.pChunk;
+
+					uint32_t j = i + 1;
+					while (j < cnt && fetch(entities[j]).pChunk == pChunk)
+						++j;
+
+					if (j - i == pChunk->size()) {
+						pArchetype->remove_all_entities(*pChunk);
+					} else {
+						rows.clear();
+						for (uint32_t k = i; k < j; ++k)
+							rows.push_back(fetch(entities[k]).row);
+						core::sort(rows, [](uint16_t left, uint16_t right) {
+							return left > right;
+						});
+
+						for (auto row: rows)
+							pArchetype->remove_entity_raw(*pChunk, row, m_recs);
+						pChunk->update_versions();
+					}
+
+					try_enqueue_chunk_for_deletion(*pArchetype, *pChunk);
+					i = j;
+				}
+
+#if GAIA_OBSERVERS_ENABLED
+				if (hasOnDelObservers) {
+					for (auto entity: entities)
+						fetch(entity).req_del();
+					m_observers.finish_diff(*this, GAIA_MOV(delDiffCtx));
+				}
+#endif
+
+				for (auto entity: entities) {
+					if GAIA_UNLIKELY (m_journal.enabled())
+						m_journal.record(JournalOp::EntityDel, entity);
+
+					if (!m_srcEntityVersions.empty())
+						remove_src_entity_version(entity);
+#if GAIA_USE_WEAK_ENTITY
+					invalidate_weak_entities(fetch(entity));
+#endif
+					invalidate_unreferenced_entity(entity);
+				}
+			}
+
+			//! Invalidates the record of an entity nothing else in the world refers to.
+			//! Same as invalidate_entity minus the graph and pair lookups can_del_in_bulk already ruled out.
+			//! \param entity Entity to delete
+			void invalidate_unreferenced_entity(Entity entity) {
+				m_recs.entities.free(entity);
+
+				if (!m_sparseComponentsByComp.empty())
+					del_sparse_components(entity);
+				if (!m_nonFragmentingRelationsByRel.empty())
+					del_nonfragmenting_relation_source(entity);
+			}
+
 			//! Deletes the entity
 			//! \param entity Entity to delete
 			void del_inter(Entity entity) {
@@ -11363,7 +12190,17 @@ namespace gaia {
 				req_del_inter(ec, entity);
 
 #if GAIA_USE_WEAK_ENTITY
-				// Invalidate WeakEntities
+				invalidate_weak_entities(ec);
+#endif
+#if GAIA_OBSERVERS_ENABLED
+				entity_deletion_leave(entity);
+#endif
+			}
+
+#if GAIA_USE_WEAK_ENTITY
+			//! Invalidates all WeakEntities pointing to the entity.
+			//! \param ec Entity container of the entity being deleted.
+			void invalidate_weak_entities(EntityContainer& ec) {
 				while (ec.pWeakTracker != nullptr) {
 					auto* pTracker = ec.pWeakTracker;
 					ec.pWeakTracker = pTracker->next;
@@ -11377,11 +12214,8 @@ namespace gaia {
 					pWeakEntity->m_entity = EntityBad;
 					delete pTracker;
 				}
-#endif
-#if GAIA_OBSERVERS_ENABLED
-				entity_deletion_leave(entity);
-#endif
 			}
+#endif
 
 			//! Removes a graph connection with the surrounding archetypes.
 			//! \param pArchetype Archetype we are removing an edge from
@@ -11593,6 +12427,14 @@ namespace gaia {
 				ec.pEntity = &pChunk->entity_view()[ec.row];
 				GAIA_ASSERT(entity.pair() || ec.data.gen == entity.gen());
 				ec.data.dis = 0;
+
+				if GAIA_UNLIKELY (m_journal.enabled() && !entity.pair()) {
+					m_journal.record(JournalOp::EntityAdd, entity);
+					for (auto comp: pArchetype->ids_view()) {
+						if (journal_comp(comp))
+							m_journal.record(JournalOp::CompAdd, entity, comp);
+					}
+				}
 			}
 
 			//! Moves an entity along with all its generic components from its current chunk to another one.
@@ -11641,8 +12483,13 @@ namespace gaia {
 				ec.pChunk = pDstChunk;
 				ec.row = (uint16_t)dstRow;
 				ec.pEntity = &pDstChunk->entity_view()[dstRow];
-				if (archetypeChanged)
+				if (archetypeChanged) {
+					if (!m_prefabPlans.empty() && (srcArchetype.has(Prefab) || dstArchetype.has(Prefab)))
+						invalidate_prefab_plans();
 					update_src_entity_version(entity);
+					if GAIA_UNLIKELY (m_journal.enabled())
+						journal_move(entity, srcArchetype, dstArchetype);
+				}
 
 				// Make the enabled state in the new chunk match the original state
 				dstArchetype.enable_entity(pDstChunk, dstRow, wasEnabled, m_recs);
@@ -11654,6 +12501,24 @@ namespace gaia {
 				validate_entities();
 			}
 
+			//! Records components added to and removed from \a entity by moving it from \a srcArchetype to
+			//! \a dstArchetype in the change journal.
+			//! \param entity Entity that moved
+			//! \param srcArchetype Archetype the entity moved from
+			//! \param dstArchetype Archetype the entity moved to
+			void journal_move(Entity entity, const Archetype& srcArchetype, const Archetype& dstArchetype) {
+				auto srcIds = srcArchetype.ids_view();
+				auto dstIds = dstArchetype.ids_view();
+				for (auto comp: srcIds) {
+					if (journal_comp(comp) && !core::has(dstIds, comp))
+						m_journal.record(JournalOp::CompDel, entity, comp);
+				}
+				for (auto comp: dstIds) {
+					if (journal_comp(comp) && !core::has(srcIds, comp))
+						m_journal.record(JournalOp::CompAdd, entity, comp);
+				}
+			}
+
 			//! Moves an entity along with all its generic components from its current chunk to another archetype.
 			//! \param entity Entity to move
 			//! \param ec Entity container describing the current entity storage.
@@ -12341,8 +13206,12 @@ namespace gaia {
 #endif
 
 #include "observer.inl"
+#include "query_kernel.inl"
 #include "system.inl"
 
+#include "spatial_index.h"
+#include "value_index.h"
+
 namespace gaia {
 	namespace ecs {
 		inline void World::init() {
@@ -13580,7 +14449,8 @@ namespace gaia {
 			detail::SystemRunCtx ctx{};
 			ctx.pWorld = this;
 			ctx.pPending = &pending;
-			ctx.canScheduleSystems = detail::sched_supports_deferred_system_jobs(world_sched(*this));
+			// Systems running concurrently would interleave their commands in a different order every time
+			ctx.canScheduleSystems = !deterministic() && detail::sched_supports_deferred_system_jobs(world_sched(*this));
 
 			for (auto& item: items)
 				detail::run_system_entity_erased(&ctx, item);
@@ -14023,6 +14893,22 @@ namespace gaia {
 			return (uint32_t)it->second.size();
 		}
 
+		//! Sums the lookup-key match counts of the component-to-archetype bucket for \a term.
+		//! For wildcard pairs this is the number of matching pairs across all indexed archetypes.
+		//! \param world World to query.
+		//! \param term Term to inspect.
+		//! \return Total match count of indexed archetype entries.
+		inline uint32_t world_component_index_match_total(const World& world, Entity term) {
+			const auto it = world.m_entityToArchetypeMap.find(EntityLookupKey(term));
+			if (it == world.m_entityToArchetypeMap.end())
+				return 0;
+
+			uint32_t total = 0;
+			for (const auto& entry: it->second)
+				total += entry.matchCount;
+			return total;
+		}
+
 		//! Returns the cached component index of \a term inside \a archetype.
 		//! \param world World to query.
 		//! \param archetype Archetype to inspect.
@@ -14341,6 +15227,13 @@ namespace gaia {
 		//! \param from First row index, inclusive.
 		//! \param to Last row index, exclusive.
 		inline void world_notify_on_set(World& world, Entity term, Chunk& chunk, uint16_t from, uint16_t to) {
+			if GAIA_UNLIKELY (world.journal_comp(term) && !world.tearing_down()) {
+				auto entities = chunk.entity_view();
+				const auto last = core::get_min((uint32_t)to, (uint32_t)entities.size());
+				if (from < last)
+					world.journal().record(JournalOp::Write, term, EntitySpan{entities.data() + from, last - from});
+			}
+
 #if GAIA_OBSERVERS_ENABLED
 			if (world.tearing_down())
 				return;
@@ -14479,6 +15372,9 @@ namespace gaia {
 		//! \param term Component or pair id that was written.
 		//! \param entity Entity that was written.
 		inline void world_notify_on_set_entity(World& world, Entity term, Entity entity) {
+			if GAIA_UNLIKELY (world.journal_comp(term) && !world.tearing_down() && world.valid(entity))
+				world.journal().record(JournalOp::Write, entity, term);
+
 #if GAIA_OBSERVERS_ENABLED
 			if (world.tearing_down())
 				return;
@@ -0,0 +1,201 @@
+#pragma once
+#include "gaia/config/config.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "gaia/mem/simd.h"
+
+namespace gaia {
+	namespace mem {
+		//! Size of one non-temporal store in bytes. Streamed ranges are aligned to it.
+		inline constexpr uint32_t StreamStoreBytes = 16;
+		//! Ranges shorter than this are always written with regular stores.
+		//! Setting up a streamed write does not pay off for a handful of cache lines.
+		inline constexpr uint32_t StreamMinBytes = 256;
+		//! Longest repeat period fill_pattern is able to stream. Longer periods fall back to regular stores.
+		inline constexpr uint32_t StreamMaxPeriod = 4096;
+
+		//! True if the target supports non-temporal stores. Streamed calls degrade to regular stores otherwise.
+		inline constexpr bool StreamStoreSupported = GAIA_SIMD_SSE2 != 0;
+
+		//! \cond INTERNAL
+		namespace detail {
+			//! Copies \a size bytes from \a pSrc to \a pDst bypassing the cache.
+			//! \a pDst must be aligned to StreamStoreBytes and \a size must be a multiple of it.
+			inline void stream_copy_aligned(uint8_t* pDst, const uint8_t* pSrc, size_t size) noexcept {
+				GAIA_ASSERT((uintptr_t)pDst % StreamStoreBytes == 0);
+				GAIA_ASSERT(size % StreamStoreBytes == 0);
+#if GAIA_SIMD_SSE2
+				size_t off = 0;
+				for (; off + 64 <= size; off += 64) {
+					const auto a = _mm_loadu_si128((const __m128i*)(pSrc + off));
+					const auto b = _mm_loadu_si128((const __m128i*)(pSrc + off + 16));
+					const auto c = _mm_loadu_si128((const __m128i*)(pSrc + off + 32));
+					const auto d = _mm_loadu_si128((const __m128i*)(pSrc + off + 48));
+					_mm_stream_si128((__m128i*)(pDst + off), a);
+					_mm_stream_si128((__m128i*)(pDst + off + 16), b);
+					_mm_stream_si128((__m128i*)(pDst + off + 32), c);
+					_mm_stream_si128((__m128i*)(pDst + off + 48), d);
+				}
+				for (; off < size; off += 16)
+					_mm_stream_si128((__m128i*)(pDst + off), _mm_loadu_si128((const __m128i*)(pSrc + off)));
+#else
+				memcpy(pDst, pSrc, size);
+#endif
+			}
+
+			//! Zeroes \a size bytes at \a pDst bypassing the cache.
+			//! \a pDst must be aligned to StreamStoreBytes and \a size must be a multiple of it.
+			inline void stream_zero_aligned(uint8_t* pDst, size_t size) noexcept {
+				GAIA_ASSERT((uintptr_t)pDst % StreamStoreBytes == 0);
+				GAIA_ASSERT(size % StreamStoreBytes == 0);
+#if GAIA_SIMD_SSE2
+				const auto z = _mm_setzero_si128();
+				for (size_t off = 0; off < size; off += 16)
+					_mm_stream_si128((__m128i*)(pDst + off), z);
+#else
+				memset(pDst, 0, size);
+#endif
+			}
+
+			//! Makes preceding non-temporal stores globally visible before any later store.
+			inline void stream_fence() noexcept {
+#if GAIA_SIMD_SSE2
+				_mm_sfence();
+#endif
+			}
+
+			//! Returns the number of bytes needed to move \a p to the next StreamStoreBytes boundary.
+			GAIA_NODISCARD inline size_t stream_head(const void* p) noexcept {
+				return (size_t)((StreamStoreBytes - ((uintptr_t)p % StreamStoreBytes)) % StreamStoreBytes);
+			}
+
+			//! Fills the first \a size bytes at \a pDst with a sequence repeating the first \a period bytes
+			//! already stored there. Every step doubles the initialized range so there are log2(size / period)
+			//! memcpy calls, each of them working on a range which does not overlap its source.
+			inline void fill_repeat(uint8_t* pDst, size_t period, size_t size) noexcept {
+				size_t filled = period;
+				while (filled < size) {
+					const size_t n = filled < size - filled ? filled : size - filled;
+					memcpy(pDst + filled, pDst, n);
+					filled += n;
+				}
+			}
+		} // namespace detail
+		//! \endcond
+
+		//! Zeroes \a size bytes at \a pDst.
+		//! \param pDst Destination address
+		//! \param size Number of bytes to zero
+		//! \param stream If true, the aligned middle part of the range is written with non-temporal stores
+		inline void fill_zero(void* pDst, size_t size, bool stream) noexcept {
+			auto* pD = (uint8_t*)pDst;
+			if (!StreamStoreSupported || !stream || size < StreamMinBytes) {
+				memset(pD, 0, size);
+				return;
+			}
+
+			const auto head = detail::stream_head(pD);
+			const auto body = (size - head) & ~(size_t)(StreamStoreBytes - 1);
+			memset(pD, 0, head);
+			detail::stream_zero_aligned(pD + head, body);
+			memset(pD + head + body, 0, size - head - body);
+			detail::stream_fence();
+		}
+
+		//! Copies \a size bytes from \a pSrc to \a pDst. The ranges must not overlap.
+		//! \param pDst Destination address
+		//! \param pSrc Source address
+		//! \param size Number of bytes to copy
+		//! \param stream If true, the aligned middle part of the destination is written with non-temporal stores
+		inline void copy_bytes(void* GAIA_RESTRICT pDst, const void* GAIA_RESTRICT pSrc, size_t size, bool stream) noexcept {
+			auto* pD = (uint8_t*)pDst;
+			const auto* pS = (const uint8_t*)pSrc;
+			if (!StreamStoreSupported || !stream || size < StreamMinBytes) {
+				memcpy(pD, pS, size);
+				return;
+			}
+
+			const auto head = detail::stream_head(pD);
+			const auto body = (size - head) & ~(size_t)(StreamStoreBytes - 1);
+			memcpy(pD, pS, head);
+			detail::stream_copy_aligned(pD + head, pS + head, body);
+			memcpy(pD + head + body, pS + head + body, size - head - body);
+			detail::stream_fence();
+		}
+
+		//! Writes \a cnt consecutive copies of the \a patternSize bytes at \a pPattern to \a pDst.
+		//! This is how one prototype value is replicated over a range of rows of a component column.
+		//! All-zero patterns turn into fill_zero. Other patterns are replicated by doubling the initialized
+		//! range which takes a logarithmic number of memcpy calls.
+		//!
+		//! When streaming, a prefix long enough to contain a whole number of patterns which is also a multiple
+		//! of StreamStoreBytes is initialized with regular stores. It stays in the cache and serves as the source
+		//! of non-temporal copies covering the rest of the range.
+		//! \param pDst Destination address. Must not overlap the pattern.
+		//! \param pPattern Bytes to replicate
+		//! \param patternSize Size of the pattern in bytes
+		//! \param cnt Number of copies to write
+		//! \param stream If true, most of the range is written with non-temporal stores
+		inline void fill_pattern(
+				void* GAIA_RESTRICT pDst, const void* GAIA_RESTRICT pPattern, size_t patternSize, size_t cnt,
+				bool stream) noexcept {
+			const size_t size = patternSize * cnt;
+			if (size == 0)
+				return;
+
+			auto* pD = (uint8_t*)pDst;
+			const auto* pP = (const uint8_t*)pPattern;
+
+			bool zero = true;
+			GAIA_FOR(patternSize) {
+				if (pP[i] != 0) {
+					zero = false;
+					break;
+				}
+			}
+			if (zero) {
+				fill_zero(pD, size, stream);
+				return;
+			}
+
+			if (patternSize == 1) {
+				memset(pD, pP[0], size);
+				return;
+			}
+
+			memcpy(pD, pP, patternSize);
+
+			if (StreamStoreSupported && stream && size >= StreamMinBytes) {
+				// The shortest period which is a multiple of both the pattern and the store size
+				size_t a = patternSize;
+				size_t b = StreamStoreBytes;
+				while (b != 0) {
+					const size_t t = a % b;
+					a = b;
+					b = t;
+				}
+				size_t period = patternSize * (StreamStoreBytes / a);
+				while (period < StreamMinBytes)
+					period *= 2;
+
+				const auto head = detail::stream_head(pD);
+				if (period <= StreamMaxPeriod && head + 2 * period <= size) {
+					detail::fill_repeat(pD, patternSize, head + period);
+
+					// Byte k of the range equals byte k - period so [head, head + period) can be copied forward.
+					size_t off = head + period;
+					for (; off + period <= size; off += period)
+						detail::stream_copy_aligned(pD + off, pD + head, period);
+					memcpy(pD + off, pD + head, size - off);
+					detail::stream_fence();
+					return;
+				}
+			}
+
+			detail::fill_repeat(pD, patternSize, size);
+		}
+	} // namespace mem
+} // namespace gaia
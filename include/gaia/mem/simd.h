@@ -0,0 +1,394 @@
+#pragma once
+#include "gaia/config/config.h"
+
+#include <cstdint>
+#include <type_traits>
+
+#if GAIA_ARCH == GAIA_ARCH_X86
+	#include <immintrin.h>
+#elif GAIA_ARCH == GAIA_ARCH_ARM && (defined(__aarch64__) || defined(_M_ARM64))
+	#include <arm_neon.h>
+#endif
+
+// Native lane types. They are only used when the target enables them, e.g. via -mavx or /arch:AVX.
+#if GAIA_ARCH == GAIA_ARCH_X86 && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define GAIA_SIMD_SSE2 1
+#else
+	#define GAIA_SIMD_SSE2 0
+#endif
+#if GAIA_ARCH == GAIA_ARCH_X86 && defined(__AVX__)
+	#define GAIA_SIMD_AVX 1
+#else
+	#define GAIA_SIMD_AVX 0
+#endif
+#if GAIA_ARCH == GAIA_ARCH_X86 && defined(__AVX512F__)
+	#define GAIA_SIMD_AVX512 1
+#else
+	#define GAIA_SIMD_AVX512 0
+#endif
+#if GAIA_ARCH == GAIA_ARCH_ARM && (defined(__aarch64__) || defined(_M_ARM64))
+	#define GAIA_SIMD_NEON 1
+#else
+	#define GAIA_SIMD_NEON 0
+#endif
+
+namespace gaia {
+	namespace mem {
+		//! Width of the widest vector register enabled for the target in bytes.
+#if GAIA_SIMD_AVX512
+		inline constexpr uint32_t SimdNativeBytes = 64;
+#elif GAIA_SIMD_AVX
+		inline constexpr uint32_t SimdNativeBytes = 32;
+#else
+		inline constexpr uint32_t SimdNativeBytes = 16;
+#endif
+
+		//! Fixed-width pack of \a N arithmetic lanes.
+		//!
+		//! The generic version stores the lanes in an array and implements every operation as a fixed-size loop,
+		//! which compilers turn into vector code for any target. Widths matching a native register of the
+		//! target (SSE2, AVX, AVX-512, NEON) are specialized to use intrinsics directly.
+		//! \tparam T Lane type
+		//! \tparam N Number of lanes
+		template <typename T, uint32_t N>
+		struct simd_vec {
+			static_assert(std::is_arithmetic_v<T>, "simd_vec lanes need to be arithmetic");
+			static_assert(N > 0 && (N & (N - 1)) == 0, "simd_vec lane count needs to be a power of two");
+
+			using value_type = T;
+			static constexpr uint32_t Lanes = N;
+
+			T v[N];
+
+			//! Loads lanes from memory aligned to sizeof(T) * N bytes.
+			GAIA_NODISCARD static simd_vec load(const T* p) noexcept {
+				simd_vec r;
+				GAIA_FOR(N) r.v[i] = p[i];
+				return r;
+			}
+			//! Loads lanes from memory with no alignment requirements.
+			GAIA_NODISCARD static simd_vec loadu(const T* p) noexcept {
+				return load(p);
+			}
+			//! Returns a pack with all lanes set to \a x.
+			GAIA_NODISCARD static simd_vec splat(T x) noexcept {
+				simd_vec r;
+				GAIA_FOR(N) r.v[i] = x;
+				return r;
+			}
+			//! Returns a pack with all lanes set to zero.
+			GAIA_NODISCARD static simd_vec zero() noexcept {
+				return splat(T(0));
+			}
+			//! Stores lanes to memory aligned to sizeof(T) * N bytes.
+			void store(T* p) const noexcept {
+				GAIA_FOR(N) p[i] = v[i];
+			}
+			//! Stores lanes to memory with no alignment requirements.
+			void storeu(T* p) const noexcept {
+				store(p);
+			}
+
+			GAIA_NODISCARD friend simd_vec operator+(simd_vec a, simd_vec b) noexcept {
+				GAIA_FOR(N) a.v[i] += b.v[i];
+				return a;
+			}
+			GAIA_NODISCARD friend simd_vec operator-(simd_vec a, simd_vec b) noexcept {
+				GAIA_FOR(N) a.v[i] -= b.v[i];
+				return a;
+			}
+			GAIA_NODISCARD friend simd_vec operator*(simd_vec a, simd_vec b) noexcept {
+				GAIA_FOR(N) a.v[i] *= b.v[i];
+				return a;
+			}
+			GAIA_NODISCARD friend simd_vec operator/(simd_vec a, simd_vec b) noexcept {
+				GAIA_FOR(N) a.v[i] /= b.v[i];
+				return a;
+			}
+			GAIA_NODISCARD friend simd_vec min(simd_vec a, simd_vec b) noexcept {
+				GAIA_FOR(N) a.v[i] = b.v[i] < a.v[i] ? b.v[i] : a.v[i];
+				return a;
+			}
+			GAIA_NODISCARD friend simd_vec max(simd_vec a, simd_vec b) noexcept {
+				GAIA_FOR(N) a.v[i] = a.v[i] < b.v[i] ? b.v[i] : a.v[i];
+				return a;
+			}
+			//! Returns lanes of \a x where a < b and lanes of \a y everywhere else.
+			GAIA_NODISCARD friend simd_vec select_lt(simd_vec a, simd_vec b, simd_vec x, simd_vec y) noexcept {
+				GAIA_FOR(N) x.v[i] = a.v[i] < b.v[i] ? x.v[i] : y.v[i];
+				return x;
+			}
+		};
+
+		//! \cond INTERNAL
+		namespace detail {
+			//! Implements the operators shared by all native lane packs on top of the Ops table of \a V.
+			template <typename V>
+			struct simd_native_ops {
+				GAIA_NODISCARD friend V operator+(V a, V b) noexcept {
+					return {V::Ops::add(a.r, b.r)};
+				}
+				GAIA_NODISCARD friend V operator-(V a, V b) noexcept {
+					return {V::Ops::sub(a.r, b.r)};
+				}
+				GAIA_NODISCARD friend V operator*(V a, V b) noexcept {
+					return {V::Ops::mul(a.r, b.r)};
+				}
+				GAIA_NODISCARD friend V operator/(V a, V b) noexcept {
+					return {V::Ops::div(a.r, b.r)};
+				}
+				GAIA_NODISCARD friend V min(V a, V b) noexcept {
+					return {V::Ops::min(a.r, b.r)};
+				}
+				GAIA_NODISCARD friend V max(V a, V b) noexcept {
+					return {V::Ops::max(a.r, b.r)};
+				}
+				GAIA_NODISCARD friend V select_lt(V a, V b, V x, V y) noexcept {
+					return {V::Ops::select_lt(a.r, b.r, x.r, y.r)};
+				}
+			};
+		} // namespace detail
+		//! \endcond
+
+#define GAIA_SIMD_NATIVE_VEC(T, N, Reg, OpsT)                                                                          \
+	template <>                                                                                                          \
+	struct simd_vec<T, N>: detail::simd_native_ops<simd_vec<T, N>> {                                                     \
+		using Ops = OpsT;                                                                                                  \
+		using value_type = T;                                                                                              \
+		static constexpr uint32_t Lanes = N;                                                                               \
+                                                                                                                       \
+		Reg r;                                                                                                             \
+                                                                                                                       \
+		simd_vec() = default;                                                                                              \
+		simd_vec(Reg reg) noexcept: r(reg) {}                                                                              \
+                                                                                                                       \
+		GAIA_NODISCARD static simd_vec load(const T* p) noexcept {                                                         \
+			return {Ops::load(p)};                                                                                           \
+		}                                                                                                                  \
+		GAIA_NODISCARD static simd_vec loadu(const T* p) noexcept {                                                        \
+			return {Ops::loadu(p)};                                                                                          \
+		}                                                                                                                  \
+		GAIA_NODISCARD static simd_vec splat(T x) noexcept {                                                               \
+			return {Ops::splat(x)};                                                                                          \
+		}                                                                                                                  \
+		GAIA_NODISCARD static simd_vec zero() noexcept {                                                                   \
+			return {Ops::splat(T(0))};                                                                                       \
+		}                                                                                                                  \
+		void store(T* p) const noexcept {                                                                                  \
+			Ops::store(p, r);                                                                                                \
+		}                                                                                                                  \
+		void storeu(T* p) const noexcept {                                                                                 \
+			Ops::storeu(p, r);                                                                                               \
+		}                                                                                                                  \
+	}
+
+		//! \cond INTERNAL
+		namespace detail {
+#if GAIA_SIMD_SSE2
+			struct simd_ops_sse_f32 {
+				static __m128 load(const float* p) noexcept {
+					return _mm_load_ps(p);
+				}
+				static __m128 loadu(const float* p) noexcept {
+					return _mm_loadu_ps(p);
+				}
+				static __m128 splat(float x) noexcept {
+					return _mm_set1_ps(x);
+				}
+				static void store(float* p, __m128 a) noexcept {
+					_mm_store_ps(p, a);
+				}
+				static void storeu(float* p, __m128 a) noexcept {
+					_mm_storeu_ps(p, a);
+				}
+				static __m128 add(__m128 a, __m128 b) noexcept {
+					return _mm_add_ps(a, b);
+				}
+				static __m128 sub(__m128 a, __m128 b) noexcept {
+					return _mm_sub_ps(a, b);
+				}
+				static __m128 mul(__m128 a, __m128 b) noexcept {
+					return _mm_mul_ps(a, b);
+				}
+				static __m128 div(__m128 a, __m128 b) noexcept {
+					return _mm_div_ps(a, b);
+				}
+				static __m128 min(__m128 a, __m128 b) noexcept {
+					return _mm_min_ps(a, b);
+				}
+				static __m128 max(__m128 a, __m128 b) noexcept {
+					return _mm_max_ps(a, b);
+				}
+				static __m128 select_lt(__m128 a, __m128 b, __m128 x, __m128 y) noexcept {
+					const auto m = _mm_cmplt_ps(a, b);
+					return _mm_or_ps(_mm_and_ps(m, x), _mm_andnot_ps(m, y));
+				}
+			};
+#endif
+#if GAIA_SIMD_AVX
+			struct simd_ops_avx_f32 {
+				static __m256 load(const float* p) noexcept {
+					return _mm256_load_ps(p);
+				}
+				static __m256 loadu(const float* p) noexcept {
+					return _mm256_loadu_ps(p);
+				}
+				static __m256 splat(float x) noexcept {
+					return _mm256_set1_ps(x);
+				}
+				static void store(float* p, __m256 a) noexcept {
+					_mm256_store_ps(p, a);
+				}
+				static void storeu(float* p, __m256 a) noexcept {
+					_mm256_storeu_ps(p, a);
+				}
+				static __m256 add(__m256 a, __m256 b) noexcept {
+					return _mm256_add_ps(a, b);
+				}
+				static __m256 sub(__m256 a, __m256 b) noexcept {
+					return _mm256_sub_ps(a, b);
+				}
+				static __m256 mul(__m256 a, __m256 b) noexcept {
+					return _mm256_mul_ps(a, b);
+				}
+				static __m256 div(__m256 a, __m256 b) noexcept {
+					return _mm256_div_ps(a, b);
+				}
+				static __m256 min(__m256 a, __m256 b) noexcept {
+					return _mm256_min_ps(a, b);
+				}
+				static __m256 max(__m256 a, __m256 b) noexcept {
+					return _mm256_max_ps(a, b);
+				}
+				static __m256 select_lt(__m256 a, __m256 b, __m256 x, __m256 y) noexcept {
+					return _mm256_blendv_ps(y, x, _mm256_cmp_ps(a, b, _CMP_LT_OQ));
+				}
+			};
+#endif
+#if GAIA_SIMD_AVX512
+			struct simd_ops_avx512_f32 {
+				static __m512 load(const float* p) noexcept {
+					return _mm512_load_ps(p);
+				}
+				static __m512 loadu(const float* p) noexcept {
+					return _mm512_loadu_ps(p);
+				}
+				static __m512 splat(float x) noexcept {
+					return _mm512_set1_ps(x);
+				}
+				static void store(float* p, __m512 a) noexcept {
+					_mm512_store_ps(p, a);
+				}
+				static void storeu(float* p, __m512 a) noexcept {
+					_mm512_storeu_ps(p, a);
+				}
+				static __m512 add(__m512 a, __m512 b) noexcept {
+					return _mm512_add_ps(a, b);
+				}
+				static __m512 sub(__m512 a, __m512 b) noexcept {
+					return _mm512_sub_ps(a, b);
+				}
+				static __m512 mul(__m512 a, __m512 b) noexcept {
+					return _mm512_mul_ps(a, b);
+				}
+				static __m512 div(__m512 a, __m512 b) noexcept {
+					return _mm512_div_ps(a, b);
+				}
+				static __m512 min(__m512 a, __m512 b) noexcept {
+					return _mm512_min_ps(a, b);
+				}
+				static __m512 max(__m512 a, __m512 b) noexcept {
+					return _mm512_max_ps(a, b);
+				}
+				static __m512 select_lt(__m512 a, __m512 b, __m512 x, __m512 y) noexcept {
+					return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a, b, _CMP_LT_OQ), y, x);
+				}
+			};
+#endif
+#if GAIA_SIMD_NEON
+			struct simd_ops_neon_f32 {
+				static float32x4_t load(const float* p) noexcept {
+					return vld1q_f32(p);
+				}
+				static float32x4_t loadu(const float* p) noexcept {
+					return vld1q_f32(p);
+				}
+				static float32x4_t splat(float x) noexcept {
+					return vdupq_n_f32(x);
+				}
+				static void store(float* p, float32x4_t a) noexcept {
+					vst1q_f32(p, a);
+				}
+				static void storeu(float* p, float32x4_t a) noexcept {
+					vst1q_f32(p, a);
+				}
+				static float32x4_t add(float32x4_t a, float32x4_t b) noexcept {
+					return vaddq_f32(a, b);
+				}
+				static float32x4_t sub(float32x4_t a, float32x4_t b) noexcept {
+					return vsubq_f32(a, b);
+				}
+				static float32x4_t mul(float32x4_t a, float32x4_t b) noexcept {
+					return vmulq_f32(a, b);
+				}
+				static float32x4_t div(float32x4_t a, float32x4_t b) noexcept {
+					return vdivq_f32(a, b);
+				}
+				static float32x4_t min(float32x4_t a, float32x4_t b) noexcept {
+					return vminq_f32(a, b);
+				}
+				static float32x4_t max(float32x4_t a, float32x4_t b) noexcept {
+					return vmaxq_f32(a, b);
+				}
+				static float32x4_t select_lt(float32x4_t a, float32x4_t b, float32x4_t x, float32x4_t y) noexcept {
+					return vbslq_f32(vcltq_f32(a, b), x, y);
+				}
+			};
+#endif
+		} // namespace detail
+		//! \endcond
+
+#if GAIA_SIMD_SSE2
+		GAIA_SIMD_NATIVE_VEC(float, 4, __m128, detail::simd_ops_sse_f32);
+#elif GAIA_SIMD_NEON
+		GAIA_SIMD_NATIVE_VEC(float, 4, float32x4_t, detail::simd_ops_neon_f32);
+#endif
+#if GAIA_SIMD_AVX
+		GAIA_SIMD_NATIVE_VEC(float, 8, __m256, detail::simd_ops_avx_f32);
+#endif
+#if GAIA_SIMD_AVX512
+		GAIA_SIMD_NATIVE_VEC(float, 16, __m512, detail::simd_ops_avx512_f32);
+#endif
+
+#undef GAIA_SIMD_NATIVE_VEC
+
+		//! Lane pack filling the widest native vector register of the target.
+		template <typename T>
+		using simd_vec_native = simd_vec<T, SimdNativeBytes / (uint32_t)sizeof(T)>;
+
+		//! Loads lanes [lo, hi) from \a p. The remaining lanes are set to zero and their memory is never touched.
+		//! \param p Address of the first lane, aligned or not.
+		//! \param lo First lane to load
+		//! \param hi One past the last lane to load
+		template <typename V>
+		GAIA_NODISCARD V simd_load_masked(const typename V::value_type* p, uint32_t lo, uint32_t hi) noexcept {
+			GAIA_ASSERT(lo <= hi && hi <= V::Lanes);
+			alignas(sizeof(typename V::value_type) * V::Lanes) typename V::value_type tmp[V::Lanes]{};
+			GAIA_FOR2(lo, hi) tmp[i] = p[i];
+			return V::load(tmp);
+		}
+
+		//! Stores lanes [lo, hi) of \a v to \a p. Memory of the remaining lanes is left untouched.
+		//! \param p Address of the first lane, aligned or not.
+		//! \param v Lanes to store
+		//! \param lo First lane to store
+		//! \param hi One past the last lane to store
+		template <typename V>
+		void simd_store_masked(typename V::value_type* p, V v, uint32_t lo, uint32_t hi) noexcept {
+			GAIA_ASSERT(lo <= hi && hi <= V::Lanes);
+			alignas(sizeof(typename V::value_type) * V::Lanes) typename V::value_type tmp[V::Lanes];
+			v.store(tmp);
+			GAIA_FOR2(lo, hi) p[i] = tmp[i];
+		}
+	} // namespace mem
+} // namespace gaia
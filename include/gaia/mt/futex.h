@@ -5,6 +5,17 @@
 #include <atomic>
 #include <mutex>
 
+#if GAIA_USE_NATIVE_FUTEX && GAIA_PLATFORM_LINUX
+	#define GAIA_FUTEX_NATIVE 1
+	#include <cerrno>
+	#include <climits>
+	#include <linux/futex.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#else
+	#define GAIA_FUTEX_NATIVE 0
+#endif
+
 #include "gaia/core/utility.h"
 #include "gaia/mt/event.h"
 
@@ -15,6 +26,14 @@ namespace gaia {
 			inline static constexpr uint32_t WaitMaskAll = 0x7FFFFFFF;
 			inline static constexpr uint32_t WaitMaskAny = ~0u;
 
+#if GAIA_FUTEX_NATIVE
+			static_assert(sizeof(std::atomic_uint32_t) == sizeof(uint32_t));
+
+			//! Returns the address the kernel associates with \a pFutexValue.
+			inline uint32_t* futex_addr(const std::atomic_uint32_t* pFutexValue) {
+				return reinterpret_cast<uint32_t*>(const_cast<std::atomic_uint32_t*>(pFutexValue));
+			}
+#else
 			struct FutexWaitNode {
 				FutexWaitNode* pNext = nullptr;
 				const std::atomic_uint32_t* pFutexValue = nullptr;
@@ -39,6 +58,7 @@ namespace gaia {
 			//! Per-thread wait node. A thread can only be waiting on a single futex at a time.
 			//! Do NOT call Futex::wait() from the same thread concurrently (e.g. via fibers or coroutines).
 			inline thread_local FutexWaitNode t_WaitNode;
+#endif
 			//! \endcond
 
 		} // namespace detail
@@ -52,8 +72,10 @@ namespace gaia {
 		//! Only when there is contention does a futex use the kernel to put threads to sleep and wake them up,
 		//! resulting in a hybrid model that is more efficient than mutexes, which always require kernel calls.
 		//!
-		//! TODO: Consider using WaitOnAddress for Windows, futex call for Linux etc.
-		//!       The current solution is platform-agnostic but platform-specific solutions might be more performant.
+		//! On Linux the futex system call is used directly (see GAIA_USE_NATIVE_FUTEX). Wait and wake masks map
+		//! to the kernel's bitset operations. Elsewhere, waiters are kept in mutex-protected hash buckets
+		//! and each of them sleeps on its own event.
+		//! TODO: Consider using WaitOnAddress for Windows.
 		struct Futex {
 			//! Outcome of a futex wait attempt.
 			enum class Result {
@@ -75,6 +97,15 @@ namespace gaia {
 
 				GAIA_ASSERT(waitMask != 0);
 
+#if GAIA_FUTEX_NATIVE
+				const auto ret = syscall(
+						SYS_futex, detail::futex_addr(pFutexValue), FUTEX_WAIT_BITSET_PRIVATE, expected, nullptr, nullptr,
+						waitMask);
+				// EINTR and spurious wakeups are reported as WakeUp. Callers re-check the value in a loop anyway.
+				if (ret == -1 && errno == EAGAIN)
+					return Result::Change;
+				return Result::WakeUp;
+#else
 				auto& bucket = detail::FutexBucket::get(pFutexValue);
 				auto& node = detail::t_WaitNode;
 				node.pFutexValue = pFutexValue;
@@ -95,6 +126,7 @@ namespace gaia {
 
 				node.evt.wait();
 				return Result::WakeUp;
+#endif
 			}
 
 			//! Wakes up to \a wakeCount waiters whose \a waitMask matches \a wakeMask.
@@ -108,6 +140,12 @@ namespace gaia {
 
 				GAIA_ASSERT(wakeMask != 0);
 
+#if GAIA_FUTEX_NATIVE
+				const auto cnt = wakeCount < (uint32_t)INT_MAX ? wakeCount : (uint32_t)INT_MAX;
+				const auto ret = syscall(
+						SYS_futex, detail::futex_addr(pFutexValue), FUTEX_WAKE_BITSET_PRIVATE, cnt, nullptr, nullptr, wakeMask);
+				return ret < 0 ? 0 : (uint32_t)ret;
+#else
 				auto& bucket = detail::FutexBucket::get(pFutexValue);
 				auto& mtx = GAIA_PROF_EXTRACT_MUTEX(bucket.mtx);
 				core::lock_scope lock(mtx);
@@ -130,6 +168,7 @@ namespace gaia {
 				}
 
 				return numAwoken;
+#endif
 			}
 		};
 	} // namespace mt
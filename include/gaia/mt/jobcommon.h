@@ -239,13 +239,24 @@ namespace gaia {
 			bool threadCreated = false;
 			//! Event signaled when a job is executed
 			Event event;
-			//! Lock-free work stealing queue for the jobs
-			JobQueue<512> jobQueue;
+			//! Lock-free work stealing queue for the jobs. Grows when full.
+			JobDeque<512> jobQueue;
+
+			//! Maximum number of job slots cached by one thread
+			static constexpr uint32_t JobSlotCacheCapacity = 64;
+			//! Slots of jobs deleted by this thread that were not returned to the shared job pool yet.
+			//! Jobs created by this thread take them first so jobs spawned and deleted from inside
+			//! running jobs rarely need to lock the job pool.
+			JobId jobSlotCache[JobSlotCacheCapacity];
+			//! Number of valid items in jobSlotCache
+			uint32_t jobSlotCacheCnt = 0;
 
 			ThreadCtx() = default;
 			~ThreadCtx() = default;
 
+			//! \warning Cached job slots need to be returned to the job pool before calling this.
 			void reset() {
+				GAIA_ASSERT(jobSlotCacheCnt == 0);
 				background = false;
 				threadCreated = false;
 				event.reset();
@@ -231,12 +231,18 @@ namespace gaia {
 		class JobManager {
 			using JobDataLayout = cnt::paged_ilist<JobContainer, JobHandle>;
 			static constexpr uint32_t JobDataPageCount = JobDataLayout::page_count_for_capacity(JobHandle::IdMask);
+			using ParallelCallbackLayout = cnt::paged_ilist<ParallelCallbackRecord, ParallelCallbackHandle>;
+			//! Every callback record is referenced by at least one live job so there can't be more records than jobs
+			static constexpr uint32_t ParallelCallbackPageCount =
+					ParallelCallbackLayout::page_count_for_capacity(JobHandle::IdMask);
 
 			//! Paged implicit list of jobs with a fixed page table.
 			//! Payload pages are still allocated lazily, but the page table never moves while background jobs are running.
 			cnt::paged_ilist<JobContainer, JobHandle, JobDataPageCount> m_jobData;
 			//! Shared callback records for parallel jobs.
-			cnt::ilist<ParallelCallbackRecord, ParallelCallbackHandle> m_parallelCallbacks;
+			//! Parallel jobs can be scheduled from worker threads while other workers invoke callbacks
+			//! so records live in a fixed page table as well.
+			cnt::paged_ilist<ParallelCallbackRecord, ParallelCallbackHandle, ParallelCallbackPageCount> m_parallelCallbacks;
 
 		public:
 			//! Returns mutable internal storage for \a jobHandle.
@@ -252,21 +258,25 @@ namespace gaia {
 
 			//! Allocates a new job container identified by a unique JobHandle.
 			//! \return JobHandle
-			//! \warning Must be used from the main thread.
+			//! \warning Caller must serialize job-pool allocation/free access.
 			GAIA_NODISCARD JobHandle alloc_job(Job job) {
 				JobAllocCtx ctx{job.priority};
 
 				auto handle = m_jobData.alloc(&ctx);
-				auto& j = m_jobData[handle.id()];
+				init_job(m_jobData[handle.id()], GAIA_MOV(job));
+				return handle;
+			}
 
-				// Make sure there is not state yet
-				GAIA_ASSERT(j.state == 0 || j.state == JobState::Released);
+			//! Allocates a new job container in a slot previously retired by retire_job.
+			//! \param jobId Slot index of the retired job.
+			//! \param job Job descriptor.
+			//! \return JobHandle
+			//! \note Only the retired slot is touched so no locking is needed as long as the caller owns the slot.
+			GAIA_NODISCARD JobHandle reuse_job(JobId jobId, Job job) {
+				JobAllocCtx ctx{job.priority};
 
-				j.edges = {};
-				j.prio = ctx.priority;
-				j.state.store(0);
-				j.func = GAIA_MOV(job.func);
-				j.flags = job.flags;
+				auto handle = m_jobData.reuse_retired(jobId, &ctx);
+				init_job(m_jobData.live_unsafe(jobId), GAIA_MOV(job));
 				return handle;
 			}
 
@@ -292,6 +302,25 @@ namespace gaia {
 				m_jobData.free_keep_live(jobHandle);
 			}
 
+			//! Invalidates \a jobHandle without returning its slot to the job pool.
+			//! The generation is increased by one, same as with free_job. The caller takes ownership of the
+			//! slot and either reuses it via reuse_job or returns it to the pool via free_retired_job.
+			//! \param jobHandle Job handle.
+			//! \note Only the retired slot is touched so no locking is needed.
+			void retire_job(JobHandle jobHandle) {
+				auto& jobData = m_jobData.live_unsafe(jobHandle.id());
+				GAIA_ASSERT(done(jobData));
+				jobData.state.store(JobState::Released);
+				m_jobData.retire_keep_live(jobHandle);
+			}
+
+			//! Returns a slot retired by retire_job to the job pool.
+			//! \param jobId Slot index of the retired job.
+			//! \warning Caller must serialize job-pool allocation/free access.
+			void free_retired_job(JobId jobId) {
+				m_jobData.free_retired(jobId);
+			}
+
 			//! Releases a shared callback record.
 			//! \param handle Handle of the callback record to free.
 			void free_parallel_callback(ParallelCallbackHandle handle) {
@@ -537,7 +566,29 @@ namespace gaia {
 				return record.refs.fetch_sub(1, std::memory_order_acq_rel) == 1;
 			}
 
+			//! Checks whether the job referenced by \a jobHandle is done.
+			//! Slots of finished jobs can be handed to new jobs at any moment, even by worker threads.
+			//! A generation different from the one stored in \a jobHandle therefore means the job is done as well.
+			//! \param jobData Job storage referenced by \a jobHandle.
+			//! \param jobHandle Handle of the job to inspect.
+			//! \return True when the job finished executing or the slot already holds a different job.
+			GAIA_NODISCARD static bool done(const JobContainer& jobData, JobHandle jobHandle) {
+				const auto state = jobData.state.load() & JobState::STATE_BITS_MASK;
+				return state >= JobState::Done || jobData.data.gen != jobHandle.gen();
+			}
+
 		private:
+			static void init_job(JobContainer& j, Job&& job) {
+				// Make sure there is not state yet
+				GAIA_ASSERT(j.state == 0 || j.state == JobState::Released);
+
+				j.edges = {};
+				j.prio = job.priority;
+				j.state.store(0);
+				j.func = GAIA_MOV(job.func);
+				j.flags = job.flags;
+			}
+
 			void dep_internal(JobHandle jobFirst, JobHandle jobSecond) {
 				GAIA_ASSERT(jobFirst != (JobHandle)JobNull_t{});
 				GAIA_ASSERT(jobSecond != (JobHandle)JobNull_t{});
@@ -7,6 +7,7 @@
 #include "gaia/cnt/sarray.h"
 #include "gaia/config/profiler.h"
 #include "gaia/core/utility.h"
+#include "gaia/mem/mem_alloc.h"
 #include "gaia/mt/jobhandle.h"
 
 // MSVC might warn about applying additional padding around alignas usage.
@@ -158,6 +159,334 @@ namespace gaia {
 			}
 		};
 
+		//! Lock-less growable job stealing deque. Inspired heavily by:
+		//! https://www.dre.vanderbilt.edu/~schmidt/PDF/work-stealing-dequeue.pdf
+		//! The owner thread pushes and pops jobs at the bottom, any other thread can steal them from the top.
+		//! Unlike JobQueue it never runs out of space. When the circular buffer is full the owner moves its
+		//! contents to a buffer twice as big.
+		//!
+		//! Thieves might still be reading the old buffer after it has been replaced, so it is retired rather than
+		//! freed right away. Retired buffers are reclaimed using epochs. A thief registers itself in the current epoch
+		//! for the duration of a steal. The owner advances the epoch only once no thief is left in the previous one.
+		//! A buffer retired in epoch E can not be reached by anyone once the epoch reaches E+2 and it is freed then.
+		//! \tparam N Initial capacity. Power of 2.
+		template <const uint32_t N = 1 << 9>
+		class JobDeque {
+			static_assert(N >= 2);
+			static_assert((N & (N - 1)) == 0, "Extent of JobDeque must be a power of 2");
+			static_assert(sizeof(std::atomic_uint32_t) == sizeof(JobHandle));
+
+			struct Buffer {
+				//! Capacity - 1
+				uint32_t mask;
+				//! Epoch in which the buffer was retired
+				uint32_t retiredEpoch;
+				//! Next retired buffer
+				Buffer* pNext;
+
+				GAIA_NODISCARD std::atomic_uint32_t* items() {
+					return (std::atomic_uint32_t*)(this + 1);
+				}
+
+				GAIA_NODISCARD static Buffer* create(uint32_t capacity) {
+					auto* pBuffer =
+							(Buffer*)mem::mem_alloc("JobDeque", sizeof(Buffer) + sizeof(std::atomic_uint32_t) * capacity);
+					pBuffer->mask = capacity - 1;
+					pBuffer->retiredEpoch = 0;
+					pBuffer->pNext = nullptr;
+					auto* pItems = pBuffer->items();
+					GAIA_FOR(capacity) core::call_ctor(&pItems[i], ((JobHandle)JobNull_t()).value());
+					return pBuffer;
+				}
+
+				static void destroy(Buffer* pBuffer) {
+					auto* pItems = pBuffer->items();
+					GAIA_FOR(pBuffer->mask + 1) core::call_dtor(&pItems[i]);
+					mem::mem_free("JobDeque", pBuffer);
+				}
+			};
+
+			//! Current buffer
+			std::atomic<Buffer*> m_buffer;
+			//! Buffers replaced by a bigger one that might still be read by thieves. Owned by the owner thread.
+			Buffer* m_pRetired = nullptr;
+			GAIA_ALIGNAS(GAIA_CACHELINE_SIZE) std::atomic_uint32_t m_bottom;
+			GAIA_ALIGNAS(GAIA_CACHELINE_SIZE) std::atomic_uint32_t m_top;
+			//! Current reclamation epoch. Only the owner advances it.
+			GAIA_ALIGNAS(GAIA_CACHELINE_SIZE) std::atomic_uint32_t m_epoch;
+			//! Number of thieves inside an even and odd epoch
+			std::atomic_uint32_t m_thieves[2];
+
+		public:
+			JobDeque() {
+				m_buffer.store(Buffer::create(N), std::memory_order_relaxed);
+				m_bottom.store(0, std::memory_order_relaxed);
+				m_top.store(0, std::memory_order_relaxed);
+				m_epoch.store(0, std::memory_order_relaxed);
+				m_thieves[0].store(0, std::memory_order_relaxed);
+				m_thieves[1].store(0, std::memory_order_relaxed);
+			}
+
+			~JobDeque() {
+				free_retired(true);
+				Buffer::destroy(m_buffer.load(std::memory_order_relaxed));
+			}
+
+			JobDeque(const JobDeque&) = delete;
+			JobDeque& operator=(const JobDeque&) = delete;
+			JobDeque(JobDeque&&) = delete;
+			JobDeque& operator=(JobDeque&&) = delete;
+
+			//! Removes all jobs and frees retired buffers. The buffer keeps its current capacity.
+			//! \warning No other thread can access the deque while this is called.
+			void clear() {
+				m_bottom.store(0);
+				m_top.store(0);
+				free_retired(true);
+			}
+
+			//! Checks if there are any items in the queue.
+			//! \return True if the queue is empty. False otherwise.
+			GAIA_NODISCARD bool empty() const {
+				GAIA_PROF_SCOPE(JobDeque::empty);
+
+				const uint32_t b = m_bottom.load(std::memory_order_relaxed);
+				const uint32_t t = m_top.load(std::memory_order_relaxed);
+				return int32_t(b - t) <= 0; // b<=t, but handles overflows, too
+			}
+
+			//! Returns the number of jobs the current buffer can hold before it needs to grow.
+			//! \return Current capacity.
+			GAIA_NODISCARD uint32_t capacity() const {
+				return m_buffer.load(std::memory_order_relaxed)->mask + 1;
+			}
+
+			//! Adds a job to the queue. The buffer grows if necessary. Owner thread only.
+			//! \param jobHandle Job to add.
+			void push(JobHandle jobHandle) {
+				GAIA_PROF_SCOPE(JobDeque::push);
+
+				const uint32_t b = m_bottom.load(std::memory_order_relaxed);
+				const uint32_t t = m_top.load(std::memory_order_acquire);
+				auto* pBuffer = reserve(b, t, 1);
+
+				pBuffer->items()[b & pBuffer->mask].store(jobHandle.value(), std::memory_order_relaxed);
+				// Make sure the handle is written before we update the bottom
+				std::atomic_thread_fence(std::memory_order_release);
+				m_bottom.store(b + 1, std::memory_order_relaxed);
+			}
+
+			//! Adds jobs to the queue. The buffer grows at most once. Owner thread only.
+			//! \param jobHandles Jobs to add.
+			void push_n(std::span<const JobHandle> jobHandles) {
+				GAIA_PROF_SCOPE(JobDeque::push_n);
+
+				const auto cnt = (uint32_t)jobHandles.size();
+				uint32_t b = m_bottom.load(std::memory_order_relaxed);
+				const uint32_t t = m_top.load(std::memory_order_acquire);
+				auto* pBuffer = reserve(b, t, cnt);
+
+				auto* pItems = pBuffer->items();
+				const auto mask = pBuffer->mask;
+				for (uint32_t i = 0; i < cnt; i++, b++)
+					pItems[b & mask].store(jobHandles[i].value(), std::memory_order_relaxed);
+				// Make sure handles are written before we update the bottom
+				std::atomic_thread_fence(std::memory_order_release);
+				m_bottom.store(b, std::memory_order_relaxed);
+			}
+
+			//! Tries retrieving a job from the queue. LIFO. Owner thread only.
+			//! \param[out] jobHandle Retrieved job.
+			//! \return True if the job was retrieved. False otherwise (e.g. there are no jobs).
+			GAIA_NODISCARD bool try_pop(JobHandle& jobHandle) {
+				GAIA_PROF_SCOPE(JobDeque::try_pop);
+
+				const uint32_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+				auto* pBuffer = m_buffer.load(std::memory_order_relaxed);
+				m_bottom.store(b, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				uint32_t t = m_top.load(std::memory_order_relaxed);
+
+				if (int(t - b) <= 0) { // t <= b, but handles overflows, too
+					// non-empty queue
+					const uint32_t jobHandleValue = pBuffer->items()[b & pBuffer->mask].load(std::memory_order_relaxed);
+
+					if (t == b) {
+						// last element in the queue
+						const bool ret =
+								m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+						m_bottom.store(b + 1, std::memory_order_relaxed);
+						jobHandle = JobHandle(jobHandleValue);
+						GAIA_ASSERT(jobHandle != (JobHandle)JobNull_t{});
+						return ret; // false = failed race, don't use jobHandle; true = found a result
+					}
+
+					jobHandle = JobHandle(jobHandleValue);
+					GAIA_ASSERT(jobHandle != (JobHandle)JobNull_t{});
+					return true;
+				}
+
+				// empty queue
+				m_bottom.store(b + 1, std::memory_order_relaxed);
+				return false; // false = empty, don't use jobHandle
+			}
+
+			//! Tries stealing a job from the queue. FIFO.
+			//! \param[out] jobHandle Stolen job. JobNull when the queue was empty.
+			//! \return True if the job was stolen or the queue was empty. False if a concurrent pop or steal won the race.
+			GAIA_NODISCARD bool try_steal(JobHandle& jobHandle) {
+				GAIA_PROF_SCOPE(JobDeque::try_steal);
+
+				const uint32_t e = enter();
+				const bool ret = steal_one(jobHandle);
+				leave(e);
+				return ret;
+			}
+
+			//! Steals up to half of the jobs in the queue. FIFO. Every job is claimed separately so a concurrent
+			//! pop never hands out a job that was stolen. The epoch is entered just once for the whole batch, though,
+			//! and the thief can put the jobs into its own queue and skip looking for victims for a while.
+			//! \param[out] jobHandles Stolen jobs. At most jobHandles.size() jobs are stolen.
+			//! \return The number of jobs stolen.
+			GAIA_NODISCARD uint32_t steal_half(std::span<JobHandle> jobHandles) {
+				GAIA_PROF_SCOPE(JobDeque::steal_half);
+
+				const auto maxCnt = (uint32_t)jobHandles.size();
+				if (maxCnt == 0)
+					return 0;
+
+				const uint32_t e = enter();
+
+				// Half of the jobs rounded up so a single job can be stolen, too
+				const uint32_t t = m_top.load(std::memory_order_acquire);
+				const uint32_t b = m_bottom.load(std::memory_order_acquire);
+				const int32_t avail = int32_t(b - t);
+				const uint32_t want = avail <= 0 ? 1 : core::get_min(maxCnt, ((uint32_t)avail + 1) / 2);
+
+				uint32_t cnt = 0;
+				while (cnt < want) {
+					JobHandle jobHandle;
+					// Failed race, try again
+					if (!steal_one(jobHandle))
+						continue;
+					// Empty queue
+					if (jobHandle == (JobHandle)JobNull_t{})
+						break;
+
+					jobHandles[cnt++] = jobHandle;
+				}
+
+				leave(e);
+				return cnt;
+			}
+
+		private:
+			//! Makes sure there is enough space for \a cnt more jobs. Owner thread only.
+			//! \param b Current bottom
+			//! \param t Current top
+			//! \param cnt Number of jobs to be added
+			//! \return Buffer the jobs can be written to
+			GAIA_NODISCARD Buffer* reserve(uint32_t b, uint32_t t, uint32_t cnt) {
+				auto* pBuffer = m_buffer.load(std::memory_order_relaxed);
+				const uint32_t used = b - t;
+				if GAIA_LIKELY (used + cnt <= pBuffer->mask + 1)
+					return pBuffer;
+
+				uint32_t capacity = (pBuffer->mask + 1) * 2;
+				while (capacity < used + cnt)
+					capacity *= 2;
+
+				// Copy over the jobs which can still be stolen. Jobs that were stolen meanwhile are copied
+				// as well. They are below the top so nobody is going to read them again.
+				auto* pBufferNew = Buffer::create(capacity);
+				auto* pItems = pBuffer->items();
+				auto* pItemsNew = pBufferNew->items();
+				for (uint32_t i = t; i != b; ++i)
+					pItemsNew[i & pBufferNew->mask].store(
+							pItems[i & pBuffer->mask].load(std::memory_order_relaxed), std::memory_order_relaxed);
+				m_buffer.store(pBufferNew, std::memory_order_seq_cst);
+
+				// Thieves might still read the old buffer
+				pBuffer->retiredEpoch = m_epoch.load(std::memory_order_relaxed);
+				pBuffer->pNext = m_pRetired;
+				m_pRetired = pBuffer;
+				free_retired(false);
+
+				return pBufferNew;
+			}
+
+			//! Advances the epoch as far as thieves allow and frees buffers nobody can reach anymore. Owner thread only.
+			//! \param all If true, all retired buffers are freed. Only valid when no thieves are around.
+			void free_retired(bool all) {
+				if (m_pRetired == nullptr)
+					return;
+
+				uint32_t e = m_epoch.load(std::memory_order_relaxed);
+				if (!all) {
+					// Two steps at most, then everything retired so far can be freed
+					GAIA_FOR(2) {
+						// Thieves still inside the previous epoch use the same counter as the next epoch
+						if (m_thieves[(e + 1) & 1].load(std::memory_order_seq_cst) != 0)
+							break;
+						++e;
+						m_epoch.store(e, std::memory_order_seq_cst);
+					}
+				}
+
+				Buffer** ppBuffer = &m_pRetired;
+				while (*ppBuffer != nullptr) {
+					auto* pBuffer = *ppBuffer;
+					if (all || e - pBuffer->retiredEpoch >= 2) {
+						*ppBuffer = pBuffer->pNext;
+						Buffer::destroy(pBuffer);
+					} else
+						ppBuffer = &pBuffer->pNext;
+				}
+			}
+
+			//! Registers a thief in the current epoch.
+			//! \return Epoch the thief entered.
+			GAIA_NODISCARD uint32_t enter() {
+				while (true) {
+					const uint32_t e = m_epoch.load(std::memory_order_seq_cst);
+					m_thieves[e & 1].fetch_add(1, std::memory_order_seq_cst);
+					// The epoch might have advanced before we were counted. Try again if so.
+					if GAIA_LIKELY (m_epoch.load(std::memory_order_seq_cst) == e)
+						return e;
+					m_thieves[e & 1].fetch_sub(1, std::memory_order_relaxed);
+				}
+			}
+
+			//! Unregisters a thief from epoch \a e.
+			void leave(uint32_t e) {
+				m_thieves[e & 1].fetch_sub(1, std::memory_order_release);
+			}
+
+			//! Tries stealing a job from the top. Has to be called between enter() and leave().
+			//! \param[out] jobHandle Stolen job. JobNull when the queue was empty.
+			//! \return True if the job was stolen or the queue was empty. False if a concurrent pop or steal won the race.
+			GAIA_NODISCARD bool steal_one(JobHandle& jobHandle) {
+				uint32_t t = m_top.load(std::memory_order_acquire);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				const uint32_t b = m_bottom.load(std::memory_order_acquire);
+
+				if (int(b - t) <= 0) { // t >= b, but handles overflows, too
+					jobHandle = (JobHandle)JobNull_t{};
+					return true; // true + JobNull = empty, don't use jobHandle
+				}
+
+				// Load the buffer after the bottom so the job at the top is guaranteed to be in it
+				auto* pBuffer = m_buffer.load(std::memory_order_seq_cst);
+				const uint32_t jobHandleValue = pBuffer->items()[t & pBuffer->mask].load(std::memory_order_relaxed);
+
+				// We fail if concurrent pop()/steal() operation changed the current top
+				const bool ret = m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+				jobHandle = JobHandle(jobHandleValue);
+				GAIA_ASSERT(!ret || jobHandle != (JobHandle)JobNull_t{});
+				return ret; // false = failed race, don't use jobHandle; true = found a result
+			}
+		};
+
 		//! Multi-producer-multi-consumer queue. FIFO, fixed size. Inspired heavily by:
 		//! http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
 		template <class T, const uint32_t N = 1 << 12>
@@ -4,13 +4,20 @@
 
 #include <atomic>
 
+#include "gaia/mt/futex.h"
 #include "gaia/mt/semaphore.h"
 
 namespace gaia {
 	namespace mt {
 		//! An optimized version of Semaphore that avoids expensive system calls when the counter is greater than 0.
+		//! With a native futex available, blocked waiters park directly on a futex instead of a system semaphore.
 		class GAIA_API SemaphoreFast final {
+#if GAIA_FUTEX_NATIVE
+			//! Wakeups handed over to blocked waiters but not consumed yet
+			std::atomic_uint32_t m_wakeups;
+#else
 			Semaphore m_sem;
+#endif
 			std::atomic_int32_t m_cnt;
 
 			SemaphoreFast(SemaphoreFast&&) = delete;
@@ -21,7 +28,11 @@ namespace gaia {
 		public:
 			//! Creates a semaphore with the requested initial system-semaphore count.
 			//! \param count Initial count passed to the underlying semaphore.
+#if GAIA_FUTEX_NATIVE
+			explicit SemaphoreFast(int32_t count = 0): m_wakeups((uint32_t)count), m_cnt(0) {}
+#else
 			explicit SemaphoreFast(int32_t count = 0): m_sem(count), m_cnt(0) {}
+#endif
 			~SemaphoreFast() = default;
 
 			//! Increments semaphore count by the specified amount.
@@ -32,8 +43,14 @@ namespace gaia {
 				if (count < toRelease)
 					toRelease = count;
 
-				if (toRelease > 0)
+				if (toRelease > 0) {
+#if GAIA_FUTEX_NATIVE
+					m_wakeups.fetch_add((uint32_t)toRelease, std::memory_order_release);
+					(void)Futex::wake(&m_wakeups, (uint32_t)toRelease);
+#else
 					m_sem.release(toRelease);
+#endif
+				}
 			}
 
 			//! Decrements semaphore count by 1.
@@ -43,11 +60,34 @@ namespace gaia {
 			bool wait() {
 				const int32_t oldCount = m_cnt.fetch_sub(1, std::memory_order_acquire);
 				bool result = true;
-				if (oldCount <= 0)
+				if (oldCount <= 0) {
+#if GAIA_FUTEX_NATIVE
+					while (true) {
+						auto wakeups = m_wakeups.load(std::memory_order_acquire);
+						while (wakeups != 0) {
+							if (m_wakeups.compare_exchange_weak(wakeups, wakeups - 1, std::memory_order_acquire))
+								return true;
+						}
+						(void)Futex::wait(&m_wakeups, 0, detail::WaitMaskAny);
+					}
+#else
 					result = m_sem.wait();
+#endif
+				}
 
 				return result;
 			}
+
+			//! Decrements semaphore count by 1 if it is greater than 0. Never blocks.
+			//! \return True when a permit was acquired. False otherwise.
+			bool try_wait() {
+				auto cnt = m_cnt.load(std::memory_order_relaxed);
+				while (cnt > 0) {
+					if (m_cnt.compare_exchange_weak(cnt, cnt - 1, std::memory_order_acquire, std::memory_order_relaxed))
+						return true;
+				}
+				return false;
+			}
 		};
 	} // namespace mt
-} // namespace gaia
\ No newline at end of file
+} // namespace gaia
@@ -93,6 +93,9 @@ namespace gaia {
 			//!       of workers. In the future consider revisiting this because
 			//!       the number of CPU cores is only going to increase.
 			static constexpr uint32_t MaxWorkers = JobState::DEP_BITS;
+			//! Default number of iterations an idle worker spins before it parks.
+			//! Roughly tens of microseconds, enough to bridge gaps between submissions within a frame.
+			static constexpr uint32_t DefaultSpinBudget = 2048;
 
 			//! ID of the main thread
 			std::thread::id m_mainThreadId;
@@ -103,8 +106,11 @@ namespace gaia {
 			cnt::sarray_ext<GAIA_THREAD, MaxWorkers> m_workers;
 			//! Array of data associated with workers
 			GAIA_ALIGNAS(128) cnt::sarray_ext<ThreadCtx, MaxWorkers> m_workersCtx;
-			//! Global job queue
+			//! Global job queue. Used by threads without a worker context and for jobs of the other priority class.
 			MpmcQueue<JobHandle, 1024> m_jobQueue[JobPriorityCnt];
+			//! Queues for jobs submitted by the main thread. Only the main thread pushes and pops, workers of the
+			//! matching priority steal from them. They grow on demand so submitting a burst of jobs never stalls.
+			JobDeque<> m_mainJobQueue[JobPriorityCnt];
 			//! Global queue for background jobs that may span multiple frames.
 			MpmcQueue<JobHandle, 1024> m_jobQueueBackground;
 			//! The number of spawned frame worker threads.
@@ -122,6 +128,13 @@ namespace gaia {
 			SemaphoreFast m_sem[JobPriorityCnt];
 			//! Semaphore controlling if background worker threads are allowed to run
 			SemaphoreFast m_semBackground;
+			//! Number of frame workers of a given priority that ran out of work and are spinning or parked.
+			//! Producers only hand out as many permits as there are idle workers.
+			std::atomic_uint32_t m_idleWorkers[JobPriorityCnt]{};
+			//! Number of background workers that ran out of work and are spinning or parked
+			std::atomic_uint32_t m_idleBackgroundWorkers{};
+			//! Maximum number of iterations an idle worker spins before it parks
+			std::atomic_uint32_t m_spinBudget{};
 
 			//! Futex counter
 			std::atomic_uint32_t m_blockedInWorkUntil;
@@ -129,8 +142,8 @@ namespace gaia {
 			//! Manager for internal jobs
 			JobManager m_jobManager;
 			//! Job allocation mutex
-			//! \note Job creation is expected from the main thread. Freeing can happen from any thread,
-			//! so allocation metadata remains locked.
+			//! \note Jobs can be created and freed from any thread. Each thread keeps a small cache of freed
+			//! job slots (see ThreadCtx::jobSlotCache) so the lock is only taken when the cache runs dry or overflows.
 			//! \note Job storage uses a fixed page table for the full handle range, so adding a job while
 			//! unrelated background jobs are running does not move existing job containers.
 			GAIA_PROF_MUTEX(SpinLock, m_jobAllocMtx);
@@ -142,6 +155,9 @@ namespace gaia {
 				make_main_thread();
 
 				const auto hwThreads = hw_thread_cnt();
+				// Spinning only makes sense when there is another core that can publish work meanwhile
+				m_spinBudget.store(hwThreads > 1 ? DefaultSpinBudget : 0, std::memory_order_relaxed);
+
 				const auto hwEffThreads = hw_efficiency_cores_cnt();
 				uint32_t hiPrioWorkers = hwThreads;
 				if (hwEffThreads < hwThreads)
@@ -184,6 +200,22 @@ namespace gaia {
 				return m_backgroundWorkersCnt;
 			}
 
+			//! Sets how long idle workers spin before they park.
+			//! A worker that runs out of work keeps polling for new permits for up to \a spins iterations
+			//! of a CPU pause instruction. Work submitted meanwhile is picked up without any system call.
+			//! The budget adapts per worker. It halves every time spinning ends up parking anyway and recovers
+			//! every time work arrives while spinning. Zero makes workers park right away.
+			//! \param spins Maximum number of spin iterations.
+			void set_spin_budget(uint32_t spins) {
+				m_spinBudget.store(spins, std::memory_order_relaxed);
+			}
+
+			//! Returns the maximum number of iterations idle workers spin before they park.
+			//! \return Spin budget. By default DefaultSpinBudget on multi-core systems and 0 otherwise.
+			GAIA_NODISCARD uint32_t spin_budget() const {
+				return m_spinBudget.load(std::memory_order_relaxed);
+			}
+
 			//! Set the maximum number of frame execution contexts for this system.
 			//! \param count Requested frame execution contexts, including the main thread.
 			//!              The number of spawned frame worker threads is one less.
@@ -199,6 +231,7 @@ namespace gaia {
 				reset();
 
 				// Reset previous worker contexts
+				flush_job_slot_caches();
 				for (auto& ctx: m_workersCtx)
 					ctx.reset();
 
@@ -304,6 +337,7 @@ namespace gaia {
 				const auto maxFrameWorkers = MaxWorkers - m_backgroundWorkersCnt - 1;
 				m_frameWorkersCnt = core::get_min(frameWorkersCntOld, maxFrameWorkers);
 
+				flush_job_slot_caches();
 				for (auto& ctx: m_workersCtx)
 					ctx.reset();
 
@@ -329,7 +363,7 @@ namespace gaia {
 			//! \param jobSecond The job that will run after \a jobFirst.
 			//! \warning This must be called before any of the listed jobs are scheduled.
 			void dep(JobHandle jobFirst, JobHandle jobSecond) {
-				GAIA_ASSERT(main_thread());
+				GAIA_ASSERT(pool_thread());
 
 				m_jobManager.dep(std::span(&jobFirst, 1), jobSecond);
 			}
@@ -340,7 +374,7 @@ namespace gaia {
 			//! \param jobSecond The job that will run after \a jobsFirst.
 			//! \warning This must must to be called before any of the listed jobs are scheduled.
 			void dep(std::span<JobHandle> jobsFirst, JobHandle jobSecond) {
-				GAIA_ASSERT(main_thread());
+				GAIA_ASSERT(pool_thread());
 
 				m_jobManager.dep(jobsFirst, jobSecond);
 			}
@@ -351,9 +385,8 @@ namespace gaia {
 			//! \param jobSecond The job that will run after \a jobFirst.
 			//! \note Unlike dep() this function needs to be called when job handles are reused.
 			//! \warning This must be called before any of the listed jobs are scheduled.
-			//! \warning This must be called from the main thread.
 			void dep_refresh(JobHandle jobFirst, JobHandle jobSecond) {
-				GAIA_ASSERT(main_thread());
+				GAIA_ASSERT(pool_thread());
 
 				m_jobManager.dep_refresh(std::span(&jobFirst, 1), jobSecond);
 			}
@@ -364,9 +397,8 @@ namespace gaia {
 			//! \param jobSecond The job that will run after \a jobsFirst.
 			//! \note Unlike dep() this function needs to be called when job handles are reused.
 			//! \warning This must be called before any of the listed jobs are scheduled.
-			//! \warning This must be called from the main thread.
 			void dep_refresh(std::span<JobHandle> jobsFirst, JobHandle jobSecond) {
-				GAIA_ASSERT(main_thread());
+				GAIA_ASSERT(pool_thread());
 
 				m_jobManager.dep_refresh(jobsFirst, jobSecond);
 			}
@@ -374,15 +406,51 @@ namespace gaia {
 			//! Creates a threadpool job from \a job.
 			//! \tparam TJob Job descriptor type convertible to Job.
 			//! \param job Job descriptor to allocate.
-			//! \warning Must be used from the main thread.
+			//! \note Can be used from the main thread or from inside a running job.
 			//! \warning Frame jobs should be created before frame work is submitted.
 			//!          It is valid to create new frame jobs while unrelated background jobs are running.
 			//! \return Job handle of the scheduled job.
 			template <typename TJob>
 			JobHandle add(TJob job) {
-				GAIA_ASSERT(main_thread());
+				GAIA_ASSERT(pool_thread());
 
 				job.priority = final_prio(job);
+				return alloc_job(GAIA_MOV(job));
+			}
+
+		private:
+			void add_n(JobPriority prio, std::span<JobHandle> jobHandles) {
+				GAIA_ASSERT(pool_thread());
+				GAIA_ASSERT(!jobHandles.empty());
+
+				// Take cached slots first
+				uint32_t i = 0;
+				auto* ctx = own_ctx();
+				if (ctx != nullptr) {
+					for (; i < jobHandles.size() && ctx->jobSlotCacheCnt != 0; ++i) {
+						const auto jobId = ctx->jobSlotCache[--ctx->jobSlotCacheCnt];
+						jobHandles[i] = m_jobManager.reuse_job(jobId, {{}, prio, JobCreationFlags::Default});
+					}
+					if (i == jobHandles.size())
+						return;
+				}
+
+				auto& mtx = GAIA_PROF_EXTRACT_MUTEX(m_jobAllocMtx);
+				core::lock_scope lock(mtx);
+				GAIA_PROF_LOCK_MARK(m_jobAllocMtx);
+
+				for (; i < jobHandles.size(); ++i)
+					jobHandles[i] = m_jobManager.alloc_job({{}, prio, JobCreationFlags::Default});
+			}
+
+			//! Allocates a job slot for \a job.
+			//! Slots cached by the calling thread are used first. The job pool is locked only when the cache is empty.
+			//! \param job Job descriptor.
+			//! \return Job handle of the allocated job.
+			GAIA_NODISCARD JobHandle alloc_job(Job job) {
+				auto* ctx = own_ctx();
+				if (ctx != nullptr && ctx->jobSlotCacheCnt != 0)
+					return m_jobManager.reuse_job(ctx->jobSlotCache[--ctx->jobSlotCacheCnt], GAIA_MOV(job));
 
 				auto& mtx = GAIA_PROF_EXTRACT_MUTEX(m_jobAllocMtx);
 				core::lock_scope lock(mtx);
@@ -391,17 +459,50 @@ namespace gaia {
 				return m_jobManager.alloc_job(GAIA_MOV(job));
 			}
 
-		private:
-			void add_n(JobPriority prio, std::span<JobHandle> jobHandles) {
-				GAIA_ASSERT(main_thread());
-				GAIA_ASSERT(!jobHandles.empty());
+			//! Releases the slot of \a jobHandle.
+			//! The slot goes to the cache of the calling thread. When the cache is full, half of it is returned
+			//! to the job pool together with the slot under a single lock.
+			//! \param jobHandle Job to release.
+			void free_job(JobHandle jobHandle) {
+				auto* ctx = own_ctx();
+				if (ctx != nullptr) {
+					m_jobManager.retire_job(jobHandle);
+					if GAIA_LIKELY (ctx->jobSlotCacheCnt < ThreadCtx::JobSlotCacheCapacity) {
+						ctx->jobSlotCache[ctx->jobSlotCacheCnt++] = jobHandle.id();
+						return;
+					}
+
+					constexpr uint32_t SlotsToKeep = ThreadCtx::JobSlotCacheCapacity / 2;
 
+					auto& mtx = GAIA_PROF_EXTRACT_MUTEX(m_jobAllocMtx);
+					core::lock_scope lock(mtx);
+					GAIA_PROF_LOCK_MARK(m_jobAllocMtx);
+
+					m_jobManager.free_retired_job(jobHandle.id());
+					for (uint32_t i = SlotsToKeep; i < ThreadCtx::JobSlotCacheCapacity; ++i)
+						m_jobManager.free_retired_job(ctx->jobSlotCache[i]);
+					ctx->jobSlotCacheCnt = SlotsToKeep;
+					return;
+				}
+
+				auto& mtx = GAIA_PROF_EXTRACT_MUTEX(m_jobAllocMtx);
+				core::lock_scope lock(mtx);
+				GAIA_PROF_LOCK_MARK(m_jobAllocMtx);
+
+				m_jobManager.free_job(jobHandle);
+			}
+
+			//! Returns job slots cached by all threads to the job pool.
+			//! \warning Worker threads must not be running.
+			void flush_job_slot_caches() {
 				auto& mtx = GAIA_PROF_EXTRACT_MUTEX(m_jobAllocMtx);
 				core::lock_scope lock(mtx);
 				GAIA_PROF_LOCK_MARK(m_jobAllocMtx);
 
-				for (auto& jobHandle: jobHandles)
-					jobHandle = m_jobManager.alloc_job({{}, prio, JobCreationFlags::Default});
+				for (auto& ctx: m_workersCtx) {
+					GAIA_FOR(ctx.jobSlotCacheCnt) m_jobManager.free_retired_job(ctx.jobSlotCache[i]);
+					ctx.jobSlotCacheCnt = 0;
+				}
 			}
 
 			GAIA_NODISCARD ParallelCallbackHandle add_parallel_callback(JobArgsFunc callback, uint32_t refs) {
@@ -438,11 +539,7 @@ namespace gaia {
 				}
 #endif
 
-				auto& mtx = GAIA_PROF_EXTRACT_MUTEX(m_jobAllocMtx);
-				core::lock_scope lock(mtx);
-				GAIA_PROF_LOCK_MARK(m_jobAllocMtx);
-
-				m_jobManager.free_job(jobHandle);
+				free_job(jobHandle);
 			}
 
 			//! Pushes \a jobHandles into the internal queue so worker threads
@@ -546,7 +643,7 @@ namespace gaia {
 
 			//! Schedules a job to run on a worker thread.
 			//! \param job Job descriptor
-			//! \warning Must be used from the main thread.
+			//! \note Can be used from the main thread or from inside a running job.
 			//! \warning Dependencies can't be modified for this job.
 			//! \return Job handle of the scheduled job.
 			JobHandle sched(Job job) {
@@ -573,7 +670,7 @@ namespace gaia {
 			//! Schedules a job to run on a worker thread.
 			//! \param job Job descriptor
 			//! \param dependsOn Job we depend on
-			//! \warning Must be used from the main thread.
+			//! \note Can be used from the main thread or from inside a running job.
 			//! \warning Dependencies can't be modified for this job.
 			//! \return Job handle of the scheduled job.
 			JobHandle sched(Job job, JobHandle dependsOn) {
@@ -587,11 +684,12 @@ namespace gaia {
 			//! \param job Job descriptor
 			//! \param itemsToProcess Total number of work items
 			//! \param groupSize Group size per created job. If zero the threadpool decides the group size.
-			//! \warning Must be used from the main thread.
+			//! \note Can be used from inside a running job. Waiting for the returned handle there executes
+			//!       the spawned jobs on the waiting worker rather than blocking it (fork-join).
 			//! \warning Dependencies can't be modified for this job.
 			//! \return Job handle of the scheduled batch of jobs.
 			JobHandle sched_par(JobParallel job, uint32_t itemsToProcess, uint32_t groupSize) {
-				GAIA_ASSERT(main_thread());
+				GAIA_ASSERT(pool_thread());
 
 				// Empty data set are considered wrong inputs
 				GAIA_ASSERT(itemsToProcess != 0);
@@ -695,11 +793,11 @@ namespace gaia {
 			//! \param job Non-owning job descriptor.
 			//! \param itemsToProcess Total number of work items.
 			//! \param groupSize Group size per created job. If zero the threadpool decides the group size.
-			//! \warning Must be used from the main thread.
+			//! \note Can be used from inside a running job, same as the owning overload.
 			//! \warning The pointed-to context must remain alive until the returned handle completes.
 			//! \return Job handle of the scheduled batch of jobs.
 			JobHandle sched_par(JobParallelRef job, uint32_t itemsToProcess, uint32_t groupSize) {
-				GAIA_ASSERT(main_thread());
+				GAIA_ASSERT(pool_thread());
 				GAIA_ASSERT(job.pCtx != nullptr);
 				GAIA_ASSERT(job.invoke != nullptr);
 
@@ -784,11 +882,14 @@ namespace gaia {
 			//! The calling thread participates in frame job processing until \a jobHandle is done.
 			//! For background jobs, the calling thread only runs background work when no
 			//! background workers are configured.
+			//! When called from inside a running job the worker never goes to sleep. It keeps executing
+			//! other ready jobs, its own queue first, until \a jobHandle is done. This makes it possible
+			//! to wait for jobs spawned by the running job (fork-join) without starving them.
 			//! \param jobHandle Job handle to wait for
 			void wait(JobHandle jobHandle) {
 				GAIA_PROF_SCOPE(tp::wait);
 
-				GAIA_ASSERT(main_thread());
+				GAIA_ASSERT(pool_thread());
 
 				// Skip waitinig for unset job handles.
 				if (jobHandle == (JobHandle)JobNull_t{})
@@ -797,13 +898,17 @@ namespace gaia {
 				auto* ctx = detail::tl_workerCtx;
 				auto& jobData = m_jobManager.data(jobHandle);
 				const bool waitBackground = is_background(jobData);
-				auto state = jobData.state.load();
 
 				// Waiting for a job that has not been initialized is nonsense.
-				GAIA_ASSERT(state != 0);
+				GAIA_ASSERT(jobData.state.load() != 0 || JobManager::done(jobData, jobHandle));
+
+				if (ctx != nullptr && ctx->workerIdx != 0) {
+					wait_nested(*ctx, jobData, jobHandle, waitBackground);
+					return;
+				}
 
 				// Wait until done
-				for (; (state & JobState::STATE_BITS_MASK) < JobState::Done; state = jobData.state.load()) {
+				for (auto state = jobData.state.load(); !JobManager::done(jobData, jobHandle); state = jobData.state.load()) {
 					// The job we are waiting for is not finished yet, try running some other job in the meantime
 					JobHandle otherJobHandle;
 					const bool canHelpBackground = waitBackground && m_backgroundWorkersCnt == 0;
@@ -1254,6 +1359,19 @@ namespace gaia {
 				return std::this_thread::get_id() == m_mainThreadId;
 			}
 
+			//! Returns the context of the calling thread if the thread belongs to this pool.
+			//! \return Context of the main thread or of a worker thread. Nullptr for foreign threads.
+			GAIA_NODISCARD ThreadCtx* own_ctx() const {
+				auto* ctx = detail::tl_workerCtx;
+				return ctx != nullptr && ctx->tp == this ? ctx : nullptr;
+			}
+
+			//! Checks if the calling thread is allowed to create and wait for jobs
+			//! \return True if the calling thread is the main thread or a worker thread of this pool.
+			GAIA_NODISCARD bool pool_thread() const {
+				return main_thread() || own_ctx() != nullptr;
+			}
+
 			//! Runs one main-thread work-drain pass.
 			//! Pops ready jobs from the queues and executes them until no more work is immediately available.
 			void main_thread_tick() {
@@ -1275,29 +1393,62 @@ namespace gaia {
 			//! \param[out] jobHandle Receives the stolen job handle when one is available.
 			//! \return True when a valid job was obtained. False otherwise.
 			GAIA_NODISCARD bool try_steal_job(ThreadCtx& ctx, JobPriority prio, JobHandle& jobHandle) {
+				// Bursts submitted by the main thread are the most likely source of work
+				if (try_steal_from(ctx, prio, m_mainJobQueue[(uint32_t)prio], jobHandle))
+					return true;
+
 				const auto workerCnt = m_workersCtx.size();
-				for (uint32_t i = 0; i < workerCnt;) {
+				GAIA_FOR(workerCnt) {
 					// Keep stealing within the same priority class and skip our own queue
-					if (i == ctx.workerIdx || m_workersCtx[i].background || m_workersCtx[i].prio != prio) {
-						++i;
+					if (i == ctx.workerIdx || m_workersCtx[i].background || m_workersCtx[i].prio != prio)
 						continue;
+
+					if (try_steal_from(ctx, prio, m_workersCtx[i].jobQueue, jobHandle))
+						return true;
+				}
+
+				return false;
+			}
+
+			//! Attempts to steal work from \a queue.
+			//! Frame workers take up to half of the jobs of their own priority class at once. The first one is returned,
+			//! the rest goes to the worker's own queue so it does not have to look for a victim again for a while.
+			//! \param ctx Worker requesting more work.
+			//! \param prio Priority class of the jobs in \a queue.
+			//! \param queue Queue to steal from.
+			//! \param[out] jobHandle Receives the stolen job handle when one is available.
+			//! \return True when a valid job was obtained. False otherwise.
+			template <typename TQueue>
+			GAIA_NODISCARD bool try_steal_from(ThreadCtx& ctx, JobPriority prio, TQueue& queue, JobHandle& jobHandle) {
+				// Only frame workers own a queue the surplus could be moved to. Jobs of the other priority class
+				// are taken one at a time so they do not end up in a queue of the wrong class.
+				if (ctx.workerIdx != 0 && !ctx.background && ctx.prio == prio) {
+					constexpr uint32_t MaxStolenJobs = 32;
+					JobHandle jobHandles[MaxStolenJobs];
+					const auto cnt = queue.steal_half(std::span(jobHandles, MaxStolenJobs));
+					if (cnt == 0)
+						return false;
+
+					jobHandle = jobHandles[0];
+					if (cnt > 1) {
+						ctx.jobQueue.push_n(std::span<const JobHandle>(jobHandles + 1, cnt - 1));
+						// Let idle workers know there is something to steal from us now
+						const auto prioIdx = (uint32_t)ctx.prio;
+						wake_workers(m_sem[prioIdx], m_idleWorkers[prioIdx], cnt - 1);
 					}
+					return true;
+				}
 
-					const auto res = m_workersCtx[i].jobQueue.try_steal(jobHandle);
-					// Race condition, try again from the same context
-					if (!res)
+				while (true) {
+					// Race condition, try again
+					if (!queue.try_steal(jobHandle))
 						continue;
 
 					// Stealing can return true if the queue is empty.
 					// We return right away only if we receive a valid handle which means
 					// when there was an idle job in the queue.
-					if (jobHandle != (JobHandle)JobNull_t{})
-						return true;
-
-					++i;
+					return jobHandle != (JobHandle)JobNull_t{};
 				}
-
-				return false;
 			}
 
 			//! Attempts to fetch work from the global queue or peer workers of one priority class.
@@ -1333,6 +1484,10 @@ namespace gaia {
 
 				// The main thread may help with both queues while waiting or updating
 				if (ctx.workerIdx == 0) {
+					if (m_mainJobQueue[(uint32_t)JobPriority::High].try_pop(jobHandle) ||
+							m_mainJobQueue[(uint32_t)JobPriority::Low].try_pop(jobHandle))
+						return true;
+
 					if (try_fetch_prio(ctx, JobPriority::High, jobHandle))
 						return true;
 
@@ -1364,6 +1519,54 @@ namespace gaia {
 				return m_workerThreadsCnt[(uint32_t)jobData.prio] == 0;
 			}
 
+			//! Fetches a job a worker waiting from inside a running job can execute in the meantime.
+			//! Jobs spawned by the running job most likely wait in the local queue so it goes first.
+			//! Other frame work of either priority follows. Background work is only considered when
+			//! the caller is a background worker or it waits for a background job.
+			//! \param ctx Waiting worker.
+			//! \param waitBackground True when the awaited job is a background job.
+			//! \param[out] jobHandle Receives the job handle when one is available.
+			//! \return True when a valid job was obtained. False otherwise.
+			GAIA_NODISCARD bool try_fetch_nested_job(ThreadCtx& ctx, bool waitBackground, JobHandle& jobHandle) {
+				if (ctx.jobQueue.try_pop(jobHandle))
+					return true;
+
+				const auto prio = ctx.prio;
+				const auto otherPrio = (JobPriority)(((uint32_t)prio + 1U) % (uint32_t)JobPriorityCnt);
+				if (try_fetch_prio(ctx, prio, jobHandle) || try_fetch_prio(ctx, otherPrio, jobHandle))
+					return true;
+
+				return (ctx.background || waitBackground) && try_fetch_background_job(jobHandle);
+			}
+
+			//! Waits for \a jobHandle from inside a running job.
+			//! The worker never blocks. Sleeping here could starve the jobs being waited for when they sit
+			//! in the worker's own queue, or when all workers end up waiting for each other's children.
+			//! \param ctx Waiting worker.
+			//! \param jobData Job storage referenced by \a jobHandle.
+			//! \param jobHandle Job to wait for.
+			//! \param waitBackground True when the awaited job is a background job.
+			void wait_nested(ThreadCtx& ctx, const JobContainer& jobData, JobHandle jobHandle, bool waitBackground) {
+				constexpr uint32_t MaxSpins = 64;
+				uint32_t spins = 0;
+
+				while (!JobManager::done(jobData, jobHandle)) {
+					JobHandle otherJobHandle;
+					if (try_fetch_nested_job(ctx, waitBackground, otherJobHandle)) {
+						(void)run(otherJobHandle, &ctx);
+						spins = 0;
+						continue;
+					}
+
+					// Nothing to help with, the awaited jobs are being executed by other workers
+					if (spins < MaxSpins) {
+						++spins;
+						GAIA_YIELD_CPU;
+					} else
+						std::this_thread::yield();
+				}
+			}
+
 			//! Helps the scheduler make progress when a priority queue is temporarily full.
 			//! \param ctx Calling worker context.
 			//! \param jobData Job whose target queue is saturated.
@@ -1372,13 +1575,11 @@ namespace gaia {
 
 				// Wake one worker from the target class in case all of them are asleep while
 				// the producer is waiting for queue space to become available.
-				if (background) {
-					if (m_backgroundWorkersCnt != 0)
-						m_semBackground.release(1);
-				} else {
+				if (background)
+					wake_workers(m_semBackground, m_idleBackgroundWorkers, 1);
+				else {
 					const auto prioIdx = (uint32_t)jobData.prio;
-					if (m_workerThreadsCnt[prioIdx] != 0)
-						m_sem[prioIdx].release(1);
+					wake_workers(m_sem[prioIdx], m_idleWorkers[prioIdx], 1);
 				}
 
 				// Keep the current worker productive without violating the priority boundary.
@@ -1397,13 +1598,11 @@ namespace gaia {
 			//! Pops ready jobs from the queues and executes them until the pool shuts down.
 			//! \param ctx Thread-local worker context.
 			void worker_loop(ThreadCtx& ctx) {
-				while (true) {
-					// Wait for work
-					if (ctx.background)
-						m_semBackground.wait();
-					else
-						m_sem[(uint32_t)ctx.prio].wait();
+				auto& sem = ctx.background ? m_semBackground : m_sem[(uint32_t)ctx.prio];
+				auto& idle = ctx.background ? m_idleBackgroundWorkers : m_idleWorkers[(uint32_t)ctx.prio];
+				uint32_t spinLimit = m_spinBudget.load(std::memory_order_relaxed);
 
+				while (true) {
 					// Keep executing while there is work
 					while (true) {
 						JobHandle jobHandle;
@@ -1417,7 +1616,97 @@ namespace gaia {
 					const bool stop = m_stop.load();
 					if (stop)
 						break;
+
+					// Wait for work
+					park(ctx, sem, idle, spinLimit);
+				}
+			}
+
+			//! Checks if there is any work \a ctx could fetch right now without actually fetching it.
+			//! \param ctx Worker context.
+			//! \return True if any queue the worker takes jobs from is not empty.
+			GAIA_NODISCARD bool has_work(const ThreadCtx& ctx) const {
+				if (ctx.background)
+					return !m_jobQueueBackground.empty();
+
+				const auto prioIdx = (uint32_t)ctx.prio;
+				if (!ctx.jobQueue.empty() || !m_jobQueue[prioIdx].empty() || !m_mainJobQueue[prioIdx].empty())
+					return true;
+
+				// Jobs that could be stolen from workers of the same priority class
+				for (const auto& other: m_workersCtx) {
+					if (!other.background && other.prio == ctx.prio && !other.jobQueue.empty())
+						return true;
+				}
+				return false;
+			}
+
+			//! Puts a worker that ran out of work to sleep until wake_workers() hands it a permit.
+			//! The worker announces itself as idle first and only then checks for work and stop requests one last
+			//! time. Producers publish work first and only then look for idle workers. With a full fence on both
+			//! sides at least one of them notices the other so no wakeup is ever lost.
+			//! Before parking the worker spins for a while. Permits handed out meanwhile are taken without
+			//! a system call. The spin limit adapts to how often spinning pays off.
+			//! \param ctx Worker context.
+			//! \param sem Semaphore the worker sleeps on.
+			//! \param idle Idle worker counter associated with \a sem.
+			//! \param[in,out] spinLimit Current spin limit of the worker.
+			void park(ThreadCtx& ctx, SemaphoreFast& sem, std::atomic_uint32_t& idle, uint32_t& spinLimit) {
+				idle.fetch_add(1, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+
+				if (m_stop.load(std::memory_order_relaxed) || has_work(ctx)) {
+					// Leave the idle state. If a producer already claimed this worker,
+					// the permit it handed out needs to be consumed.
+					auto idleCnt = idle.load(std::memory_order_relaxed);
+					while (idleCnt != 0) {
+						if (idle.compare_exchange_weak(idleCnt, idleCnt - 1, std::memory_order_relaxed))
+							return;
+					}
+					(void)sem.wait();
+					return;
+				}
+
+				const auto spinBudget = m_spinBudget.load(std::memory_order_relaxed);
+				if (spinLimit > spinBudget)
+					spinLimit = spinBudget;
+
+				GAIA_FOR(spinLimit) {
+					if (sem.try_wait()) {
+						// Spinning paid off. Allow longer spins next time.
+						spinLimit = core::get_min(spinBudget, core::get_max(spinLimit * 2, 16U));
+						return;
+					}
+					GAIA_YIELD_CPU;
 				}
+
+				// Spinning was wasted. Spin less next time.
+				spinLimit /= 2;
+				(void)sem.wait();
+			}
+
+			//! Wakes up to \a cnt idle workers sleeping on \a sem.
+			//! Only workers registered as idle receive a permit. A batch of N jobs never wakes more than N workers
+			//! and busy workers do not collect stale permits that would make them spin through empty queues later.
+			//! Busy workers pick up the remaining jobs once they finish their current ones.
+			//! \param sem Semaphore of the target worker class.
+			//! \param idle Idle worker counter associated with \a sem.
+			//! \param cnt Maximum number of workers to wake.
+			void wake_workers(SemaphoreFast& sem, std::atomic_uint32_t& idle, uint32_t cnt) {
+				if (cnt == 0)
+					return;
+
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+
+				auto idleCnt = idle.load(std::memory_order_relaxed);
+				uint32_t toWake = 0;
+				do {
+					if (idleCnt == 0)
+						return;
+					toWake = core::get_min(idleCnt, cnt);
+				} while (!idle.compare_exchange_weak(idleCnt, idleCnt - toWake, std::memory_order_relaxed));
+
+				sem.release((int32_t)toWake);
 			}
 
 			//! Finishes all jobs and stops all worker threads
@@ -1428,13 +1717,9 @@ namespace gaia {
 				// Request stopping
 				m_stop.store(true);
 
-				// Signal all threads
-				GAIA_FOR(JobPriorityCnt) {
-					if (m_workerThreadsCnt[i] != 0)
-						m_sem[i].release((int32_t)m_workerThreadsCnt[i]);
-				}
-				if (m_backgroundWorkersCnt != 0)
-					m_semBackground.release((int32_t)m_backgroundWorkersCnt);
+				// Signal all threads. Workers that are not idle yet notice the stop request before parking.
+				GAIA_FOR(JobPriorityCnt) wake_workers(m_sem[i], m_idleWorkers[i], MaxWorkers);
+				wake_workers(m_semBackground, m_idleBackgroundWorkers, MaxWorkers);
 
 				auto* ctx = detail::tl_workerCtx;
 				if (ctx == nullptr) {
@@ -1458,6 +1743,16 @@ namespace gaia {
 				// Join threads with the main one
 				GAIA_FOR(m_workers.size()) join_thread(i + 1);
 
+				// Every worker either consumed its permit or left the idle state on its own
+				GAIA_FOR(JobPriorityCnt) GAIA_ASSERT(m_idleWorkers[i].load() == 0);
+				GAIA_ASSERT(m_idleBackgroundWorkers.load() == 0);
+
+				// Nobody can steal anymore. Release buffers the main queues grew out of.
+				GAIA_FOR(JobPriorityCnt) {
+					GAIA_ASSERT(m_mainJobQueue[i].empty());
+					m_mainJobQueue[i].clear();
+				}
+
 				// All threads have been stopped. Allow new threads to run if necessary.
 				m_stop.store(false);
 			}
@@ -1582,26 +1877,23 @@ namespace gaia {
 						const auto prio = jobData.prio;
 						// Worker-local queues are reserved for work that matches the worker's own
 						// priority class. Cross-priority releases must go through the matching
-						// global queue so the right workers can pick them up.
-						const bool useLocalQueue = ctx != nullptr && !ctx->background && ctx->workerIdx != 0 && ctx->prio == prio;
-						const bool res =
-								useLocalQueue ? ctx->jobQueue.try_push(handle) : m_jobQueue[(uint32_t)prio].try_push(handle);
-						if (!res)
+						// global queue so the right workers can pick them up. The main thread
+						// has a growable queue for each priority class. Both kinds of local
+						// queues grow so only the global queue can ever be full.
+						if (ctx != nullptr && ctx->workerIdx == 0)
+							m_mainJobQueue[(uint32_t)prio].push(handle);
+						else if (ctx != nullptr && !ctx->background && ctx->prio == prio)
+							ctx->jobQueue.push(handle);
+						else if (!m_jobQueue[(uint32_t)prio].try_push(handle))
 							break;
 
 						released[(uint32_t)prio]++;
 					}
 
-					GAIA_FOR(JobPriorityCnt) {
-						// Only spawned worker threads block on semaphores. The main thread helps by
-						// draining queues opportunistically from wait() and update().
-						const auto cnt = core::get_min(released[i], m_workerThreadsCnt[i]);
-						if (cnt != 0)
-							m_sem[i].release((int32_t)cnt);
-					}
-					const auto backgroundCnt = core::get_min(backgroundReleased, m_backgroundWorkersCnt);
-					if (backgroundCnt != 0)
-						m_semBackground.release((int32_t)backgroundCnt);
+					// Only spawned worker threads block on semaphores. The main thread helps by
+					// draining queues opportunistically from wait() and update().
+					GAIA_FOR(JobPriorityCnt) wake_workers(m_sem[i], m_idleWorkers[i], released[i]);
+					wake_workers(m_semBackground, m_idleBackgroundWorkers, backgroundReleased);
 
 					handles = handles.subspan(pushed);
 					if (!handles.empty()) {
@@ -1,6 +1,8 @@
 #pragma once
 #include "gaia/config/config.h"
 
+#include <cstring>
+
 #include "gaia/mem/mem_alloc.h"
 #include "gaia/ser/ser_buffer_binary.h"
 #include "gaia/ser/ser_rt.h"
@@ -24,8 +26,13 @@ namespace gaia {
 		public:
 			//! Writes raw bytes with type-aware alignment.
 			void save_raw(const void* src, uint32_t size, serialization_type_id id) {
+				const auto pos = m_buffer.tell();
 				align(size, id);
+				const auto padding = m_buffer.tell() - pos;
 				m_buffer.save_raw((const char*)src, size, id);
+				// Keep padding deterministic so equal worlds produce equal (and better compressible) snapshots
+				if (padding != 0 && size != 0)
+					memset(m_buffer.data_mut() + pos, 0, padding);
 			}
 
 			//! Reads raw bytes with type-aware alignment.
@@ -39,6 +46,18 @@ namespace gaia {
 				return (const char*)m_buffer.data();
 			}
 
+			//! Returns mutable pointer to serialized bytes.
+			char* data_mut() {
+				return (char*)m_buffer.data_mut();
+			}
+
+			//! Resizes the buffered data to \a size bytes and rewinds the stream.
+			//! Used by backends filling the stream directly (e.g. decompression).
+			void resize(uint32_t size) {
+				m_buffer.resize(size);
+				m_buffer.seek(0);
+			}
+
 			//! Clears buffered data and resets stream position.
 			void reset() {
 				m_buffer.reset();
@@ -47,6 +47,11 @@ namespace gaia {
 					return m_data.data();
 				}
 
+				//! Returns the mutable pointer to the data in the buffer
+				GAIA_NODISCARD auto* data_mut() {
+					return m_data.data();
+				}
+
 				//! Makes sure there is enough capacity in our data container to hold another \a size bytes of data.
 				//! \param size Minimum number of free bytes at the end of the buffer.
 				void reserve(uint32_t size) {
@@ -56,7 +61,13 @@ namespace gaia {
 
 					// Make sure there is enough capacity to hold our data
 					const auto newSize = bytes() + size;
-					const auto newCapacity = ((newSize / CapacityIncreaseSize) * CapacityIncreaseSize) + CapacityIncreaseSize;
+					const auto currCapacity = (uint32_t)m_data.capacity();
+					if (newSize <= currCapacity)
+						return;
+
+					// Grow geometrically so big snapshots do not reallocate on every write
+					auto newCapacity = ((newSize / CapacityIncreaseSize) * CapacityIncreaseSize) + CapacityIncreaseSize;
+					newCapacity = core::get_max(newCapacity, currCapacity + (currCapacity / 2));
 					m_data.reserve(newCapacity);
 				}
 
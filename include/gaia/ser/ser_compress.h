@@ -0,0 +1,565 @@
+#pragma once
+#include "gaia/config/config.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "gaia/cnt/darray.h"
+#include "gaia/core/utility.h"
+#include "gaia/ser/ser_binary.h"
+
+namespace gaia {
+	namespace ser {
+		//! Pre-compression filter applied to each block of a packed snapshot.
+		enum class pack_filter : uint8_t {
+			//! Blocks are compressed as they are.
+			None,
+			//! Bytes are transposed by \a stride so same-significance bytes of consecutive values end up next to
+			//! each other. Works well for SoA float/int columns.
+			Shuffle,
+			//! Shuffle followed by a byte-wise delta. Works well for monotonic or slowly changing values
+			//! (ids, counters, versions).
+			ShuffleDelta,
+			//! Every filter is tried and the smallest result is kept. Roughly 3x slower to pack.
+			Auto
+		};
+
+		//! Options controlling how a snapshot is packed.
+		struct pack_opts {
+			//! Size of one independently decodable block in bytes.
+			uint32_t blockSize = 64 * 1024;
+			//! Filter applied to blocks before compression.
+			pack_filter filter = pack_filter::Auto;
+			//! Element stride in bytes used by the shuffle filter.
+			uint8_t stride = 4;
+		};
+
+		//! Executor running \a cnt independent tasks one after another.
+		//! Any callable with the same signature can be used instead, e.g. one forwarding to mt::ThreadPool::sched_par.
+		struct pack_serial_executor {
+			template <typename Func>
+			void operator()(uint32_t cnt, Func&& func) const {
+				GAIA_FOR(cnt) func(i);
+			}
+		};
+
+		namespace detail {
+			//! \cond INTERNAL
+
+			//! "GPAK" in little-endian
+			static constexpr uint32_t PackMagic = 0x4B415047;
+			static constexpr uint32_t PackVersion = 1;
+
+			//! Block payload is stored uncompressed.
+			static constexpr uint32_t PackCodecStored = 0;
+			//! Block payload is LZ4 block-format compressed.
+			static constexpr uint32_t PackCodecLz = 1;
+			static constexpr uint32_t PackFlagShuffle = 1U << 8;
+			static constexpr uint32_t PackFlagDelta = 1U << 9;
+
+			struct pack_header {
+				uint32_t magic;
+				uint32_t version;
+				uint32_t rawSize;
+				uint32_t blockSize;
+				uint32_t blockCnt;
+			};
+
+			struct pack_block {
+				//! Offset of the payload relative to the start of the container.
+				uint32_t offset;
+				//! Size of the payload in bytes.
+				uint32_t size;
+				//! Codec in bits 0-7, filter flags in bits 8-15, shuffle stride in bits 16-23.
+				uint32_t method;
+			};
+
+			//----------------------------------------------------------------------
+			// LZ codec (LZ4 block format)
+			//----------------------------------------------------------------------
+
+			static constexpr uint32_t LzMinMatch = 4;
+			static constexpr uint32_t LzLastLiterals = 5;
+			static constexpr uint32_t LzMfLimit = 12;
+			static constexpr uint32_t LzMaxOffset = 65535;
+			static constexpr uint32_t LzHashLog = 14;
+
+			GAIA_NODISCARD inline uint32_t lz_read32(const uint8_t* p) {
+				uint32_t v;
+				memcpy(&v, p, sizeof(v));
+				return v;
+			}
+
+			GAIA_NODISCARD inline uint32_t lz_hash(uint32_t v) {
+				return (v * 2654435761U) >> (32 - LzHashLog);
+			}
+
+			//! Returns the worst-case compressed size of \a size bytes of input.
+			GAIA_NODISCARD constexpr uint32_t lz_bound(uint32_t size) {
+				return size + (size / 255) + 16;
+			}
+
+			//! Writes a LZ4 length continuation. Returns false if there is not enough space left.
+			GAIA_NODISCARD inline bool lz_write_len(uint8_t* dst, uint32_t dstCap, uint32_t& op, uint32_t len) {
+				while (len >= 255) {
+					if (op >= dstCap)
+						return false;
+					dst[op++] = 255;
+					len -= 255;
+				}
+				if (op >= dstCap)
+					return false;
+				dst[op++] = (uint8_t)len;
+				return true;
+			}
+
+			//! Emits one sequence. \a matchLen == 0 marks the trailing literal-only sequence.
+			GAIA_NODISCARD inline bool lz_emit(
+					uint8_t* dst, uint32_t dstCap, uint32_t& op, const uint8_t* lit, uint32_t litLen, uint32_t offset,
+					uint32_t matchLen) {
+				if (op >= dstCap)
+					return false;
+
+				const uint32_t mlCode = matchLen != 0 ? matchLen - LzMinMatch : 0;
+				dst[op++] = (uint8_t)((core::get_min(litLen, 15U) << 4) | core::get_min(mlCode, 15U));
+				if (litLen >= 15 && !lz_write_len(dst, dstCap, op, litLen - 15))
+					return false;
+
+				if (op + litLen > dstCap)
+					return false;
+				memcpy(dst + op, lit, litLen);
+				op += litLen;
+
+				if (matchLen == 0)
+					return true;
+
+				if (op + 2 > dstCap)
+					return false;
+				dst[op++] = (uint8_t)(offset & 0xFF);
+				dst[op++] = (uint8_t)(offset >> 8);
+				return mlCode < 15 || lz_write_len(dst, dstCap, op, mlCode - 15);
+			}
+
+			//! Compresses \a srcSize bytes into \a dst.
+			//! \return Compressed size or 0 if the result would not fit into \a dstCap bytes.
+			GAIA_NODISCARD inline uint32_t
+			lz_compress(const uint8_t* src, uint32_t srcSize, uint8_t* dst, uint32_t dstCap, uint32_t* pTable) {
+				memset(pTable, 0, sizeof(uint32_t) << LzHashLog);
+
+				uint32_t ip = 0;
+				uint32_t anchor = 0;
+				uint32_t op = 0;
+
+				if (srcSize > LzMfLimit) {
+					const uint32_t ipLimit = srcSize - LzMfLimit;
+					const uint32_t matchLimit = srcSize - LzLastLiterals;
+
+					while (ip < ipLimit) {
+						const uint32_t seq = lz_read32(src + ip);
+						const uint32_t h = lz_hash(seq);
+						const uint32_t cand = pTable[h];
+						pTable[h] = ip;
+
+						if (cand >= ip || ip - cand > LzMaxOffset || lz_read32(src + cand) != seq) {
+							// Skip faster over incompressible data
+							ip += 1 + ((ip - anchor) >> 6);
+							continue;
+						}
+
+						// Extend the match backwards and forwards
+						uint32_t start = ip;
+						uint32_t ref = cand;
+						while (start > anchor && ref > 0 && src[start - 1] == src[ref - 1]) {
+							--start;
+							--ref;
+						}
+						uint32_t end = ip + LzMinMatch;
+						while (end < matchLimit && src[end] == src[ref + (end - start)])
+							++end;
+
+						if (!lz_emit(dst, dstCap, op, src + anchor, start - anchor, start - ref, end - start))
+							return 0;
+
+						ip = anchor = end;
+						if (ip >= 2 && ip < ipLimit)
+							pTable[lz_hash(lz_read32(src + ip - 2))] = ip - 2;
+					}
+				}
+
+				if (!lz_emit(dst, dstCap, op, src + anchor, srcSize - anchor, 0, 0))
+					return 0;
+				return op;
+			}
+
+			//! Decompresses \a srcSize bytes into exactly \a dstSize bytes. Every read and write is bounds-checked
+			//! so malformed input is rejected rather than trusted.
+			GAIA_NODISCARD inline bool lz_decompress(const uint8_t* src, uint32_t srcSize, uint8_t* dst, uint32_t dstSize) {
+				uint32_t ip = 0;
+				uint32_t op = 0;
+
+				auto read_len = [&](uint32_t& len) {
+					uint8_t b = 0;
+					do {
+						if (ip >= srcSize)
+							return false;
+						b = src[ip++];
+						len += b;
+					} while (b == 255);
+					return true;
+				};
+
+				while (true) {
+					if (ip >= srcSize)
+						return false;
+					const uint32_t token = src[ip++];
+
+					uint32_t litLen = token >> 4;
+					if (litLen == 15 && !read_len(litLen))
+						return false;
+					if (litLen > srcSize - ip || litLen > dstSize - op)
+						return false;
+					memcpy(dst + op, src + ip, litLen);
+					ip += litLen;
+					op += litLen;
+
+					// The last sequence carries literals only
+					if (ip == srcSize)
+						return op == dstSize;
+
+					if (srcSize - ip < 2)
+						return false;
+					const uint32_t offset = (uint32_t)src[ip] | ((uint32_t)src[ip + 1] << 8);
+					ip += 2;
+					if (offset == 0 || offset > op)
+						return false;
+
+					uint32_t matchLen = token & 15;
+					if (matchLen == 15 && !read_len(matchLen))
+						return false;
+					matchLen += LzMinMatch;
+					if (matchLen > dstSize - op)
+						return false;
+
+					const uint8_t* pRef = dst + op - offset;
+					if (offset >= matchLen)
+						memcpy(dst + op, pRef, matchLen);
+					else {
+						// Overlapping copy repeats the last offset bytes
+						GAIA_FOR(matchLen) dst[op + i] = pRef[i];
+					}
+					op += matchLen;
+				}
+			}
+
+			//----------------------------------------------------------------------
+			// Filters
+			//----------------------------------------------------------------------
+
+			inline void filter_shuffle(const uint8_t* src, uint8_t* dst, uint32_t size, uint32_t stride) {
+				const uint32_t cnt = size / stride;
+				GAIA_FOR_(stride, b) {
+					uint8_t* pPlane = dst + (b * cnt);
+					GAIA_FOR(cnt) pPlane[i] = src[(i * stride) + b];
+				}
+				// Trailing bytes which do not form a whole element stay as they are
+				const uint32_t done = cnt * stride;
+				memcpy(dst + done, src + done, size - done);
+			}
+
+			inline void filter_unshuffle(const uint8_t* src, uint8_t* dst, uint32_t size, uint32_t stride) {
+				const uint32_t cnt = size / stride;
+				GAIA_FOR_(stride, b) {
+					const uint8_t* pPlane = src + (b * cnt);
+					GAIA_FOR(cnt) dst[(i * stride) + b] = pPlane[i];
+				}
+				const uint32_t done = cnt * stride;
+				memcpy(dst + done, src + done, size - done);
+			}
+
+			inline void filter_delta(uint8_t* data, uint32_t size) {
+				uint8_t prev = 0;
+				GAIA_FOR(size) {
+					const uint8_t curr = data[i];
+					data[i] = (uint8_t)(curr - prev);
+					prev = curr;
+				}
+			}
+
+			inline void filter_undelta(uint8_t* data, uint32_t size) {
+				uint8_t prev = 0;
+				GAIA_FOR(size) {
+					prev = (uint8_t)(prev + data[i]);
+					data[i] = prev;
+				}
+			}
+
+			//! Per-block scratch memory used while packing.
+			struct pack_scratch {
+				cnt::darray<uint32_t> table;
+				cnt::darray<uint8_t> filtered;
+				cnt::darray<uint8_t> out;
+				cnt::darray<uint8_t> best;
+			};
+
+			//! Compresses one block with the given filter flags.
+			//! \return Compressed size or 0 if the block does not compress.
+			GAIA_NODISCARD inline uint32_t pack_block_with(
+					const uint8_t* src, uint32_t size, uint32_t flags, uint32_t stride, pack_scratch& scratch, uint8_t* dst,
+					uint32_t dstCap) {
+				const uint8_t* pInput = src;
+				if ((flags & PackFlagShuffle) != 0) {
+					filter_shuffle(src, scratch.filtered.data(), size, stride);
+					if ((flags & PackFlagDelta) != 0)
+						filter_delta(scratch.filtered.data(), size);
+					pInput = scratch.filtered.data();
+				}
+				return lz_compress(pInput, size, dst, dstCap, scratch.table.data());
+			}
+
+			//! Compresses one block choosing the filter according to \a opts.
+			//! The result is stored in scratch.best. Returns the block method.
+			GAIA_NODISCARD inline uint32_t
+			pack_block_data(const uint8_t* src, uint32_t size, const pack_opts& opts, pack_scratch& scratch, uint32_t& outSize) {
+				const uint32_t stride = core::get_max<uint32_t>(opts.stride, 1U);
+				const uint32_t cap = size - 1; // Anything bigger is not worth it
+
+				uint32_t candidates[3];
+				uint32_t candidateCnt = 0;
+				switch (opts.filter) {
+					case pack_filter::None:
+						candidates[candidateCnt++] = 0;
+						break;
+					case pack_filter::Shuffle:
+						candidates[candidateCnt++] = PackFlagShuffle;
+						break;
+					case pack_filter::ShuffleDelta:
+						candidates[candidateCnt++] = PackFlagShuffle | PackFlagDelta;
+						break;
+					case pack_filter::Auto:
+						candidates[candidateCnt++] = 0;
+						candidates[candidateCnt++] = PackFlagShuffle;
+						candidates[candidateCnt++] = PackFlagShuffle | PackFlagDelta;
+						break;
+				}
+
+				uint32_t bestMethod = PackCodecStored;
+				uint32_t bestSize = size;
+				GAIA_FOR(candidateCnt) {
+					const uint32_t flags = candidates[i];
+					const uint32_t packed =
+							size > 1 ? pack_block_with(src, size, flags, stride, scratch, scratch.out.data(), cap) : 0;
+					if (packed == 0 || packed >= bestSize)
+						continue;
+
+					bestSize = packed;
+					bestMethod = PackCodecLz | flags | (stride << 16);
+					memcpy(scratch.best.data(), scratch.out.data(), packed);
+				}
+
+				if (bestMethod == PackCodecStored)
+					memcpy(scratch.best.data(), src, size);
+
+				outSize = bestSize;
+				return bestMethod;
+			}
+
+			//! Decodes one block payload into \a dst which must be exactly \a dstSize bytes big.
+			GAIA_NODISCARD inline bool unpack_block_data(
+					const uint8_t* src, uint32_t srcSize, uint32_t method, uint8_t* dst, uint32_t dstSize,
+					cnt::darray<uint8_t>& tmp) {
+				const uint32_t codec = method & 0xFF;
+				if (codec == PackCodecStored) {
+					if (srcSize != dstSize)
+						return false;
+					memcpy(dst, src, dstSize);
+					return true;
+				}
+				if (codec != PackCodecLz)
+					return false;
+
+				if ((method & PackFlagShuffle) == 0)
+					return lz_decompress(src, srcSize, dst, dstSize);
+
+				const uint32_t stride = (method >> 16) & 0xFF;
+				if (stride == 0)
+					return false;
+
+				tmp.resize(dstSize);
+				if (!lz_decompress(src, srcSize, tmp.data(), dstSize))
+					return false;
+				if ((method & PackFlagDelta) != 0)
+					filter_undelta(tmp.data(), dstSize);
+				filter_unshuffle(tmp.data(), dst, dstSize, stride);
+				return true;
+			}
+
+			//! \endcond
+		} // namespace detail
+
+		//! Read-only view of a packed snapshot container.
+		//! Blocks are independent so they can be decoded in any order and on any thread.
+		class packed_view {
+			const uint8_t* m_pData = nullptr;
+			uint32_t m_size = 0;
+			detail::pack_header m_header{};
+
+			GAIA_NODISCARD detail::pack_block block(uint32_t idx) const {
+				detail::pack_block b;
+				memcpy(&b, m_pData + sizeof(detail::pack_header) + (idx * sizeof(detail::pack_block)), sizeof(b));
+				return b;
+			}
+
+		public:
+			//! Validates the container header and block table.
+			//! \return True if \a pData holds a well-formed container.
+			GAIA_NODISCARD bool init(const void* pData, uint32_t size) {
+				m_pData = (const uint8_t*)pData;
+				m_size = size;
+				m_header = {};
+
+				if (size < sizeof(detail::pack_header))
+					return false;
+				memcpy(&m_header, m_pData, sizeof(m_header));
+				if (m_header.magic != detail::PackMagic || m_header.version != detail::PackVersion)
+					return false;
+				if (m_header.blockSize == 0)
+					return false;
+				if (m_header.blockCnt != (m_header.rawSize + m_header.blockSize - 1) / m_header.blockSize)
+					return false;
+
+				const uint64_t tableEnd =
+						sizeof(detail::pack_header) + ((uint64_t)m_header.blockCnt * sizeof(detail::pack_block));
+				if (tableEnd > size)
+					return false;
+
+				GAIA_FOR(m_header.blockCnt) {
+					const auto b = block(i);
+					if (b.offset < tableEnd || (uint64_t)b.offset + b.size > size)
+						return false;
+				}
+
+				return true;
+			}
+
+			//! Returns the number of blocks in the container.
+			GAIA_NODISCARD uint32_t block_cnt() const {
+				return m_header.blockCnt;
+			}
+
+			//! Returns the size of the decompressed data in bytes.
+			GAIA_NODISCARD uint32_t raw_size() const {
+				return m_header.rawSize;
+			}
+
+			//! Returns the size of the container in bytes.
+			GAIA_NODISCARD uint32_t packed_size() const {
+				return m_size;
+			}
+
+			//! Decodes block \a idx into \a pDst. The output of the block starts at offset idx * blockSize
+			//! of the raw data so \a pDst is expected to point to the beginning of the whole raw buffer.
+			//! \param tmp Scratch memory reused between calls on the same thread.
+			GAIA_NODISCARD bool decode_block(uint32_t idx, void* pDst, cnt::darray<uint8_t>& tmp) const {
+				GAIA_ASSERT(idx < m_header.blockCnt);
+				const auto b = block(idx);
+				const uint32_t rawOffset = idx * m_header.blockSize;
+				const uint32_t rawSize = core::get_min(m_header.blockSize, m_header.rawSize - rawOffset);
+				return detail::unpack_block_data(
+						m_pData + b.offset, b.size, b.method, (uint8_t*)pDst + rawOffset, rawSize, tmp);
+			}
+		};
+
+		//! Packs \a size bytes of a serialized snapshot into a block-compressed container.
+		//! Each block is compressed independently so both packing and unpacking can run in parallel.
+		//! \param pData Raw snapshot data.
+		//! \param size Size of the raw data in bytes.
+		//! \param out Receives the container.
+		//! \param opts Packing options.
+		//! \param exec Executor invoked as exec(blockCnt, func) where func(blockIdx) must be called once for each block.
+		template <typename Executor = pack_serial_executor>
+		inline void pack_snapshot(
+				const void* pData, uint32_t size, cnt::darray<uint8_t>& out, const pack_opts& opts = {},
+				Executor&& exec = {}) {
+			const uint32_t blockSize = core::get_max(opts.blockSize, 64U);
+			const uint32_t blockCnt = (size + blockSize - 1) / blockSize;
+			const uint32_t tableEnd = (uint32_t)(sizeof(detail::pack_header) + (blockCnt * sizeof(detail::pack_block)));
+			const auto* pSrc = (const uint8_t*)pData;
+
+			// Compress every block into its own worst-case slot first. Slots are compacted afterwards
+			// so the threads never need to agree on the final offsets.
+			cnt::darray<uint8_t> slots(blockCnt * blockSize);
+			cnt::darray<uint32_t> methods(blockCnt);
+			cnt::darray<uint32_t> sizes(blockCnt);
+			exec(blockCnt, [&](uint32_t idx) {
+				detail::pack_scratch scratch;
+				scratch.table.resize(1U << detail::LzHashLog);
+				scratch.filtered.resize(blockSize);
+				scratch.out.resize(detail::lz_bound(blockSize));
+				scratch.best.resize(detail::lz_bound(blockSize));
+
+				const uint32_t rawOffset = idx * blockSize;
+				const uint32_t rawSize = core::get_min(blockSize, size - rawOffset);
+				uint32_t packed = 0;
+				methods[idx] = detail::pack_block_data(pSrc + rawOffset, rawSize, opts, scratch, packed);
+				sizes[idx] = packed;
+				memcpy(slots.data() + rawOffset, scratch.best.data(), packed);
+			});
+
+			uint32_t total = tableEnd;
+			GAIA_FOR(blockCnt) total += sizes[i];
+			out.resize(total);
+
+			detail::pack_header header{detail::PackMagic, detail::PackVersion, size, blockSize, blockCnt};
+			memcpy(out.data(), &header, sizeof(header));
+
+			uint32_t offset = tableEnd;
+			GAIA_FOR(blockCnt) {
+				detail::pack_block b{offset, sizes[i], methods[i]};
+				memcpy(out.data() + sizeof(header) + (i * sizeof(b)), &b, sizeof(b));
+				memcpy(out.data() + offset, slots.data() + (i * blockSize), sizes[i]);
+				offset += sizes[i];
+			}
+		}
+
+		//! Packs the contents of \a stream into a block-compressed container.
+		template <typename Executor = pack_serial_executor>
+		inline void pack_snapshot(
+				const bin_stream& stream, cnt::darray<uint8_t>& out, const pack_opts& opts = {}, Executor&& exec = {}) {
+			pack_snapshot(stream.data(), stream.bytes(), out, opts, GAIA_FWD(exec));
+		}
+
+		//! Unpacks a block-compressed container into \a stream so it can be passed to World::load.
+		//! \param pData Container data.
+		//! \param size Size of the container in bytes.
+		//! \param stream Receives the raw snapshot. Its stream position is rewound.
+		//! \param exec Executor invoked as exec(blockCnt, func) where func(blockIdx) must be called once for each block.
+		//! \return True on success. False if the container is malformed or truncated.
+		template <typename Executor = pack_serial_executor>
+		GAIA_NODISCARD inline bool
+		unpack_snapshot(const void* pData, uint32_t size, bin_stream& stream, Executor&& exec = {}) {
+			packed_view view;
+			if (!view.init(pData, size)) {
+				stream.resize(0);
+				return false;
+			}
+
+			stream.resize(view.raw_size());
+			char* pDst = stream.data_mut();
+
+			cnt::darray<uint8_t> results(view.block_cnt());
+			exec(view.block_cnt(), [&](uint32_t idx) {
+				cnt::darray<uint8_t> tmp;
+				results[idx] = view.decode_block(idx, pDst, tmp) ? 1 : 0;
+			});
+
+			GAIA_EACH(results) {
+				if (results[i] == 0) {
+					stream.resize(0);
+					return false;
+				}
+			}
+
+			return true;
+		}
+	} // namespace ser
+} // namespace gaia
@@ -133,6 +133,11 @@ namespace gaia {
 #if GAIA_ASSERT_ENABLED
 			template <typename T>
 			void check(const T& arg) {
+				// Only in-memory backends exposing their data can be rewound.
+				// Streaming backends move forward only.
+				if (data() == nullptr)
+					return;
+
 				T tmp{};
 
 				// Make sure that we write just as many bytes as we read.
@@ -0,0 +1,452 @@
+#pragma once
+#include "gaia/config/config.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if GAIA_PLATFORM_WINDOWS
+	#include <io.h>
+#else
+	#include <sys/uio.h>
+	#include <unistd.h>
+#endif
+
+#include "gaia/cnt/darray.h"
+#include "gaia/core/utility.h"
+#include "gaia/mem/mem_alloc.h"
+#include "gaia/ser/ser_common.h"
+#include "gaia/ser/ser_rt.h"
+
+namespace gaia {
+	namespace ser {
+		//! Contiguous range of bytes handed over to a stream sink.
+		struct stream_block {
+			//! First byte of the block.
+			const void* data;
+			//! Number of bytes in the block.
+			uint32_t size;
+		};
+
+		//! Writes \a blockCnt blocks in order. Returns false when the write failed.
+		using stream_write_fn = bool (*)(void* user, const stream_block* pBlocks, uint32_t blockCnt);
+		//! Reads up to \a size bytes into \a pDst. Returns the number of bytes read, 0 on end of stream or error.
+		using stream_read_fn = uint32_t (*)(void* user, void* pDst, uint32_t size);
+
+		//! Destination of a streaming binary writer.
+		struct stream_sink {
+			//! Opaque user context passed to the callback.
+			void* user = nullptr;
+			//! Callback receiving batches of filled blocks.
+			stream_write_fn write = nullptr;
+		};
+
+		//! Origin of a streaming binary reader.
+		struct stream_source {
+			//! Opaque user context passed to the callback.
+			void* user = nullptr;
+			//! Callback filling the reader's ring buffer.
+			stream_read_fn read = nullptr;
+		};
+
+		namespace detail {
+			inline int stream_fd(void* user) {
+				return (int)(intptr_t)user;
+			}
+
+			inline bool stream_fd_write(void* user, const stream_block* pBlocks, uint32_t blockCnt) {
+				const int fd = stream_fd(user);
+#if GAIA_PLATFORM_WINDOWS
+				GAIA_FOR(blockCnt) {
+					const auto* pData = (const char*)pBlocks[i].data;
+					uint32_t left = pBlocks[i].size;
+					while (left > 0) {
+						const int written = ::_write(fd, pData, left);
+						if (written <= 0)
+							return false;
+						pData += written;
+						left -= (uint32_t)written;
+					}
+				}
+				return true;
+#else
+				// Hand over the whole batch in as few syscalls as possible
+				static constexpr uint32_t MaxIov = 64;
+				iovec iov[MaxIov];
+
+				uint32_t blockIdx = 0;
+				uint32_t blockOffs = 0;
+				while (blockIdx < blockCnt) {
+					uint32_t iovCnt = 0;
+					for (uint32_t i = blockIdx; i < blockCnt && iovCnt < MaxIov; ++i, ++iovCnt) {
+						const uint32_t offs = i == blockIdx ? blockOffs : 0;
+						iov[iovCnt].iov_base = (void*)((const char*)pBlocks[i].data + offs);
+						iov[iovCnt].iov_len = pBlocks[i].size - offs;
+					}
+
+					const auto written = ::writev(fd, iov, (int)iovCnt);
+					if (written <= 0)
+						return false;
+
+					// Advance past everything written, handling partial writes
+					auto left = (size_t)written;
+					while (left > 0) {
+						const size_t blockLeft = pBlocks[blockIdx].size - blockOffs;
+						if (left < blockLeft) {
+							blockOffs += (uint32_t)left;
+							break;
+						}
+						left -= blockLeft;
+						++blockIdx;
+						blockOffs = 0;
+					}
+					// Skip empty blocks
+					while (blockIdx < blockCnt && pBlocks[blockIdx].size == blockOffs) {
+						++blockIdx;
+						blockOffs = 0;
+					}
+				}
+				return true;
+#endif
+			}
+
+			inline uint32_t stream_fd_read(void* user, void* pDst, uint32_t size) {
+				const int fd = stream_fd(user);
+#if GAIA_PLATFORM_WINDOWS
+				const int got = ::_read(fd, pDst, size);
+#else
+				const auto got = ::read(fd, pDst, size);
+#endif
+				return got <= 0 ? 0U : (uint32_t)got;
+			}
+		} // namespace detail
+
+		//! Creates a sink writing into an open file descriptor. The descriptor is not closed.
+		//! \param fd File descriptor opened for writing.
+		inline stream_sink make_fd_sink(int fd) {
+			return {(void*)(intptr_t)fd, detail::stream_fd_write};
+		}
+
+		//! Creates a source reading from an open file descriptor. The descriptor is not closed.
+		//! \param fd File descriptor opened for reading.
+		inline stream_source make_fd_source(int fd) {
+			return {(void*)(intptr_t)fd, detail::stream_fd_read};
+		}
+
+		//! Write-only binary backend that streams serialized data to a sink in fixed-size blocks.
+		//! The output is byte-compatible with bin_stream, so snapshots can be loaded by either backend.
+		//! Memory use is bounded by BlockSize * BlockCnt regardless of how much data is written.
+		//! Full batches of blocks are handed over to the sink in one call (writev-style). Writes bigger
+		//! than the internal buffer bypass it and are forwarded to the sink directly.
+		//! The backend does not expose data() because the snapshot is never materialized.
+		class bin_stream_writer {
+		public:
+			//! Default size of a single block in bytes.
+			static constexpr uint32_t DefaultBlockSize = 64 * 1024;
+			//! Default number of blocks handed over to the sink at once.
+			static constexpr uint32_t DefaultBlockCnt = 8;
+
+		private:
+			stream_sink m_sink;
+			//! Staging buffer holding BlockCnt blocks
+			cnt::darray<uint8_t> m_buffer;
+			//! Size of a single block
+			uint32_t m_blockSize;
+			//! Number of bytes used in the staging buffer
+			uint32_t m_used = 0;
+			//! Logical position in the stream
+			uint64_t m_pos = 0;
+			//! Number of bytes already handed over to the sink
+			uint64_t m_flushed = 0;
+			//! True if the sink reported an error
+			bool m_failed = false;
+
+			GAIA_NODISCARD uint32_t capacity() const {
+				return (uint32_t)m_buffer.size();
+			}
+
+			void write_blocks(const stream_block* pBlocks, uint32_t blockCnt, uint32_t bytes) {
+				if (blockCnt == 0 || m_failed)
+					return;
+
+				if (!m_sink.write(m_sink.user, pBlocks, blockCnt))
+					m_failed = true;
+				m_flushed += bytes;
+			}
+
+			//! Hands over the staging buffer to the sink as a batch of blocks
+			void flush_buffer() {
+				if (m_used == 0)
+					return;
+
+				static constexpr uint32_t MaxBatch = 64;
+				stream_block blocks[MaxBatch];
+				uint32_t blockCnt = 0;
+				uint32_t batchBytes = 0;
+				for (uint32_t offs = 0; offs < m_used; offs += m_blockSize) {
+					const auto size = core::get_min(m_blockSize, m_used - offs);
+					blocks[blockCnt++] = {&m_buffer[offs], size};
+					batchBytes += size;
+					if (blockCnt == MaxBatch) {
+						write_blocks(blocks, blockCnt, batchBytes);
+						blockCnt = 0;
+						batchBytes = 0;
+					}
+				}
+				write_blocks(blocks, blockCnt, batchBytes);
+				m_used = 0;
+			}
+
+			void put(const void* pSrc, uint32_t size) {
+				const auto* pData = (const uint8_t*)pSrc;
+				m_pos += size;
+
+				while (size > 0) {
+					// Large writes do not need to go through the staging buffer
+					if (m_used == 0 && size >= capacity()) {
+						const uint32_t bytes = size - (size % m_blockSize);
+						const stream_block block{pData, bytes};
+						write_blocks(&block, 1, bytes);
+						pData += bytes;
+						size -= bytes;
+						continue;
+					}
+
+					const auto n = core::get_min(size, capacity() - m_used);
+					memcpy(&m_buffer[m_used], pData, n);
+					m_used += n;
+					pData += n;
+					size -= n;
+
+					if (m_used == capacity())
+						flush_buffer();
+				}
+			}
+
+			void pad(uint32_t size) {
+				m_pos += size;
+
+				while (size > 0) {
+					const auto n = core::get_min(size, capacity() - m_used);
+					memset(&m_buffer[m_used], 0, n);
+					m_used += n;
+					size -= n;
+
+					if (m_used == capacity())
+						flush_buffer();
+				}
+			}
+
+		public:
+			//! \param sink Destination receiving the serialized blocks
+			//! \param blockSize Size of a single block in bytes
+			//! \param blockCnt Number of blocks buffered before they are handed over to the sink
+			explicit bin_stream_writer(
+					stream_sink sink, uint32_t blockSize = DefaultBlockSize, uint32_t blockCnt = DefaultBlockCnt):
+					m_sink(sink), m_blockSize(blockSize) {
+				GAIA_ASSERT(sink.write != nullptr);
+				GAIA_ASSERT(blockSize > 0 && blockCnt > 0);
+				m_buffer.resize(blockSize * blockCnt);
+			}
+
+			~bin_stream_writer() {
+				flush();
+			}
+
+			bin_stream_writer(const bin_stream_writer&) = delete;
+			bin_stream_writer& operator=(const bin_stream_writer&) = delete;
+			bin_stream_writer(bin_stream_writer&&) = delete;
+			bin_stream_writer& operator=(bin_stream_writer&&) = delete;
+
+			//! Writes raw bytes with type-aware alignment.
+			void save_raw(const void* src, uint32_t size, serialization_type_id id) {
+				const auto posAligned = mem::align(m_pos, (uint64_t)serialization_type_size(id, size));
+				pad((uint32_t)(posAligned - m_pos));
+				if (size > 0)
+					put(src, size);
+			}
+
+			//! Not supported. The writer is write-only.
+			void load_raw(
+					[[maybe_unused]] void* src, [[maybe_unused]] uint32_t size, [[maybe_unused]] serialization_type_id id) {
+				GAIA_ASSERT2(false, "bin_stream_writer is write-only");
+			}
+
+			//! Restarts the stream. Only valid before anything was handed over to the sink.
+			void reset() {
+				GAIA_ASSERT2(m_flushed == 0, "bin_stream_writer can't be reset once data was flushed");
+				m_used = 0;
+				m_pos = 0;
+			}
+
+			//! Returns current stream cursor position in bytes.
+			uint32_t tell() const {
+				return (uint32_t)m_pos;
+			}
+
+			//! Returns the total number of bytes written so far.
+			GAIA_NODISCARD uint64_t bytes_total() const {
+				return m_pos;
+			}
+
+			//! The writer only moves forward. Seeking is a no-op for the current position
+			//! and pads the stream when moving forward.
+			void seek(uint32_t pos) {
+				GAIA_ASSERT2(pos >= tell(), "bin_stream_writer can't seek backwards");
+				if (pos > tell())
+					pad(pos - tell());
+			}
+
+			//! Hands over all buffered data to the sink.
+			//! \return True if all data was written successfully.
+			bool flush() {
+				flush_buffer();
+				return !m_failed;
+			}
+
+			//! Returns true if the sink has not reported any error so far.
+			GAIA_NODISCARD bool ok() const {
+				return !m_failed;
+			}
+		};
+
+		//! Read-only binary backend that decodes data streamed from a source through a bounded ring buffer.
+		//! Reads data produced by bin_stream or bin_stream_writer. Memory use is bounded by the ring capacity.
+		//! Reads bigger than the ring buffer bypass it and land in the destination directly.
+		class bin_stream_reader {
+		public:
+			//! Default capacity of the ring buffer in bytes.
+			static constexpr uint32_t DefaultCapacity = 256 * 1024;
+
+		private:
+			stream_source m_source;
+			//! Ring buffer. Its capacity is a power of two
+			cnt::darray<uint8_t> m_ring;
+			//! Index of the first unread byte in the ring
+			uint32_t m_head = 0;
+			//! Number of unread bytes in the ring
+			uint32_t m_cnt = 0;
+			//! Logical position in the stream
+			uint64_t m_pos = 0;
+			//! True if the source ran dry before the requested data was read
+			bool m_failed = false;
+
+			GAIA_NODISCARD uint32_t mask() const {
+				return (uint32_t)m_ring.size() - 1;
+			}
+
+			//! Refills the free part of the ring buffer.
+			//! \return False when the source has no more data.
+			bool fill() {
+				const auto cap = (uint32_t)m_ring.size();
+				bool any = false;
+				// The free space is at most two contiguous regions
+				GAIA_FOR(2) {
+					if (m_cnt == cap)
+						break;
+					const auto tail = (m_head + m_cnt) & mask();
+					const auto contiguous = tail >= m_head ? cap - tail : m_head - tail;
+					const auto space = core::get_min(contiguous, cap - m_cnt);
+					const auto got = m_source.read(m_source.user, &m_ring[tail], space);
+					if (got == 0)
+						break;
+					m_cnt += got;
+					any = true;
+					if (got < space)
+						break;
+				}
+				return any;
+			}
+
+			//! Consumes \a size bytes. When \a pDst is null the bytes are discarded.
+			void take(uint8_t* pDst, uint32_t size) {
+				m_pos += size;
+
+				while (size > 0) {
+					if (m_cnt == 0) {
+						// Large reads bypass the ring buffer
+						if (pDst != nullptr && size >= m_ring.size()) {
+							const auto got = m_source.read(m_source.user, pDst, size);
+							if (got == 0)
+								break;
+							pDst += got;
+							size -= got;
+							continue;
+						}
+
+						if (!fill())
+							break;
+					}
+
+					const auto n = core::get_min(core::get_min(size, m_cnt), (uint32_t)m_ring.size() - m_head);
+					if (pDst != nullptr) {
+						memcpy(pDst, &m_ring[m_head], n);
+						pDst += n;
+					}
+					m_head = (m_head + n) & mask();
+					m_cnt -= n;
+					size -= n;
+				}
+
+				if (size > 0) {
+					m_failed = true;
+					if (pDst != nullptr)
+						memset(pDst, 0, size);
+				}
+			}
+
+		public:
+			//! \param source Origin of the serialized data
+			//! \param capacity Capacity of the ring buffer in bytes. Rounded up to a power of two.
+			explicit bin_stream_reader(stream_source source, uint32_t capacity = DefaultCapacity): m_source(source) {
+				GAIA_ASSERT(source.read != nullptr);
+				GAIA_ASSERT(capacity > 0);
+				uint32_t cap = 1;
+				while (cap < capacity)
+					cap <<= 1;
+				m_ring.resize(cap);
+			}
+
+			bin_stream_reader(const bin_stream_reader&) = delete;
+			bin_stream_reader& operator=(const bin_stream_reader&) = delete;
+			bin_stream_reader(bin_stream_reader&&) = delete;
+			bin_stream_reader& operator=(bin_stream_reader&&) = delete;
+
+			//! Not supported. The reader is read-only.
+			void save_raw(
+					[[maybe_unused]] const void* src, [[maybe_unused]] uint32_t size,
+					[[maybe_unused]] serialization_type_id id) {
+				GAIA_ASSERT2(false, "bin_stream_reader is read-only");
+			}
+
+			//! Reads raw bytes with type-aware alignment.
+			void load_raw(void* src, uint32_t size, serialization_type_id id) {
+				const auto posAligned = mem::align(m_pos, (uint64_t)serialization_type_size(id, size));
+				take(nullptr, (uint32_t)(posAligned - m_pos));
+				if (size > 0)
+					take((uint8_t*)src, size);
+			}
+
+			//! Returns current stream cursor position in bytes.
+			uint32_t tell() const {
+				return (uint32_t)m_pos;
+			}
+
+			//! Returns the total number of bytes consumed so far.
+			GAIA_NODISCARD uint64_t bytes_total() const {
+				return m_pos;
+			}
+
+			//! The reader only moves forward. Seeking forward skips data.
+			void seek(uint32_t pos) {
+				GAIA_ASSERT2(pos >= tell(), "bin_stream_reader can't seek backwards");
+				if (pos > tell())
+					take(nullptr, pos - tell());
+			}
+
+			//! Returns true if all requested data was available so far.
+			GAIA_NODISCARD bool ok() const {
+				return !m_failed;
+			}
+		};
+	} // namespace ser
+} // namespace gaia
@@ -1790,6 +1790,294 @@ void BM_ECS_Iter_SoA_Dir(picobench::state& state) {
 	}
 }
 
+void BM_ECS_Iter_SoA_Simd(picobench::state& state) {
+	GAIA_PROF_SCOPE(BM_ECS_Iter_SoA_Simd);
+
+	ecs::World w;
+
+	w.system().name("update_pos").all<PositionSoA&>().all<VelocitySoA>().on_each([](ecs::Iter& it) {
+		auto p = it.simd_view_mut<PositionSoA>();
+		auto v = it.simd_view<VelocitySoA>();
+
+		auto ppx = p.set<0>();
+		auto ppy = p.set<1>();
+		auto ppz = p.set<2>();
+
+		auto vvx = v.get<0>();
+		auto vvy = v.get<1>();
+		auto vvz = v.get<2>();
+
+		using vec = decltype(ppx)::vec_type;
+		const auto cdt = vec::splat(dt);
+
+		const auto cnt = ppx.block_cnt();
+		GAIA_FOR(cnt) {
+			ppx.store(i, ppx.load(i) + vvx.load(i) * cdt);
+			ppy.store(i, ppy.load(i) + vvy.load(i) * cdt);
+			ppz.store(i, ppz.load(i) + vvz.load(i) * cdt);
+		}
+	});
+
+	w.system().name("handle_collision").all<PositionSoA&>().all<VelocitySoA&>().on_each([](ecs::Iter& it) {
+		auto p = it.simd_view_mut<PositionSoA>();
+		auto v = it.simd_view_mut<VelocitySoA>();
+
+		auto ppy = p.set<1>();
+		auto vvy = v.set<1>();
+
+		using vec = decltype(ppy)::vec_type;
+		const auto zero = vec::zero();
+
+		const auto cnt = ppy.block_cnt();
+		GAIA_FOR(cnt) {
+			const auto py = ppy.load(i);
+			ppy.store(i, select_lt(py, zero, zero, py));
+			vvy.store(i, select_lt(py, zero, zero, vvy.load(i)));
+		}
+	});
+
+	w.system().name("apply_gravity").all<VelocitySoA&>().on_each([](ecs::Iter& it) {
+		auto v = it.simd_view_mut<VelocitySoA>();
+
+		auto vvy = v.set<1>();
+
+		using vec = decltype(vvy)::vec_type;
+		const auto g = vec::splat(9.81f * dt);
+
+		const auto cnt = vvy.block_cnt();
+		GAIA_FOR(cnt) vvy.store(i, vvy.load(i) + g);
+	});
+
+	w.system().name("calc_alive").all<Health>().on_each([](ecs::Iter& it) {
+		auto h = it.view<Health>();
+		uint32_t aliveUnits = 0;
+
+		const auto cnt = it.size();
+		GAIA_FOR(cnt) {
+			if (h[i].value > 0)
+				++aliveUnits;
+		}
+		gaia::dont_optimize(aliveUnits);
+	});
+
+	{
+		GAIA_PROF_SCOPE(setup);
+		Register_ESC_Components<true>(w);
+		CreateECSEntities_Static<true>(w, (uint32_t)state.user_data() / 2);
+		CreateECSEntities_Dynamic<true>(w, (uint32_t)state.user_data() / 2);
+
+		/* We want to benchmark the hot-path. In real-world scenarios queries are cached so cache them now */
+		for (uint32_t i = 0; i < 10; ++i)
+			w.systems_run();
+	}
+
+	srand(0);
+	for (auto _: state) {
+		(void)_;
+		dt = CalculateDelta(state);
+		w.systems_run();
+	}
+}
+
+void BM_ECS_Kernel(picobench::state& state) {
+	GAIA_PROF_SCOPE(BM_ECS_Kernel);
+
+	ecs::World w;
+
+	auto kPosCVel = w.query<ecs::AllOf<Position&, const Velocity>>();
+	auto kPosVel = w.query<ecs::AllOf<Position&, Velocity&>>();
+	auto kVel = w.query<ecs::AllOf<Velocity&>>();
+	auto kCHealth = w.query<ecs::AllOf<const Health>>();
+
+	{
+		GAIA_PROF_SCOPE(setup);
+		Register_ESC_Components<false>(w);
+		CreateECSEntities_Static<false>(w, (uint32_t)state.user_data() / 2);
+		CreateECSEntities_Dynamic<false>(w, (uint32_t)state.user_data() / 2);
+
+		/* We want to benchmark the hot-path. In real-world scenarios queries are cached so cache them now */
+		gaia::dont_optimize(kPosCVel.archetype_cnt());
+		gaia::dont_optimize(kPosVel.archetype_cnt());
+		gaia::dont_optimize(kVel.archetype_cnt());
+		gaia::dont_optimize(kCHealth.archetype_cnt());
+	}
+
+	srand(0);
+	for (auto _: state) {
+		(void)_;
+		const float cdt = CalculateDelta(state);
+
+		// Update position
+		{
+			GAIA_PROF_SCOPE(update_pos);
+			kPosCVel.each([&](Position& p, const Velocity& v) {
+				p.x += v.x * cdt;
+				p.y += v.y * cdt;
+				p.z += v.z * cdt;
+			});
+		}
+		// Handle ground collision
+		{
+			GAIA_PROF_SCOPE(handle_collision);
+			kPosVel.each([&](Position& p, Velocity& v) {
+				if (p.y < 0.0f) {
+					p.y = 0.0f;
+					v.y = 0.0f;
+				}
+			});
+		}
+		// Apply gravity
+		{
+			GAIA_PROF_SCOPE(apply_gravity);
+			kVel.each([&](Velocity& v) {
+				v.y += 9.81f * cdt;
+			});
+		}
+		// Calculate the number of units alive
+		{
+			GAIA_PROF_SCOPE(calc_alive);
+			uint32_t aliveUnits = 0;
+			kCHealth.each([&](const Health& h) {
+				if (h.value > 0)
+					++aliveUnits;
+			});
+			gaia::dont_optimize(aliveUnits);
+		}
+
+		GAIA_PROF_FRAME();
+	}
+}
+
+void BM_ECS_Kernel_SoA(picobench::state& state) {
+	GAIA_PROF_SCOPE(BM_ECS_Kernel_SoA);
+
+	ecs::World w;
+
+	auto kPosCVel = w.query<ecs::AllOf<PositionSoA&, const VelocitySoA>>();
+	auto kPosVel = w.query<ecs::AllOf<PositionSoA&, VelocitySoA&>>();
+	auto kVel = w.query<ecs::AllOf<VelocitySoA&>>();
+	auto kCHealth = w.query<ecs::AllOf<const Health>>();
+
+	{
+		GAIA_PROF_SCOPE(setup);
+		Register_ESC_Components<true>(w);
+		CreateECSEntities_Static<true>(w, (uint32_t)state.user_data() / 2);
+		CreateECSEntities_Dynamic<true>(w, (uint32_t)state.user_data() / 2);
+
+		/* We want to benchmark the hot-path. In real-world scenarios queries are cached so cache them now */
+		gaia::dont_optimize(kPosCVel.archetype_cnt());
+		gaia::dont_optimize(kPosVel.archetype_cnt());
+		gaia::dont_optimize(kVel.archetype_cnt());
+		gaia::dont_optimize(kCHealth.archetype_cnt());
+	}
+
+	srand(0);
+	for (auto _: state) {
+		(void)_;
+		const float cdt = CalculateDelta(state);
+
+		// Update position
+		kPosCVel.each_chunk([&](uint32_t from, uint32_t to, auto p, auto v) {
+			auto ppx = p.template set<0>();
+			auto ppy = p.template set<1>();
+			auto ppz = p.template set<2>();
+
+			auto vvx = v.template get<0>();
+			auto vvy = v.template get<1>();
+			auto vvz = v.template get<2>();
+
+			GAIA_FOR2(from, to) ppx[i] += vvx[i] * cdt;
+			GAIA_FOR2(from, to) ppy[i] += vvy[i] * cdt;
+			GAIA_FOR2(from, to) ppz[i] += vvz[i] * cdt;
+		});
+		// Handle ground collision
+		kPosVel.each_chunk([&](uint32_t from, uint32_t to, auto p, auto v) {
+			auto ppy = p.template set<1>();
+			auto vvy = v.template set<1>();
+
+			GAIA_FOR2(from, to) {
+				if (ppy[i] < 0.0f) {
+					ppy[i] = 0.0f;
+					vvy[i] = 0.0f;
+				}
+			}
+		});
+		// Apply gravity
+		kVel.each_chunk([&](uint32_t from, uint32_t to, auto v) {
+			auto vvy = v.template set<1>();
+			GAIA_FOR2(from, to) vvy[i] += 9.81f * cdt;
+		});
+		// Calculate the number of units alive
+		uint32_t aliveUnits = 0;
+		kCHealth.each_chunk([&](uint32_t from, uint32_t to, auto h) {
+			uint32_t localAliveUnits = 0;
+			GAIA_FOR2(from, to) {
+				if (h[i].value > 0)
+					++localAliveUnits;
+			}
+			aliveUnits += localAliveUnits;
+		});
+		gaia::dont_optimize(aliveUnits);
+	}
+}
+
+void BM_ECS_UpdatePositionOnlyKernel(picobench::state& state) {
+	GAIA_PROF_SCOPE(BM_ECS_UpdatePositionOnlyKernel);
+
+	ecs::World w;
+	auto kPosCVel = w.query<ecs::AllOf<Position&, const Velocity>>();
+
+	{
+		GAIA_PROF_SCOPE(setup);
+		Register_ESC_Components<false>(w);
+		CreateECSEntities_Static<false>(w, (uint32_t)state.user_data() / 2);
+		CreateECSEntities_Dynamic<false>(w, (uint32_t)state.user_data() / 2);
+		gaia::dont_optimize(kPosCVel.archetype_cnt());
+	}
+
+	for (auto _: state) {
+		(void)_;
+		const float cdt = CalculateDelta(state);
+		kPosCVel.each([&](Position& p, const Velocity& v) {
+			p.x += v.x * cdt;
+			p.y += v.y * cdt;
+			p.z += v.z * cdt;
+		});
+	}
+}
+
+void BM_ECS_UpdatePositionFixedDeltaWithReadbackKernel(picobench::state& state) {
+	GAIA_PROF_SCOPE(BM_ECS_UpdatePositionFixedDeltaWithReadbackKernel);
+
+	ecs::World w;
+	auto kPosCVel = w.query<ecs::AllOf<Position&, const Velocity>>();
+
+	{
+		GAIA_PROF_SCOPE(setup);
+		Register_ESC_Components<false>(w);
+		CreateECSEntities_Static<false>(w, (uint32_t)state.user_data() / 2);
+		CreateECSEntities_Dynamic<false>(w, (uint32_t)state.user_data() / 2);
+		gaia::dont_optimize(kPosCVel.archetype_cnt());
+	}
+
+	for (auto _: state) {
+		(void)_;
+		float sum = 0.0f;
+		constexpr float cdt = 0.016f;
+		kPosCVel.each_chunk([&](uint32_t from, uint32_t to, auto p, auto v) {
+			float localSum = 0.0f;
+			GAIA_FOR2(from, to) {
+				p[i].x += v[i].x * cdt;
+				p[i].y += v[i].y * cdt;
+				p[i].z += v[i].z * cdt;
+				localSum += p[i].x + p[i].y + p[i].z;
+			}
+			sum += localSum;
+		});
+		gaia::dont_optimize(sum);
+	}
+}
+
 namespace NonECS {
 	struct IUnit {
 		Position p;
@@ -2796,6 +3084,9 @@ int main(int argc, char* argv[]) {
 			PICOBENCH_REG(BM_ECS).PICO_SETTINGS().baseline().label("Default");
 			PICOBENCH_REG(BM_ECS_Iter).PICO_SETTINGS().label("Iter");
 			PICOBENCH_REG(BM_ECS_Iter_SoA).PICO_SETTINGS().label("Iter_SoA");
+			PICOBENCH_REG(BM_ECS_Iter_SoA_Simd).PICO_SETTINGS().label("Iter_SoA_Simd");
+			PICOBENCH_REG(BM_ECS_Kernel).PICO_SETTINGS().label("Kernel");
+			PICOBENCH_REG(BM_ECS_Kernel_SoA).PICO_SETTINGS().label("Kernel_SoA");
 			r.run_benchmarks();
 			return 0;
 		}
@@ -2890,6 +3181,10 @@ int main(int argc, char* argv[]) {
 					.PICO_SETTINGS()
 					.user_data(NMany)
 					.label("UpdatePositionOnlyEachArch Many");
+			PICOBENCH_REG(BM_ECS_UpdatePositionOnlyKernel)
+					.PICO_SETTINGS()
+					.user_data(NMany)
+					.label("UpdatePositionOnlyKernel Many");
 			PICOBENCH_REG(BM_ECS_ReadPositionVelocityOnly)
 					.PICO_SETTINGS()
 					.user_data(NMany)
@@ -2954,6 +3249,10 @@ int main(int argc, char* argv[]) {
 					.PICO_SETTINGS()
 					.user_data(NMany)
 					.label("UpdatePositionFixedDeltaWithReadbackIterLocalSum Many");
+			PICOBENCH_REG(BM_ECS_UpdatePositionFixedDeltaWithReadbackKernel)
+					.PICO_SETTINGS()
+					.user_data(NMany)
+					.label("UpdatePositionFixedDeltaWithReadbackKernel Many");
 			PICOBENCH_REG(BM_ECS_ReadVelocityOnly).PICO_SETTINGS().user_data(NMany).label("ReadVelocityOnly Many");
 			PICOBENCH_REG(BM_ECS_WriteVelocityOnly).PICO_SETTINGS().user_data(NMany).label("WriteVelocityOnly Many");
 			PICOBENCH_REG(BM_ECS_ReadVelocityChunkRawOnly)
@@ -2980,6 +3279,14 @@ int main(int argc, char* argv[]) {
 			PICOBENCH_REG(BM_ECS_Iter_SoA).PICO_SETTINGS().user_data(NMany).label("Iter_SoA Many");
 			PICOBENCH_REG(BM_ECS_Iter_SoA_Dir).PICO_SETTINGS().label("Iter_SoA_Dir");
 			PICOBENCH_REG(BM_ECS_Iter_SoA_Dir).PICO_SETTINGS().user_data(NMany).label("Iter_SoA_Dir Many");
+			// Explicit SIMD over SoA columns. Compare with Iter_SoA_Dir which runs the same systems with scalar loops.
+			PICOBENCH_REG(BM_ECS_Iter_SoA_Simd).PICO_SETTINGS().label("Iter_SoA_Simd");
+			PICOBENCH_REG(BM_ECS_Iter_SoA_Simd).PICO_SETTINGS().user_data(NMany).label("Iter_SoA_Simd Many");
+			// Compile-time query kernels. Performance targets are the DOD and DOD_SoA suites.
+			PICOBENCH_REG(BM_ECS_Kernel).PICO_SETTINGS().label("Kernel");
+			PICOBENCH_REG(BM_ECS_Kernel).PICO_SETTINGS().user_data(NMany).label("Kernel Many");
+			PICOBENCH_REG(BM_ECS_Kernel_SoA).PICO_SETTINGS().label("Kernel_SoA");
+			PICOBENCH_REG(BM_ECS_Kernel_SoA).PICO_SETTINGS().user_data(NMany).label("Kernel_SoA Many");
 			PICOBENCH_REG(BM_ECS_DepthOrder_Iter_EnabledOnly)
 					.PICO_SETTINGS()
 					.user_data(NMany)
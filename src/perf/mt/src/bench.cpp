@@ -196,6 +196,45 @@ void BM_Schedule_ECS_Complex(picobench::state& state) {
 	}
 }
 
+void BM_Schedule_ECS_Deterministic(picobench::state& state) {
+	const auto user_data = state.user_data();
+	const uint32_t N = user_data & 0xFFFFFFFF;
+	const bool deterministic = (user_data >> 32) != 0;
+
+	ecs::World w;
+	w.deterministic(deterministic);
+
+	GAIA_FOR(N) {
+		auto e = w.add();
+		w.add<Data>(e, {i});
+	}
+
+	auto q = w.query().all<Data>();
+	auto run = [&]() {
+		// Partial results are combined the same way in both modes so only the execution differs
+		ecs::OrderedReduce<uint32_t> reduce;
+		q.each(
+				[&](ecs::Iter& it) {
+					auto dv = it.view<Data>();
+					auto sp = std::span((const Data*)dv.data(), dv.size());
+					it.reduce(reduce, BenchFunc_Complex(sp));
+				},
+				ecs::QueryExecType::Parallel);
+		auto res = reduce.fold(0U, [](uint32_t a, uint32_t b) {
+			return a + b;
+		});
+		gaia::dont_optimize(res);
+	};
+
+	// Warm up
+	run();
+
+	for (auto _: state) {
+		(void)_;
+		run();
+	}
+}
+
 template <typename Func>
 void Run_ScheduleParallel(const Data* pArr, uint32_t Items, Func func) {
 	auto& tp = mt::ThreadPool::get();
@@ -241,6 +280,191 @@ void BM_ScheduleParallel_Complex(picobench::state& state) {
 	}
 }
 
+//! Reduces \a cnt items by recursively splitting them into \a Parts ranges processed via sched_par.
+//! Every level waits for its children from inside a running job (fork-join).
+template <typename Func>
+uint32_t Run_ForkJoin(const Data* pArr, uint32_t cnt, uint32_t cutoff, Func func) {
+	if (cnt <= cutoff)
+		return func({pArr, cnt});
+
+	auto& tp = mt::ThreadPool::get();
+
+	constexpr uint32_t Parts = 4;
+	const uint32_t partSize = (cnt + Parts - 1) / Parts;
+	std::atomic_uint32_t sum = 0;
+
+	mt::JobParallel job;
+	job.func = [&](const mt::JobArgs& args) {
+		uint32_t partSum = 0;
+		for (uint32_t p = args.idxStart; p < args.idxEnd; ++p) {
+			const uint32_t from = p * partSize;
+			const uint32_t to = core::get_min(from + partSize, cnt);
+			partSum += Run_ForkJoin(pArr + from, to - from, cutoff, func);
+		}
+		sum += partSum;
+	};
+
+	tp.wait(tp.sched_par(GAIA_MOV(job), Parts, 1));
+	return sum;
+}
+
+void BM_ForkJoin_Simple(picobench::state& state) {
+	const auto user_data = state.user_data();
+	const uint32_t N = user_data & 0xFFFFFFFF;
+	const uint32_t Cutoff = (uint32_t)(user_data >> 32);
+
+	cnt::darray<Data> arr;
+	arr.resize(N);
+	GAIA_EACH(arr) arr[i].val = i;
+
+	for (auto _: state) {
+		(void)_;
+		auto sum = Run_ForkJoin(arr.data(), N, Cutoff, BenchFunc_Simple);
+		gaia::dont_optimize(sum);
+	}
+}
+
+void BM_Schedule_WakeLatency(picobench::state& state) {
+	const auto user_data = state.user_data();
+	const uint32_t spinBudget = user_data & 0xFFFFFFFF;
+	const bool cold = (user_data >> 32) != 0;
+
+	auto& tp = mt::ThreadPool::get();
+	const auto spinBudgetOld = tp.spin_budget();
+	tp.set_spin_budget(spinBudget);
+
+	// The main thread never helps here so the job has to be picked up by a worker
+	const bool hasWorkers = tp.workers() > 0;
+	std::atomic_bool started = false;
+
+	for (auto _: state) {
+		(void)_;
+		state.stop_timer();
+
+		// Give workers enough time to run out of spin budget and park
+		if (cold)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		started.store(false, std::memory_order_relaxed);
+		mt::Job job;
+		job.func = [&started]() {
+			started.store(true, std::memory_order_release);
+		};
+		auto jobHandle = tp.add(GAIA_MOV(job));
+
+		// Submit -> first execution
+		state.start_timer();
+		tp.submit(jobHandle);
+		if (hasWorkers) {
+			while (!started.load(std::memory_order_acquire))
+				GAIA_YIELD_CPU;
+		} else
+			tp.update();
+		state.stop_timer();
+	}
+
+	tp.set_spin_budget(spinBudgetOld);
+}
+
+void BM_Schedule_Frames(picobench::state& state) {
+	const auto user_data = state.user_data();
+	const uint32_t Jobs = user_data & 0xFFFFFFFF;
+	const uint32_t spinBudget = (uint32_t)(user_data >> 32);
+
+	auto& tp = mt::ThreadPool::get();
+	const auto spinBudgetOld = tp.spin_budget();
+	tp.set_spin_budget(spinBudget);
+
+	// Every iteration is a burst of 16 frames with tiny jobs. Between frames workers briefly run out of work.
+	constexpr uint32_t Frames = 16;
+	for (auto _: state) {
+		(void)_;
+		GAIA_FOR(Frames) Run_Schedule_Empty(Jobs);
+	}
+
+	tp.set_spin_budget(spinBudgetOld);
+}
+
+template <uint32_t N>
+bool Burst_Push(mt::JobQueue<N>& q, mt::JobHandle jobHandle) {
+	return q.try_push(jobHandle);
+}
+
+template <uint32_t N>
+bool Burst_Push(mt::JobDeque<N>& q, mt::JobHandle jobHandle) {
+	q.push(jobHandle);
+	return true;
+}
+
+template <uint32_t N>
+uint32_t Burst_Steal(mt::JobQueue<N>& q, std::span<mt::JobHandle> jobHandles) {
+	return q.try_steal(jobHandles[0]) && jobHandles[0] != (mt::JobHandle)mt::JobNull_t{} ? 1 : 0;
+}
+
+template <uint32_t N>
+uint32_t Burst_Steal(mt::JobDeque<N>& q, std::span<mt::JobHandle> jobHandles) {
+	return q.steal_half(jobHandles);
+}
+
+//! One producer pushes a burst of jobs while thieves steal them. When a fixed queue is full
+//! the producer runs jobs itself the same way the thread pool does.
+template <typename TQueue>
+void Run_JobQueue_Burst(picobench::state& state) {
+	const uint32_t Jobs = (uint32_t)state.user_data();
+	const uint32_t Thieves = core::get_min(4U, core::get_max(2U, mt::ThreadPool::hw_thread_cnt()) - 1);
+
+	for (auto _: state) {
+		(void)_;
+		state.stop_timer();
+
+		// A new queue every time so growing is measured, too
+		auto pQueue = std::make_unique<TQueue>();
+		auto& q = *pQueue;
+		std::atomic_uint32_t done = 0;
+		std::atomic_bool terminate = false;
+
+		cnt::darray<std::thread> thieves;
+		GAIA_FOR(Thieves) {
+			thieves.push_back(std::thread([&]() {
+				mt::JobHandle jobHandles[32];
+				while (!terminate.load(std::memory_order_relaxed)) {
+					const auto cnt = Burst_Steal(q, std::span(jobHandles, 32));
+					if (cnt == 0)
+						GAIA_YIELD_CPU;
+					else
+						done.fetch_add(cnt, std::memory_order_relaxed);
+				}
+			}));
+		}
+
+		state.start_timer();
+		mt::JobHandle jobHandle;
+		GAIA_FOR(Jobs) {
+			while (!Burst_Push(q, mt::JobHandle(i, 0, 0))) {
+				if (q.try_pop(jobHandle))
+					done.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		while (q.try_pop(jobHandle))
+			done.fetch_add(1, std::memory_order_relaxed);
+		while (done.load(std::memory_order_relaxed) < Jobs)
+			GAIA_YIELD_CPU;
+		state.stop_timer();
+
+		terminate = true;
+		for (auto& t: thieves)
+			t.join();
+	}
+}
+
+void BM_JobQueue_Burst_Fixed(picobench::state& state) {
+	Run_JobQueue_Burst<mt::JobQueue<>>(state);
+}
+
+void BM_JobQueue_Burst_Growable(picobench::state& state) {
+	Run_JobQueue_Burst<mt::JobDeque<>>(state);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 // Main func
 ////////////////////////////////////////////////////////////////////////////////////////////////
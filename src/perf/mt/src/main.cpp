@@ -9,13 +9,19 @@ using namespace gaia;
 #define PICOBENCH_SUITE_REG(name) r.current_suite_name() = name;
 #define PICOBENCH_REG(func) (void)r.add_benchmark(#func, func)
 
+void BM_ForkJoin_Simple(picobench::state& state);
+void BM_JobQueue_Burst_Fixed(picobench::state& state);
+void BM_JobQueue_Burst_Growable(picobench::state& state);
 void BM_ScheduleParallel_Complex(picobench::state& state);
 void BM_ScheduleParallel_Simple(picobench::state& state);
 void BM_Schedule_Complex(picobench::state& state);
 void BM_Schedule_ECS_Complex(picobench::state& state);
+void BM_Schedule_ECS_Deterministic(picobench::state& state);
 void BM_Schedule_ECS_Simple(picobench::state& state);
 void BM_Schedule_Empty(picobench::state& state);
+void BM_Schedule_Frames(picobench::state& state);
 void BM_Schedule_Simple(picobench::state& state);
+void BM_Schedule_WakeLatency(picobench::state& state);
 
 int main(int argc, char* argv[]) {
 	picobench::runner r(true);
@@ -97,6 +103,37 @@ int main(int argc, char* argv[]) {
 			PICOBENCH_REG(BM_Schedule_Empty).PICO_SETTINGS().user_data(1000).label("sched, 1000");
 			PICOBENCH_REG(BM_Schedule_Empty).PICO_SETTINGS().user_data(5000).label("sched, 5000");
 			PICOBENCH_REG(BM_Schedule_Empty).PICO_SETTINGS().user_data(10000).label("sched, 10000");
+			PICOBENCH_REG(BM_Schedule_Empty).PICO_SETTINGS().user_data(100000).label("sched, 100000");
+
+			////////////////////////////////////////////////////////////////////////////////////////////////
+			// Bursts of jobs pushed by one thread while others steal them.
+			// The fixed queue keeps running out of space, the growable one never does.
+			////////////////////////////////////////////////////////////////////////////////////////////////
+			PICOBENCH_SUITE_REG("JobQueue - Burst");
+			PICOBENCH_REG(BM_JobQueue_Burst_Fixed).PICO_SETTINGS().user_data(100000).label("fixed, 100000");
+			PICOBENCH_REG(BM_JobQueue_Burst_Growable).PICO_SETTINGS().user_data(100000).label("growable, 100000");
+
+			////////////////////////////////////////////////////////////////////////////////////////////////
+			// Measures how fast idle workers react to new work. Cold runs give workers time to park first.
+			// Frames measure throughput of many tiny jobs per frame where workers keep going idle.
+			////////////////////////////////////////////////////////////////////////////////////////////////
+			PICOBENCH_SUITE_REG("Schedule - Wake");
+			constexpr uint64_t SpinBudget = 2048;
+			PICOBENCH_REG(BM_Schedule_WakeLatency).PICO_SETTINGS().user_data(0).label("latency, park");
+			PICOBENCH_REG(BM_Schedule_WakeLatency)
+					.PICO_SETTINGS()
+					.user_data(SpinBudget)
+					.label("latency, spin");
+			PICOBENCH_REG(BM_Schedule_WakeLatency).PICO_SETTINGS().user_data(1ll << 32).label("latency cold, park");
+			PICOBENCH_REG(BM_Schedule_WakeLatency)
+					.PICO_SETTINGS()
+					.user_data(SpinBudget | (1ll << 32))
+					.label("latency cold, spin");
+			PICOBENCH_REG(BM_Schedule_Frames).PICO_SETTINGS().user_data(1000).label("frames, 1000, park");
+			PICOBENCH_REG(BM_Schedule_Frames)
+					.PICO_SETTINGS()
+					.user_data(1000 | ((uint64_t)SpinBudget << 32))
+					.label("frames, 1000, spin");
 
 			////////////////////////////////////////////////////////////////////////////////////////////////
 			// Low load most likely to show scheduling overhead.
@@ -188,6 +225,24 @@ int main(int argc, char* argv[]) {
 			}
 			PICOBENCH_REG(BM_ScheduleParallel_Complex).PICO_SETTINGS().user_data(ItemsToProcess_Complex).label("sched_par");
 
+			////////////////////////////////////////////////////////////////////////////////////////////////
+			// Nested parallelism. Jobs spawn and wait for jobs recursively so job creation, submission
+			// and waiting happen mostly on worker threads. Smaller cutoffs mean more and shorter jobs.
+			////////////////////////////////////////////////////////////////////////////////////////////////
+			PICOBENCH_SUITE_REG("ForkJoin");
+			PICOBENCH_REG(BM_ForkJoin_Simple) //
+					.PICO_SETTINGS()
+					.user_data(ItemsToProcess_Simple | (65536ll << 32))
+					.label("cutoff 64K");
+			PICOBENCH_REG(BM_ForkJoin_Simple) //
+					.PICO_SETTINGS()
+					.user_data(ItemsToProcess_Simple | (4096ll << 32))
+					.label("cutoff 4K");
+			PICOBENCH_REG(BM_ForkJoin_Simple) //
+					.PICO_SETTINGS()
+					.user_data(ItemsToProcess_Simple | (256ll << 32))
+					.label("cutoff 256");
+
 			////////////////////////////////////////////////////////////////////////////////////////////////
 			// ECS
 			////////////////////////////////////////////////////////////////////////////////////////////////
@@ -208,6 +263,19 @@ int main(int argc, char* argv[]) {
 					.PICO_SETTINGS()
 					.user_data(ItemsToProcess_Complex | ((uint64_t)ecs::QueryExecType::Parallel << 32))
 					.label("complex, 1M");
+
+			////////////////////////////////////////////////////////////////////////////////////////////////
+			// Cost of deterministic parallel execution compared to the regular one.
+			////////////////////////////////////////////////////////////////////////////////////////////////
+			PICOBENCH_SUITE_REG("ECS - Deterministic");
+			PICOBENCH_REG(BM_Schedule_ECS_Deterministic) //
+					.PICO_SETTINGS()
+					.user_data(ItemsToProcess_Complex)
+					.label("default, 1M");
+			PICOBENCH_REG(BM_Schedule_ECS_Deterministic) //
+					.PICO_SETTINGS()
+					.user_data(ItemsToProcess_Complex | (1ll << 32))
+					.label("deterministic, 1M");
 		}
 	}
 
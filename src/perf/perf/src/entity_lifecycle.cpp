@@ -111,6 +111,36 @@ void BM_EntityCopyN_4Comp(picobench::state& state) {
 	}
 }
 
+//! Mass spawn of 4-component entities with cached or non-temporal column fills.
+//! \tparam Stream True to write component data with non-temporal stores
+//! \tparam Prefab True to spawn via instantiate_n, copy_n otherwise
+template <bool Stream, bool Prefab>
+void BM_EntitySpawnN_4Comp(picobench::state& state) {
+	const uint32_t n = (uint32_t)state.user_data();
+
+	for (auto _: state) {
+		(void)_;
+		state.stop_timer();
+		ecs::World w;
+		w.stream_copy_threshold(Stream ? 0 : uint32_t(-1));
+
+		auto seed = Prefab ? w.prefab() : w.add();
+		w.add<Position>(seed, {1.0f, 2.0f, 3.0f});
+		w.add<Velocity>(seed, {1.0f, 0.5f, 0.25f});
+		w.add<Acceleration>(seed, {0.0f, -0.01f, 0.0f});
+		w.add<Health>(seed, {100, 100});
+
+		state.start_timer();
+
+		if constexpr (Prefab)
+			w.instantiate_n(seed, n);
+		else
+			w.copy_n(seed, n);
+
+		state.stop_timer();
+	}
+}
+
 void BM_EntityInstantiateN_ParentedFallback_4Comp(picobench::state& state) {
 	const uint32_t n = (uint32_t)state.user_data();
 
@@ -298,6 +328,67 @@ void BM_EntityDestroy_4Comp(picobench::state& state) {
 	}
 }
 
+template <uint32_t Percent, bool Bulk>
+void BM_EntityDestroy_Archetype(picobench::state& state) {
+	const uint32_t n = (uint32_t)state.user_data();
+	constexpr uint32_t Step = 100 / Percent;
+	cnt::darray<ecs::Entity> entities;
+	cnt::darray<ecs::Entity> victims;
+
+	for (auto _: state) {
+		(void)_;
+		state.stop_timer();
+		ecs::World w;
+		auto e = w.add();
+		w.add<Position>(e, {1.0f, 2.0f, 3.0f});
+		w.add<Mass>(e, {1.0f});
+		w.add<Team>(e, {1U});
+		w.add<AIState>(e, {1U});
+		w.copy_n(e, n - 1);
+
+		entities.clear();
+		w.query().all<Position>().arr(entities);
+		victims.clear();
+		for (uint32_t i = 0; i < entities.size(); i += Step)
+			victims.push_back(entities[i]);
+		state.start_timer();
+
+		if constexpr (Bulk) {
+			w.del_n(victims);
+		} else {
+			for (auto victim: victims)
+				w.del(victim);
+		}
+		w.update();
+
+		state.stop_timer();
+	}
+}
+
+void BM_EntityDestroy_Query(picobench::state& state) {
+	const uint32_t n = (uint32_t)state.user_data();
+
+	for (auto _: state) {
+		(void)_;
+		state.stop_timer();
+		ecs::World w;
+		auto e = w.add();
+		w.add<Position>(e, {1.0f, 2.0f, 3.0f});
+		w.add<Mass>(e, {1.0f});
+		w.add<Team>(e, {1U});
+		w.add<AIState>(e, {1U});
+		w.copy_n(e, n - 1);
+		auto q = w.query().all<Position>();
+		(void)q.count();
+		state.start_timer();
+
+		w.del(q);
+		w.update();
+
+		state.stop_timer();
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void register_entity_lifecycle(PerfRunMode mode) {
@@ -341,6 +432,58 @@ void register_entity_lifecycle(PerfRunMode mode) {
 					.label("instantiate_n prefab subtree, 10K");
 			PICOBENCH_REG(BM_EntityDestroy_Empty).PICO_SETTINGS().user_data(NEntitiesMedium).label("destroy empty");
 			PICOBENCH_REG(BM_EntityDestroy_4Comp).PICO_SETTINGS().user_data(NEntitiesFew).label("destroy 4comp");
+
+			PICOBENCH_SUITE_REG("Entity bulk destroy");
+			PICOBENCH_REG((BM_EntityDestroy_Archetype<10, false>))
+					.PICO_SETTINGS_HEAVY()
+					.user_data(NEntitiesMany)
+					.label("del, 10% of 1M");
+			PICOBENCH_REG((BM_EntityDestroy_Archetype<10, true>))
+					.PICO_SETTINGS_HEAVY()
+					.user_data(NEntitiesMany)
+					.label("del_n, 10% of 1M");
+			PICOBENCH_REG((BM_EntityDestroy_Archetype<50, false>))
+					.PICO_SETTINGS_HEAVY()
+					.user_data(NEntitiesMany)
+					.label("del, 50% of 1M");
+			PICOBENCH_REG((BM_EntityDestroy_Archetype<50, true>))
+					.PICO_SETTINGS_HEAVY()
+					.user_data(NEntitiesMany)
+					.label("del_n, 50% of 1M");
+			PICOBENCH_REG((BM_EntityDestroy_Archetype<100, false>))
+					.PICO_SETTINGS_HEAVY()
+					.user_data(NEntitiesMany)
+					.label("del, 100% of 1M");
+			PICOBENCH_REG((BM_EntityDestroy_Archetype<100, true>))
+					.PICO_SETTINGS_HEAVY()
+					.user_data(NEntitiesMany)
+					.label("del_n, 100% of 1M");
+			PICOBENCH_REG(BM_EntityDestroy_Query).PICO_SETTINGS_HEAVY().user_data(NEntitiesMany).label("del query, 1M");
+
+			PICOBENCH_SUITE_REG("Entity spawn");
+			PICOBENCH_REG((BM_EntitySpawnN_4Comp<false, false>)).PICO_SETTINGS().user_data(NEntitiesFew).label("copy_n, 10K");
+			PICOBENCH_REG((BM_EntitySpawnN_4Comp<true, false>))
+					.PICO_SETTINGS()
+					.user_data(NEntitiesFew)
+					.label("copy_n streamed, 10K");
+			PICOBENCH_REG((BM_EntitySpawnN_4Comp<false, false>)).PICO_SETTINGS().user_data(NEntitiesMedium).label("copy_n, 100K");
+			PICOBENCH_REG((BM_EntitySpawnN_4Comp<true, false>))
+					.PICO_SETTINGS()
+					.user_data(NEntitiesMedium)
+					.label("copy_n streamed, 100K");
+			PICOBENCH_REG((BM_EntitySpawnN_4Comp<false, false>)).PICO_SETTINGS_HEAVY().user_data(NEntitiesMany).label("copy_n, 1M");
+			PICOBENCH_REG((BM_EntitySpawnN_4Comp<true, false>))
+					.PICO_SETTINGS_HEAVY()
+					.user_data(NEntitiesMany)
+					.label("copy_n streamed, 1M");
+			PICOBENCH_REG((BM_EntitySpawnN_4Comp<false, true>))
+					.PICO_SETTINGS_HEAVY()
+					.user_data(NEntitiesMany)
+					.label("instantiate_n, 1M");
+			PICOBENCH_REG((BM_EntitySpawnN_4Comp<true, true>))
+					.PICO_SETTINGS_HEAVY()
+					.user_data(NEntitiesMany)
+					.label("instantiate_n streamed, 1M");
 			return;
 		case PerfRunMode::Profiling:
 		default:
@@ -43,12 +43,14 @@ int main(int argc, char* argv[]) {
 	register_systems(mode);
 	register_mixed(mode);
 	register_parent(mode);
+	register_prefab(mode);
 	register_sparse(mode);
 	register_legacy_entity(mode);
 	register_legacy_iter(mode);
 	register_containers(mode);
 	register_allocators(mode);
 	register_funcs(mode);
+	register_serialization(mode);
 
 	picobench::runner r;
 	r.parse_cmd_line((int)picobenchArgs.size(), picobenchArgs.data());
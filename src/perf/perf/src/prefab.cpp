@@ -0,0 +1,141 @@
+#include "common.h"
+#include "registry.h"
+
+//! Builds a vehicle-like prefab tree: a chassis, 4 wheel assemblies and a turret, 40 nodes in total.
+//! \tparam UseChildOf True to link the nodes via the fragmenting ChildOf relation, Parent otherwise
+//! \return Root prefab of the tree
+template <bool UseChildOf>
+ecs::Entity make_vehicle_prefab(ecs::World& w) {
+	auto link = [&](ecs::Entity child, ecs::Entity parent) {
+		if constexpr (UseChildOf)
+			w.child(child, parent);
+		else
+			w.parent(child, parent);
+	};
+	auto node = [&](ecs::Entity parent, float x) {
+		const auto e = w.prefab();
+		w.add<Position>(e, {x, 0.0f, 0.0f});
+		w.add<Mass>(e, {1.0f});
+		if (parent != ecs::EntityBad)
+			link(e, parent);
+		return e;
+	};
+
+	const auto chassis = node(ecs::EntityBad, 0.0f);
+	w.add<Velocity>(chassis, {1.0f, 0.0f, 0.0f});
+	w.add<Health>(chassis, {100, 100});
+	uint32_t nodes = 1;
+
+	// 4 wheels, each with a hub, a tire and 4 bolts
+	GAIA_FOR(4) {
+		const auto wheel = node(chassis, (float)i);
+		const auto hub = node(wheel, 0.5f);
+		(void)node(wheel, 1.0f);
+		GAIA_FOR_(4, j)(void) node(hub, (float)j);
+		nodes += 7;
+	}
+
+	// Turret with a barrel chain
+	auto turret = node(chassis, 2.0f);
+	w.add<Team>(turret, {1});
+	++nodes;
+	while (nodes < 40) {
+		turret = node(turret, (float)nodes);
+		++nodes;
+	}
+
+	return chassis;
+}
+
+template <bool UseChildOf>
+void BM_PrefabInstantiateN_Vehicle(picobench::state& state) {
+	const uint32_t n = (uint32_t)state.user_data();
+
+	for (auto _: state) {
+		(void)_;
+		state.stop_timer();
+		ecs::World w;
+		const auto vehicle = make_vehicle_prefab<UseChildOf>(w);
+		state.start_timer();
+
+		w.instantiate_n(vehicle, n);
+
+		state.stop_timer();
+	}
+}
+
+template <bool UseChildOf>
+void BM_PrefabInstantiateN_Vehicle_Waves(picobench::state& state) {
+	const uint32_t n = (uint32_t)state.user_data();
+	constexpr uint32_t Waves = 50;
+
+	for (auto _: state) {
+		(void)_;
+		state.stop_timer();
+		ecs::World w;
+		const auto vehicle = make_vehicle_prefab<UseChildOf>(w);
+		state.start_timer();
+
+		GAIA_FOR(Waves) w.instantiate_n(vehicle, n / Waves);
+
+		state.stop_timer();
+	}
+}
+
+void BM_PrefabInstantiateN_Vehicle_Parented(picobench::state& state) {
+	const uint32_t n = (uint32_t)state.user_data();
+
+	for (auto _: state) {
+		(void)_;
+		state.stop_timer();
+		ecs::World w;
+		const auto vehicle = make_vehicle_prefab<false>(w);
+		const auto scene = w.add();
+		state.start_timer();
+
+		w.instantiate_n(vehicle, scene, n);
+
+		state.stop_timer();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void register_prefab(PerfRunMode mode) {
+	switch (mode) {
+		case PerfRunMode::Sanitizer:
+			PICOBENCH_SUITE_REG("Sanitizer picks");
+			PICOBENCH_REG(BM_PrefabInstantiateN_Vehicle<false>).PICO_SETTINGS_SANI().user_data(100).label("vehicle");
+			return;
+		case PerfRunMode::Normal:
+			PICOBENCH_SUITE_REG("Prefab instantiate");
+			PICOBENCH_REG(BM_PrefabInstantiateN_Vehicle<false>)
+					.PICO_SETTINGS()
+					.user_data(2000)
+					.label("vehicle 40 nodes Parent, 2K");
+			PICOBENCH_REG(BM_PrefabInstantiateN_Vehicle<false>)
+					.PICO_SETTINGS_OBS()
+					.user_data(20'000)
+					.label("vehicle 40 nodes Parent, 20K");
+			PICOBENCH_REG(BM_PrefabInstantiateN_Vehicle_Parented)
+					.PICO_SETTINGS()
+					.user_data(2000)
+					.label("vehicle 40 nodes parented, 2K");
+			PICOBENCH_REG(BM_PrefabInstantiateN_Vehicle_Waves<false>)
+					.PICO_SETTINGS()
+					.user_data(2000)
+					.label("vehicle 40 nodes Parent, 50 waves of 40");
+			PICOBENCH_REG(BM_PrefabInstantiateN_Vehicle<true>)
+					.PICO_SETTINGS_OBS()
+					.user_data(500)
+					.label("vehicle 40 nodes ChildOf, 500");
+			PICOBENCH_REG(BM_PrefabInstantiateN_Vehicle_Waves<true>)
+					.PICO_SETTINGS_OBS()
+					.user_data(500)
+					.label("vehicle 40 nodes ChildOf, 50 waves of 10");
+			return;
+		case PerfRunMode::Profiling:
+		default:
+			return;
+	}
+}
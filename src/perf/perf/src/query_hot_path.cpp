@@ -2083,6 +2083,70 @@ void BM_QueryMatch_Variable_2VarPairAll_Unbound(picobench::state& state) {
 	BM_QueryMatch_Variable_2VarPairAll<false>(state);
 }
 
+template <uint32_t DeviceCnt>
+void BM_QueryMatch_Variable_Skewed(picobench::state& state) {
+	const uint32_t archetypeCnt = (uint32_t)state.user_data();
+	constexpr uint32_t EndpointCnt = 16;
+	constexpr uint32_t PowerCnt = 4;
+
+	ecs::World w;
+
+	const auto relConnected = w.add();
+	const auto relPowered = w.add();
+
+	cnt::sarray<ecs::Entity, EndpointCnt> endpoints{};
+	GAIA_FOR(EndpointCnt) {
+		endpoints[i] = w.add();
+	}
+	cnt::sarray<ecs::Entity, PowerCnt> powers{};
+	GAIA_FOR(PowerCnt) {
+		powers[i] = w.add();
+	}
+
+	// One device endpoint. Any other devices live elsewhere in the world.
+	w.add<SourceType0>(endpoints[0]);
+	for (uint32_t i = 1; i < DeviceCnt; ++i)
+		w.add<SourceType0>(w.add());
+
+	// Skewed fan-out: a quarter of the archetypes connect to every endpoint, the rest to ever fewer.
+	// Only every other archetype reaches the device endpoint.
+	GAIA_FOR(archetypeCnt) {
+		auto e = w.add();
+		add_var_match_tags(w, e, i);
+
+		const uint32_t fanOut = EndpointCnt >> (i % 4);
+		const uint32_t first = (i / 4) % 2;
+		GAIA_FOR_(fanOut, j) {
+			if (first + j < EndpointCnt)
+				w.add(e, ecs::Pair(relConnected, endpoints[first + j]));
+		}
+		w.add(e, ecs::Pair(relPowered, powers[i % PowerCnt]));
+	}
+
+	auto q = w.query()
+							 .all(ecs::Pair(relConnected, ecs::Var0))
+							 .all(ecs::Pair(relPowered, ecs::Var1))
+							 .template all<SourceType0>(ecs::QueryTermOptions{}.src(ecs::Var0));
+
+	auto& qi = q.fetch();
+	q.match_all(qi);
+	dont_optimize(qi.cache_archetype_view().size());
+
+	for (auto _: state) {
+		(void)_;
+		q.match_all(qi);
+		dont_optimize(qi.cache_archetype_view().size());
+	}
+}
+
+void BM_QueryMatch_Variable_Skewed_FewDevices(picobench::state& state) {
+	BM_QueryMatch_Variable_Skewed<1>(state);
+}
+
+void BM_QueryMatch_Variable_Skewed_ManyDevices(picobench::state& state) {
+	BM_QueryMatch_Variable_Skewed<4096>(state);
+}
+
 template <bool BoundVars>
 void BM_QueryMatch_Variable_AllOnly(picobench::state& state) {
 	const uint32_t archetypeCnt = (uint32_t)state.user_data();
@@ -3010,6 +3074,286 @@ void BM_QueryCompile_Variable_GenericSourceBacktrack_Recompile(picobench::state&
 	BM_QueryCompile_Variable_Recompile<VariableBuildFixture_GenericSourceBacktrack>(state);
 }
 
+//! Number of clients each querying their own area of interest every frame
+static constexpr uint32_t SpatialClientCnt = 500U;
+//! Size of the square world entities are spread over
+static constexpr float SpatialWorldSize = 8192.0f;
+//! Half-size of the area of interest of a client
+static constexpr float SpatialAreaRadius = 128.0f;
+
+struct Replicated {};
+
+//! Spreads \a n entities uniformly over the world. Every other one is replicated.
+static void create_spatial_world(ecs::World& w, uint32_t n) {
+	uint32_t seed = 0x12345678U;
+	auto rnd = [&]() {
+		seed = seed * 1664525U + 1013904223U;
+		return (float)(seed >> 8) * (SpatialWorldSize / (float)(1U << 24));
+	};
+
+	GAIA_FOR(n) {
+		auto e = w.add();
+		w.add<Position>(e, {rnd(), rnd(), 0.0f});
+		if ((i & 1U) != 0U)
+			w.add<Replicated>(e);
+	}
+}
+
+//! Returns the area of interest of client \a idx. Clients are spread evenly over the world.
+static ecs::SpatialBox spatial_client_area(uint32_t idx) {
+	const float step = SpatialWorldSize / 23.0f;
+	const float x = step * (float)(idx % 23U) + step * 0.5f;
+	const float y = step * (float)((idx / 23U) % 23U) + step * 0.5f;
+	return {{x - SpatialAreaRadius, y - SpatialAreaRadius, -1.0f}, {x + SpatialAreaRadius, y + SpatialAreaRadius, 1.0f}};
+}
+
+//! Moves every entity a bit so each chunk has its positions changed.
+static void spatial_move(ecs::Query& q, uint32_t frame) {
+	const float d = (frame & 1U) != 0U ? 1.0f : -1.0f;
+	q.each([d](Position& p) {
+		p.x += d;
+		p.y += d;
+	});
+}
+
+template <bool Moving>
+void BM_Spatial_FullScan(picobench::state& state) {
+	const uint32_t n = (uint32_t)state.user_data();
+	ecs::World w;
+	create_spatial_world(w, n);
+
+	auto q = w.query().all<Position>().all<Replicated>();
+	auto qMove = w.query().all<Position&>();
+	dont_optimize(q.count());
+
+	uint32_t frame = 0;
+	for (auto _: state) {
+		(void)_;
+		if constexpr (Moving)
+			spatial_move(qMove, frame++);
+
+		uint32_t cnt = 0;
+		GAIA_FOR_(SpatialClientCnt, c) {
+			const auto box = spatial_client_area(c);
+			q.each([&](const Position& p) {
+				if (p.x >= box.min[0] && p.x <= box.max[0] && p.y >= box.min[1] && p.y <= box.max[1])
+					++cnt;
+			});
+		}
+		dont_optimize(cnt);
+	}
+}
+
+template <bool Moving>
+void BM_Spatial_Index(picobench::state& state) {
+	const uint32_t n = (uint32_t)state.user_data();
+	ecs::World w;
+	create_spatial_world(w, n);
+
+	auto q = w.query().all<Position>().all<Replicated>();
+	auto qMove = w.query().all<Position&>();
+	auto& index = w.spatial_index<Position>(SpatialAreaRadius);
+	dont_optimize(q.count());
+	index.update();
+
+	uint32_t frame = 0;
+	for (auto _: state) {
+		(void)_;
+		if constexpr (Moving)
+			spatial_move(qMove, frame++);
+
+		uint32_t cnt = 0;
+		GAIA_FOR_(SpatialClientCnt, c) {
+			index.each(q, spatial_client_area(c), [&](ecs::Iter& it) {
+				cnt += it.size();
+			});
+		}
+		dont_optimize(cnt);
+	}
+}
+
+//! Number of entities value lookups run over
+static constexpr uint32_t ValueLookupEntityCnt = 5'000'000U;
+//! Number of lookups per frame
+static constexpr uint32_t ValueLookupCnt = 16U;
+//! Number of distinct teams. Each lookup hits 0.1% of entities.
+static constexpr uint32_t ValueLookupTeamCnt = 1000U;
+
+struct IndexedTeam {
+	uint32_t id;
+	float health;
+};
+
+//! Creates \a n entities with random teams and health in [0, ValueLookupTeamCnt).
+static void create_value_world(ecs::World& w, uint32_t n) {
+	uint32_t seed = 0x12345678U;
+	auto rnd = [&]() {
+		seed = seed * 1664525U + 1013904223U;
+		return seed >> 8;
+	};
+
+	GAIA_FOR(n) {
+		auto e = w.add();
+		const auto id = rnd() % ValueLookupTeamCnt;
+		const auto health = (float)rnd() * ((float)ValueLookupTeamCnt / (float)(1U << 24));
+		w.add<IndexedTeam>(e, {id, health});
+	}
+}
+
+void BM_ValueLookup_FullScan(picobench::state& state) {
+	ecs::World w;
+	create_value_world(w, ValueLookupEntityCnt);
+
+	auto q = w.query().all<IndexedTeam>();
+	dont_optimize(q.count());
+
+	for (auto _: state) {
+		(void)_;
+
+		uint32_t cnt = 0;
+		GAIA_FOR_(ValueLookupCnt, l) {
+			const auto id = l * 61U;
+			q.each([&](const IndexedTeam& t) {
+				if (t.id == id)
+					++cnt;
+			});
+		}
+		dont_optimize(cnt);
+	}
+}
+
+template <ecs::ValueIndexKind Kind>
+void BM_ValueLookup_Index(picobench::state& state) {
+	ecs::World w;
+	create_value_world(w, ValueLookupEntityCnt);
+
+	auto q = w.query().all<IndexedTeam>();
+	auto& index = Kind == ecs::ValueIndexKind::Hash ? w.value_index(&IndexedTeam::id, Kind)
+																									: w.value_index(&IndexedTeam::health, Kind);
+	dont_optimize(index.count(ecs::eq(0)));
+
+	for (auto _: state) {
+		(void)_;
+
+		uint32_t cnt = 0;
+		GAIA_FOR_(ValueLookupCnt, l) {
+			// Equality on the team or a health range of the same selectivity
+			const auto id = l * 61U;
+			const auto cond = Kind == ecs::ValueIndexKind::Hash ? ecs::eq(id) : ecs::between((float)id, (float)id + 1.0f);
+			index.each(q, cond, [&](ecs::Iter& it) {
+				cnt += it.size();
+			});
+		}
+		dont_optimize(cnt);
+	}
+}
+
+//! Sorted index lookups with 0.1% of entities changing their value every frame.
+void BM_ValueLookup_Index_Writes(picobench::state& state) {
+	ecs::World w;
+	create_value_world(w, ValueLookupEntityCnt);
+
+	cnt::darray<ecs::Entity> ents;
+	auto q = w.query().all<IndexedTeam>();
+	q.arr(ents);
+	auto& index = w.value_index(&IndexedTeam::health, ecs::ValueIndexKind::Sorted);
+	dont_optimize(index.count(ecs::eq(0)));
+
+	uint32_t frame = 0;
+	for (auto _: state) {
+		(void)_;
+
+		const auto writeCnt = ValueLookupEntityCnt / ValueLookupTeamCnt;
+		GAIA_FOR(writeCnt) {
+			const auto e = ents[(i * 997U + frame * 7919U) % ents.size()];
+			auto t = w.get<IndexedTeam>(e);
+			t.health = (float)((i + frame) % ValueLookupTeamCnt);
+			w.set<IndexedTeam>(e) = t;
+		}
+		++frame;
+
+		uint32_t cnt = 0;
+		GAIA_FOR_(ValueLookupCnt, l) {
+			const auto h = (float)(l * 61U);
+			index.each(q, ecs::between(h, h + 1.0f), [&](ecs::Iter& it) {
+				cnt += it.size();
+			});
+		}
+		dont_optimize(cnt);
+	}
+}
+
+//! Number of queries built from scratch per frame by the cold build benchmarks
+static constexpr uint32_t ColdBuildQueryCnt = 2000U;
+//! Number of tags the archetypes of the cold build benchmarks are made of
+static constexpr uint32_t ColdBuildTagCnt = 24U;
+
+//! Creates \a archetypeCnt archetypes, each with Position and a distinct combination of tags.
+static void create_cold_build_world(ecs::World& w, cnt::darray<ecs::Entity>& tags, uint32_t archetypeCnt) {
+	tags.resize(ColdBuildTagCnt);
+	GAIA_FOR(ColdBuildTagCnt) {
+		tags[i] = w.add();
+	}
+
+	GAIA_FOR(archetypeCnt) {
+		auto e = w.add();
+		auto eb = w.build(e);
+		eb.add<Position>();
+		// The tag combination is the binary representation of the archetype index
+		GAIA_FOR_(ColdBuildTagCnt, j) {
+			if (((i + 1) & (1U << j)) != 0)
+				eb.add(tags[j]);
+		}
+		eb.commit();
+	}
+}
+
+//! Benchmarks matching ColdBuildQueryCnt freshly registered queries, as happens after gameplay code is reloaded.
+//! \tparam Build Matches the queries via World::build_queries if true. One by one via match_all otherwise.
+template <bool Build>
+void BM_Query_ColdBuild(picobench::state& state) {
+	ecs::World w;
+	cnt::darray<ecs::Entity> tags;
+	create_cold_build_world(w, tags, (uint32_t)state.user_data());
+
+	cnt::darray<ecs::Query> queries;
+	queries.reserve(ColdBuildQueryCnt);
+
+	for (auto _: state) {
+		(void)_;
+
+		GAIA_FOR(ColdBuildQueryCnt) {
+			const auto a = tags[i % ColdBuildTagCnt];
+			const auto b = tags[(i / ColdBuildTagCnt + i + 1) % ColdBuildTagCnt];
+			auto q = w.query().all<Position>();
+			if (i % 3 == 0)
+				q.or_(a).or_(b);
+			else
+				q.all(a).no(b);
+			queries.push_back(q);
+		}
+
+		if constexpr (Build) {
+			for (auto& q: queries)
+				(void)q.fetch();
+			w.build_queries();
+		} else {
+			for (auto& q: queries)
+				q.match_all(q.fetch());
+		}
+
+		uint32_t cnt = 0;
+		for (auto& q: queries)
+			cnt += (uint32_t)q.fetch().cache_archetype_view().size();
+		dont_optimize(cnt);
+
+		state.stop_timer();
+		queries.clear();
+		state.start_timer();
+	}
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void BM_EntityBuilder_BatchAdd_4(picobench::state& state);
@@ -3518,6 +3862,14 @@ void register_query_hot_path(PerfRunMode mode) {
 					.PICO_SETTINGS_HEAVY()
 					.user_data(128)
 					.label("match 2var pair-all (unbound)");
+			PICOBENCH_REG(BM_QueryMatch_Variable_Skewed_FewDevices)
+					.PICO_SETTINGS_HEAVY()
+					.user_data(128)
+					.label("match 2var skewed fan-out, 1 device");
+			PICOBENCH_REG(BM_QueryMatch_Variable_Skewed_ManyDevices)
+					.PICO_SETTINGS_HEAVY()
+					.user_data(128)
+					.label("match 2var skewed fan-out, 4K devices");
 			PICOBENCH_REG(BM_QueryMatch_Variable_AllOnly_Bound)
 					.PICO_SETTINGS_HEAVY()
 					.user_data(128)
@@ -3599,6 +3951,65 @@ void register_query_hot_path(PerfRunMode mode) {
 					.user_data(128)
 					.label("match 1var pair-mixed (unbound)");
 
+			PICOBENCH_SUITE_REG("Spatial queries");
+			PICOBENCH_REG(BM_Spatial_FullScan<false>)
+					.iterations({2})
+					.samples(1)
+					.user_data(NEntitiesMany)
+					.label("500 full scans 1M");
+			PICOBENCH_REG(BM_Spatial_Index<false>).PICO_SETTINGS_HEAVY().user_data(NEntitiesMany).label("500 regions 1M");
+			PICOBENCH_REG(BM_Spatial_FullScan<true>)
+					.iterations({2})
+					.samples(1)
+					.user_data(NEntitiesMany)
+					.label("500 full scans 1M, moving");
+			PICOBENCH_REG(BM_Spatial_Index<true>)
+					.PICO_SETTINGS_HEAVY()
+					.user_data(NEntitiesMany)
+					.label("500 regions 1M, moving");
+
+			PICOBENCH_SUITE_REG("Value lookups");
+			PICOBENCH_REG(BM_ValueLookup_FullScan).iterations({2}).samples(1).label("16 full scans 5M");
+			PICOBENCH_REG(BM_ValueLookup_Index<ecs::ValueIndexKind::Hash>)
+					.PICO_SETTINGS_HEAVY()
+					.label("16 hash eq 5M");
+			PICOBENCH_REG(BM_ValueLookup_Index<ecs::ValueIndexKind::Sorted>)
+					.PICO_SETTINGS_HEAVY()
+					.label("16 sorted ranges 5M");
+			PICOBENCH_REG(BM_ValueLookup_Index_Writes).PICO_SETTINGS_HEAVY().label("16 sorted ranges 5M, 5k writes");
+
+			PICOBENCH_SUITE_REG("Query cold build");
+			PICOBENCH_REG(BM_Query_ColdBuild<false>)
+					.iterations({4})
+					.samples(1)
+					.user_data(1000)
+					.label("2K queries 1K arch, serial");
+			PICOBENCH_REG(BM_Query_ColdBuild<true>)
+					.iterations({4})
+					.samples(1)
+					.user_data(1000)
+					.label("2K queries 1K arch, build");
+			PICOBENCH_REG(BM_Query_ColdBuild<false>)
+					.iterations({4})
+					.samples(1)
+					.user_data(4000)
+					.label("2K queries 4K arch, serial");
+			PICOBENCH_REG(BM_Query_ColdBuild<true>)
+					.iterations({4})
+					.samples(1)
+					.user_data(4000)
+					.label("2K queries 4K arch, build");
+			PICOBENCH_REG(BM_Query_ColdBuild<false>)
+					.iterations({4})
+					.samples(1)
+					.user_data(16000)
+					.label("2K queries 16K arch, serial");
+			PICOBENCH_REG(BM_Query_ColdBuild<true>)
+					.iterations({4})
+					.samples(1)
+					.user_data(16000)
+					.label("2K queries 16K arch, build");
+
 			PICOBENCH_SUITE_REG("Query variable focus");
 			PICOBENCH_REG(BM_QueryMatch_Variable_1VarMixed_Bound)
 					.PICO_SETTINGS_FOCUS()
@@ -15,9 +15,11 @@ void register_observers(PerfRunMode mode);
 void register_systems(PerfRunMode mode);
 void register_mixed(PerfRunMode mode);
 void register_parent(PerfRunMode mode);
+void register_prefab(PerfRunMode mode);
 void register_sparse(PerfRunMode mode);
 void register_legacy_entity(PerfRunMode mode);
 void register_legacy_iter(PerfRunMode mode);
 void register_containers(PerfRunMode mode);
 void register_allocators(PerfRunMode mode);
 void register_funcs(PerfRunMode mode);
+void register_serialization(PerfRunMode mode);
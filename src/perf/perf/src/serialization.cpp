@@ -0,0 +1,474 @@
+#include "common.h"
+#include "registry.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Serialization helpers
+////////////////////////////////////////////////////////////////////////////////
+
+//! Sink discarding everything. Measures the cost of producing the stream without any I/O.
+struct NullSink {
+	uint64_t bytes = 0;
+	uint32_t calls = 0;
+};
+
+//! Source replaying an in-memory snapshot through the streaming reader.
+struct MemSource {
+	const uint8_t* pData = nullptr;
+	uint32_t left = 0;
+};
+
+inline ser::stream_sink make_null_sink(NullSink& sink) {
+	return {&sink, [](void* user, const ser::stream_block* pBlocks, uint32_t blockCnt) {
+						auto& dst = *(NullSink*)user;
+						++dst.calls;
+						GAIA_FOR(blockCnt) dst.bytes += pBlocks[i].size;
+						return true;
+					}};
+}
+
+inline ser::stream_source make_mem_source(MemSource& source) {
+	return {&source, [](void* user, void* pDst, uint32_t size) {
+						auto& src = *(MemSource*)user;
+						size = core::get_min(size, src.left);
+						memcpy(pDst, src.pData, size);
+						src.pData += size;
+						src.left -= size;
+						return size;
+					}};
+}
+
+inline void init_serialization_components(ecs::World& w) {
+	(void)w.add<Position>();
+	(void)w.add<Velocity>();
+	(void)w.add<Health>();
+}
+
+inline void create_serialization_world(ecs::World& w, uint32_t n) {
+	init_serialization_components(w);
+
+	auto e = w.add();
+	w.add<Position>(e, {1.0f, 2.0f, 3.0f});
+	w.add<Velocity>(e, {1.0f, 0.5f, 0.25f});
+	w.add<Health>(e, {100, 100});
+	if (n > 1)
+		w.copy_n(e, n - 1);
+}
+
+//! Saves a world with slowly changing values which is what typical simulation data looks like.
+inline void create_packing_snapshot(ser::bin_stream& buffer, uint32_t n) {
+	ecs::World w;
+	create_serialization_world(w, n);
+
+	uint32_t idx = 0;
+	w.query().all<Position&>().all<Velocity&>().each([&](Position& p, Velocity& v) {
+		const auto f = (float)idx++;
+		p = {f * 0.5f, 10.0f, f * 0.25f};
+		v = {1.0f, 0.0f, (float)(idx % 16)};
+	});
+
+	w.set_serializer(buffer);
+	w.save();
+	w.set_serializer(nullptr);
+}
+
+//! Forwards independent block tasks to the job system.
+struct PackParallelExecutor {
+	template <typename Func>
+	void operator()(uint32_t cnt, Func&& func) const {
+		auto& tp = mt::ThreadPool::get();
+
+		mt::JobParallel job;
+		job.func = [&func](const mt::JobArgs& args) {
+			GAIA_FOR2(args.idxStart, args.idxEnd) func(i);
+		};
+		auto handle = tp.sched_par(GAIA_MOV(job), cnt, 1);
+		tp.wait(handle);
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Save
+////////////////////////////////////////////////////////////////////////////////
+
+void BM_WorldSave_Buffer(picobench::state& state) {
+	const uint32_t n = (uint32_t)state.user_data();
+
+	ecs::World w;
+	create_serialization_world(w, n);
+
+	for (auto _: state) {
+		(void)_;
+		state.stop_timer();
+		ser::bin_stream buffer;
+		w.set_serializer(buffer);
+		state.start_timer();
+
+		w.save();
+
+		state.stop_timer();
+		w.set_serializer(nullptr);
+	}
+}
+
+void BM_WorldSave_Streamed(picobench::state& state) {
+	const uint32_t n = (uint32_t)state.user_data();
+
+	ecs::World w;
+	create_serialization_world(w, n);
+
+	for (auto _: state) {
+		(void)_;
+		state.stop_timer();
+		NullSink sink;
+		ser::bin_stream_writer writer(make_null_sink(sink));
+		w.set_serializer(writer);
+		state.start_timer();
+
+		w.save();
+		(void)writer.flush();
+
+		state.stop_timer();
+		w.set_serializer(nullptr);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Load
+////////////////////////////////////////////////////////////////////////////////
+
+void BM_WorldLoad_Buffer(picobench::state& state) {
+	const uint32_t n = (uint32_t)state.user_data();
+
+	ecs::World src;
+	create_serialization_world(src, n);
+	ser::bin_stream buffer;
+	src.set_serializer(buffer);
+	src.save();
+
+	for (auto _: state) {
+		(void)_;
+		state.stop_timer();
+		ecs::World w;
+		init_serialization_components(w);
+		state.start_timer();
+
+		(void)w.load(buffer);
+
+		state.stop_timer();
+	}
+}
+
+void BM_WorldLoad_Streamed(picobench::state& state) {
+	const uint32_t n = (uint32_t)state.user_data();
+
+	ecs::World src;
+	create_serialization_world(src, n);
+	ser::bin_stream buffer;
+	src.set_serializer(buffer);
+	src.save();
+
+	for (auto _: state) {
+		(void)_;
+		state.stop_timer();
+		ecs::World w;
+		init_serialization_components(w);
+		MemSource source{(const uint8_t*)buffer.data(), buffer.bytes()};
+		ser::bin_stream_reader reader(make_mem_source(source));
+		state.start_timer();
+
+		(void)w.load(reader);
+
+		state.stop_timer();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Packed snapshots
+////////////////////////////////////////////////////////////////////////////////
+
+template <ser::pack_filter Filter>
+void BM_WorldPack(picobench::state& state) {
+	const uint32_t n = (uint32_t)state.user_data();
+
+	ser::bin_stream buffer;
+	create_packing_snapshot(buffer, n);
+
+	cnt::darray<uint8_t> packed;
+	ser::pack_opts opts;
+	opts.filter = Filter;
+
+	for (auto _: state) {
+		(void)_;
+		state.stop_timer();
+		packed.clear();
+		state.start_timer();
+
+		ser::pack_snapshot(buffer, packed, opts);
+
+		state.stop_timer();
+	}
+
+	const double ratio = (double)buffer.bytes() / (double)packed.size();
+	GAIA_LOG_N(
+			"pack filter %u: %u -> %u bytes, ratio %.2f", (uint32_t)Filter, buffer.bytes(), (uint32_t)packed.size(), ratio);
+}
+
+template <bool Parallel>
+void BM_WorldUnpack(picobench::state& state) {
+	const uint32_t n = (uint32_t)state.user_data();
+
+	ser::bin_stream buffer;
+	create_packing_snapshot(buffer, n);
+
+	cnt::darray<uint8_t> packed;
+	ser::pack_snapshot(buffer, packed);
+
+	for (auto _: state) {
+		(void)_;
+		state.stop_timer();
+		ser::bin_stream unpacked;
+		state.start_timer();
+
+		bool ok = false;
+		if constexpr (Parallel)
+			ok = ser::unpack_snapshot(packed.data(), (uint32_t)packed.size(), unpacked, PackParallelExecutor{});
+		else
+			ok = ser::unpack_snapshot(packed.data(), (uint32_t)packed.size(), unpacked);
+
+		state.stop_timer();
+		GAIA_ASSERT(ok);
+		(void)ok;
+	}
+}
+
+template <bool Parallel>
+void BM_WorldLoad_Packed(picobench::state& state) {
+	const uint32_t n = (uint32_t)state.user_data();
+
+	ser::bin_stream buffer;
+	create_packing_snapshot(buffer, n);
+
+	cnt::darray<uint8_t> packed;
+	ser::pack_snapshot(buffer, packed);
+
+	for (auto _: state) {
+		(void)_;
+		state.stop_timer();
+		ecs::World w;
+		init_serialization_components(w);
+		ser::bin_stream unpacked;
+		state.start_timer();
+
+		if constexpr (Parallel)
+			(void)ser::unpack_snapshot(packed.data(), (uint32_t)packed.size(), unpacked, PackParallelExecutor{});
+		else
+			(void)ser::unpack_snapshot(packed.data(), (uint32_t)packed.size(), unpacked);
+		(void)w.load(unpacked);
+
+		state.stop_timer();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// State hash
+////////////////////////////////////////////////////////////////////////////////
+
+//! Baseline: hashing a full snapshot of the world.
+void BM_WorldHash_Save(picobench::state& state) {
+	const uint32_t n = (uint32_t)state.user_data();
+
+	ecs::World w;
+	create_serialization_world(w, n);
+
+	ser::bin_stream buffer;
+	w.set_serializer(buffer);
+	for (auto _: state) {
+		(void)_;
+		w.save();
+		const auto hash = core::hash_data64(buffer.data(), buffer.bytes());
+		gaia::dont_optimize(hash);
+	}
+	w.set_serializer(nullptr);
+}
+
+//! Hashes the world after writing to \a ChangedPct percent of its chunks.
+template <uint32_t ChangedPct>
+void BM_WorldHash_State(picobench::state& state) {
+	const uint32_t n = (uint32_t)state.user_data();
+
+	ecs::World w;
+	create_serialization_world(w, n);
+	(void)w.hash_state();
+
+	auto q = w.query().all<Position&>();
+	uint32_t frame = 0;
+	for (auto _: state) {
+		(void)_;
+		state.stop_timer();
+		uint32_t chunkIdx = 0;
+		q.each([&](ecs::Iter& it) {
+			if ((chunkIdx++ + frame) % 100 >= ChangedPct)
+				return;
+			auto p = it.view_mut<Position>();
+			p[0].x += 1.0f;
+		});
+		++frame;
+		state.start_timer();
+
+		const auto hash = w.hash_state();
+		gaia::dont_optimize(hash);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Rollback
+////////////////////////////////////////////////////////////////////////////////
+
+static constexpr uint32_t RollbackFrames = 8;
+
+//! Moves entities in \a MovingPct percent of the chunks by their velocity.
+template <uint32_t MovingPct>
+void rollback_move(ecs::Query& q, uint32_t frame) {
+	uint32_t chunkIdx = 0;
+	q.each([&](ecs::Iter& it) {
+		if ((chunkIdx++ + frame) % 100 >= MovingPct)
+			return;
+		auto p = it.view_mut<Position>();
+		auto v = it.view<Velocity>();
+		GAIA_EACH(it) {
+			p[i].x += v[i].x;
+			p[i].y += v[i].y;
+			p[i].z += v[i].z;
+		}
+	});
+}
+
+//! Baseline: every frame is saved and the oldest one is loaded back into a new world.
+void BM_Rollback_SaveLoad(picobench::state& state) {
+	const uint32_t n = (uint32_t)state.user_data();
+
+	ecs::World w;
+	create_serialization_world(w, n);
+	auto q = w.query().all<Position&>().all<Velocity>();
+
+	ser::bin_stream buffers[RollbackFrames];
+	uint32_t frame = 0;
+	for (auto _: state) {
+		(void)_;
+		GAIA_FOR(RollbackFrames) {
+			state.stop_timer();
+			rollback_move<100>(q, frame++);
+			buffers[i].reset();
+			w.set_serializer(buffers[i]);
+			state.start_timer();
+
+			w.save();
+		}
+
+		state.stop_timer();
+		w.set_serializer(nullptr);
+		ecs::World w2;
+		init_serialization_components(w2);
+		state.start_timer();
+
+		(void)w2.load(buffers[0]);
+	}
+}
+
+//! Every frame is captured by a snapshot ring and the world is rolled back 8 frames.
+template <uint32_t MovingPct>
+void BM_Rollback_Snapshot(picobench::state& state) {
+	const uint32_t n = (uint32_t)state.user_data();
+
+	ecs::World w;
+	create_serialization_world(w, n);
+	auto q = w.query().all<Position&>().all<Velocity>();
+
+	ecs::SnapshotRing ring(w, RollbackFrames);
+	uint32_t frame = 0;
+	ring.capture(frame);
+	for (auto _: state) {
+		(void)_;
+		const auto first = frame;
+		GAIA_FOR(RollbackFrames) {
+			state.stop_timer();
+			rollback_move<MovingPct>(q, ++frame);
+			state.start_timer();
+
+			ring.capture(frame);
+		}
+
+		const bool ok = ring.restore(first + 1);
+		gaia::dont_optimize(ok);
+		frame = first + 1;
+	}
+}
+
+void register_serialization(PerfRunMode mode) {
+	switch (mode) {
+		case PerfRunMode::Sanitizer:
+			PICOBENCH_SUITE_REG("Sanitizer picks");
+			PICOBENCH_REG(BM_WorldSave_Streamed).PICO_SETTINGS_SANI().user_data(NEntitiesFew).label("save streamed");
+			PICOBENCH_REG(BM_WorldLoad_Streamed).PICO_SETTINGS_SANI().user_data(NEntitiesFew).label("load streamed");
+			PICOBENCH_REG(BM_WorldLoad_Packed<false>).PICO_SETTINGS_SANI().user_data(NEntitiesFew).label("load packed");
+			return;
+		case PerfRunMode::Normal:
+			PICOBENCH_SUITE_REG("Serialization");
+			PICOBENCH_REG(BM_WorldSave_Buffer).PICO_SETTINGS_HEAVY().user_data(NEntitiesMany).label("save buffer, 1M");
+			PICOBENCH_REG(BM_WorldSave_Streamed).PICO_SETTINGS_HEAVY().user_data(NEntitiesMany).label("save streamed, 1M");
+			PICOBENCH_REG(BM_WorldLoad_Buffer).PICO_SETTINGS_HEAVY().user_data(NEntitiesMany).label("load buffer, 1M");
+			PICOBENCH_REG(BM_WorldLoad_Streamed).PICO_SETTINGS_HEAVY().user_data(NEntitiesMany).label("load streamed, 1M");
+
+			PICOBENCH_SUITE_REG("State hash");
+			PICOBENCH_REG(BM_WorldHash_Save).PICO_SETTINGS_HEAVY().user_data(NEntitiesMany).label("save+hash, 1M");
+			PICOBENCH_REG(BM_WorldHash_State<1>).PICO_SETTINGS_HEAVY().user_data(NEntitiesMany).label("1% changed, 1M");
+			PICOBENCH_REG(BM_WorldHash_State<10>).PICO_SETTINGS_HEAVY().user_data(NEntitiesMany).label("10% changed, 1M");
+			PICOBENCH_REG(BM_WorldHash_State<100>)
+					.PICO_SETTINGS_HEAVY()
+					.user_data(NEntitiesMany)
+					.label("100% changed, 1M");
+
+			PICOBENCH_SUITE_REG("Rollback");
+			PICOBENCH_REG(BM_Rollback_SaveLoad).PICO_SETTINGS_HEAVY().user_data(NEntitiesMedium).label("save+load, 100k");
+			PICOBENCH_REG(BM_Rollback_Snapshot<1>).PICO_SETTINGS_HEAVY().user_data(NEntitiesMedium).label("1% moving, 100k");
+			PICOBENCH_REG(BM_Rollback_Snapshot<10>)
+					.PICO_SETTINGS_HEAVY()
+					.user_data(NEntitiesMedium)
+					.label("10% moving, 100k");
+			PICOBENCH_REG(BM_Rollback_Snapshot<100>)
+					.PICO_SETTINGS_HEAVY()
+					.user_data(NEntitiesMedium)
+					.label("100% moving, 100k");
+
+			PICOBENCH_SUITE_REG("Serialization packed");
+			PICOBENCH_REG(BM_WorldPack<ser::pack_filter::None>)
+					.PICO_SETTINGS_HEAVY()
+					.user_data(NEntitiesMany)
+					.label("pack lz, 1M");
+			PICOBENCH_REG(BM_WorldPack<ser::pack_filter::Shuffle>)
+					.PICO_SETTINGS_HEAVY()
+					.user_data(NEntitiesMany)
+					.label("pack shuffle+lz, 1M");
+			PICOBENCH_REG(BM_WorldPack<ser::pack_filter::ShuffleDelta>)
+					.PICO_SETTINGS_HEAVY()
+					.user_data(NEntitiesMany)
+					.label("pack shuffle+delta+lz, 1M");
+			PICOBENCH_REG(BM_WorldPack<ser::pack_filter::Auto>)
+					.PICO_SETTINGS_HEAVY()
+					.user_data(NEntitiesMany)
+					.label("pack auto, 1M");
+			PICOBENCH_REG(BM_WorldUnpack<false>).PICO_SETTINGS_HEAVY().user_data(NEntitiesMany).label("unpack, 1M");
+			PICOBENCH_REG(BM_WorldUnpack<true>).PICO_SETTINGS_HEAVY().user_data(NEntitiesMany).label("unpack par, 1M");
+			PICOBENCH_REG(BM_WorldLoad_Packed<false>).PICO_SETTINGS_HEAVY().user_data(NEntitiesMany).label("load packed, 1M");
+			PICOBENCH_REG(BM_WorldLoad_Packed<true>)
+					.PICO_SETTINGS_HEAVY()
+					.user_data(NEntitiesMany)
+					.label("load packed par, 1M");
+			return;
+		case PerfRunMode::Profiling:
+		default:
+			return;
+	}
+}
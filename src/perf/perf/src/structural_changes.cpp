@@ -1,6 +1,52 @@
 #include "common.h"
 #include "registry.h"
 
+//! How structural changes are reported to their consumer
+enum class ChangeTracking : uint8_t {
+	//! Changes are not tracked
+	None,
+	//! Changes are recorded by the change journal and read once per frame
+	Journal,
+	//! Changes are reported by observers
+	Observer
+};
+
+struct ChangeTracker {
+	uint64_t events = 0;
+	ecs::JournalCursor cursor;
+};
+
+template <ChangeTracking Tracking>
+void track_changes_begin(ecs::World& w, ChangeTracker& tracker) {
+	if constexpr (Tracking == ChangeTracking::Journal) {
+		w.journal().enable(true);
+		tracker.cursor = w.journal().cursor();
+	} else if constexpr (Tracking == ChangeTracking::Observer) {
+#if GAIA_OBSERVERS_ENABLED
+		auto func = [&tracker](ecs::Iter& it) {
+			tracker.events += it.size();
+		};
+		w.observer().event(ecs::ObserverEvent::OnAdd).all<Velocity>().on_each(func);
+		w.observer().event(ecs::ObserverEvent::OnDel).all<Velocity>().on_each(func);
+		w.observer().event(ecs::ObserverEvent::OnAdd).all<Frozen>().on_each(func);
+		w.observer().event(ecs::ObserverEvent::OnDel).all<Frozen>().on_each(func);
+#endif
+	}
+	(void)w;
+	(void)tracker;
+}
+
+template <ChangeTracking Tracking>
+void track_changes_end(ecs::World& w, ChangeTracker& tracker) {
+	if constexpr (Tracking == ChangeTracking::Journal) {
+		w.journal().commit();
+		tracker.events += w.journal().read(tracker.cursor, [](const ecs::JournalEvent&) {});
+	}
+	(void)w;
+	dont_optimize(tracker.events);
+}
+
+template <ChangeTracking Tracking>
 void BM_ComponentAdd_Velocity(picobench::state& state) {
 	const uint32_t n = (uint32_t)state.user_data();
 	cnt::darray<ecs::Entity> entities;
@@ -19,15 +65,19 @@ void BM_ComponentAdd_Velocity(picobench::state& state) {
 			w.del<Velocity>(warm);
 		}
 
+		ChangeTracker tracker;
+		track_changes_begin<Tracking>(w, tracker);
 		state.start_timer();
 
 		for (auto e: entities)
 			w.add<Velocity>(e, {1.0f, 0.0f, 0.0f});
+		track_changes_end<Tracking>(w, tracker);
 
 		state.stop_timer();
 	}
 }
 
+template <ChangeTracking Tracking>
 void BM_ComponentRemove_Velocity(picobench::state& state) {
 	const uint32_t n = (uint32_t)state.user_data();
 	cnt::darray<ecs::Entity> entities;
@@ -37,20 +87,26 @@ void BM_ComponentRemove_Velocity(picobench::state& state) {
 		state.stop_timer();
 		ecs::World w;
 		create_linear_entities<true, false, false, false, false>(w, entities, n);
+		ChangeTracker tracker;
+		track_changes_begin<Tracking>(w, tracker);
 		state.start_timer();
 
 		for (auto e: entities)
 			w.del<Velocity>(e);
+		track_changes_end<Tracking>(w, tracker);
 
 		state.stop_timer();
 	}
 }
 
+template <ChangeTracking Tracking>
 void BM_ComponentToggle_Frozen(picobench::state& state) {
 	const uint32_t n = (uint32_t)state.user_data();
 	cnt::darray<ecs::Entity> entities;
 	ecs::World w;
 	create_linear_entities<true, true, false, false, false>(w, entities, n);
+	ChangeTracker tracker;
+	track_changes_begin<Tracking>(w, tracker);
 
 	bool addPhase = true;
 	for (auto _: state) {
@@ -62,6 +118,7 @@ void BM_ComponentToggle_Frozen(picobench::state& state) {
 			for (uint32_t idx = 0U; idx < entities.size(); idx += 2U)
 				w.del<Frozen>(entities[idx]);
 		}
+		track_changes_end<Tracking>(w, tracker);
 		addPhase = !addPhase;
 	}
 }
@@ -101,17 +158,57 @@ void register_structural_changes(PerfRunMode mode) {
 	switch (mode) {
 		case PerfRunMode::Sanitizer:
 			PICOBENCH_SUITE_REG("Sanitizer picks");
-			PICOBENCH_REG(BM_ComponentAdd_Velocity).PICO_SETTINGS_SANI().user_data(NEntitiesFew).label("add velocity");
+			PICOBENCH_REG(BM_ComponentAdd_Velocity<ChangeTracking::None>)
+					.PICO_SETTINGS_SANI()
+					.user_data(NEntitiesFew)
+					.label("add velocity");
 			return;
 		case PerfRunMode::Normal:
 			PICOBENCH_SUITE_REG("Structural changes");
-			PICOBENCH_REG(BM_ComponentAdd_Velocity).PICO_SETTINGS().user_data(NEntitiesMedium).label("add velocity");
-			PICOBENCH_REG(BM_ComponentRemove_Velocity).PICO_SETTINGS().user_data(NEntitiesMedium).label("remove velocity");
-			PICOBENCH_REG(BM_ComponentToggle_Frozen).PICO_SETTINGS().user_data(NEntitiesMedium).label("toggle frozen");
+			PICOBENCH_REG(BM_ComponentAdd_Velocity<ChangeTracking::None>)
+					.PICO_SETTINGS()
+					.user_data(NEntitiesMedium)
+					.label("add velocity");
+			PICOBENCH_REG(BM_ComponentRemove_Velocity<ChangeTracking::None>)
+					.PICO_SETTINGS()
+					.user_data(NEntitiesMedium)
+					.label("remove velocity");
+			PICOBENCH_REG(BM_ComponentToggle_Frozen<ChangeTracking::None>)
+					.PICO_SETTINGS()
+					.user_data(NEntitiesMedium)
+					.label("toggle frozen");
 			PICOBENCH_REG(BM_World_ChunkDeleteQueue_GC)
 					.PICO_SETTINGS_FOCUS()
 					.user_data(NEntitiesFew)
 					.label("chunk delete queue gc 10K");
+
+			PICOBENCH_SUITE_REG("Structural changes - change tracking");
+			PICOBENCH_REG(BM_ComponentAdd_Velocity<ChangeTracking::Journal>)
+					.PICO_SETTINGS()
+					.user_data(NEntitiesMedium)
+					.label("add velocity, journal");
+			PICOBENCH_REG(BM_ComponentRemove_Velocity<ChangeTracking::Journal>)
+					.PICO_SETTINGS()
+					.user_data(NEntitiesMedium)
+					.label("remove velocity, journal");
+			PICOBENCH_REG(BM_ComponentToggle_Frozen<ChangeTracking::Journal>)
+					.PICO_SETTINGS()
+					.user_data(NEntitiesMedium)
+					.label("toggle frozen, journal");
+#if GAIA_OBSERVERS_ENABLED
+			PICOBENCH_REG(BM_ComponentAdd_Velocity<ChangeTracking::Observer>)
+					.PICO_SETTINGS()
+					.user_data(NEntitiesMedium)
+					.label("add velocity, observers");
+			PICOBENCH_REG(BM_ComponentRemove_Velocity<ChangeTracking::Observer>)
+					.PICO_SETTINGS()
+					.user_data(NEntitiesMedium)
+					.label("remove velocity, observers");
+			PICOBENCH_REG(BM_ComponentToggle_Frozen<ChangeTracking::Observer>)
+					.PICO_SETTINGS()
+					.user_data(NEntitiesMedium)
+					.label("toggle frozen, observers");
+#endif
 			return;
 		case PerfRunMode::Profiling:
 		default:
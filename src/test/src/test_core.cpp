@@ -240,6 +240,51 @@ TEST_CASE("Memory allocation") {
 	}
 }
 
+TEST_CASE("Memory - bulk fill") {
+	// Odd offsets and pattern sizes exercise unaligned heads and tails of the streamed ranges
+	alignas(64) uint8_t buffer[8192 + 64];
+	for (const bool stream: {false, true}) {
+		for (const uint32_t offset: {0U, 3U, 16U}) {
+			for (const uint32_t patternSize: {1U, 4U, 12U, 24U, 100U}) {
+				uint8_t pattern[128];
+				GAIA_FOR(patternSize) pattern[i] = (uint8_t)(i * 7 + 1);
+
+				const uint32_t cnt = 8000 / patternSize;
+				memset(buffer, 0xCD, sizeof(buffer));
+				mem::fill_pattern(buffer + offset, pattern, patternSize, cnt, stream);
+
+				bool ok = true;
+				GAIA_FOR(patternSize * cnt) ok &= buffer[offset + i] == pattern[i % patternSize];
+				CHECK(ok);
+				// Nothing outside of the range was touched
+				CHECK(buffer[offset + patternSize * cnt] == 0xCD);
+				if (offset > 0)
+					CHECK(buffer[offset - 1] == 0xCD);
+			}
+
+			{
+				const uint8_t zeroes[12]{};
+				memset(buffer, 0xCD, sizeof(buffer));
+				mem::fill_pattern(buffer + offset, zeroes, sizeof(zeroes), 500, stream);
+
+				bool ok = true;
+				GAIA_FOR(sizeof(zeroes) * 500) ok &= buffer[offset + i] == 0;
+				CHECK(ok);
+				CHECK(buffer[offset + sizeof(zeroes) * 500] == 0xCD);
+			}
+
+			{
+				uint8_t src[4000];
+				GAIA_FOR(sizeof(src)) src[i] = (uint8_t)(i * 13);
+				memset(buffer, 0xCD, sizeof(buffer));
+				mem::copy_bytes(buffer + offset, src, sizeof(src), stream);
+				CHECK(memcmp(buffer + offset, src, sizeof(src)) == 0);
+				CHECK(buffer[offset + sizeof(src)] == 0xCD);
+			}
+		}
+	}
+}
+
 TEST_CASE("pow2") {
 	SUBCASE("is_pow2") {
 		CHECK(core::is_pow2(0));
@@ -1863,6 +1863,85 @@ TEST_CASE("AddAndDel_entity - 1 component") {
 	}
 }
 
+TEST_CASE("AddAndDel_entity - bulk") {
+	const uint32_t N = 5'000;
+
+	TestWorld twld;
+	cnt::darr<ecs::Entity> arr;
+	arr.reserve(N);
+
+	GAIA_FOR(N) {
+		auto e = wld.add();
+		wld.add<Int3>(e, {i, i, i});
+		wld.add<StringComponent>(e, {StringComponentDefaultValue});
+		arr.push_back(e);
+	}
+	// Disabled entities live at the front of their chunks
+	for (uint32_t i = 0; i < N; i += 7)
+		wld.enable(arr[i], false);
+
+	auto check_survivors = [&](auto&& deleted) {
+		uint32_t alive = 0;
+		GAIA_FOR(N) {
+			const auto e = arr[i];
+			if (deleted(i)) {
+				CHECK_FALSE(wld.valid(e));
+				continue;
+			}
+
+			++alive;
+			CHECK(wld.valid(e));
+			CHECK(wld.enabled(e) == (i % 7 != 0));
+			const auto& v = wld.get<Int3>(e);
+			CHECK(v.x == i);
+			CHECK(v.z == i);
+			CHECK(wld.get<StringComponent>(e).value == StringComponentDefaultValue);
+		}
+		return alive;
+	};
+
+	// Every third entity, listed twice and mixed with invalid ones. Only parts of each chunk are removed.
+	{
+		cnt::darr<ecs::Entity> victims;
+		for (uint32_t i = 0; i < N; i += 3) {
+			victims.push_back(arr[i]);
+			victims.push_back(arr[i]);
+		}
+		victims.push_back(ecs::EntityBad);
+		wld.del_n(victims);
+	}
+	CHECK(check_survivors([](uint32_t i) {
+					return i % 3 == 0;
+				}) == N - (N + 2) / 3);
+
+	// A target of a relationship with OnDeleteTarget(Delete) takes the regular path and takes its sources with it
+	auto parent = wld.add();
+	auto child = wld.add();
+	wld.child(child, parent);
+	{
+		ecs::Entity victims[] = {arr[1], parent};
+		wld.del_n(victims);
+	}
+	CHECK_FALSE(wld.valid(arr[1]));
+	CHECK_FALSE(wld.valid(parent));
+	CHECK_FALSE(wld.valid(child));
+
+	// Everything the query matches. Whole chunks are removed at once.
+	auto q = wld.query().all<Int3>();
+	wld.del(q, ecs::Constraints::AcceptAll);
+	CHECK(q.count(ecs::Constraints::AcceptAll) == 0);
+	GAIA_FOR(N) CHECK_FALSE(wld.valid(arr[i]));
+
+	wld.update();
+
+	// The archetype keeps working once its chunks are gone
+	auto e = wld.add();
+	wld.add<Int3>(e, {1, 2, 3});
+	wld.add<StringComponent>(e, {StringComponentDefaultValue});
+	CHECK(q.count() == 1);
+	CHECK(wld.get<Int3>(e).y == 2);
+}
+
 void verify_entity_has(const ecs::ComponentCache& cc, ecs::Entity entity) {
 	const auto* res = cc.find(entity);
 	CHECK(res != nullptr);
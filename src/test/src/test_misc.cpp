@@ -25,6 +25,11 @@ struct RuntimeTypedPosition {
 	float z;
 };
 
+struct IndexedTeam {
+	int32_t id;
+	float score;
+};
+
 TEST_CASE("DataLayout SoA - ECS") {
 	TestDataLayoutSoA_ECS<PositionSoA>();
 	TestDataLayoutSoA_ECS<RotationSoA>();
@@ -40,6 +45,72 @@ TEST_CASE("DataLayout SoA16 - ECS") {
 	TestDataLayoutSoA_ECS<RotationSoA16>();
 }
 
+template <typename T>
+void TestSimdView_ECS() {
+	TestWorld twld;
+
+	constexpr uint32_t N = 1000;
+	constexpr uint32_t NDisabled = 5;
+	cnt::darr<ecs::Entity> ents;
+	GAIA_FOR(N) {
+		auto e = wld.add();
+		wld.add<T>(e, {(float)i, 1.0f, 2.0f});
+		wld.add<float>(e, 0.5f);
+		ents.push_back(e);
+	}
+	// Disabled rows precede the enabled ones so blocks of the first chunk start mid-way
+	GAIA_FOR(NDisabled) wld.enable(ents[i], false);
+
+	auto q = wld.query().template all<T&>().template all<float>();
+	uint32_t rows = 0;
+	q.each([&](ecs::Iter& it) {
+		auto view = it.template simd_view_mut<T>();
+		auto px = view.template set<0>();
+		auto pz = view.template set<2>();
+		const auto dt = it.template simd_view<float>().template get<0>();
+
+		CHECK((uintptr_t)px.data() % (sizeof(float) * px.Lanes) == 0);
+		CHECK((uintptr_t)pz.data() % (sizeof(float) * pz.Lanes) == 0);
+		CHECK((uintptr_t)dt.data() % (sizeof(float) * dt.Lanes) == 0);
+
+		GAIA_FOR(px.block_cnt()) {
+			px.store(i, px.load(i) + pz.load(i));
+			pz.store(i, pz.load(i) * decltype(pz)::vec_type::splat(2.0f));
+		}
+		GAIA_FOR(dt.block_cnt()) {
+			const auto lanes = dt.load(i);
+			float tmp[dt.Lanes];
+			lanes.storeu(tmp);
+			GAIA_FOR_(dt.Lanes, j) {
+				const auto row = dt.block_row(i) + j;
+				CHECK(tmp[j] == (row >= it.row_begin() && row < it.row_end() ? 0.5f : 0.0f));
+			}
+		}
+		rows += it.size();
+	});
+	CHECK(rows == N - NDisabled);
+
+	GAIA_FOR(N) {
+		const auto p = wld.get<T>(ents[i]);
+		const bool enabled = i >= NDisabled;
+		CHECK(p.x == (float)i + (enabled ? 2.0f : 0.0f));
+		CHECK(p.y == 1.0f);
+		CHECK(p.z == (enabled ? 4.0f : 2.0f));
+	}
+}
+
+TEST_CASE("SIMD view - ECS") {
+	SUBCASE("SoA") {
+		TestSimdView_ECS<PositionSoA>();
+	}
+	SUBCASE("SoA8") {
+		TestSimdView_ECS<PositionSoA8>();
+	}
+	SUBCASE("SoA16") {
+		TestSimdView_ECS<PositionSoA16>();
+	}
+}
+
 //------------------------------------------------------------------------------
 // Component cache
 //------------------------------------------------------------------------------
@@ -4489,6 +4560,393 @@ TEST_CASE("Hooks") {
 
 #endif
 
+//------------------------------------------------------------------------------
+// Change journal
+//------------------------------------------------------------------------------
+
+TEST_CASE("Change journal") {
+	TestWorld twld;
+	const auto pos = wld.add<Position>().entity;
+	const auto rot = wld.add<Rotation>().entity;
+
+	auto& journal = wld.journal();
+	CHECK_FALSE(journal.enabled());
+
+	cnt::darray<ecs::JournalEvent> events;
+	auto read = [&](ecs::JournalCursor c) {
+		events.clear();
+		return journal.read(c, [&](const ecs::JournalEvent& ev) {
+			events.push_back(ev);
+		});
+	};
+	auto check = [&](uint32_t idx, ecs::JournalOp op, ecs::Entity entity, ecs::Entity comp) {
+		REQUIRE(idx < events.size());
+		CHECK(events[idx].op == op);
+		CHECK(events[idx].entity == entity);
+		CHECK(events[idx].comp == comp);
+	};
+
+	// Nothing is recorded while disabled
+	auto c0 = journal.cursor();
+	(void)wld.add();
+	wld.update();
+	CHECK(read(c0) == 0);
+
+	journal.enable(true);
+	const auto frame = journal.frame();
+	auto e = wld.add();
+	wld.add<Position>(e, {1, 2, 3});
+	wld.set<Position>(e) = {4, 5, 6};
+	wld.add<Rotation>(e, {1, 2, 3, 4});
+	wld.del<Position>(e);
+	// Uncommitted changes are not visible yet
+	CHECK(read(c0) == 0);
+	wld.update();
+
+	CHECK(read(c0) == 5);
+	check(0, ecs::JournalOp::EntityAdd, e, ecs::EntityBad);
+	check(1, ecs::JournalOp::CompAdd, e, pos);
+	check(2, ecs::JournalOp::Write, e, pos);
+	check(3, ecs::JournalOp::CompAdd, e, rot);
+	check(4, ecs::JournalOp::CompDel, e, pos);
+	CHECK(events[0].frame == frame);
+
+	SUBCASE("Writes via queries") {
+		cnt::darray<ecs::Entity> ents;
+		GAIA_FOR(100) {
+			auto e2 = wld.add();
+			wld.add<Position>(e2, {(float)i, 0, 0});
+			ents.push_back(e2);
+		}
+		wld.update();
+		CHECK(read(c0) == 200);
+
+		wld.query().all<Position&>().each([](Position& p) {
+			p.y += 1.f;
+		});
+		wld.update();
+		CHECK(read(c0) == 100);
+		GAIA_EACH(events) check(i, ecs::JournalOp::Write, ents[i], pos);
+	}
+
+	SUBCASE("Copies and deletes") {
+		auto e2 = wld.copy(e);
+		wld.del(e);
+		wld.update();
+		CHECK(read(c0) == 3);
+		check(0, ecs::JournalOp::EntityAdd, e2, ecs::EntityBad);
+		check(1, ecs::JournalOp::CompAdd, e2, rot);
+		check(2, ecs::JournalOp::EntityDel, e, ecs::EntityBad);
+	}
+
+	SUBCASE("Multiple cursors") {
+		auto c1 = journal.cursor();
+		wld.set<Rotation>(e) = {0, 0, 0, 0};
+		wld.update();
+		wld.set<Rotation>(e) = {1, 1, 1, 1};
+		wld.update();
+
+		CHECK(read(c0) == 2);
+		CHECK(events[0].frame + 1 == events[1].frame);
+		// Frames are kept until every cursor has read them
+		CHECK(journal.bytes() > 0);
+		CHECK(read(c1) == 2);
+		CHECK(journal.bytes() == 0);
+
+		wld.set<Rotation>(e) = {2, 2, 2, 2};
+		wld.update();
+		CHECK(journal.bytes() > 0);
+		journal.release(c1);
+		CHECK(journal.bytes() > 0);
+		journal.release(c0);
+		CHECK(journal.bytes() == 0);
+
+		// Nothing is kept with no cursors around
+		wld.set<Rotation>(e) = {3, 3, 3, 3};
+		wld.update();
+		CHECK(journal.bytes() == 0);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Spatial index
+//------------------------------------------------------------------------------
+
+TEST_CASE("Spatial index") {
+	TestWorld twld;
+
+	// 20x20 entities on the XY plane, one unit apart. Every other one has Rotation.
+	cnt::darray<ecs::Entity> ents;
+	GAIA_FOR(400) {
+		auto e = wld.add();
+		wld.add<Position>(e, {(float)(i % 20), (float)(i / 20), 0});
+		if ((i & 1) != 0)
+			wld.add<Rotation>(e, {0, 0, 0, 1});
+		ents.push_back(e);
+	}
+
+	auto& index = wld.spatial_index<Position>(4.0f);
+	CHECK(&index == &wld.spatial_index<Position>(1.0f));
+	CHECK(index.cell_size() == 4.0f);
+
+	cnt::darray<ecs::ChunkRange> ranges;
+	auto sorted = [](cnt::darray<ecs::Entity>& res) {
+		core::sort(res, [](ecs::Entity a, ecs::Entity b) {
+			return a.id() < b.id();
+		});
+		return res;
+	};
+	auto collect = [&](const ecs::SpatialBox& box) {
+		cnt::darray<ecs::Entity> res;
+		index.ranges(box, ranges);
+		for (const auto& r: ranges) {
+			const auto entities = r.pChunk->entity_view();
+			for (uint32_t row = r.from; row < r.to; ++row)
+				res.push_back(entities[row]);
+		}
+		return sorted(res);
+	};
+	auto brute = [&](const ecs::SpatialBox& box) {
+		cnt::darray<ecs::Entity> res;
+		for (auto e: ents) {
+			if (!wld.valid(e) || !wld.enabled(e) || !wld.has<Position>(e))
+				continue;
+			const auto& p = wld.get<Position>(e);
+			if (p.x >= box.min[0] && p.x <= box.max[0] && p.y >= box.min[1] && p.y <= box.max[1] && p.z >= box.min[2] &&
+					p.z <= box.max[2])
+				res.push_back(e);
+		}
+		return sorted(res);
+	};
+	auto check = [&](const ecs::SpatialBox& box) {
+		const auto a = collect(box);
+		const auto b = brute(box);
+		REQUIRE(a.size() == b.size());
+		GAIA_EACH(a) CHECK(a[i] == b[i]);
+		return (uint32_t)a.size();
+	};
+
+	const ecs::SpatialBox box{{2.5f, 2.5f, -1.0f}, {9.0f, 5.0f, 1.0f}};
+	CHECK(check(box) == 7 * 3);
+	CHECK(index.size() == 400);
+	CHECK(check({{-100, -100, -100}, {100, 100, 100}}) == 400);
+	CHECK(check({{50, 50, 0}, {60, 60, 0}}) == 0);
+
+	SUBCASE("writes") {
+		// Move an entity into the region and another one out of it
+		wld.set<Position>(ents[0]) = {3, 3, 0};
+		wld.set<Position>(ents[3 * 20 + 4]) = {100, 100, 0};
+		CHECK(check(box) == 7 * 3);
+		CHECK(check({{99, 99, 0}, {101, 101, 0}}) == 1);
+
+		// Writes via queries are picked up as well
+		auto q = wld.query().all<Position&>();
+		q.each([](Position& p) {
+			p.x += 20.0f;
+		});
+		CHECK(check(box) == 0);
+		CHECK(check({{22.5f, 2.5f, -1.0f}, {29.0f, 5.0f, 1.0f}}) == 7 * 3);
+		CHECK(index.size() == 400);
+	}
+
+	SUBCASE("structural changes") {
+		wld.del(ents[3 * 20 + 4]);
+		wld.enable(ents[3 * 20 + 5], false);
+		wld.del<Rotation>(ents[3 * 20 + 3]);
+		wld.update();
+		CHECK(check(box) == 7 * 3 - 2);
+		CHECK(index.size() == 398);
+
+		auto e = wld.copy(ents[3 * 20 + 6]);
+		ents.push_back(e);
+		wld.enable(ents[3 * 20 + 5], true);
+		CHECK(check(box) == 7 * 3);
+
+		wld.del<Position>(e);
+		CHECK(check(box) == 7 * 3 - 1);
+		CHECK(index.size() == 399);
+	}
+
+	SUBCASE("query") {
+		auto q = wld.query().all<Position>().all<Rotation>();
+		uint32_t cnt = 0;
+		index.each(q, box, [&](ecs::Iter& it) {
+			auto p = it.view<Position>();
+			GAIA_EACH(it) {
+				CHECK(p[i].x >= 2.5f);
+				CHECK(p[i].x <= 9.0f);
+				++cnt;
+			}
+		});
+		// Odd x coordinates 3, 5, 7, 9 in 3 rows
+		CHECK(cnt == 4 * 3);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Value index
+//------------------------------------------------------------------------------
+
+TEST_CASE("Value index") {
+	TestWorld twld;
+
+	const ecs::RuntimeFieldInit fields[] = {
+			{util::str_view("id"), ecs::S32, (uint32_t)offsetof(IndexedTeam, id), 0},
+			{util::str_view("score"), ecs::F32, (uint32_t)offsetof(IndexedTeam, score), 0}};
+	ecs::RuntimeTypeDesc schema{};
+	schema.typeKind = ecs::RuntimeTypeKind::Struct;
+	schema.fields = fields;
+	schema.fieldCount = 2;
+	const auto& item = wld.add<IndexedTeam>(schema);
+
+	// Teams -5..4 and scores 0, 0.5, 1, ... Every other entity has Rotation.
+	cnt::darray<ecs::Entity> ents;
+	GAIA_FOR(1000) {
+		auto e = wld.add();
+		wld.add<IndexedTeam>(e, {(int32_t)(i % 10) - 5, (float)i * 0.5f});
+		if ((i & 1) != 0)
+			wld.add<Rotation>(e, {0, 0, 0, 1});
+		ents.push_back(e);
+	}
+
+	auto& ids = wld.value_index(item.entity, "id");
+	auto& scores = wld.value_index(&IndexedTeam::score, ecs::ValueIndexKind::Sorted);
+	CHECK(&ids == &wld.value_index(&IndexedTeam::id));
+	CHECK(&scores == &wld.value_index(item.entity, "score", ecs::ValueIndexKind::Sorted));
+	CHECK(&ids != &wld.value_index(item.entity, "id", ecs::ValueIndexKind::Sorted));
+	CHECK(ids.kind() == ecs::ValueIndexKind::Hash);
+	CHECK(scores.kind() == ecs::ValueIndexKind::Sorted);
+
+	cnt::darray<ecs::ChunkRange> ranges;
+	auto sorted = [](cnt::darray<ecs::Entity>& res) {
+		core::sort(res, [](ecs::Entity a, ecs::Entity b) {
+			return a.id() < b.id();
+		});
+		return res;
+	};
+	auto collect = [&](ecs::ValueIndex& index, const ecs::ValueCond& cond) {
+		cnt::darray<ecs::Entity> res;
+		index.ranges(cond, ranges);
+		for (const auto& r: ranges) {
+			const auto entities = r.pChunk->entity_view();
+			for (uint32_t row = r.from; row < r.to; ++row)
+				res.push_back(entities[row]);
+		}
+		return sorted(res);
+	};
+	auto check = [&](ecs::ValueIndex& index, const ecs::ValueCond& cond, auto pred) {
+		cnt::darray<ecs::Entity> expected;
+		for (auto e: ents) {
+			if (wld.valid(e) && wld.enabled(e) && wld.has<IndexedTeam>(e) && pred(wld.get<IndexedTeam>(e)))
+				expected.push_back(e);
+		}
+		sorted(expected);
+
+		const auto res = collect(index, cond);
+		REQUIRE(res.size() == expected.size());
+		GAIA_EACH(res) CHECK(res[i] == expected[i]);
+		CHECK(index.count(cond) == res.size());
+		return (uint32_t)res.size();
+	};
+	auto check_all = [&]() {
+		for (auto* pIndex: {&ids, &wld.value_index(item.entity, "id", ecs::ValueIndexKind::Sorted)}) {
+			check(*pIndex, ecs::eq(-2), [](const IndexedTeam& t) {
+				return t.id == -2;
+			});
+			check(*pIndex, ecs::lt(0), [](const IndexedTeam& t) {
+				return t.id < 0;
+			});
+			check(*pIndex, ecs::ge(3), [](const IndexedTeam& t) {
+				return t.id >= 3;
+			});
+			check(*pIndex, ecs::between(-1, 1), [](const IndexedTeam& t) {
+				return t.id >= -1 && t.id <= 1;
+			});
+		}
+		check(scores, ecs::le(10.0f), [](const IndexedTeam& t) {
+			return t.score <= 10.0f;
+		});
+		check(scores, ecs::gt(450), [](const IndexedTeam& t) {
+			return t.score > 450.0f;
+		});
+		check(scores, ecs::eq(250.5), [](const IndexedTeam& t) {
+			return t.score == 250.5f;
+		});
+	};
+
+	CHECK(ids.count(ecs::eq(-2)) == 100);
+	CHECK(ids.count(ecs::eq(100)) == 0);
+	CHECK(ids.count(ecs::lt(-5)) == 0);
+	CHECK(scores.count(ecs::between(10.0f, 20.0f)) == 21);
+	CHECK(scores.count(ecs::between(20.0f, 10.0f)) == 0);
+	CHECK(ids.size() == 1000);
+	check_all();
+
+	SUBCASE("writes") {
+		wld.set<IndexedTeam>(ents[0]) = {-2, 1000.0f};
+		wld.set<IndexedTeam>(ents[4]) = {-2, -1.0f};
+		CHECK(ids.count(ecs::eq(-2)) == 102);
+		CHECK(scores.count(ecs::lt(0)) == 1);
+		check_all();
+
+		// Medium batches are merged into sorted indices
+		GAIA_FOR(50) {
+			auto t = wld.get<IndexedTeam>(ents[i * 20 + 1]);
+			t.score = -(float)i;
+			wld.set<IndexedTeam>(ents[i * 20 + 1]) = t;
+		}
+		CHECK(scores.count(ecs::lt(0)) == 50);
+		check_all();
+
+		// Writes via queries are picked up as well. Large batches rebuild sorted indices.
+		auto q = wld.query().all<IndexedTeam&>();
+		q.each([](IndexedTeam& t) {
+			t.id = -t.id;
+			t.score += 1.0f;
+		});
+		CHECK(ids.count(ecs::eq(-2)) == 100);
+		CHECK(ids.count(ecs::eq(2)) == 102);
+		check_all();
+		CHECK(ids.size() == 1000);
+		CHECK(scores.size() == 1000);
+	}
+
+	SUBCASE("structural changes") {
+		wld.del(ents[8]);
+		wld.enable(ents[18], false);
+		wld.del<Rotation>(ents[39]);
+		wld.update();
+		CHECK(ids.count(ecs::eq(3)) == 98);
+		CHECK(ids.size() == 998);
+		check_all();
+
+		auto e = wld.copy(ents[38]);
+		ents.push_back(e);
+		wld.enable(ents[18], true);
+		CHECK(ids.count(ecs::eq(3)) == 100);
+		check_all();
+
+		wld.del<IndexedTeam>(e);
+		CHECK(ids.count(ecs::eq(3)) == 99);
+		CHECK(ids.size() == 999);
+		check_all();
+	}
+
+	SUBCASE("query") {
+		auto q = wld.query().all<IndexedTeam>().all<Rotation>();
+		uint32_t cnt = 0;
+		ids.each(q, ecs::eq(-2), [&](ecs::Iter& it) {
+			auto t = it.view<IndexedTeam>();
+			GAIA_EACH(it) {
+				CHECK(t[i].id == -2);
+				++cnt;
+			}
+		});
+		// Only odd entities have Rotation and -2 means i % 10 == 3
+		CHECK(cnt == 100);
+	}
+}
+
 //------------------------------------------------------------------------------
 // Multiple worlds
 //------------------------------------------------------------------------------
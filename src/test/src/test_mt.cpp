@@ -1142,6 +1142,111 @@ void TestJobQueueMT(uint32_t threadCnt) {
 	}
 }
 
+void TestJobDeque_Grow() {
+	mt::JobDeque<4> q;
+	mt::JobHandle handle;
+	constexpr uint32_t Items = 1000;
+
+	CHECK(q.empty());
+	CHECK(q.capacity() == 4);
+
+	// Push past the initial capacity, both one by one and in batches
+	uint32_t i = 1;
+	for (; i <= Items / 2; ++i)
+		q.push(mt::JobHandle(i, 0, 0));
+	{
+		cnt::darray<mt::JobHandle> handles;
+		for (; i <= Items; ++i)
+			handles.push_back(mt::JobHandle(i, 0, 0));
+		q.push_n(std::span<const mt::JobHandle>(handles.data(), handles.size()));
+	}
+	CHECK_FALSE(q.empty());
+	CHECK(q.capacity() >= Items);
+
+	// Thieves take the oldest jobs, up to a half of them
+	mt::JobHandle stolen[Items];
+	const auto stolenCnt = q.steal_half(std::span(stolen, Items));
+	CHECK(stolenCnt == Items / 2);
+	GAIA_FOR(stolenCnt) CHECK(stolen[i].id() == i + 1);
+
+	const auto res = q.try_steal(handle);
+	CHECK(res);
+	CHECK(handle.id() == Items / 2 + 1);
+
+	// The owner takes the newest ones
+	uint32_t expected = Items;
+	while (q.try_pop(handle)) {
+		CHECK(handle.id() == expected);
+		--expected;
+	}
+	CHECK(expected == Items / 2 + 1);
+	CHECK(q.empty());
+	CHECK(q.steal_half(std::span(stolen, Items)) == 0);
+}
+
+void TestJobDequeMT(uint32_t threadCnt) {
+	constexpr uint32_t Items = 20000;
+	constexpr uint32_t BatchSize = 8;
+
+	// Tiny initial capacity so the buffer keeps growing while thieves are reading it
+	mt::JobDeque<4> q;
+	auto hits = std::make_unique<std::atomic_uint32_t[]>(Items);
+	std::atomic_bool terminate = false;
+
+	auto consume = [&](mt::JobHandle handle) {
+		hits[handle.id()].fetch_add(1, std::memory_order_relaxed);
+	};
+
+	cnt::darray<std::thread> thieves;
+	GAIA_FOR(threadCnt - 1) {
+		thieves.push_back(std::thread([&, i]() {
+			mt::JobHandle handles[BatchSize];
+			while (!terminate.load()) {
+				uint32_t stolenCnt = 0;
+				if (i % 2 == 0)
+					stolenCnt = q.steal_half(std::span(handles, BatchSize));
+				else if (q.try_steal(handles[0]) && handles[0] != (mt::JobHandle)mt::JobNull_t{})
+					stolenCnt = 1;
+
+				GAIA_FOR_(stolenCnt, j) consume(handles[j]);
+				if (stolenCnt == 0)
+					std::this_thread::yield();
+			}
+		}));
+	}
+
+	// The owner pushes jobs one by one and in batches and occasionally takes some back
+	mt::JobHandle batch[BatchSize];
+	mt::JobHandle handle;
+	for (uint32_t i = 0; i < Items;) {
+		if (i % 3 == 0 && i + BatchSize <= Items) {
+			GAIA_FOR_(BatchSize, j) batch[j] = mt::JobHandle(i + j, 0, 0);
+			q.push_n(std::span<const mt::JobHandle>(batch, BatchSize));
+			i += BatchSize;
+		} else
+			q.push(mt::JobHandle(i++, 0, 0));
+
+		if (i % 16 == 0 && q.try_pop(handle))
+			consume(handle);
+	}
+	while (q.try_pop(handle))
+		consume(handle);
+	while (!q.empty())
+		std::this_thread::yield();
+
+	terminate = true;
+	for (auto& t: thieves)
+		t.join();
+
+	// Every job was executed exactly once
+	uint32_t wrong = 0;
+	GAIA_FOR(Items) {
+		if (hits[i].load() != 1)
+			++wrong;
+	}
+	CHECK(wrong == 0);
+}
+
 TEST_CASE("JobQueue") {
 	using jc = mt::JobQueue<1024>;
 	using mpmc = mt::MpmcQueue<mt::JobHandle, 1024>;
@@ -1151,6 +1256,12 @@ TEST_CASE("JobQueue") {
 		TestJobQueue_PushPop<mpmc>(true);
 	}
 
+	SUBCASE("Growable") {
+		TestJobDeque_Grow();
+		TestJobDequeMT(2);
+		TestJobDequeMT(4);
+	}
+
 	using mt_tester_jc = JobQueueMTTester_PushPopSteal<jc>;
 	using mt_tester_mpmc = JobQueueMTTester_PushPop<mpmc>;
 
@@ -1880,3 +1991,484 @@ TEST_CASE("Multithreading - Handle reuse mixed delete modes") {
 	CHECK(autoCnt.load(std::memory_order_relaxed) == Iters);
 	CHECK(manualCnt.load(std::memory_order_relaxed) == Iters);
 }
+
+static uint32_t ForkJoinSum(const uint32_t* pArr, uint32_t cnt) {
+	constexpr uint32_t Cutoff = 1024;
+	if (cnt <= Cutoff)
+		return JobSystemFunc({pArr, cnt});
+
+	auto& tp = mt::ThreadPool::get();
+
+	// Split the range and reduce the parts in parallel. Each part does the same recursively
+	// so most nested sched_par/wait calls run on worker threads.
+	constexpr uint32_t Parts = 4;
+	const uint32_t partSize = (cnt + Parts - 1) / Parts;
+	std::atomic_uint32_t sum = 0;
+
+	mt::JobParallel j;
+	j.func = [&](const mt::JobArgs& args) {
+		uint32_t partSum = 0;
+		for (uint32_t p = args.idxStart; p < args.idxEnd; ++p) {
+			const uint32_t from = p * partSize;
+			const uint32_t to = core::get_min(from + partSize, cnt);
+			partSum += ForkJoinSum(pArr + from, to - from);
+		}
+		sum += partSum;
+	};
+
+	tp.wait(tp.sched_par(GAIA_MOV(j), Parts, 1));
+	return sum;
+}
+
+TEST_CASE("Multithreading - Nested fork-join") {
+	auto& tp = mt::ThreadPool::get();
+
+	constexpr uint32_t N = 1 << 18;
+	cnt::darr<uint32_t> arr;
+	arr.resize(N);
+	GAIA_EACH(arr) arr[i] = 1;
+
+	auto work = [&]() {
+		SUBCASE("Recursive sched_par") {
+			// Repeat a few times so job slots cached by workers get recycled
+			GAIA_FOR(8) CHECK(ForkJoinSum(arr.data(), N) == N);
+		}
+		SUBCASE("Jobs spawning jobs") {
+			constexpr uint32_t Parents = 16;
+			constexpr uint32_t Children = 64;
+			std::atomic_uint32_t cnt = 0;
+
+			mt::JobHandle parentHandles[Parents];
+			GAIA_FOR(Parents) {
+				mt::Job parent;
+				parent.flags = mt::JobCreationFlags::ManualDelete;
+				parent.func = [&]() {
+					mt::JobHandle handles[Children];
+					GAIA_FOR_(Children, j) {
+						mt::Job child;
+						child.func = [&]() {
+							cnt.fetch_add(1, std::memory_order_relaxed);
+						};
+						handles[j] = tp.sched(GAIA_MOV(child));
+					}
+					GAIA_FOR_(Children, j) tp.wait(handles[j]);
+				};
+				parentHandles[i] = tp.sched(GAIA_MOV(parent));
+			}
+			GAIA_FOR(Parents) {
+				tp.wait(parentHandles[i]);
+				tp.del(parentHandles[i]);
+			}
+
+			CHECK(cnt.load(std::memory_order_relaxed) == Parents * Children);
+		}
+	};
+
+	SUBCASE("Max workers") {
+		const auto threads = tp.hw_thread_cnt();
+		tp.set_max_workers(threads, threads);
+
+		work();
+	}
+	SUBCASE("0 workers") {
+		tp.set_max_workers(0, 0);
+
+		work();
+	}
+}
+
+TEST_CASE("Multithreading - Futex") {
+	std::atomic_uint32_t value = 0;
+
+	// Waiting on a value that doesn't match returns right away
+	CHECK(mt::Futex::wait(&value, 1, mt::detail::WaitMaskAny) == mt::Futex::Result::Change);
+	// Nobody is waiting
+	CHECK(mt::Futex::wake(&value, 1) == 0);
+
+	std::atomic_bool waiting = false;
+	std::thread t([&]() {
+		waiting = true;
+		while (value.load() == 0)
+			(void)mt::Futex::wait(&value, 0, mt::detail::WaitMaskAny);
+	});
+
+	while (!waiting.load())
+		std::this_thread::yield();
+	value.store(1);
+	(void)mt::Futex::wake(&value, mt::detail::WaitMaskAll);
+	t.join();
+	CHECK(value.load() == 1);
+}
+
+TEST_CASE("Multithreading - Worker parking") {
+	auto& tp = mt::ThreadPool::get();
+	tp.set_max_workers(4, 4);
+
+	const auto spinBudgetOld = tp.spin_budget();
+
+	auto work = [&]() {
+		// Many small batches with gaps in between so workers keep going idle and waking up again
+		constexpr uint32_t Frames = 64;
+		constexpr uint32_t JobsPerFrame = 32;
+		std::atomic_uint32_t cnt = 0;
+		GAIA_FOR(Frames) {
+			mt::JobHandle handles[JobsPerFrame];
+			GAIA_FOR_(JobsPerFrame, j) {
+				mt::Job job;
+				job.flags = mt::JobCreationFlags::ManualDelete;
+				job.func = [&]() {
+					cnt.fetch_add(1, std::memory_order_relaxed);
+				};
+				handles[j] = tp.add(GAIA_MOV(job));
+			}
+			tp.submit(std::span(handles, JobsPerFrame));
+			GAIA_FOR_(JobsPerFrame, j) {
+				tp.wait(handles[j]);
+				tp.del(handles[j]);
+			}
+
+			if ((i & 7) == 0)
+				std::this_thread::sleep_for(std::chrono::microseconds(100));
+		}
+		CHECK(cnt.load() == Frames * JobsPerFrame);
+	};
+
+	SUBCASE("Spin then park") {
+		tp.set_spin_budget(1024);
+		CHECK(tp.spin_budget() == 1024);
+		work();
+	}
+	SUBCASE("Park right away") {
+		tp.set_spin_budget(0);
+		CHECK(tp.spin_budget() == 0);
+		work();
+	}
+
+	tp.set_spin_budget(spinBudgetOld);
+
+	// Worker threads need to stop cleanly no matter whether they are busy, spinning or parked
+	tp.set_max_workers(2, 2);
+	CHECK(tp.workers() == 1);
+}
+
+TEST_CASE("Multithreading - Job burst") {
+	auto& tp = mt::ThreadPool::get();
+
+	// Far more jobs than any fixed-size queue of the pool can hold
+	constexpr uint32_t Jobs = 20000;
+	std::atomic_uint32_t cnt = 0;
+
+	auto work = [&]() {
+		cnt = 0;
+
+		SUBCASE("Main thread") {
+			mt::Job syncJob;
+			syncJob.flags = mt::JobCreationFlags::ManualDelete;
+			auto syncHandle = tp.add(GAIA_MOV(syncJob));
+
+			// Mix both priority classes
+			cnt::darray<mt::JobHandle> handles(Jobs);
+			GAIA_FOR(Jobs) {
+				mt::Job job;
+				job.priority = (i & 1) != 0 ? mt::JobPriority::Low : mt::JobPriority::High;
+				job.func = [&]() {
+					cnt.fetch_add(1, std::memory_order_relaxed);
+				};
+				handles[i] = tp.add(GAIA_MOV(job));
+			}
+			tp.dep(std::span(handles.data(), handles.size()), syncHandle);
+			tp.submit(std::span(handles.data(), handles.size()));
+			tp.submit(syncHandle);
+			tp.wait(syncHandle);
+			tp.del(syncHandle);
+
+			CHECK(cnt.load() == Jobs);
+		}
+		SUBCASE("Worker") {
+			mt::Job parent;
+			parent.flags = mt::JobCreationFlags::ManualDelete;
+			parent.func = [&]() {
+				cnt::darray<mt::JobHandle> handles(Jobs);
+				GAIA_FOR(Jobs) {
+					mt::Job job;
+					job.flags = mt::JobCreationFlags::ManualDelete;
+					job.func = [&]() {
+						cnt.fetch_add(1, std::memory_order_relaxed);
+					};
+					handles[i] = tp.add(GAIA_MOV(job));
+				}
+				tp.submit(std::span(handles.data(), handles.size()));
+				for (auto handle: handles) {
+					tp.wait(handle);
+					tp.del(handle);
+				}
+			};
+			auto parentHandle = tp.sched(GAIA_MOV(parent));
+			tp.wait(parentHandle);
+			tp.del(parentHandle);
+
+			CHECK(cnt.load() == Jobs);
+		}
+	};
+
+	SUBCASE("Max workers") {
+		const auto threads = tp.hw_thread_cnt();
+		tp.set_max_workers(threads, threads);
+		work();
+	}
+	SUBCASE("Both priorities") {
+		tp.set_max_workers(4, 2);
+		work();
+	}
+	SUBCASE("0 workers") {
+		tp.set_max_workers(0, 0);
+		work();
+	}
+}
+
+TEST_CASE("ECS - build_queries matches cached queries up front") {
+	TestWorld twld;
+
+	constexpr uint32_t TagCnt = 8;
+	ecs::Entity tags[TagCnt];
+	GAIA_FOR(TagCnt) tags[i] = wld.add();
+
+	// One entity per tag combination makes a few hundred archetypes
+	GAIA_FOR(1U << TagCnt) {
+		const auto e = wld.add();
+		GAIA_FOR_(TagCnt, j) {
+			if ((i & (1U << j)) != 0)
+				wld.add(e, tags[j]);
+		}
+	}
+
+	cnt::darray<ecs::Query> queries;
+	GAIA_FOR(TagCnt) {
+		queries.push_back(wld.query().all(tags[i]));
+		queries.push_back(wld.query().all(tags[i]).all(tags[(i + 1) % TagCnt]).no(tags[(i + 3) % TagCnt]));
+		queries.push_back(wld.query().or_(tags[i]).or_(tags[(i + 2) % TagCnt]));
+	}
+	// Grouped queries fill their result cache after the parallel part
+	const auto groupRel = wld.add();
+	queries.push_back(wld.query().all(tags[0]).group_by(groupRel));
+	// Wildcard queries are matched serially
+	queries.push_back(wld.query().all(ecs::Pair(ecs::ChildOf, ecs::All)));
+
+	cnt::darray<uint32_t> passCounts;
+	for (auto& q: queries)
+		passCounts.push_back(q.fetch().test_match_pass_count());
+
+	wld.build_queries();
+
+	GAIA_EACH(queries) {
+		auto& info = queries[i].fetch();
+		CHECK(info.test_match_pass_count() == passCounts[i] + 1);
+		passCounts[i] = info.test_match_pass_count();
+	}
+
+	// The built results match those of uncached queries and no further VM pass is needed to get them
+	GAIA_FOR(TagCnt) {
+		auto uq0 = wld.uquery().all(tags[i]);
+		auto uq1 = wld.uquery().all(tags[i]).all(tags[(i + 1) % TagCnt]).no(tags[(i + 3) % TagCnt]);
+		auto uq2 = wld.uquery().or_(tags[i]).or_(tags[(i + 2) % TagCnt]);
+		CHECK(queries[i * 3 + 0].count() == uq0.count());
+		CHECK(queries[i * 3 + 1].count() == uq1.count());
+		CHECK(queries[i * 3 + 2].count() == uq2.count());
+	}
+	CHECK(queries[TagCnt * 3].count() == (1U << (TagCnt - 1)));
+	CHECK(queries.back().count() == 0);
+	GAIA_EACH(queries) CHECK(queries[i].fetch().test_match_pass_count() == passCounts[i]);
+	CHECK(wld.verify_query_cache());
+
+	// Archetypes created later are picked up by the next build
+	const auto e = wld.add();
+	wld.add(e, tags[0]);
+	wld.add(e, tags[1]);
+	wld.add(e, wld.add());
+	wld.build_queries();
+	CHECK(queries[0].count() == (1U << (TagCnt - 1)) + 1);
+	CHECK(queries[3].count() == (1U << (TagCnt - 1)) + 1);
+	CHECK(wld.verify_query_cache());
+}
+
+TEST_CASE("ECS - instantiate_n fills prefab subtrees in parallel") {
+	TestWorld twld;
+
+	const auto rootPrefab = wld.prefab();
+	wld.add<Position>(rootPrefab, {1, 0, 0});
+	cnt::darray<ecs::Entity> childPrefabs;
+	GAIA_FOR(4) {
+		const auto child = wld.prefab();
+		wld.add<Position>(child, {(float)i + 2, 0, 0});
+		wld.add<Scale>(child, {1, 2, 3});
+		wld.parent(child, rootPrefab);
+		childPrefabs.push_back(child);
+	}
+
+	// Every instantiation goes through the parallel fill
+	wld.par_instantiate_threshold(0);
+	CHECK(wld.par_instantiate_threshold() == 0);
+
+	constexpr uint32_t N = 3000;
+	cnt::darray<ecs::Entity> roots;
+	wld.instantiate_n(rootPrefab, N, [&](ecs::Entity instance) {
+		roots.push_back(instance);
+	});
+	CHECK(roots.size() == N);
+
+	uint32_t childCnt = 0;
+	for (const auto root: roots) {
+		CHECK(wld.get<Position>(root).x == doctest::Approx(1.0f));
+		wld.sources(ecs::Parent, root, [&](ecs::Entity child) {
+			++childCnt;
+			ecs::Entity prefab = ecs::EntityBad;
+			for (const auto cp: childPrefabs) {
+				if (wld.has_direct(child, ecs::Pair(ecs::Is, cp)))
+					prefab = cp;
+			}
+			REQUIRE(prefab != ecs::EntityBad);
+			CHECK(wld.get<Position>(child).x == doctest::Approx(wld.get<Position>(prefab).x));
+			CHECK(wld.get<Scale>(child).z == doctest::Approx(3.0f));
+		});
+	}
+	CHECK(childCnt == N * 4);
+
+	auto q = wld.query().all<Scale>();
+	CHECK(q.count() == N * 4);
+}
+
+TEST_CASE("ECS - OrderedReduce") {
+	ecs::OrderedReduce<float> reduce;
+	CHECK(reduce.empty());
+
+	// Added out of order, folded in batch order
+	reduce.add(2, 1e8f);
+	reduce.add(0, 1.f);
+	reduce.add(1, -1e8f);
+	reduce.add(0, 2.f);
+	CHECK(reduce.size() == 4);
+
+	const auto sum = reduce.fold(0.f, [](float a, float b) {
+		return a + b;
+	});
+	// ((1 + 2) - 1e8) + 1e8 with float rounding
+	CHECK(sum == ((3.f - 1e8f) + 1e8f));
+
+	uint32_t order = 0;
+	(void)reduce.fold(0.f, [&](float a, float b) {
+		if (b == 1.f)
+			order = order * 10 + 1;
+		else if (b == 2.f)
+			order = order * 10 + 2;
+		else
+			order = order * 10 + 3;
+		return a + b;
+	});
+	CHECK(order == 1233);
+
+	reduce.clear();
+	CHECK(reduce.empty());
+}
+
+namespace {
+	struct DetSimResult {
+		cnt::darray<uint64_t> hashes;
+		cnt::darray<float> sums;
+	};
+
+	uint64_t det_hash(uint64_t hash, const void* pData, uint32_t size) {
+		const auto* pBytes = (const uint8_t*)pData;
+		GAIA_FOR(size) {
+			hash ^= pBytes[i];
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+
+	DetSimResult det_simulate(uint32_t threads, uint32_t frames) {
+		auto& tp = mt::ThreadPool::get();
+		tp.set_max_workers(threads, threads);
+
+		TestWorld twld;
+		wld.deterministic(true);
+		CHECK(wld.deterministic());
+		CHECK(wld.det_partitions() == ecs::World::DetPartitionsDefault);
+
+		constexpr uint32_t N = 20'000;
+		GAIA_FOR(N) {
+			auto e = wld.add();
+			wld.add<Position>(e, {(float)i * 0.001f, 0.f, 0.f});
+			wld.add<Acceleration>(e, {0.1f + (float)(i % 7) * 0.013f, 0.f, 0.f});
+		}
+
+		auto qMove = wld.query().all<Position&>().all<Acceleration>();
+		auto qHash = wld.query().all<Position>();
+
+		DetSimResult res;
+		GAIA_FOR_(frames, frame) {
+			ecs::OrderedReduce<float> reduce;
+			qMove.each(
+					[&](ecs::Iter& it) {
+						auto entities = it.view<ecs::Entity>();
+						auto posView = it.view_mut<Position>();
+						auto accView = it.view<Acceleration>();
+						float sum = 0.f;
+						GAIA_EACH(it) {
+							auto& p = posView[i];
+							p.x += accView[i].x * 0.016f;
+							p.y += p.x * 0.5f;
+							sum += p.y;
+
+							// Recycle entities that got too far. Ids and chunk positions of the new entities
+							// depend on the order in which the commands are committed.
+							if (p.x > 20.f) {
+								auto& cb = it.cmd_buffer_mt();
+								cb.del(entities[i]);
+								auto e = cb.add();
+								cb.add<Position>(e, {0.f, p.y * 0.001f, (float)frame});
+								cb.add<Acceleration>(e, {0.2f, 0.f, 0.f});
+							}
+						}
+						it.reduce(reduce, sum);
+					},
+					ecs::QueryExecType::Parallel);
+
+			res.sums.push_back(reduce.fold(0.f, [](float a, float b) {
+				return a + b;
+			}));
+
+			uint64_t hash = 14695981039346656037ULL;
+			qHash.each([&](ecs::Iter& it) {
+				auto entities = it.view<ecs::Entity>();
+				auto posView = it.view<Position>();
+				GAIA_EACH(it) {
+					const auto e = entities[i];
+					const auto p = posView[i];
+					hash = det_hash(hash, &e, sizeof(e));
+					hash = det_hash(hash, &p, sizeof(p));
+				}
+			});
+			res.hashes.push_back(hash);
+		}
+
+		return res;
+	}
+} // namespace
+
+TEST_CASE("ECS - Deterministic parallel execution") {
+	auto& tp = mt::ThreadPool::get();
+	const auto threadsPrev = tp.workers() + 1;
+
+	constexpr uint32_t Frames = 24;
+	const auto ref = det_simulate(1, Frames);
+	for (uint32_t threads: {4U, 16U}) {
+		const auto res = det_simulate(threads, Frames);
+		REQUIRE(res.hashes.size() == Frames);
+		GAIA_FOR(Frames) {
+			CHECK(res.hashes[i] == ref.hashes[i]);
+			CHECK(res.sums[i] == ref.sums[i]);
+		}
+	}
+
+	tp.set_max_workers(threadsPrev, threadsPrev);
+}
@@ -299,6 +299,99 @@ TEST_CASE("copy_n") {
 	}
 }
 
+TEST_CASE("copy_n - bulk column fill") {
+	TestWorld twld;
+
+	const auto check = [&](uint32_t threshold, bool named) {
+		wld.stream_copy_threshold(threshold);
+
+		auto e = wld.add();
+		wld.add<Position>(e, {1.f, 2.f, 3.f});
+		wld.add<PositionSoA>(e, {4.f, 5.f, 6.f});
+		wld.add<PositionNonTrivial>(e, {7.f, 8.f, 9.f});
+		wld.add<TypeNonTrivialC<float>>(e, {10.f});
+		if (named)
+			wld.name(e, "proto");
+
+		// Spans several chunks
+		constexpr uint32_t N = 3000;
+		uint32_t copied = 0;
+		wld.copy_n(e, N, [&](ecs::Entity) {
+			++copied;
+		});
+		CHECK(copied == N);
+
+		uint32_t cnt = 0;
+		wld.query()
+				.all<Position>()
+				.all<PositionSoA>()
+				.all<PositionNonTrivial>()
+				.all<TypeNonTrivialC<float>>()
+				.each([&](ecs::Iter& it) {
+					auto p = it.view<Position>();
+					auto ps = it.view<PositionSoA>();
+					auto pn = it.view<PositionNonTrivial>();
+					auto t = it.view<TypeNonTrivialC<float>>();
+					auto px = ps.get<0>();
+					auto py = ps.get<1>();
+					auto pz = ps.get<2>();
+					GAIA_EACH(it) {
+						CHECK(p[i].x == 1.f);
+						CHECK(p[i].y == 2.f);
+						CHECK(p[i].z == 3.f);
+						CHECK(px[i] == 4.f);
+						CHECK(py[i] == 5.f);
+						CHECK(pz[i] == 6.f);
+						CHECK(pn[i].x == 7.f);
+						CHECK(pn[i].y == 8.f);
+						CHECK(pn[i].z == 9.f);
+						CHECK((float)t[i] == 10.f);
+						++cnt;
+					}
+				});
+		CHECK(cnt == N + 1);
+	};
+
+	SUBCASE("cached stores") {
+		check(uint32_t(-1), false);
+	}
+	SUBCASE("streamed stores") {
+		check(0, false);
+	}
+	SUBCASE("streamed stores, named source") {
+		check(0, true);
+	}
+}
+
+TEST_CASE("instantiate_n - bulk column fill") {
+	TestWorld twld;
+	wld.stream_copy_threshold(0);
+
+	auto prefab = wld.prefab();
+	wld.add<Position>(prefab, {1.f, 2.f, 3.f});
+	wld.add<PositionSoA>(prefab, {4.f, 5.f, 6.f});
+	wld.add<TypeNonTrivialC<float>>(prefab, {10.f});
+
+	constexpr uint32_t N = 3000;
+	wld.instantiate_n(prefab, N);
+
+	uint32_t cnt = 0;
+	wld.query().all<Position>().all<PositionSoA>().all<TypeNonTrivialC<float>>().each([&](ecs::Iter& it) {
+		auto p = it.view<Position>();
+		auto ps = it.view<PositionSoA>();
+		auto t = it.view<TypeNonTrivialC<float>>();
+		auto pz = ps.get<2>();
+		GAIA_EACH(it) {
+			CHECK(p[i].x == 1.f);
+			CHECK(p[i].z == 3.f);
+			CHECK(pz[i] == 6.f);
+			CHECK((float)t[i] == 10.f);
+			++cnt;
+		}
+	});
+	CHECK(cnt == N);
+}
+
 TEST_CASE("Set - generic") {
 	TestWorld twld;
 
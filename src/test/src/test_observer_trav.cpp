@@ -86,6 +86,43 @@ TEST_CASE("Observer - deleting a direct source emits OnDel") {
 		CHECK(removed[0] == matched);
 }
 
+TEST_CASE("Observer - bulk deleting a direct source emits OnDel") {
+	TestWorld twld;
+
+	const auto source = wld.add();
+	wld.add<Acceleration>(source, {1.0f, 2.0f, 3.0f});
+
+	cnt::darr<ecs::Entity> matched;
+	cnt::darr<ecs::Entity> victims;
+	GAIA_FOR(100) {
+		const auto e = wld.add();
+		wld.add<Position>(e, {(float)i, 0.0f, 0.0f});
+		matched.push_back(e);
+
+		const auto other = wld.add();
+		wld.add<Rotation>(other, {(float)i, 0.0f, 0.0f, 0.0f});
+		victims.push_back(other);
+	}
+	victims.push_back(source);
+
+	cnt::darr<ecs::Entity> removed;
+	wld.observer()
+			.event(ecs::ObserverEvent::OnDel)
+			.all<Position>()
+			.all<Acceleration>(ecs::QueryTermOptions{}.src(source))
+			.on_each([&](ecs::Iter& it) {
+				auto entities = it.view<ecs::Entity>();
+				GAIA_EACH(it) removed.push_back(entities[i]);
+			});
+
+	wld.del_n(victims);
+
+	CHECK_FALSE(wld.valid(source));
+	CHECK(removed.size() == 100);
+	for (auto e: matched)
+		CHECK(core::has(removed, e));
+}
+
 TEST_CASE("Observer - direct source ignores recycled source ids") {
 	TestWorld twld;
 
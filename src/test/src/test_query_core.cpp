@@ -2862,11 +2862,24 @@ void Test_Query_Variable_Opcode_Selection_IsStructural() {
 		return CompileShape{bytecode, queryInfo.op_signature(), queryInfo.op_count()};
 	};
 
+	// Costs and cardinality estimates follow live statistics, everything else is structural
+	auto strip_stats = [](const util::str& bytecode) {
+		std::string out(bytecode.data(), bytecode.size());
+		for (const char* key: {"cost=", "card="}) {
+			for (auto pos = out.find(key); pos != std::string::npos; pos = out.find(key, pos + 1)) {
+				auto end = pos + std::strlen(key);
+				while (end < out.size() && out[end] >= '0' && out[end] <= '9')
+					++end;
+				out.erase(pos + std::strlen(key), end - pos - std::strlen(key));
+			}
+		}
+		return out;
+	};
+
 	const auto shapeFew = build_shape(0);
 	const auto shapeMany = build_shape(1024);
 
-	CHECK(shapeFew.bytecode == shapeMany.bytecode);
-	CHECK(shapeFew.opSignature == shapeMany.opSignature);
+	CHECK(strip_stats(shapeFew.bytecode) == strip_stats(shapeMany.bytecode));
 	CHECK(shapeFew.opCount == shapeMany.opCount);
 }
 
@@ -2968,6 +2981,65 @@ TEST_CASE("Query - variable program recompile") {
 	}
 }
 
+template <typename TQuery>
+void Test_Query_Variable_Program_Replan() {
+	constexpr bool UseCachedQuery = use_cached_query_v<TQuery>;
+
+	struct Device {};
+
+	TestWorld twld;
+	const auto connectedTo = wld.add();
+
+	// Cables connect to many endpoints but only a few endpoints are devices
+	constexpr uint32_t EndpointCnt = 24;
+	cnt::darr<ecs::Entity> endpoints;
+	GAIA_FOR(EndpointCnt) endpoints.push_back(wld.add());
+	wld.add<Device>(endpoints[0]);
+
+	const auto cableAll = wld.add();
+	GAIA_FOR(EndpointCnt) wld.add(cableAll, ecs::Pair(connectedTo, endpoints[i]));
+	const auto cableNoDevice = wld.add();
+	for (uint32_t i = 1; i < EndpointCnt; ++i)
+		wld.add(cableNoDevice, ecs::Pair(connectedTo, endpoints[i]));
+
+	auto q = make_query<UseCachedQuery>(wld) //
+							 .all(ecs::Pair(connectedTo, ecs::Var0))
+							 .template all<Device>(ecs::QueryTermOptions{}.src(ecs::Var0));
+	CHECK(q.count() == 1);
+	expect_exact_entities(q, {cableAll});
+	const auto bytecodeBefore = q.bytecode();
+	CHECK(bytecodeBefore.find("card=1\n") != BadIndex);
+
+	// Devices become common. Matching the next batch of archetypes re-plans the search around the new counts.
+	GAIA_FOR(1000) wld.add<Device>(wld.add());
+	cnt::darr<ecs::Entity> cables{cableAll};
+	GAIA_FOR(16) {
+		const auto cable = wld.add();
+		wld.add(cable, ecs::Pair(connectedTo, endpoints[0]));
+		wld.add(cable, wld.add());
+		cables.push_back(cable);
+	}
+	cnt::darr<ecs::Entity> matched;
+	q.each([&](ecs::Entity entity) {
+		matched.push_back(entity);
+	});
+	CHECK(matched.size() == cables.size());
+	for (auto cable: cables)
+		CHECK(core::has(matched, cable));
+	const auto bytecodeAfter = q.bytecode();
+	CHECK(!(bytecodeAfter == bytecodeBefore));
+	CHECK(bytecodeAfter.find("card=1001\n") != BadIndex);
+}
+
+TEST_CASE("Query - variable program replans on statistics drift") {
+	SUBCASE("Cached query") {
+		Test_Query_Variable_Program_Replan<ecs::Query>();
+	}
+	SUBCASE("Non-cached query") {
+		Test_Query_Variable_Program_Replan<QueryUncached>();
+	}
+}
+
 template <typename TQuery>
 void Test_Query_SingleOr_CanonicalizedToAll() {
 	constexpr bool UseCachedQuery = use_cached_query_v<TQuery>;
@@ -5836,3 +5908,117 @@ TEST_CASE("Query - Iter auto view accessors") {
 		CHECK(p1.z == doctest::Approx(7.0f));
 	}
 }
+
+TEST_CASE("Query - compile-time kernel") {
+	TestWorld twld;
+
+	auto create = [&](float x, bool withEmpty) {
+		auto e = wld.add();
+		wld.add<Position>(e, {x, 0, 0});
+		wld.add<Acceleration>(e, {1, 2, 3});
+		if (withEmpty)
+			wld.add<Empty>(e);
+		return e;
+	};
+
+	cnt::darray<ecs::Entity> matched;
+	GAIA_FOR(100) matched.push_back(create((float)i, false));
+	const auto excluded = create(1000, true);
+	const auto disabled = create(2000, false);
+	wld.enable(disabled, false);
+	const auto posOnly = wld.add();
+	wld.add<Position>(posOnly, {3000, 0, 0});
+	const auto prefab = wld.prefab();
+	wld.add<Position>(prefab, {4000, 0, 0});
+	wld.add<Acceleration>(prefab, {1, 2, 3});
+
+	auto k = wld.query<ecs::AllOf<Position&, const Acceleration>, ecs::NoneOf<Empty>>();
+	CHECK(k.archetype_cnt() == 1);
+	CHECK(k.count() == matched.size());
+
+	SUBCASE("each") {
+		k.each([](Position& p, const Acceleration& a) {
+			p.y += a.y;
+			p.z += a.z;
+		});
+
+		GAIA_EACH(matched) {
+			const auto p = wld.get<Position>(matched[i]);
+			CHECK(p.x == (float)i);
+			CHECK(p.y == 2.f);
+			CHECK(p.z == 3.f);
+		}
+		CHECK(wld.get<Position>(excluded).y == 0.f);
+		CHECK(wld.get<Position>(disabled).y == 0.f);
+		CHECK(wld.get<Position>(posOnly).y == 0.f);
+		CHECK(wld.get<Position>(prefab).y == 0.f);
+	}
+
+	SUBCASE("writes are tracked") {
+		auto qChanged = wld.query().all<Position>().changed<Position>();
+		uint32_t cnt = 0;
+		qChanged.each([&](const Position&) {
+			++cnt;
+		});
+
+		cnt = 0;
+		qChanged.each([&](const Position&) {
+			++cnt;
+		});
+		CHECK(cnt == 0);
+
+		k.each([](Position& p, const Acceleration&) {
+			p.x += 1.f;
+		});
+
+		cnt = 0;
+		qChanged.each([&](const Position&) {
+			++cnt;
+		});
+		CHECK(cnt == matched.size());
+	}
+
+	SUBCASE("new archetypes") {
+		const auto e = create(5000, false);
+		wld.add<Rotation>(e, {1, 1, 1, 1});
+		CHECK(k.archetype_cnt() == 2);
+		CHECK(k.count() == matched.size() + 1);
+
+		uint32_t visited = 0;
+		k.each([&](Position& p, const Acceleration&) {
+			p.y = 10.f;
+			++visited;
+		});
+		CHECK(visited == matched.size() + 1);
+		CHECK(wld.get<Position>(e).y == 10.f);
+
+		wld.del(e);
+		wld.update();
+		CHECK(k.count() == matched.size());
+	}
+
+	SUBCASE("each_chunk") {
+		auto kSoA = wld.query<ecs::AllOf<PositionSoA&, const Acceleration>>();
+		cnt::darray<ecs::Entity> soa;
+		GAIA_FOR(50) {
+			auto e = wld.add();
+			wld.add<PositionSoA>(e, {(float)i, 0, 0});
+			wld.add<Acceleration>(e, {1, 2, 3});
+			soa.push_back(e);
+		}
+		wld.enable(soa[0], false);
+
+		kSoA.each_chunk([](uint32_t from, uint32_t to, auto p, auto a) {
+			auto py = p.template set<1>();
+			for (uint32_t i = from; i < to; ++i)
+				py[i] += a[i].y;
+		});
+
+		CHECK(wld.get<PositionSoA>(soa[0]).y == 0.f);
+		GAIA_FOR2(1, soa.size()) {
+			const auto p = wld.get<PositionSoA>(soa[i]);
+			CHECK(p.x == (float)i);
+			CHECK(p.y == 2.f);
+		}
+	}
+}
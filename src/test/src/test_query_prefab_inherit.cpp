@@ -1408,6 +1408,91 @@ TEST_CASE("Prefab - prefab instance lookup maps nested child prefabs under a spa
 	}
 }
 
+TEST_CASE("Prefab - instantiate_n reflects prefab edits made between calls") {
+	TestWorld twld;
+
+	const auto rootPrefab = wld.prefab();
+	const auto childPrefab = wld.prefab();
+	wld.parent(childPrefab, rootPrefab);
+	wld.add<Position>(rootPrefab, {1, 0, 0});
+	wld.add<Position>(childPrefab, {2, 0, 0});
+
+	auto spawn = [&]() {
+		cnt::darray<ecs::Entity> roots;
+		wld.instantiate_n(rootPrefab, 3, [&](ecs::Entity instance) {
+			roots.push_back(instance);
+		});
+		CHECK(roots.size() == 3);
+		return roots;
+	};
+	auto children_of = [&](ecs::Entity root) {
+		cnt::darray<ecs::Entity> children;
+		wld.sources(ecs::Parent, root, [&](ecs::Entity child) {
+			children.push_back(child);
+		});
+		return children;
+	};
+
+	// The first call builds the instantiation plan, the second one reuses it
+	(void)spawn();
+	for (const auto root: spawn()) {
+		const auto children = children_of(root);
+		REQUIRE(children.size() == 1);
+		CHECK(wld.get<Position>(children[0]).x == doctest::Approx(2.0f));
+		CHECK_FALSE(wld.has<Scale>(children[0]));
+	}
+
+	// New component on a child prefab
+	wld.add<Scale>(childPrefab, {4, 0, 0});
+	for (const auto root: spawn()) {
+		const auto children = children_of(root);
+		REQUIRE(children.size() == 1);
+		CHECK(wld.get<Scale>(children[0]).x == doctest::Approx(4.0f));
+	}
+
+	// Changed data is picked up without rebuilding anything
+	wld.set<Scale>(childPrefab) = {5, 0, 0};
+	for (const auto root: spawn()) {
+		const auto children = children_of(root);
+		REQUIRE(children.size() == 1);
+		CHECK(wld.get<Scale>(children[0]).x == doctest::Approx(5.0f));
+	}
+
+	// New child prefab
+	const auto childPrefab2 = wld.prefab();
+	wld.add<Position>(childPrefab2, {3, 0, 0});
+	wld.parent(childPrefab2, rootPrefab);
+	for (const auto root: spawn()) {
+		const auto children = children_of(root);
+		CHECK(children.size() == 2);
+		uint32_t hits = 0;
+		for (const auto child: children) {
+			if (wld.has_direct(child, ecs::Pair(ecs::Is, childPrefab2))) {
+				CHECK(wld.get<Position>(child).x == doctest::Approx(3.0f));
+				++hits;
+			}
+		}
+		CHECK(hits == 1);
+	}
+
+	// Changed instantiation policy
+	wld.add(wld.add<Position>().entity, ecs::Pair(ecs::OnInstantiate, ecs::DontInherit));
+	for (const auto root: spawn()) {
+		CHECK_FALSE(wld.has<Position>(root));
+		for (const auto child: children_of(root))
+			CHECK_FALSE(wld.has<Position>(child));
+	}
+
+	// Deleted child prefab
+	wld.del(childPrefab2);
+	for (const auto root: spawn()) {
+		const auto children = children_of(root);
+		REQUIRE(children.size() == 1);
+		CHECK(wld.has_direct(children[0], ecs::Pair(ecs::Is, childPrefab)));
+		CHECK(wld.get<Scale>(children[0]).x == doctest::Approx(5.0f));
+	}
+}
+
 TEST_CASE("Prefab - instantiate_n with zero count does nothing") {
 	TestWorld twld;
 
@@ -1882,6 +1882,453 @@ TEST_CASE("Serialization - world other") {
 	CHECK(apple2 == apple);
 }
 
+TEST_CASE("Serialization - world streamed") {
+	auto initComponents = [](ecs::World& w) {
+		(void)w.add<Position>();
+		(void)w.add<PositionSoA>();
+	};
+
+	ecs::World in;
+	initComponents(in);
+
+	ecs::Entity eats = in.add();
+	ecs::Entity carrot = in.add();
+	in.add<Position>(eats, {1, 2, 3});
+	in.add<PositionSoA>(eats, {10, 20, 30});
+	in.name(eats, "Eats");
+	in.name(carrot, "Carrot");
+	in.alias(carrot, "Veggie");
+
+	// Enough data to overflow the small block and ring buffers used below
+	cnt::darray<ecs::Entity> copies;
+	in.copy_n(eats, 1000, [&](ecs::Entity e) {
+		copies.push_back(e);
+	});
+	GAIA_EACH(copies) in.set<Position>(copies[i]) = {(float)i, 2, 3};
+
+	struct Sink {
+		cnt::darray<uint8_t> data;
+		uint32_t calls = 0;
+	} sink;
+	struct Source {
+		const uint8_t* pData;
+		uint32_t left;
+	};
+
+	const ser::stream_sink streamSink{&sink, [](void* user, const ser::stream_block* pBlocks, uint32_t blockCnt) {
+		auto& dst = *(Sink*)user;
+		++dst.calls;
+		GAIA_FOR(blockCnt) {
+			const auto* pData = (const uint8_t*)pBlocks[i].data;
+			GAIA_FOR_(pBlocks[i].size, j) dst.data.push_back(pData[j]);
+		}
+		return true;
+	}};
+	const ser::stream_read_fn readFunc = [](void* user, void* pDst, uint32_t size) {
+		auto& src = *(Source*)user;
+		size = core::get_min(size, src.left);
+		memcpy(pDst, src.pData, size);
+		src.pData += size;
+		src.left -= size;
+		return size;
+	};
+
+	{
+		// Tiny blocks to exercise batching and direct writes
+		ser::bin_stream_writer writer(streamSink, 64, 4);
+		in.set_serializer(writer);
+		in.save();
+		CHECK(writer.flush());
+		CHECK(writer.bytes_total() == sink.data.size());
+		in.set_serializer(nullptr);
+	}
+	CHECK(sink.calls > 1);
+
+	// The streamed snapshot matches the in-memory one
+	ser::bin_stream buffer;
+	in.set_serializer(buffer);
+	in.save();
+	CHECK(buffer.bytes() == sink.data.size());
+
+	auto checkWorld = [&](ecs::World& w) {
+		Position pos = w.get<Position>(eats);
+		CHECK(pos.x == 1.f);
+		CHECK(pos.y == 2.f);
+		CHECK(pos.z == 3.f);
+
+		PositionSoA pos_soa = w.get<PositionSoA>(eats);
+		CHECK(pos_soa.x == 10.f);
+		CHECK(pos_soa.y == 20.f);
+		CHECK(pos_soa.z == 30.f);
+
+		GAIA_EACH(copies) CHECK(w.get<Position>(copies[i]).x == (float)i);
+
+		CHECK(w.get("Eats") == eats);
+		CHECK(w.get("Carrot") == carrot);
+		CHECK(w.alias(carrot) == "Veggie");
+	};
+
+	SUBCASE("streamed reader") {
+		Source source{sink.data.data(), (uint32_t)sink.data.size()};
+		ser::bin_stream_reader reader({&source, readFunc}, 128);
+
+		TestWorld twld;
+		initComponents(wld);
+		CHECK(wld.load(reader));
+		CHECK(reader.ok());
+		CHECK(source.left == 0);
+		checkWorld(wld);
+	}
+
+	SUBCASE("in-memory reader") {
+		ser::bin_stream input;
+		input.save_raw(sink.data.data(), (uint32_t)sink.data.size(), ser::serialization_type_id::u8);
+
+		TestWorld twld;
+		initComponents(wld);
+		CHECK(wld.load(input));
+		checkWorld(wld);
+	}
+
+	SUBCASE("truncated stream") {
+		Source source{sink.data.data(), (uint32_t)sink.data.size() / 2};
+		ser::bin_stream_reader reader({&source, readFunc}, 128);
+
+		uint32_t version = 0;
+		auto s = ser::make_serializer(reader);
+		s.load(version);
+		CHECK(reader.ok());
+		s.seek((uint32_t)sink.data.size());
+		CHECK_FALSE(reader.ok());
+	}
+}
+
+TEST_CASE("Serialization - world packed") {
+	auto initComponents = [](ecs::World& w) {
+		(void)w.add<Position>();
+		(void)w.add<PositionSoA>();
+	};
+
+	ecs::World in;
+	initComponents(in);
+
+	ecs::Entity eats = in.add();
+	in.add<Position>(eats, {1, 2, 3});
+	in.add<PositionSoA>(eats, {10, 20, 30});
+	in.name(eats, "Eats");
+
+	cnt::darray<ecs::Entity> copies;
+	in.copy_n(eats, 5000, [&](ecs::Entity e) {
+		copies.push_back(e);
+	});
+	GAIA_EACH(copies) in.set<Position>(copies[i]) = {(float)i, 2, 3};
+
+	ser::bin_stream buffer;
+	in.set_serializer(buffer);
+	in.save();
+	in.set_serializer(nullptr);
+
+	auto checkWorld = [&](ecs::World& w) {
+		CHECK(w.get<Position>(eats).x == 1.f);
+		CHECK(w.get<PositionSoA>(eats).z == 30.f);
+		GAIA_EACH(copies) CHECK(w.get<Position>(copies[i]).x == (float)i);
+		CHECK(w.get("Eats") == eats);
+	};
+
+	auto roundTrip = [&](const ser::pack_opts& opts) {
+		cnt::darray<uint8_t> packed;
+		ser::pack_snapshot(buffer, packed, opts);
+		CHECK(packed.size() < buffer.bytes());
+
+		ser::packed_view view;
+		CHECK(view.init(packed.data(), (uint32_t)packed.size()));
+		CHECK(view.raw_size() == buffer.bytes());
+		CHECK(view.block_cnt() > 1);
+
+		// Blocks are independent so decode them in reverse order
+		ser::bin_stream unpacked;
+		uint32_t decoded = 0;
+		CHECK(ser::unpack_snapshot(
+				packed.data(), (uint32_t)packed.size(), unpacked, [&](uint32_t cnt, const auto& func) {
+					for (uint32_t i = cnt; i > 0; --i) {
+						func(i - 1);
+						++decoded;
+					}
+				}));
+		CHECK(decoded == view.block_cnt());
+		CHECK(unpacked.bytes() == buffer.bytes());
+		CHECK(memcmp(unpacked.data(), buffer.data(), buffer.bytes()) == 0);
+
+		TestWorld twld;
+		initComponents(wld);
+		CHECK(wld.load(unpacked));
+		checkWorld(wld);
+	};
+
+	SUBCASE("no filter") {
+		roundTrip({4096, ser::pack_filter::None, 4});
+	}
+	SUBCASE("shuffle") {
+		roundTrip({4096, ser::pack_filter::Shuffle, 4});
+	}
+	SUBCASE("shuffle delta") {
+		roundTrip({4096, ser::pack_filter::ShuffleDelta, 4});
+	}
+	SUBCASE("auto") {
+		roundTrip({4096, ser::pack_filter::Auto, 4});
+	}
+
+	SUBCASE("incompressible data") {
+		cnt::darray<uint8_t> noise(10000);
+		uint32_t seed = 12345;
+		GAIA_EACH(noise) {
+			seed = seed * 1664525U + 1013904223U;
+			noise[i] = (uint8_t)(seed >> 24);
+		}
+
+		cnt::darray<uint8_t> packed;
+		ser::pack_snapshot(noise.data(), (uint32_t)noise.size(), packed, {1000, ser::pack_filter::Auto, 4});
+
+		ser::bin_stream unpacked;
+		CHECK(ser::unpack_snapshot(packed.data(), (uint32_t)packed.size(), unpacked));
+		CHECK(unpacked.bytes() == noise.size());
+		CHECK(memcmp(unpacked.data(), noise.data(), noise.size()) == 0);
+	}
+
+	SUBCASE("corrupted container") {
+		cnt::darray<uint8_t> packed;
+		ser::pack_snapshot(buffer, packed);
+
+		ser::bin_stream unpacked;
+		CHECK_FALSE(ser::unpack_snapshot(packed.data(), 10, unpacked));
+		CHECK(unpacked.bytes() == 0);
+
+		// Damage every payload byte past the block table. Decoding must fail or at least stay in bounds.
+		ser::packed_view view;
+		CHECK(view.init(packed.data(), (uint32_t)packed.size()));
+		const uint32_t payload = (uint32_t)packed.size() - 16;
+		GAIA_FOR2(payload, (uint32_t)packed.size()) packed[i] ^= 0x5A;
+		(void)ser::unpack_snapshot(packed.data(), (uint32_t)packed.size(), unpacked);
+
+		packed[0] = 0;
+		CHECK_FALSE(ser::unpack_snapshot(packed.data(), (uint32_t)packed.size(), unpacked));
+	}
+}
+
+TEST_CASE("Serialization - world state hash") {
+	auto init = [](ecs::World& w, cnt::darray<ecs::Entity>& ents) {
+		(void)w.add<Position>();
+		(void)w.add<PositionSoA>();
+		(void)w.add<Acceleration>();
+		GAIA_FOR(1000) {
+			auto e = w.add();
+			w.add<Position>(e, {(float)i, 1.f, 2.f});
+			w.add<PositionSoA>(e, {(float)i, 3.f, 4.f});
+			w.add<Acceleration>(e, {0.f, 0.f, 0.f});
+			ents.push_back(e);
+		}
+	};
+
+	ecs::World w;
+	cnt::darray<ecs::Entity> ents;
+	init(w, ents);
+
+	const auto h0 = w.hash_state();
+	CHECK(h0 == w.hash_state());
+
+	// Identical worlds give identical hashes
+	{
+		ecs::World w2;
+		cnt::darray<ecs::Entity> ents2;
+		init(w2, ents2);
+		CHECK(h0 == w2.hash_state());
+	}
+
+	SUBCASE("Component writes") {
+		w.set<Position>(ents[500]) = {-1.f, 1.f, 2.f};
+		const auto h1 = w.hash_state();
+		CHECK(h1 != h0);
+		CHECK(h1 == w.hash_state());
+
+		// Reverting the value reverts the hash
+		w.set<Position>(ents[500]) = {500.f, 1.f, 2.f};
+		CHECK(w.hash_state() == h0);
+
+		// SoA components are hashed as well
+		w.set<PositionSoA>(ents[10]) = {10.f, 3.f, 5.f};
+		CHECK(w.hash_state() != h0);
+		w.set<PositionSoA>(ents[10]) = {10.f, 3.f, 4.f};
+		CHECK(w.hash_state() == h0);
+
+		// Writes via queries are visible
+		w.query().all<Position&>().each([](Position& p) {
+			p.z += 1.f;
+		});
+		CHECK(w.hash_state() != h0);
+	}
+
+	SUBCASE("Excluded components") {
+		const ecs::Entity excluded[] = {w.add<Acceleration>().entity};
+		const auto h1 = w.hash_state(excluded);
+		CHECK(h1 != h0);
+
+		w.set<Acceleration>(ents[0]) = {1.f, 1.f, 1.f};
+		CHECK(w.hash_state(excluded) == h1);
+		CHECK(w.hash_state() != h0);
+	}
+
+	SUBCASE("Structural changes") {
+		struct HashTag {};
+		w.add<HashTag>(ents[5]);
+		const auto h1 = w.hash_state();
+		CHECK(h1 != h0);
+		w.del<HashTag>(ents[5]);
+		CHECK(w.hash_state() != h1);
+
+		w.enable(ents[7], false);
+		const auto h2 = w.hash_state();
+		CHECK(h2 != h0);
+		w.enable(ents[7], true);
+		CHECK(w.hash_state() != h2);
+
+		w.del(ents[9]);
+		w.update();
+		CHECK(w.hash_state() != h0);
+	}
+
+	SUBCASE("Save and load") {
+		ser::bin_stream buffer;
+		w.set_serializer(buffer);
+		w.save();
+
+		w.set_serializer(nullptr);
+
+		// A loaded world has the same state even though its chunks were allocated differently
+		ecs::World w2;
+		(void)w2.add<Position>();
+		(void)w2.add<PositionSoA>();
+		(void)w2.add<Acceleration>();
+		CHECK(w2.load(buffer));
+		CHECK(w2.hash_state() == h0);
+
+		w2.set<Position>(ents[1]) = {0.f, 0.f, 0.f};
+		CHECK(w2.hash_state() != h0);
+	}
+}
+
+TEST_CASE("Serialization - snapshot ring") {
+	ecs::World w;
+	(void)w.add<Position>();
+	(void)w.add<PositionSoA>();
+	(void)w.add<Acceleration>();
+
+	cnt::darray<ecs::Entity> ents;
+	GAIA_FOR(1000) {
+		auto e = w.add();
+		w.add<Position>(e, {(float)i, 1.f, 2.f});
+		w.add<PositionSoA>(e, {(float)i, 3.f, 4.f});
+		w.add<Acceleration>(e, {0.f, 0.f, 0.f});
+		ents.push_back(e);
+	}
+
+	auto q = w.query().all<Position&>().all<PositionSoA&>();
+	auto move = [&]() {
+		q.each([](ecs::Iter& it) {
+			auto p = it.view_mut<Position>();
+			auto ps = it.view_mut<PositionSoA>(1);
+			GAIA_EACH(it) {
+				p[i].x += 1.f;
+				auto row = (PositionSoA)ps[i];
+				row.y += 1.f;
+				ps[i] = row;
+			}
+		});
+	};
+
+	ecs::SnapshotRing ring(w, 4);
+	CHECK(ring.max_frames() == 4);
+	CHECK(ring.size() == 0);
+	CHECK_FALSE(ring.restore(0));
+
+	cnt::darray<uint64_t> hashes;
+	GAIA_FOR(6) {
+		hashes.push_back(w.hash_state());
+		ring.capture(i);
+		move();
+	}
+
+	// Only the last 4 frames are kept
+	CHECK(ring.size() == 4);
+	CHECK_FALSE(ring.contains(1));
+	CHECK(ring.contains(2));
+	CHECK(ring.contains(5));
+
+	SUBCASE("Restore") {
+		CHECK(ring.restore(3));
+		CHECK(w.hash_state() == hashes[3]);
+		CHECK(w.get<Position>(ents[10]).x == 13.f);
+		CHECK(w.get<PositionSoA>(ents[10]).y == 6.f);
+		CHECK(w.get<Acceleration>(ents[10]).x == 0.f);
+
+		// Newer frames are dropped
+		CHECK(ring.size() == 2);
+		CHECK_FALSE(ring.contains(4));
+
+		// Restored data is visible to changed() filters
+		uint32_t cnt = 0;
+		w.query().all<Position>().changed<Position>().each([&]() {
+			++cnt;
+		});
+		CHECK(cnt == 1000);
+
+		// Rolling back again and re-simulating reproduces the same frames
+		CHECK(ring.restore(2));
+		CHECK(w.hash_state() == hashes[2]);
+		move();
+		ring.capture(3);
+		CHECK(w.hash_state() == hashes[3]);
+		move();
+		CHECK(w.hash_state() == hashes[4]);
+		CHECK(ring.restore(3));
+		CHECK(w.hash_state() == hashes[3]);
+	}
+
+	SUBCASE("Unchanged columns are shared") {
+		ecs::SnapshotRing ring2(w);
+		ring2.capture(0);
+		const auto bytes = ring2.bytes();
+		ring2.capture(1);
+		ring2.capture(2);
+		CHECK(ring2.bytes() == bytes);
+
+		// Only the modified column is copied
+		w.set<Acceleration>(ents[0]) = {1.f, 1.f, 1.f};
+		ring2.capture(3);
+		CHECK(ring2.bytes() > bytes);
+		CHECK(ring2.bytes() < bytes + bytes / 2);
+		CHECK(ring2.restore(2));
+		CHECK(w.get<Acceleration>(ents[0]).x == 0.f);
+	}
+
+	SUBCASE("Structural changes") {
+		w.del(ents[9]);
+		w.update();
+		CHECK_FALSE(ring.restore(3));
+
+		// Frames captured after the change can be restored
+		ring.capture(6);
+		move();
+		CHECK(ring.restore(6));
+	}
+
+	SUBCASE("Clear") {
+		ring.clear();
+		CHECK(ring.size() == 0);
+		CHECK(ring.bytes() == 0);
+		CHECK_FALSE(ring.restore(5));
+	}
+}
+
 TEST_CASE("Serialization - world preserves Parent non-fragmenting relations") {
 	ecs::World in;
 